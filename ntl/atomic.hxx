@@ -569,6 +569,16 @@ namespace atomic {
 
 #elif defined(__GNUC__)
 
+namespace intrinsic
+{
+  __forceinline uint64_t rdtsc()
+  {
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return static_cast<uint64_t>(hi) << 32 | lo;
+  }
+}
+
 namespace atomic {
 
   template<typename T>
@@ -0,0 +1,269 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  B-tree ordered containers
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__BTREE
+#define NTL__BTREE
+#pragma once
+
+#include "stlx/stdexcept_fwd.hxx"
+#include "stlx/ext/btree.hxx"
+
+namespace ntl {
+
+/**
+ *	The std::map interface over the B-tree: many values per node instead of a node per value,
+ *  so the lookups and the ordered iteration are cache-friendly and a value takes less memory.
+ *
+ *  The insertion and the erasure invalidate the iterators and the references.
+ *  \a NodeSize is the size of the leaf node in bytes, the 32-bit integer keys are searched with SSE2 unless NTL_NO_SIMD is defined.
+ **/
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T> >,
+          size_t NodeSize = 256>
+class btree_map:
+  public std::ext::tree::btree<Key, std::pair<Key, T>, std::ext::tree::__::btree_map_key<Key, T>, Compare, Allocator, false, NodeSize>
+{
+  typedef std::ext::tree::btree<Key, std::pair<Key, T>, std::ext::tree::__::btree_map_key<Key, T>, Compare, Allocator, false, NodeSize> tree_type;
+  public:
+
+    ///\name  types
+    typedef T                                         mapped_type;
+    typedef typename tree_type::key_type              key_type;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+    typedef typename tree_type::size_type             size_type;
+
+    class value_compare:
+      public std::binary_function<value_type, value_type, bool>
+    {
+      friend class btree_map;
+    public:
+      bool operator()(const value_type& x, const value_type& y) const { return comp(x.first, y.first); }
+    protected:
+      Compare comp;
+      value_compare(Compare c) : comp(c) {}
+    };
+
+    ///\name construct/copy/destroy
+    explicit btree_map(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    btree_map(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    btree_map& operator=(const btree_map& x)
+    {
+      tree_type::operator=(x);
+      return *this;
+    }
+
+    ///\name element access
+    T& operator[](const key_type& x)
+    {
+      iterator i = tree_type::lower_bound(x);
+      if ( i == this->end() || this->comparator_(x, i->first) )
+        i = tree_type::insert_unique(i, value_type(x, mapped_type()));
+      return i->second;
+    }
+
+    T& at(const key_type& x) __ntl_throws(std::out_of_range)
+    {
+      iterator i = this->find(x);
+      if ( i == this->end() )
+        std::__throw_out_of_range("specified key isn't exists in the map");
+      return i->second;
+    }
+
+    const T& at(const key_type& x) const __ntl_throws(std::out_of_range)
+    {
+      const_iterator i = this->find(x);
+      if ( i == this->end() )
+        std::__throw_out_of_range("specified key isn't exists in the map");
+      return i->second;
+    }
+
+    ///\name modifiers
+    std::pair<iterator, bool> insert(const value_type& x)           { return tree_type::insert_unique(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_unique(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_unique(first, last); }
+
+    void swap(btree_map& x)                                         { tree_type::swap(x); }
+
+    ///\name observers
+    value_compare value_comp() const { return value_compare(this->comparator_); }
+    ///\}
+};
+
+/// The std::multimap interface over the B-tree, the equal keys are kept in the order of insertion
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T> >,
+          size_t NodeSize = 256>
+class btree_multimap:
+  public std::ext::tree::btree<Key, std::pair<Key, T>, std::ext::tree::__::btree_map_key<Key, T>, Compare, Allocator, true, NodeSize>
+{
+  typedef std::ext::tree::btree<Key, std::pair<Key, T>, std::ext::tree::__::btree_map_key<Key, T>, Compare, Allocator, true, NodeSize> tree_type;
+  public:
+
+    ///\name  types
+    typedef T                                         mapped_type;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+
+    ///\name construct/copy/destroy
+    explicit btree_multimap(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    btree_multimap(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    btree_multimap& operator=(const btree_multimap& x)
+    {
+      tree_type::operator=(x);
+      return *this;
+    }
+
+    ///\name modifiers
+    iterator insert(const value_type& x)                            { return tree_type::insert_multi(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_multi(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_multi(first, last); }
+
+    void swap(btree_multimap& x)                                    { tree_type::swap(x); }
+    ///\}
+};
+
+/// The std::set interface over the B-tree
+template <class Key,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<Key>,
+          size_t NodeSize = 256>
+class btree_set:
+  public std::ext::tree::btree<Key, Key, std::ext::tree::__::btree_set_key<Key>, Compare, Allocator, false, NodeSize>
+{
+  typedef std::ext::tree::btree<Key, Key, std::ext::tree::__::btree_set_key<Key>, Compare, Allocator, false, NodeSize> tree_type;
+  public:
+
+    ///\name  types
+    typedef Compare                                   value_compare;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+
+    ///\name construct/copy/destroy
+    explicit btree_set(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    btree_set(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    btree_set& operator=(const btree_set& x)
+    {
+      tree_type::operator=(x);
+      return *this;
+    }
+
+    ///\name modifiers
+    std::pair<iterator, bool> insert(const value_type& x)           { return tree_type::insert_unique(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_unique(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_unique(first, last); }
+
+    void swap(btree_set& x)                                         { tree_type::swap(x); }
+
+    ///\name observers
+    value_compare value_comp() const { return this->comparator_; }
+    ///\}
+};
+
+/// The std::multiset interface over the B-tree
+template <class Key,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<Key>,
+          size_t NodeSize = 256>
+class btree_multiset:
+  public std::ext::tree::btree<Key, Key, std::ext::tree::__::btree_set_key<Key>, Compare, Allocator, true, NodeSize>
+{
+  typedef std::ext::tree::btree<Key, Key, std::ext::tree::__::btree_set_key<Key>, Compare, Allocator, true, NodeSize> tree_type;
+  public:
+
+    ///\name  types
+    typedef Compare                                   value_compare;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+
+    ///\name construct/copy/destroy
+    explicit btree_multiset(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    btree_multiset(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    btree_multiset& operator=(const btree_multiset& x)
+    {
+      tree_type::operator=(x);
+      return *this;
+    }
+
+    ///\name modifiers
+    iterator insert(const value_type& x)                            { return tree_type::insert_multi(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_multi(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_multi(first, last); }
+
+    void swap(btree_multiset& x)                                    { tree_type::swap(x); }
+
+    ///\name observers
+    value_compare value_comp() const { return this->comparator_; }
+    ///\}
+};
+
+template <class Key, class T, class Compare, class Allocator, size_t NodeSize>
+inline void swap(btree_map<Key, T, Compare, Allocator, NodeSize>& x, btree_map<Key, T, Compare, Allocator, NodeSize>& y) { x.swap(y); }
+
+template <class Key, class T, class Compare, class Allocator, size_t NodeSize>
+inline void swap(btree_multimap<Key, T, Compare, Allocator, NodeSize>& x, btree_multimap<Key, T, Compare, Allocator, NodeSize>& y) { x.swap(y); }
+
+template <class Key, class Compare, class Allocator, size_t NodeSize>
+inline void swap(btree_set<Key, Compare, Allocator, NodeSize>& x, btree_set<Key, Compare, Allocator, NodeSize>& y) { x.swap(y); }
+
+template <class Key, class Compare, class Allocator, size_t NodeSize>
+inline void swap(btree_multiset<Key, Compare, Allocator, NodeSize>& x, btree_multiset<Key, Compare, Allocator, NodeSize>& y) { x.swap(y); }
+
+}//namespace ntl
+
+#endif//#ifndef NTL__BTREE
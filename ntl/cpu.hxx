@@ -14,6 +14,10 @@ namespace ntl {
   namespace intrinsic {
     extern "C" void __cdecl _mm_pause();
     #pragma intrinsic(_mm_pause)
+#ifdef _MSC_VER
+    extern "C" void __cdecl __cpuid(int CPUInfo[4], int InfoType);
+    #pragma intrinsic(__cpuid)
+#endif
   }
 
   /// CPU functions
@@ -32,6 +36,27 @@ namespace ntl {
 #ifdef NTL__NT_BASEDEF
     static inline void yield() { ntl::nt::ZwYieldExecution(); }
 #endif
+
+    /** Queries the processor identification and feature information for the \p leaf into EAX, EBX, ECX and EDX */
+    static inline void cpuid(int leaf, int regs[4])
+    {
+#ifdef _MSC_VER
+      intrinsic::__cpuid(regs, leaf);
+#else
+      __asm__ __volatile__("cpuid" : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3]) : "a"(leaf), "c"(0));
+#endif
+    }
+
+    /** The time-stamp counter runs at a constant rate in all ACPI P-, C- and T-states */
+    static inline bool invariant_tsc()
+    {
+      int regs[4];
+      cpuid(0x80000000, regs);
+      if(static_cast<unsigned>(regs[0]) < 0x80000007)
+        return false;
+      cpuid(0x80000007, regs);
+      return (regs[3] & (1 << 8)) != 0;
+    }
   } // cpu
 } // ntl
 #endif // NTL__CPU
@@ -0,0 +1,300 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Sorted vector ordered containers
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__FLAT_MAP
+#define NTL__FLAT_MAP
+#pragma once
+
+#include "stlx/stdexcept_fwd.hxx"
+#include "stlx/ext/flat_tree.hxx"
+
+namespace ntl {
+
+/// The range is sorted by the key_comp() already
+struct sorted_range_t {};
+
+#ifndef __BCPLUSPLUS__
+__declspec(selectany) extern const sorted_range_t sorted_range = {};
+#else
+__declspec(selectany) extern const sorted_range_t sorted_range;
+#endif
+
+/// The lookup layouts: the binary search, the binary search without branches and the Eytzinger index
+using std::ext::tree::flat_binary_layout;
+using std::ext::tree::flat_branchless_layout;
+using std::ext::tree::flat_eytzinger_layout;
+
+/**
+ *	The std::map interface over the sorted vector: the maps which are built at once and then only looked up
+ *  take no memory besides the values and are walked as the arrays.
+ *
+ *  The range constructor and insert() sort the range and merge it, the single value is inserted in O(n).
+ *  The insertion and the erasure invalidate the iterators and the references.
+ *  \a Layout selects the lookup: flat_binary_layout, flat_branchless_layout or flat_eytzinger_layout.
+ **/
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T> >,
+          class Layout = flat_binary_layout>
+class flat_map:
+  public std::ext::tree::flat_tree<Key, std::pair<Key, T>, std::ext::tree::__::flat_map_key<Key, T>, Compare, Allocator, false, Layout>
+{
+  typedef std::ext::tree::flat_tree<Key, std::pair<Key, T>, std::ext::tree::__::flat_map_key<Key, T>, Compare, Allocator, false, Layout> tree_type;
+  public:
+
+    ///\name  types
+    typedef T                                         mapped_type;
+    typedef typename tree_type::key_type              key_type;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+    typedef typename tree_type::size_type             size_type;
+
+    class value_compare:
+      public std::binary_function<value_type, value_type, bool>
+    {
+      friend class flat_map;
+    public:
+      bool operator()(const value_type& x, const value_type& y) const { return comp(x.first, y.first); }
+    protected:
+      Compare comp;
+      value_compare(Compare c) : comp(c) {}
+    };
+
+    ///\name construct/copy/destroy
+    explicit flat_map(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    template <class InputIterator>
+    flat_map(sorted_range_t, InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(sorted_range, first, last);
+    }
+
+    ///\name element access
+    T& operator[](const key_type& x)
+    {
+      iterator i = tree_type::lower_bound(x);
+      if ( i == this->end() || this->comparator_(x, i->first) )
+        i = tree_type::insert_unique(i, value_type(x, mapped_type()));
+      return i->second;
+    }
+
+    T& at(const key_type& x) __ntl_throws(std::out_of_range)
+    {
+      iterator i = this->find(x);
+      if ( i == this->end() )
+        std::__throw_out_of_range("specified key isn't exists in the map");
+      return i->second;
+    }
+
+    const T& at(const key_type& x) const __ntl_throws(std::out_of_range)
+    {
+      const_iterator i = this->find(x);
+      if ( i == this->end() )
+        std::__throw_out_of_range("specified key isn't exists in the map");
+      return i->second;
+    }
+
+    ///\name modifiers
+    std::pair<iterator, bool> insert(const value_type& x)           { return tree_type::insert_unique(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_unique(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_range(first, last, false); }
+
+    template <class InputIterator>
+    void insert(sorted_range_t, InputIterator first, InputIterator last) { tree_type::insert_range(first, last, true); }
+
+    void swap(flat_map& x)                                          { tree_type::swap(x); }
+
+    ///\name observers
+    value_compare value_comp() const { return value_compare(this->comparator_); }
+    ///\}
+};
+
+/// The std::multimap interface over the sorted vector, the equal keys are kept in the order of insertion
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T> >,
+          class Layout = flat_binary_layout>
+class flat_multimap:
+  public std::ext::tree::flat_tree<Key, std::pair<Key, T>, std::ext::tree::__::flat_map_key<Key, T>, Compare, Allocator, true, Layout>
+{
+  typedef std::ext::tree::flat_tree<Key, std::pair<Key, T>, std::ext::tree::__::flat_map_key<Key, T>, Compare, Allocator, true, Layout> tree_type;
+  public:
+
+    ///\name  types
+    typedef T                                         mapped_type;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+
+    ///\name construct/copy/destroy
+    explicit flat_multimap(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    flat_multimap(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    template <class InputIterator>
+    flat_multimap(sorted_range_t, InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(sorted_range, first, last);
+    }
+
+    ///\name modifiers
+    iterator insert(const value_type& x)                            { return tree_type::insert_multi(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_multi(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_range(first, last, false); }
+
+    template <class InputIterator>
+    void insert(sorted_range_t, InputIterator first, InputIterator last) { tree_type::insert_range(first, last, true); }
+
+    void swap(flat_multimap& x)                                     { tree_type::swap(x); }
+    ///\}
+};
+
+/// The std::set interface over the sorted vector
+template <class Key,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<Key>,
+          class Layout = flat_binary_layout>
+class flat_set:
+  public std::ext::tree::flat_tree<Key, Key, std::ext::tree::__::flat_set_key<Key>, Compare, Allocator, false, Layout>
+{
+  typedef std::ext::tree::flat_tree<Key, Key, std::ext::tree::__::flat_set_key<Key>, Compare, Allocator, false, Layout> tree_type;
+  public:
+
+    ///\name  types
+    typedef Compare                                   value_compare;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+
+    ///\name construct/copy/destroy
+    explicit flat_set(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    template <class InputIterator>
+    flat_set(sorted_range_t, InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(sorted_range, first, last);
+    }
+
+    ///\name modifiers
+    std::pair<iterator, bool> insert(const value_type& x)           { return tree_type::insert_unique(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_unique(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_range(first, last, false); }
+
+    template <class InputIterator>
+    void insert(sorted_range_t, InputIterator first, InputIterator last) { tree_type::insert_range(first, last, true); }
+
+    void swap(flat_set& x)                                          { tree_type::swap(x); }
+
+    ///\name observers
+    value_compare value_comp() const { return this->comparator_; }
+    ///\}
+};
+
+/// The std::multiset interface over the sorted vector
+template <class Key,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<Key>,
+          class Layout = flat_binary_layout>
+class flat_multiset:
+  public std::ext::tree::flat_tree<Key, Key, std::ext::tree::__::flat_set_key<Key>, Compare, Allocator, true, Layout>
+{
+  typedef std::ext::tree::flat_tree<Key, Key, std::ext::tree::__::flat_set_key<Key>, Compare, Allocator, true, Layout> tree_type;
+  public:
+
+    ///\name  types
+    typedef Compare                                   value_compare;
+    typedef typename tree_type::value_type            value_type;
+    typedef typename tree_type::iterator              iterator;
+    typedef typename tree_type::const_iterator        const_iterator;
+
+    ///\name construct/copy/destroy
+    explicit flat_multiset(const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {}
+
+    template <class InputIterator>
+    flat_multiset(InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(first, last);
+    }
+
+    template <class InputIterator>
+    flat_multiset(sorted_range_t, InputIterator first, InputIterator last, const Compare& comp = Compare(), const Allocator& a = Allocator())
+      :tree_type(comp, a)
+    {
+      insert(sorted_range, first, last);
+    }
+
+    ///\name modifiers
+    iterator insert(const value_type& x)                            { return tree_type::insert_multi(x); }
+    iterator insert(const_iterator position, const value_type& x)   { return tree_type::insert_multi(position, x); }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last)            { tree_type::insert_range(first, last, false); }
+
+    template <class InputIterator>
+    void insert(sorted_range_t, InputIterator first, InputIterator last) { tree_type::insert_range(first, last, true); }
+
+    void swap(flat_multiset& x)                                     { tree_type::swap(x); }
+
+    ///\name observers
+    value_compare value_comp() const { return this->comparator_; }
+    ///\}
+};
+
+template <class Key, class T, class Compare, class Allocator, class Layout>
+inline void swap(flat_map<Key, T, Compare, Allocator, Layout>& x, flat_map<Key, T, Compare, Allocator, Layout>& y) { x.swap(y); }
+
+template <class Key, class T, class Compare, class Allocator, class Layout>
+inline void swap(flat_multimap<Key, T, Compare, Allocator, Layout>& x, flat_multimap<Key, T, Compare, Allocator, Layout>& y) { x.swap(y); }
+
+template <class Key, class Compare, class Allocator, class Layout>
+inline void swap(flat_set<Key, Compare, Allocator, Layout>& x, flat_set<Key, Compare, Allocator, Layout>& y) { x.swap(y); }
+
+template <class Key, class Compare, class Allocator, class Layout>
+inline void swap(flat_multiset<Key, Compare, Allocator, Layout>& x, flat_multiset<Key, Compare, Allocator, Layout>& y) { x.swap(y); }
+
+}//namespace ntl
+
+#endif//#ifndef NTL__FLAT_MAP
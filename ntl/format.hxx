@@ -1,14 +1,24 @@
 /**\file*********************************************************************
  *                                                                     \brief
- *
+ *  Allocation-free {}-style formatting into fixed buffers
  *
  ****************************************************************************
  */
 #ifndef NTL__FORMAT
 #define NTL__FORMAT
-#pragma once
+#pragma once
 
-#include "base.hxx"
+#include "basedef.hxx"
+#ifndef NTL__EXT_NUMERIC_CONVERSIONS
+# include "stlx/ext/numeric_conversions.hxx"
+#endif
+#ifndef NTL__NT_STRING
+# include "nt/string.hxx"
+#endif
+#include "nt/status.hxx"
+#ifndef NTL_SPP_ARGS_HXX
+# include "spp/args.hxx"
+#endif
 
 namespace ntl {
 namespace fmt {
@@ -43,18 +53,18 @@ char_t * to_hex(int_t v, char_t * const p)
 template<typename char_t = char>
 struct hex_str_cast
 {
-    hex_str_cast(int8 v)    { to_hex(v, buf); }
-    hex_str_cast(int16 v)   { to_hex(v, buf); }
-    hex_str_cast(int32 v)   { to_hex(v, buf); }
-    hex_str_cast(int64 v)   { to_hex(v, buf); }
-    hex_str_cast(uint8 v)   { to_hex(v, buf); }
-    hex_str_cast(uint16 v)  { to_hex(v, buf); }
-    hex_str_cast(uint32 v)  { to_hex(v, buf); }
-    hex_str_cast(uint64 v)  { to_hex(v, buf); }
+    hex_str_cast(int8_t v)    { to_hex(v, buf); }
+    hex_str_cast(int16_t v)   { to_hex(v, buf); }
+    hex_str_cast(int32_t v)   { to_hex(v, buf); }
+    hex_str_cast(int64_t v)   { to_hex(v, buf); }
+    hex_str_cast(uint8_t v)   { to_hex(v, buf); }
+    hex_str_cast(uint16_t v)  { to_hex(v, buf); }
+    hex_str_cast(uint32_t v)  { to_hex(v, buf); }
+    hex_str_cast(uint64_t v)  { to_hex(v, buf); }
     operator const char_t * () { return buf; }
 
   private:
-    char_t    buf[sizeof(uint64) * 2 + sizeof("0x")];
+    char_t    buf[sizeof(uint64_t) * 2 + sizeof("0x")];
 };//struct hex_str_cast
 
 
@@ -86,14 +96,14 @@ char_t * to_dec(int_t v, char_t * const p)
 template<typename char_t = char>
 struct str_cast
 {
-    str_cast(int8 v)    { to_dec(v, buf); }
-    str_cast(int16 v)   { to_dec(v, buf); }
-    str_cast(int32 v)   { to_dec(v, buf); }
-    str_cast(int64 v)   { to_dec(v, buf); }
-    str_cast(uint8 v)   { to_dec(v, buf); }
-    str_cast(uint16 v)  { to_dec(v, buf); }
-    str_cast(uint32 v)  { to_dec(v, buf); }
-    str_cast(uint64 v)  { to_dec(v, buf); }
+    str_cast(int8_t v)    { to_dec(v, buf); }
+    str_cast(int16_t v)   { to_dec(v, buf); }
+    str_cast(int32_t v)   { to_dec(v, buf); }
+    str_cast(int64_t v)   { to_dec(v, buf); }
+    str_cast(uint8_t v)   { to_dec(v, buf); }
+    str_cast(uint16_t v)  { to_dec(v, buf); }
+    str_cast(uint32_t v)  { to_dec(v, buf); }
+    str_cast(uint64_t v)  { to_dec(v, buf); }
     operator const char_t * () { return buf; }
 
   private:
@@ -101,6 +111,564 @@ struct str_cast
 };//struct str_cast
 
 
+/**\defgroup format_args ********** {}-style formatting **********************
+ *
+ *  format(buf, "status {} at {:p}, name `{}'", st, irp, name) writes into the
+ *  caller's buffer and returns the length the full result needs (as snprintf).
+ *  The result is always truncated to fit and null-terminated.
+ *
+ *  Nothing is allocated, no locale, no floating point and no exceptions are used,
+ *  so it is safe at any IRQL the buffer and the arguments are accessible at.
+ *
+ *  Replacement field: \c {[:[<|>][#][0][width][type]]}, \c {{ and \c }} are literal braces.
+ *  Types: \c d \c x \c X \c o \c b for integers, \c c for characters, \c p for pointers,
+ *  \c s for strings. Pointers and NTSTATUS values default to zero-padded \c 0xHHHHHHHH.
+ *  Fields without an argument are copied verbatim.
+ *
+ *  The argument types are checked at compile time: only the types arg is constructible of
+ *  are accepted (a double is rejected, for example). With constexpr-capable compilers
+ *  NTL_FORMAT also checks the number of fields against the number of arguments and
+ *  compiles the literal format string into a table of the literal runs and the parsed
+ *  fields, which vformat walks without parsing. The other compilers and the format
+ *  strings which are not literals use the run-time parser.
+ *@{*/
+
+/// Type-erased formatting argument, constructed implicitly from the supported types
+class arg
+{
+  public:
+    enum kind_type { none, boolean, narrow_char, wide_char, signed_int, unsigned_int, pointer, narrow_string, wide_string, status };
+
+    struct string_ref
+    {
+      const void* ptr;
+      size_t      len;  ///< in characters, size_t(-1) for the null-terminated strings
+    };
+
+    arg() : kind(none) {}
+
+    arg(bool v)               : kind(boolean)       { value.u = v; }
+    arg(char v)               : kind(narrow_char)   { value.u = static_cast<unsigned char>(v); }
+    arg(wchar_t v)            : kind(wide_char)     { value.u = v; }
+    arg(signed char v)        : kind(signed_int)    { value.i = v; }
+    arg(short v)              : kind(signed_int)    { value.i = v; }
+    arg(int v)                : kind(signed_int)    { value.i = v; }
+    arg(long v)               : kind(signed_int)    { value.i = v; }
+    arg(long long v)          : kind(signed_int)    { value.i = v; }
+    arg(unsigned char v)      : kind(unsigned_int)  { value.u = v; }
+    arg(unsigned short v)     : kind(unsigned_int)  { value.u = v; }
+    arg(unsigned int v)       : kind(unsigned_int)  { value.u = v; }
+    arg(unsigned long v)      : kind(unsigned_int)  { value.u = v; }
+    arg(unsigned long long v) : kind(unsigned_int)  { value.u = v; }
+    arg(const void* v)        : kind(pointer)       { value.u = reinterpret_cast<uintptr_t>(v); }
+    arg(nt::ntstatus v)       : kind(status)        { value.u = static_cast<uint32_t>(v); }
+
+    arg(const char* v)        : kind(narrow_string) { value.str.ptr = v; value.str.len = static_cast<size_t>(-1); }
+    arg(const wchar_t* v)     : kind(wide_string)   { value.str.ptr = v; value.str.len = static_cast<size_t>(-1); }
+    arg(const nt::const_unicode_string& v) : kind(wide_string) { value.str.ptr = v.data(); value.str.len = v.size(); }
+    arg(const nt::unicode_string& v)       : kind(wide_string) { value.str.ptr = v.data(); value.str.len = v.size(); }
+
+    kind_type kind;
+    union
+    {
+      long long           i;
+      unsigned long long  u;
+      string_ref          str;
+    } value;
+
+  private:
+    // floating point is not available at raised IRQL
+    arg(float) __deleted;
+    arg(double) __deleted;
+    arg(long double) __deleted;
+};
+
+namespace detail
+{
+  /// Truncating output to the caller's buffer which counts the required length
+  template<typename charT>
+  struct writer
+  {
+    writer(charT* buf, size_t size)
+    : p(buf), last(size ? buf + size - 1 : buf), required(0), has_room(size != 0)
+    {}
+
+    void put(char c)
+    {
+      if(p < last)
+        *p++ = static_cast<charT>(static_cast<unsigned char>(c));
+      ++required;
+    }
+
+    void put(wchar_t c)
+    {
+      if(p < last)
+        *p++ = sizeof(charT) == 1 && static_cast<unsigned>(c) > 0x7F ? static_cast<charT>('?') : static_cast<charT>(c);
+      ++required;
+    }
+
+    template<typename srcT>
+    void put(const srcT* s, size_t n)
+    {
+      while(n--)
+        put(*s++);
+    }
+
+    void fill(char c, size_t n)
+    {
+      while(n--)
+        put(c);
+    }
+
+    size_t finish()
+    {
+      if(has_room)
+        *p = 0;
+      return required;
+    }
+
+    charT*        p;
+    charT* const  last;
+    size_t        required;
+    const bool    has_room;
+  };
+
+  struct spec
+  {
+    unsigned  width;
+    char      align;
+    char      type;
+    bool      zero;
+    bool      alt;
+  };
+
+  /// Parses the replacement field after `{', returns the position of the closing `}' or null if malformed
+  template<typename charT>
+  inline const charT* parse_spec(const charT* f, spec& s)
+  {
+    s.width = 0, s.align = 0, s.type = 0, s.zero = s.alt = false;
+    if(*f == '}')
+      return f;
+    if(*f++ != ':')
+      return 0;
+    if(*f == '<' || *f == '>')
+      s.align = static_cast<char>(*f++);
+    if(*f == '#')
+      s.alt = true, ++f;
+    if(*f == '0')
+      s.zero = true, ++f;
+    while(*f >= '0' && *f <= '9')
+      s.width = s.width * 10 + static_cast<unsigned>(*f++ - '0');
+    switch(*f){
+    case 'd': case 'x': case 'X': case 'o': case 'b': case 'c': case 'p': case 's':
+      s.type = static_cast<char>(*f++);
+      break;
+    }
+    return *f == '}' ? f : 0;
+  }
+
+  template<typename charT>
+  inline void format_integer(writer<charT>& w, const spec& s, unsigned long long u, bool negative, char type, unsigned min_digits, bool prefix)
+  {
+    int base = 10;
+    switch(type){
+    case 'x': case 'X': base = 16; break;
+    case 'o': base = 8; break;
+    case 'b': base = 2; break;
+    }
+    char digits[64];
+    const size_t n = static_cast<size_t>(numeric::to_chars(digits, digits + _countof(digits), u, base).ptr - digits);
+    if(type == 'X')
+      for(size_t i = 0; i < n; i++)
+        if(digits[i] >= 'a') digits[i] -= 'a' - 'A';
+
+    char head[3];
+    size_t hn = 0;
+    if(negative)
+      head[hn++] = '-';
+    if(prefix && base != 10){
+      head[hn++] = '0';
+      if(base != 8)
+        head[hn++] = base == 16 ? 'x' : 'b';
+    }
+
+    size_t zeros = n < min_digits ? min_digits - n : 0;
+    if(s.zero && s.width > hn + zeros + n)
+      zeros = s.width - hn - n;
+    const size_t total = hn + zeros + n;
+    const size_t pad = s.width > total ? s.width - total : 0;
+    if(s.align != '<')
+      w.fill(' ', pad);
+    w.put(head, hn);
+    w.fill('0', zeros);
+    w.put(digits, n);
+    if(s.align == '<')
+      w.fill(' ', pad);
+  }
+
+  template<typename charT, typename srcT>
+  inline void format_string(writer<charT>& w, const spec& s, const srcT* str, size_t len)
+  {
+    if(!str){
+      format_string(w, s, "(null)", 6);
+      return;
+    }
+    if(len == static_cast<size_t>(-1))
+      for(len = 0; str[len]; len++);
+    const size_t pad = s.width > len ? s.width - len : 0;
+    if(s.align == '>')
+      w.fill(' ', pad);
+    w.put(str, len);
+    if(s.align != '>')
+      w.fill(' ', pad);
+  }
+
+  template<typename charT>
+  inline void format_arg(writer<charT>& w, const arg& a, const spec& s)
+  {
+    const arg::kind_type kind = a.kind;
+    const char type = s.type;
+    const bool as_integer = type && type != 'c' && type != 's' && type != 'p';
+
+    if((kind == arg::boolean || kind == arg::narrow_char || kind == arg::wide_char) && !as_integer){
+      if(kind == arg::boolean)
+        format_string(w, s, a.value.u ? "true" : "false", a.value.u ? 4 : 5);
+      else if(kind == arg::narrow_char){
+        const char c = static_cast<char>(a.value.u);
+        format_string(w, s, &c, 1);
+      }else{
+        const wchar_t c = static_cast<wchar_t>(a.value.u);
+        format_string(w, s, &c, 1);
+      }
+      return;
+    }
+
+    switch(kind){
+    case arg::narrow_string:
+      format_string(w, s, static_cast<const char*>(a.value.str.ptr), a.value.str.len);
+      break;
+    case arg::wide_string:
+      format_string(w, s, static_cast<const wchar_t*>(a.value.str.ptr), a.value.str.len);
+      break;
+    case arg::pointer:
+    case arg::status:
+      if(!as_integer){
+        format_integer(w, s, a.value.u, false, 'X', kind == arg::pointer ? sizeof(void*) * 2 : 8, true);
+        break;
+      }
+      if(kind == arg::pointer || type != 'd'){
+        format_integer(w, s, a.value.u, false, type, 0, s.alt);
+        break;
+      }
+      // NTSTATUS is signed
+      {
+      const int32_t v = static_cast<int32_t>(a.value.u);
+      format_integer(w, s, v < 0 ? 0 - static_cast<unsigned long long>(v) : v, v < 0, type, 0, s.alt);
+      }
+      break;
+    case arg::signed_int:
+      {
+      const bool negative = a.value.i < 0;
+      const unsigned long long u = negative ? 0 - a.value.u : a.value.u;
+      format_integer(w, s, u, negative, type, 0, s.alt);
+      }
+      break;
+    default:
+      format_integer(w, s, a.value.u, false, type, 0, s.alt);
+      break;
+    }
+  }
+
+} // detail
+
+/// Formats \p count arguments by the \p f format to the \p buf of \p size characters
+/// \return the number of characters (excluding the terminating null) the complete output requires
+template<typename charT>
+inline size_t vformat(charT* buf, size_t size, const charT* f, const arg* args, unsigned count)
+{
+  detail::writer<charT> w(buf, size);
+  unsigned next = 0;
+  for(const charT* p = f; *p; ++p){
+    const charT c = *p;
+    if(c == '{' || c == '}'){
+      if(p[1] == c){
+        w.put(c);
+        ++p;
+        continue;
+      }
+      detail::spec s;
+      const charT* e;
+      if(c == '{' && next < count && (e = detail::parse_spec(p + 1, s)) != 0){
+        detail::format_arg(w, args[next++], s);
+        p = e;
+        continue;
+      }
+    }
+    w.put(c);
+  }
+  return w.finish();
+}
+
+template<typename charT>
+inline size_t format(charT* buf, size_t size, const charT* f)
+{
+  return vformat(buf, size, f, static_cast<const arg*>(0), 0);
+}
+
+template<typename charT, size_t Size>
+inline size_t format(charT (&buf)[Size], const charT* f)
+{
+  return vformat(buf, Size, f, static_cast<const arg*>(0), 0);
+}
+
+#define NTL_X(n,aux) \
+  template<typename charT> \
+  inline size_t format(charT* buf, size_t size, const charT* f, NTL_SPP_ARGS(1,n,const arg& a)) \
+  { \
+    const arg args[] = { NTL_SPP_ARGS(1,n,a) }; \
+    return vformat(buf, size, f, args, n); \
+  } \
+  template<typename charT, size_t Size> \
+  inline size_t format(charT (&buf)[Size], const charT* f, NTL_SPP_ARGS(1,n,const arg& a)) \
+  { \
+    const arg args[] = { NTL_SPP_ARGS(1,n,a) }; \
+    return vformat(buf, Size, f, args, n); \
+  }
+
+NTL_X(1,)
+NTL_X(2,)
+NTL_X(3,)
+NTL_X(4,)
+NTL_X(5,)
+#undef NTL_X
+
+#if defined(NTL__CXX_CONSTEXPR) && defined(NTL__CXX_VT) && defined(NTL__CXX_ASSERT) && defined(NTL__CXX_LAMBDA)
+
+namespace detail
+{
+  template<typename charT>
+  constexpr int placeholder_end(const charT* f, int n);
+}
+
+/// Number of the replacement fields, or -1 if the format has an unbalanced brace
+template<typename charT>
+constexpr int placeholders(const charT* f, int n = 0)
+{
+  return *f == 0 ? n
+    : (f[0] == '{' && f[1] == '{') || (f[0] == '}' && f[1] == '}') ? placeholders(f + 2, n)
+    : f[0] == '}' ? -1
+    : f[0] == '{' ? detail::placeholder_end(f + 1, n)
+    : placeholders(f + 1, n);
+}
+
+namespace detail
+{
+  template<typename charT>
+  constexpr int placeholder_end(const charT* f, int n)
+  {
+    return *f == 0 || *f == '{' ? -1
+      : *f == '}' ? placeholders(f + 1, n + 1)
+      : placeholder_end(f + 1, n);
+  }
+}
+
+/// A literal run or a replacement field of the format string compiled by NTL_FORMAT
+struct segment
+{
+  unsigned      begin;  ///< offset of the literal run in the format string
+  unsigned      length; ///< length of the literal run, 0 for a field
+  detail::spec  spec;
+};
+
+/// The format string split into the literal runs and the parsed fields at compile time
+template<typename charT, unsigned N>
+struct compiled_format
+{
+  const charT*  f;
+  segment       segments[N ? N : 1];
+};
+
+namespace detail
+{
+  template<typename charT>
+  constexpr unsigned skip_if(const charT* f, unsigned p, char c)
+  {
+    return f[p] == c ? p + 1 : p;
+  }
+
+  template<typename charT>
+  constexpr unsigned skip_digits(const charT* f, unsigned p)
+  {
+    return f[p] >= '0' && f[p] <= '9' ? skip_digits(f, p + 1) : p;
+  }
+
+  template<typename charT>
+  constexpr unsigned number(const charT* f, unsigned p, unsigned last, unsigned n = 0)
+  {
+    return p == last ? n : number(f, p + 1, last, n * 10 + static_cast<unsigned>(f[p] - '0'));
+  }
+
+  // the positions of the spec parts `[<|>][#][0][width][type]}' which starts at p
+  template<typename charT>
+  constexpr unsigned alt_at(const charT* f, unsigned p)
+  {
+    return f[p] == '<' || f[p] == '>' ? p + 1 : p;
+  }
+
+  template<typename charT>
+  constexpr unsigned zero_at(const charT* f, unsigned p)
+  {
+    return skip_if(f, alt_at(f, p), '#');
+  }
+
+  template<typename charT>
+  constexpr unsigned width_at(const charT* f, unsigned p)
+  {
+    return skip_if(f, zero_at(f, p), '0');
+  }
+
+  template<typename charT>
+  constexpr unsigned type_at(const charT* f, unsigned p)
+  {
+    return skip_digits(f, width_at(f, p));
+  }
+
+  template<typename charT>
+  constexpr bool is_type(charT c)
+  {
+    return c == 'd' || c == 'x' || c == 'X' || c == 'o' || c == 'b' || c == 'c' || c == 'p' || c == 's';
+  }
+
+  template<typename charT>
+  constexpr unsigned close_at(const charT* f, unsigned p)
+  {
+    return is_type(f[type_at(f, p)]) ? type_at(f, p) + 1 : type_at(f, p);
+  }
+
+  /// Position of `}' of the field which starts at `{' at b, or 0 if the field is malformed (as parse_spec)
+  template<typename charT>
+  constexpr unsigned field_end(const charT* f, unsigned b)
+  {
+    return f[b + 1] == '}' ? b + 1
+      : f[b + 1] != ':' ? 0
+      : f[close_at(f, b + 2)] == '}' ? close_at(f, b + 2) : 0;
+  }
+
+  template<typename charT>
+  constexpr spec field_spec(const charT* f, unsigned p)
+  {
+    return spec{ number(f, width_at(f, p), type_at(f, p)),
+      alt_at(f, p) != p ? static_cast<char>(f[p]) : '\0',
+      close_at(f, p) != type_at(f, p) ? static_cast<char>(f[type_at(f, p)]) : '\0',
+      width_at(f, p) != zero_at(f, p),
+      zero_at(f, p) != alt_at(f, p) };
+  }
+
+  template<typename charT>
+  constexpr unsigned literal_end(const charT* f, unsigned p)
+  {
+    return f[p] == 0 || f[p] == '{' || f[p] == '}' ? p : literal_end(f, p + 1);
+  }
+
+  template<typename charT>
+  constexpr unsigned string_end(const charT* f, unsigned p)
+  {
+    return f[p] == 0 ? p : string_end(f, p + 1);
+  }
+
+  /// Position after the literal run, the escaped brace or the field at p; a malformed field ends the string
+  template<typename charT>
+  constexpr unsigned segment_next(const charT* f, unsigned p)
+  {
+    return (f[p] == '{' || f[p] == '}') && f[p + 1] == f[p] ? p + 2
+      : f[p] == '}' ? p + 1
+      : f[p] == '{' ? (field_end(f, p) ? field_end(f, p) + 1 : string_end(f, p))
+      : literal_end(f, p);
+  }
+
+  template<typename charT>
+  constexpr unsigned segment_count(const charT* f, unsigned p = 0, unsigned n = 0)
+  {
+    return f[p] == 0 ? n : segment_count(f, segment_next(f, p), n + 1);
+  }
+
+  /// Checks that all the fields are well-formed
+  template<typename charT>
+  constexpr bool fields_valid(const charT* f, unsigned p = 0)
+  {
+    return f[p] == 0 ? true
+      : f[p] == '{' && f[p + 1] != '{' && !field_end(f, p) ? false
+      : fields_valid(f, segment_next(f, p));
+  }
+
+  template<typename charT>
+  constexpr unsigned segment_start(const charT* f, unsigned i, unsigned p = 0)
+  {
+    return i == 0 ? p : segment_start(f, i - 1, segment_next(f, p));
+  }
+
+  template<typename charT>
+  constexpr segment make_segment(const charT* f, unsigned p)
+  {
+    return f[p] == '{' && f[p + 1] != '{'
+      ? segment{ p, 0, field_spec(f, p + 2) }
+      : segment{ p, f[p] == '{' || f[p] == '}' ? 1 : literal_end(f, p) - p, spec{ 0, '\0', '\0', false, false } };
+  }
+
+  template<unsigned... I> struct indices {};
+  template<unsigned N, unsigned... I> struct make_indices: make_indices<N - 1, N - 1, I...> {};
+  template<unsigned... I> struct make_indices<0, I...> { typedef indices<I...> type; };
+
+  template<unsigned N, typename charT, unsigned... I>
+  constexpr compiled_format<charT, N> compile(const charT* f, indices<I...>)
+  {
+    return compiled_format<charT, N>{ f, { make_segment(f, segment_start(f, I))... } };
+  }
+}
+
+/// Splits the literal format string \p f of \p N segments (detail::segment_count) at compile time
+template<unsigned N, typename charT>
+constexpr compiled_format<charT, N> compile(const charT* f)
+{
+  return detail::compile<N>(f, typename detail::make_indices<N>::type());
+}
+
+/// Formats the arguments by the compiled format \p f to the \p buf of \p size characters, the fields are not parsed
+template<typename charT, unsigned N>
+inline size_t vformat(charT* buf, size_t size, const compiled_format<charT, N>& f, const arg* args)
+{
+  detail::writer<charT> w(buf, size);
+  for(unsigned i = 0; i != N; ++i){
+    const segment& s = f.segments[i];
+    if(s.length)
+      w.put(f.f + s.begin, s.length);
+    else
+      detail::format_arg(w, *args++, s.spec);
+  }
+  return w.finish();
+}
+
+template<int Fields, bool Valid, typename charT, unsigned N, size_t Size, typename... Args>
+inline size_t format_checked(charT (&buf)[Size], const compiled_format<charT, N>& f, const Args&... args)
+{
+  static_assert(Fields >= 0, "unbalanced braces in the format string");
+  static_assert(Valid, "malformed replacement field in the format string");
+  static_assert(Fields == sizeof...(Args), "the number of format fields doesn't match the number of arguments");
+  const arg a[sizeof...(Args) + 1] = { args... };
+  return vformat(buf, Size, f, a);
+}
+
+/// Formats to the array \p buf with the format string literal checked and compiled at compile time
+#define NTL_FORMAT(buf, f, ...) \
+  ntl::fmt::format_checked<ntl::fmt::placeholders(f), ntl::fmt::detail::fields_valid(f)>(buf, \
+    []() -> const decltype(ntl::fmt::compile<ntl::fmt::detail::segment_count(f)>(f))& { \
+      static constexpr auto compiled = ntl::fmt::compile<ntl::fmt::detail::segment_count(f)>(f); \
+      return compiled; }(), ##__VA_ARGS__)
+
+#endif
+
+/**@} format_args */
+
 }//namespace fmt
 
 namespace format = fmt;
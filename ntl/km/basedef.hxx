@@ -106,6 +106,9 @@ NTL__EXTERNVAR volatile int8_t KeNumberProcessors;
 NTL__EXTERNAPI
 void* __stdcall MmGetSystemRoutineAddress(const const_unicode_string& SystemRoutineName);
 
+NTL__EXTERNAPI
+bool __stdcall MmIsNonPagedSystemAddressValid(const void* VirtualAddress);
+
 /// interrupt request level
 typedef uint8_t kirql_t;
 
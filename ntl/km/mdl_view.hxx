@@ -0,0 +1,386 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  MDL chain views and scatter/gather algorithms
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__KM_MDL_VIEW
+#define NTL__KM_MDL_VIEW
+#pragma once
+
+#include "basedef.hxx"
+#include "mm.hxx"
+#include "../span.hxx"
+#include "../stlx/cstring.hxx"
+
+
+namespace ntl {
+namespace km {
+
+
+/**
+ *	Range of the memory described by the MDL chain, optionally a window of it.
+ *
+ *  The view iterates over the chunks of the chain as the span<uint8_t> of the system addresses, one per MDL,
+ *  and its algorithms work across the chunk boundaries, so the data need not be copied into a contiguous buffer.
+ *  The bytes_begin() and bytes_end() iterators make the whole view a sequence of bytes for the generic algorithms.
+ *
+ *  The MDLs should be locked, the unmapped ones are mapped to the system space on the first access.
+ *  The mapping fails when the system is out of the PTEs, the chunk of such MDL is empty then:
+ *  copy_to() and copy_from() stop at it, contiguous() returns null and find() returns npos.
+ *  map() maps the whole view up front and tells whether it succeeded.
+ **/
+class mdl_view
+{
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef span<uint8_t> chunk_type;
+    typedef size_t        size_type;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    /// Forward iterator over the chunks
+    class const_iterator:
+      public std::iterator<std::forward_iterator_tag, chunk_type, ptrdiff_t, const chunk_type*, chunk_type>
+    {
+      public:
+        const_iterator()
+        : m(0), skip(0), left(0)
+        {/**/}
+
+        /** The chunk, empty if the MDL can't be mapped */
+        chunk_type operator*() const
+        {
+          uint8_t * const p = static_cast<uint8_t*>(m->system_address_safe(NormalPagePriority));
+          return p ? chunk_type(p + skip, length()) : chunk_type();
+        }
+
+        const_iterator & operator++()
+        {
+          left -= length();
+          skip = 0;
+          m = left ? next(m->next()) : 0;
+          return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+          const_iterator tmp(*this);
+          ++*this;
+          return tmp;
+        }
+
+        /** The MDL of the chunk */
+        const mdl * get() const { return m; }
+
+        friend bool operator==(const const_iterator & x, const const_iterator & y) { return x.m == y.m; }
+        friend bool operator!=(const const_iterator & x, const const_iterator & y) { return x.m != y.m; }
+
+      private:
+        friend class mdl_view;
+
+        const_iterator(const mdl * m, uint32_t skip, size_type left)
+        : m(m), skip(skip), left(left)
+        {/**/}
+
+        uint32_t length() const
+        {
+          const uint32_t n = m->byte_count() - skip;
+          return left < n ? static_cast<uint32_t>(left) : n;
+        }
+
+        // skips the empty MDLs
+        static const mdl * next(const mdl * m)
+        {
+          while ( m && !m->byte_count() )
+            m = m->next();
+          return m;
+        }
+
+        const mdl * m;
+        uint32_t    skip;
+        size_type   left;   // bytes from the chunk start to the end of the view
+    };
+
+    /// Forward iterator over the bytes
+    class byte_iterator:
+      public std::iterator<std::forward_iterator_tag, uint8_t>
+    {
+      public:
+        byte_iterator()
+        : p(0), last(0)
+        {/**/}
+
+        uint8_t & operator*() const { return *p; }
+
+        byte_iterator & operator++()
+        {
+          if ( ++p == last )
+            load(++chunk);
+          return *this;
+        }
+
+        byte_iterator operator++(int)
+        {
+          byte_iterator tmp(*this);
+          ++*this;
+          return tmp;
+        }
+
+        friend bool operator==(const byte_iterator & x, const byte_iterator & y) { return x.p == y.p; }
+        friend bool operator!=(const byte_iterator & x, const byte_iterator & y) { return x.p != y.p; }
+
+      private:
+        friend class mdl_view;
+
+        explicit byte_iterator(const const_iterator & it)
+        : chunk(it)
+        {
+          load(it);
+        }
+
+        void load(const const_iterator & it)
+        {
+          if ( it == const_iterator() )
+            p = last = 0;
+          else
+          {
+            const chunk_type c = *it;
+            p = c.begin(), last = c.end();
+          }
+        }
+
+        const_iterator  chunk;
+        uint8_t *       p;
+        uint8_t *       last;
+    };
+
+    mdl_view()
+    : chain(0), offset(0), length(0)
+    {/**/}
+
+    /** The whole chain */
+    explicit mdl_view(const mdl * chain)
+    : chain(chain), offset(0), length(chain ? chain->total_bytes() : 0)
+    {/**/}
+
+    /** The window of \a length bytes at the \a offset of the chain */
+    mdl_view(const mdl * chain, size_type offset, size_type length)
+    : chain(chain), offset(0), length(0)
+    {
+      const size_type total = chain ? chain->total_bytes() : 0;
+      this->offset = offset < total ? offset : total;
+      this->length = length < total - this->offset ? length : total - this->offset;
+    }
+
+    ///\name iterators
+    const_iterator begin() const
+    {
+      if ( !length )
+        return end();
+      const mdl * m = chain;
+      size_type skip = offset;
+      while ( skip >= m->byte_count() )
+        skip -= m->byte_count(), m = m->next();
+      return const_iterator(m, static_cast<uint32_t>(skip), length);
+    }
+
+    const_iterator end() const { return const_iterator(); }
+
+    byte_iterator bytes_begin() const { return byte_iterator(begin()); }
+    byte_iterator bytes_end() const { return byte_iterator(); }
+
+    ///\name observers
+    size_type size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    const mdl * get() const { return chain; }
+
+    /** Maps the MDLs of the view to the system space, false if any of them can't be mapped */
+    bool map() const
+    {
+      for ( const_iterator it = begin(); it != end(); ++it )
+        if ( (*it).empty() )
+          return false;
+      return true;
+    }
+
+    /** The window of this view */
+    mdl_view subview(size_type pos, size_type count = npos) const
+    {
+      pos = pos < length ? pos : length;
+      return mdl_view(chain, offset + pos, count < length - pos ? count : length - pos);
+    }
+
+    ///\name algorithms
+    /** Calls \a f for each chunk */
+    template<class F>
+    F for_each(F f) const
+    {
+      for ( const_iterator it = begin(); it != end(); ++it )
+        f(*it);
+      return f;
+    }
+
+    /** Copies up to \a n bytes from the view starting at \a pos, returns the number of bytes copied, less if a chunk can't be mapped */
+    size_type copy_to(void * dest, size_type n, size_type pos = 0) const
+    {
+      uint8_t * to = static_cast<uint8_t*>(dest);
+      const mdl_view v = subview(pos, n);
+      for ( const_iterator it = v.begin(); it != v.end(); ++it )
+      {
+        const chunk_type c = *it;
+        if ( c.empty() )
+          break;
+        std::memcpy(to, c.data(), c.size());
+        to += c.size();
+      }
+      return static_cast<size_type>(to - static_cast<uint8_t*>(dest));
+    }
+
+    /** Copies up to \a n bytes into the view starting at \a pos, returns the number of bytes copied, less if a chunk can't be mapped */
+    size_type copy_from(const void * src, size_type n, size_type pos = 0) const
+    {
+      const uint8_t * from = static_cast<const uint8_t*>(src);
+      const mdl_view v = subview(pos, n);
+      for ( const_iterator it = v.begin(); it != v.end(); ++it )
+      {
+        const chunk_type c = *it;
+        if ( c.empty() )
+          break;
+        std::memcpy(c.data(), from, c.size());
+        from += c.size();
+      }
+      return static_cast<size_type>(from - static_cast<const uint8_t*>(src));
+    }
+
+    /** Copies the \a n bytes at \a pos into the \a buf if they span several chunks, returns the pointer to them */
+    const uint8_t * contiguous(void * buf, size_type n, size_type pos = 0) const
+    {
+      if ( pos > length || n > length - pos )
+        return 0;
+      const mdl_view v = subview(pos, n);
+      const const_iterator it = v.begin();
+      if ( it != v.end() && (*it).size() == n )
+        return (*it).data();
+      return v.copy_to(buf, n) == n ? static_cast<const uint8_t*>(buf) : 0;
+    }
+
+    /** Position of the first occurrence of the \a n bytes of the \a pattern at or after \a pos, or npos */
+    size_type find(const void * pattern, size_type n, size_type pos = 0) const
+    {
+      if ( pos > length || n > length - pos )
+        return npos;
+      if ( !n )
+        return pos;
+      const uint8_t * const what = static_cast<const uint8_t*>(pattern);
+      const mdl_view v = subview(pos);
+      size_type base = pos;
+      for ( const_iterator it = v.begin(); it != v.end(); ++it )
+      {
+        const chunk_type c = *it;
+        if ( c.empty() )
+          return npos;
+        for ( const uint8_t * p = c.begin(); p != c.end(); ++p )
+        {
+          p = static_cast<const uint8_t*>(std::memchr(p, what[0], c.end() - p));
+          if ( !p )
+            break;
+          if ( matches(it, p, what, n) )
+            return base + (p - c.begin());
+        }
+        base += c.size();
+      }
+      return npos;
+    }
+
+    /**
+     *	The Internet checksum (RFC 1071) of the view: the one's complement of the one's complement sum of the 16-bit words.
+     *  The result is in the byte order of the data, so it is stored as is.
+     *  \a initial is the partial sum of the preceding data, e.g. the pseudo header.
+     *  The view should be mapped by map() first, the chunks which can't be mapped are not summed.
+     **/
+    uint16_t internet_checksum(uint32_t initial = 0) const
+    {
+      uint64_t sum = initial;
+      bool odd = false;
+      for ( const_iterator it = begin(); it != end(); ++it )
+      {
+        const chunk_type c = *it;
+        uint32_t part = fold(partial_sum(c.data(), c.size()));
+        // the chunk starting at an odd offset has its bytes swapped within the words
+        if ( odd )
+          part = ((part & 0xFF) << 8) | (part >> 8);
+        sum += part;
+        odd ^= (c.size() & 1) != 0;
+      }
+      return static_cast<uint16_t>(~fold(sum));
+    }
+    ///\}
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    static bool matches(const_iterator it, const uint8_t * p, const uint8_t * what, size_type n)
+    {
+      for ( chunk_type c = *it; ; c = *it )
+      {
+        if ( c.empty() )
+          return false;
+        const size_type tail = static_cast<size_type>(c.end() - p), k = tail < n ? tail : n;
+        if ( std::memcmp(p, what, k) != 0 )
+          return false;
+        if ( (n -= k) == 0 )
+          return true;
+        what += k;
+        if ( ++it == const_iterator() )
+          return false;
+        p = (*it).begin();
+      }
+    }
+
+    static uint64_t partial_sum(const uint8_t * p, size_t n)
+    {
+      uint64_t sum = 0;
+      for ( ; n >= 4; n -= 4, p += 4 )
+      {
+        uint32_t w;
+        std::memcpy(&w, p, sizeof(w));
+        sum += w;
+      }
+      if ( n >= 2 )
+      {
+        uint16_t w;
+        std::memcpy(&w, p, sizeof(w));
+        sum += w;
+        n -= 2, p += 2;
+      }
+      // the odd byte is the first byte of the word
+      if ( n )
+      {
+        uint16_t w = 0;
+        std::memcpy(&w, p, 1);
+        sum += w;
+      }
+      return sum;
+    }
+
+    static uint32_t fold(uint64_t sum)
+    {
+      while ( sum >> 16 )
+        sum = (sum & 0xFFFF) + (sum >> 16);
+      return static_cast<uint32_t>(sum);
+    }
+
+    const mdl * chain;
+    size_type   offset;
+    size_type   length;
+};
+
+
+}//namspace km
+}//namespace ntl
+
+
+#endif//#ifndef NTL__KM_MDL_VIEW
@@ -90,6 +90,12 @@ namespace ntl {
       MmWriteCombined
     };
 
+    enum mm_page_priority {
+      LowPagePriority,
+      NormalPagePriority  = 16,
+      HighPagePriority    = 32
+    };
+
     static inline
       void * highest_user_address()
     {
@@ -197,6 +203,17 @@ namespace ntl {
         kprocessor_mode AccessMode
         );
 
+    NTL__EXTERNAPI
+      void * __stdcall
+      MmMapLockedPagesSpecifyCache(
+        const mdl *         MemoryDescriptorList,
+        kprocessor_mode     AccessMode,
+        memory_caching_type CacheType,
+        void *              RequestedAddress  __optional,
+        uint32_t            BugCheckOnFailure,
+        uint32_t            Priority
+        );
+
     NTL__EXTERNAPI
       void * __stdcall
       MmUnmapLockedPages(
@@ -306,6 +323,13 @@ namespace ntl {
           ? MappedSystemVa : map_locked_pages();
       }
 
+      /** The system address as MmGetSystemAddressForMdlSafe does, null if the system is out of the PTEs */
+      void * system_address_safe(mm_page_priority priority = NormalPagePriority) const
+      {
+        return mapped_to_system_va || source_is_nonpaged_pool
+          ? MappedSystemVa : MmMapLockedPagesSpecifyCache(this, KernelMode, MmCached, 0, false, priority);
+      }
+
       uint32_t byte_count() const
       {
         return ByteCount;
@@ -0,0 +1,413 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Per-processor data, sharded counters and histograms
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__KM_PERCPU
+#define NTL__KM_PERCPU
+#pragma once
+
+#include "basedef.hxx"
+#include "thread.hxx"
+#include "new.hxx"
+
+
+namespace ntl {
+namespace km {
+
+
+/**
+ *	Default percpu environment: the processors of the system and the IRQL.
+ *
+ *  The processors are numbered across all processor groups where the system has them (Windows 7 and later),
+ *  KeNumberProcessors and the PRCB number count the processors of the current group only.
+ *  The count is the maximum one, which includes the processors that may be added while the system runs.
+ **/
+struct percpu_api
+{
+  static unsigned processor_count()
+  {
+    const group_routines & g = groups();
+    return g.count ? g.count(all_processor_groups) : static_cast<unsigned>(KeNumberProcessors);
+  }
+
+  static unsigned current_processor()
+  {
+    const group_routines & g = groups();
+    return g.current ? g.current(0) : km::current_processor();
+  }
+
+  /** Keeps the thread on the current processor for the scope by raising the IRQL to DISPATCH_LEVEL */
+  class preemption_guard
+  {
+      preemption_guard(const preemption_guard&);
+      const preemption_guard& operator=(const preemption_guard&);
+
+    public:
+      preemption_guard()  { irql.raisetodpc(); }
+      ~preemption_guard() { irql.lower(); }
+
+    private:
+      kirql irql;
+  };
+
+  private:
+
+    struct processor_number
+    {
+      uint16_t  Group;
+      uint8_t   Number;
+      uint8_t   Reserved;
+    };
+
+    static const uint16_t all_processor_groups = 0xFFFF;
+
+    typedef uint32_t __stdcall query_maximum_processor_count_ex_t(uint16_t GroupNumber);
+    typedef uint32_t __stdcall get_current_processor_number_ex_t(processor_number * ProcNumber);
+
+    struct group_routines
+    {
+      query_maximum_processor_count_ex_t * count;
+      get_current_processor_number_ex_t *  current;
+      volatile bool                        resolved;
+    };
+
+    // resolved at the first use, a concurrent first use resolves the same addresses
+    static const group_routines & groups()
+    {
+      static group_routines g;
+      if ( !g.resolved )
+      {
+        const const_unicode_string count_name(L"KeQueryMaximumProcessorCountEx"), current_name(L"KeGetCurrentProcessorNumberEx");
+        get_current_processor_number_ex_t * const current =
+          reinterpret_cast<get_current_processor_number_ex_t*>(MmGetSystemRoutineAddress(current_name));
+        query_maximum_processor_count_ex_t * const count =
+          reinterpret_cast<query_maximum_processor_count_ex_t*>(MmGetSystemRoutineAddress(count_name));
+        // both or none
+        g.current = count ? current : 0;
+        g.count = current ? count : 0;
+        g.resolved = true;
+      }
+      return g;
+    }
+};
+
+
+/**
+ *	Instance of \a T for each processor, each in its own cache line.
+ *
+ *  The processor updates its instance with the plain instructions and no cache line is shared by the processors,
+ *  as long as the thread stays on the processor: it runs at DISPATCH_LEVEL or holds a preemption_guard.
+ *  The instances of the other processors are reached by the index, e.g. to sum them up.
+ **/
+template<class T, class Api = percpu_api>
+class percpu
+{
+    percpu(const percpu&);
+    const percpu& operator=(const percpu&);
+
+    alignas(SYSTEM_CACHE_ALIGNMENT_SIZE)
+    struct slot
+    {
+      T value;
+    };
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef T value_type;
+    typedef typename Api::preemption_guard preemption_guard;
+
+    percpu() __ntl_nothrow
+    : slots(0), raw(0), processors(0)
+    {/**/}
+
+    ~percpu() __ntl_nothrow
+    {
+      destroy();
+    }
+
+    /** Allocates and value-initializes the instances of the processors, including the ones which may be added later */
+    ntstatus initialize() __ntl_nothrow
+    {
+      destroy();
+      unsigned n = Api::processor_count();
+      if ( !n )
+        n = 1;
+      raw = new (nonpaged) char[n * sizeof(slot) + SYSTEM_CACHE_ALIGNMENT_SIZE];
+      if ( !raw )
+        return status::insufficient_resources;
+      slots = reinterpret_cast<slot*>(
+        (uintptr_t(raw) + SYSTEM_CACHE_ALIGNMENT_SIZE - 1) & ~uintptr_t(SYSTEM_CACHE_ALIGNMENT_SIZE - 1));
+      for ( unsigned i = 0; i < n; i++ )
+        new (&slots[i]) slot();
+      processors = n;
+      return status::success;
+    }
+
+    void destroy() __ntl_nothrow
+    {
+      for ( unsigned i = 0; i < processors; i++ )
+        slots[i].~slot();
+      delete[] raw;
+      raw = 0;
+      slots = 0;
+      processors = 0;
+    }
+
+    unsigned processor_count() const { return processors; }
+
+    /** The instance of the current processor, the caller keeps the thread on it */
+    T & local() { return slots[Api::current_processor() % processors].value; }
+
+    T & operator[](unsigned processor) { return slots[processor].value; }
+    const T & operator[](unsigned processor) const { return slots[processor].value; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    slot *    slots;
+    char *    raw;
+    unsigned  processors;
+};
+
+
+/**
+ *	Counter of the frequent events, e.g. the requests or the bytes transferred by a driver.
+ *
+ *  Each processor accumulates its updates in its own delta without interlocked instructions,
+ *  the delta which reaches the \c batch is folded into the total under a short lock.
+ *  approximate() reads the total only and misses less than \c batch per processor,
+ *  exact() adds up the deltas too and includes every update completed before it.
+ *
+ *  add() is usable at IRQL <= DISPATCH_LEVEL, add_local() at DISPATCH_LEVEL or under a preemption_guard.
+ **/
+template<class Api = percpu_api>
+class basic_sharded_counter
+{
+    basic_sharded_counter(const basic_sharded_counter&);
+    const basic_sharded_counter& operator=(const basic_sharded_counter&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef typename Api::preemption_guard preemption_guard;
+
+    explicit basic_sharded_counter(int32_t batch = 1024) __ntl_nothrow
+    : batch(batch), total(0), lock(0)
+    {/**/}
+
+    ntstatus initialize() __ntl_nothrow
+    {
+      return deltas.initialize();
+    }
+
+    void add(int64_t n) __ntl_nothrow
+    {
+      preemption_guard pin;
+      add_local(n);
+    }
+
+    void add_local(int64_t n) __ntl_nothrow
+    {
+      volatile int32_t & delta = deltas.local();
+      const int64_t v = delta + n;
+      if ( v < batch && v > -batch )
+      {
+        delta = static_cast<int32_t>(v);
+        return;
+      }
+      acquire();
+      // a single 64-bit write for approximate()
+      atomic::exchange_add(total, static_cast<uint64_t>(v));
+      delta = 0;
+      release();
+    }
+
+    void increment() __ntl_nothrow { add(1); }
+    void decrement() __ntl_nothrow { add(-1); }
+
+    /** The total without the recent updates of the processors, O(1) */
+    int64_t approximate() const __ntl_nothrow
+    {
+#ifdef _M_X64
+      return static_cast<int64_t>(total);
+#else
+      // a 64-bit read, the folds are 64-bit interlocked writes
+      return static_cast<int64_t>(atomic::compare_exchange(const_cast<volatile uint64_t&>(total), 0, 0));
+#endif
+    }
+
+    /** The total with the deltas of all processors, O(processors) */
+    int64_t exact() const __ntl_nothrow
+    {
+      // the folding processor may not be preempted by the reader holding the lock
+      preemption_guard pin;
+      acquire();
+      int64_t sum = static_cast<int64_t>(total);
+      for ( unsigned i = 0; i < deltas.processor_count(); i++ )
+        sum += deltas[i];
+      release();
+      return sum;
+    }
+
+    /** The difference of approximate() from exact() is less than this */
+    int64_t error_bound() const { return int64_t(batch) * deltas.processor_count(); }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    void acquire() const
+    {
+      for ( atomic::backoff b; atomic::compare_exchange(lock, 1u, 0u) != 0; )
+        b.pause();
+    }
+
+    void release() const
+    {
+      atomic::exchange(lock, 0u);
+    }
+
+    percpu<volatile int32_t, Api>   deltas;
+    const int32_t                   batch;
+    volatile uint64_t               total;
+    mutable volatile uint32_t       lock;
+};
+
+typedef basic_sharded_counter<> sharded_counter;
+
+
+/**
+ *	Distribution of the recorded values, e.g. the latencies of the requests in the performance counter ticks.
+ *
+ *  A value is counted in the bucket of its octave quarter, so the percentiles are within 25% of the actual values
+ *  over the whole 64-bit range. Each processor counts into its own buckets without interlocked instructions,
+ *  read() sums them up into a snapshot, which may miss the concurrent records only.
+ *  The buckets of a processor wrap around after 2^32 records of the same bucket.
+ *
+ *  record() is usable at IRQL <= DISPATCH_LEVEL, record_local() at DISPATCH_LEVEL or under a preemption_guard.
+ **/
+template<class Api = percpu_api>
+class basic_percpu_histogram
+{
+    basic_percpu_histogram(const basic_percpu_histogram&);
+    const basic_percpu_histogram& operator=(const basic_percpu_histogram&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef typename Api::preemption_guard preemption_guard;
+
+    /// the values 0 to 3 have their own buckets, each next octave is split into 4 buckets
+    static const unsigned sub_bits = 2;
+    static const unsigned buckets = (64 - sub_bits + 1) << sub_bits;
+
+    /// the sum of the buckets of all processors
+    struct snapshot
+    {
+      uint64_t count;
+      uint64_t bucket[buckets];
+
+      /** The upper bound of the values below which the \a permille of the recorded values are, e.g. 990 for p99 */
+      uint64_t percentile(unsigned permille) const
+      {
+        if ( !count )
+          return 0;
+        const uint64_t rank = (count * permille + 999) / 1000;
+        uint64_t seen = 0;
+        for ( unsigned b = 0; b < buckets; b++ )
+        {
+          seen += bucket[b];
+          if ( seen >= rank && seen )
+            return upper_bound(b);
+        }
+        return upper_bound(buckets - 1);
+      }
+    };
+
+    basic_percpu_histogram() __ntl_nothrow
+    {/**/}
+
+    ntstatus initialize() __ntl_nothrow
+    {
+      return shards.initialize();
+    }
+
+    void record(uint64_t value) __ntl_nothrow
+    {
+      preemption_guard pin;
+      record_local(value);
+    }
+
+    void record_local(uint64_t value) __ntl_nothrow
+    {
+      shards.local().bucket[bucket_of(value)]++;
+    }
+
+    void read(snapshot & s) const __ntl_nothrow
+    {
+      s.count = 0;
+      for ( unsigned b = 0; b < buckets; b++ )
+      {
+        uint64_t sum = 0;
+        for ( unsigned i = 0; i < shards.processor_count(); i++ )
+          sum += shards[i].bucket[b];
+        s.bucket[b] = sum;
+        s.count += sum;
+      }
+    }
+
+    static unsigned bucket_of(uint64_t value)
+    {
+      if ( value < (1u << sub_bits) )
+        return static_cast<unsigned>(value);
+      const unsigned msb = highest_bit(value);
+      return ((msb - sub_bits + 1) << sub_bits) + static_cast<unsigned>((value >> (msb - sub_bits)) & ((1u << sub_bits) - 1));
+    }
+
+    /** The smallest value of the bucket */
+    static uint64_t lower_bound(unsigned bucket)
+    {
+      if ( bucket < (1u << sub_bits) )
+        return bucket;
+      const unsigned msb = (bucket >> sub_bits) + sub_bits - 1;
+      return uint64_t((1u << sub_bits) | (bucket & ((1u << sub_bits) - 1))) << (msb - sub_bits);
+    }
+
+    /** The largest value of the bucket */
+    static uint64_t upper_bound(unsigned bucket)
+    {
+      return bucket + 1 < buckets ? lower_bound(bucket + 1) - 1 : ~uint64_t(0);
+    }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    struct counts
+    {
+      volatile uint32_t bucket[buckets];
+    };
+
+    static unsigned highest_bit(uint64_t x)
+    {
+      static const uint8_t debruijn[64] =
+      {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+      };
+      x |= x >> 1, x |= x >> 2, x |= x >> 4, x |= x >> 8, x |= x >> 16, x |= x >> 32;
+      return debruijn[((x ^ (x >> 1)) * 0x03F79D71B4CB0A89ULL) >> 58];
+    }
+
+    percpu<counts, Api> shards;
+};
+
+typedef basic_percpu_histogram<> percpu_histogram;
+
+}//namespace km
+}//namespace ntl
+
+#endif//#ifndef NTL__KM_PERCPU
@@ -0,0 +1,348 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Per-processor pool of the I/O request contexts
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__KM_REQUEST_POOL
+#define NTL__KM_REQUEST_POOL
+#pragma once
+
+#include "basedef.hxx"
+#include "irp.hxx"
+#include "thread.hxx"
+#include "lookaside_list.hxx"
+#include "new.hxx"
+
+
+namespace ntl {
+namespace km {
+
+
+/// Default request_pool environment: the system lookaside lists and processors
+struct request_pool_api
+{
+  template<class CellType>
+  struct lookaside
+  {
+    typedef npaged_lookaside_list<CellType> type;
+  };
+
+  static unsigned processor_count()
+  {
+    return static_cast<unsigned>(KeNumberProcessors);
+  }
+
+  static unsigned current_processor()
+  {
+    return km::current_processor();
+  }
+
+  static slist_entry * pop(slist_header & list, kspin_lock & lock)
+  {
+    return ExInterlockedPopEntrySList(&list, &lock);
+  }
+
+  static void push(slist_header & list, slist_entry * entry, kspin_lock & lock)
+  {
+    ExInterlockedPushEntrySList(&list, entry, &lock);
+  }
+};
+
+
+/// request_pool counters
+struct request_pool_stats
+{
+  /** Allocations served by the cache of the current processor */
+  uint32_t  hits;
+  /** Allocations served by the caches of the other processors */
+  uint32_t  steals;
+  /** Allocations served by the lookaside list */
+  uint32_t  misses;
+  /** Contexts returned to the pool */
+  uint32_t  frees;
+  /** Allocations failed */
+  uint32_t  failures;
+  /** Memory blocks owned by the pool now, cached and in use */
+  uint32_t  cells;
+  /** High-water mark of the \c cells, the reserve to preallocate to make every allocation a hit */
+  uint32_t  peak;
+
+  /** Contexts in use now, correct after the counters wrap around too */
+  uint32_t in_use() const { return hits + steals + misses - frees; }
+};
+
+
+/**
+ *	Pool of the request contexts with a cache per processor.
+ *
+ *  The contexts are taken from and returned to the cache of the current processor, which are the interlocked
+ *  lists filled by initialize() at the DriverEntry, so a request makes no pool allocations in the steady state.
+ *  A context may be freed on any processor, so when the cache is empty the context is taken from the cache of another
+ *  processor and then from the nonpaged lookaside list. A context freed into the full cache goes back to the lookaside list.
+ *
+ *  The counters allow to size the pool: the \c peak of the stats() is the reserve which makes every allocation a hit.
+ *
+ *  Usable at IRQL <= DISPATCH_LEVEL.
+ **/
+template<class Context, class Api = request_pool_api>
+class request_pool
+{
+    request_pool(const request_pool&);
+    const request_pool& operator=(const request_pool&);
+
+    union cell
+    {
+      slist_entry link;
+      char        storage[sizeof(Context)];
+      uint64_t    align;
+    };
+
+    typedef typename Api::template lookaside<cell>::type lookaside_type;
+
+    alignas(SYSTEM_CACHE_ALIGNMENT_SIZE)
+    struct processor_cache
+    {
+      slist_header      list;
+      kspin_lock        lock;
+      volatile uint32_t hits;
+      volatile uint32_t steals;
+      volatile uint32_t misses;
+      volatile uint32_t frees;
+    };
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef Context value_type;
+
+    class context_ptr;
+
+    request_pool() __ntl_nothrow
+    : caches(0), raw(0), processors(0), depth(0), cells(0), peak(0), failures(0)
+    {/**/}
+
+    ~request_pool() __ntl_nothrow
+    {
+      destroy();
+    }
+
+    /**
+     *	Creates the processor caches and fills each with \a reserve contexts.
+     *  A cache keeps up to \a max_depth free contexts, twice the reserve by default.
+     **/
+    ntstatus initialize(uint16_t reserve, uint16_t max_depth = 0) __ntl_nothrow
+    {
+      destroy();
+      processors = Api::processor_count();
+      if ( !processors )
+        processors = 1;
+      depth = max_depth ? max_depth : static_cast<uint16_t>(reserve * 2);
+      if ( depth < reserve )
+        depth = reserve;
+
+      raw = new (nonpaged) char[processors * sizeof(processor_cache) + SYSTEM_CACHE_ALIGNMENT_SIZE];
+      if ( !raw )
+        return status::insufficient_resources;
+      caches = reinterpret_cast<processor_cache*>(
+        (uintptr_t(raw) + SYSTEM_CACHE_ALIGNMENT_SIZE - 1) & ~uintptr_t(SYSTEM_CACHE_ALIGNMENT_SIZE - 1));
+      for ( unsigned i = 0; i < processors; i++ )
+        new (&caches[i]) processor_cache();
+
+      for ( unsigned i = 0; i < processors; i++ )
+        for ( uint16_t n = 0; n < reserve; n++ )
+        {
+          cell * c = lookaside.allocate();
+          if ( !c )
+            return status::insufficient_resources;
+          grow();
+          Api::push(caches[i].list, &c->link, caches[i].lock);
+        }
+      return status::success;
+    }
+
+    /** Returns the cached contexts to the lookaside list, the contexts in use must be freed before */
+    void destroy() __ntl_nothrow
+    {
+      if ( !caches )
+        return;
+      for ( unsigned i = 0; i < processors; i++ )
+        while ( slist_entry * e = Api::pop(caches[i].list, caches[i].lock) )
+        {
+          lookaside.free(e);
+          atomic::decrement(cells);
+        }
+      delete[] raw;
+      raw = 0;
+      caches = 0;
+    }
+
+    /** Constructs a context, returns null if out of memory */
+    Context * allocate() __ntl_nothrow
+    {
+      processor_cache & cache = current();
+      cell * c = reinterpret_cast<cell*>(Api::pop(cache.list, cache.lock));
+      if ( c )
+        atomic::increment(cache.hits);
+      else if ( (c = steal(cache)) != 0 )
+        atomic::increment(cache.steals);
+      else
+      {
+        c = lookaside.allocate();
+        if ( !c )
+        {
+          atomic::increment(failures);
+          return 0;
+        }
+        atomic::increment(cache.misses);
+        grow();
+      }
+      return new (c->storage) Context();
+    }
+
+    /** Destroys the context allocated by this pool */
+    void free(Context * p) __ntl_nothrow
+    {
+      if ( !p )
+        return;
+      p->~Context();
+      cell * c = reinterpret_cast<cell*>(p);
+      processor_cache & cache = current();
+      atomic::increment(cache.frees);
+      if ( cache.list.Depth < depth )
+        Api::push(cache.list, &c->link, cache.lock);
+      else
+      {
+        lookaside.free(c);
+        atomic::decrement(cells);
+      }
+    }
+
+    /** Sums up the counters of the processors */
+    request_pool_stats stats() const __ntl_nothrow
+    {
+      request_pool_stats s = {};
+      for ( unsigned i = 0; caches && i < processors; i++ )
+      {
+        s.hits   += caches[i].hits;
+        s.steals += caches[i].steals;
+        s.misses += caches[i].misses;
+        s.frees  += caches[i].frees;
+      }
+      s.failures = failures;
+      s.cells = cells;
+      s.peak = peak;
+      return s;
+    }
+
+    unsigned processor_count() const { return processors; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    processor_cache & current()
+    {
+      return caches[Api::current_processor() % processors];
+    }
+
+    cell * steal(processor_cache & cache)
+    {
+      const unsigned self = static_cast<unsigned>(&cache - caches);
+      for ( unsigned i = 1; i < processors; i++ )
+      {
+        processor_cache & other = caches[(self + i) % processors];
+        if ( other.list.Depth )
+          if ( slist_entry * e = Api::pop(other.list, other.lock) )
+            return reinterpret_cast<cell*>(e);
+      }
+      return 0;
+    }
+
+    void grow()
+    {
+      const uint32_t n = atomic::increment(cells);
+      for ( uint32_t top = peak; n > top; top = peak )
+        if ( atomic::compare_exchange(peak, n, top) == top )
+          break;
+    }
+
+    processor_cache * caches;
+    char *            raw;
+    unsigned          processors;
+    uint16_t          depth;
+    volatile uint32_t cells;
+    volatile uint32_t peak;
+    volatile uint32_t failures;
+    lookaside_type    lookaside;
+};
+
+
+/**
+ *	Owner of a request_pool context.
+ *
+ *  The context is freed when the pointer goes out of scope unless it was released or attached to an IRP.
+ *  An attached context lives in the IRP's DriverContext while the driver owns the request,
+ *  and the pointer constructed from the IRP takes it back, e.g. in the completion routine.
+ **/
+template<class Context, class Api>
+class request_pool<Context, Api>::context_ptr
+{
+    context_ptr(const context_ptr&);
+    const context_ptr& operator=(const context_ptr&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    /** Allocates a new context */
+    explicit context_ptr(request_pool & pool) __ntl_nothrow
+    : pool(pool), p(pool.allocate())
+    {/**/}
+
+    /** Takes the context attached to the \a Irp */
+    context_ptr(request_pool & pool, irp & Irp, unsigned slot = 0) __ntl_nothrow
+    : pool(pool), p(attached(Irp, slot))
+    {
+      Irp.Tail.Overlay.DriverContext[slot] = 0;
+    }
+
+    ~context_ptr() __ntl_nothrow
+    {
+      pool.free(p);
+    }
+
+    Context * get() const { return p; }
+    Context * operator->() const { return p; }
+    Context & operator*() const { return *p; }
+    operator const void *() const { return p; }
+
+    Context * release()
+    {
+      Context * const r = p;
+      p = 0;
+      return r;
+    }
+
+    /** Passes the context to the \a Irp, it stays there until taken by another context_ptr */
+    void attach(irp & Irp, unsigned slot = 0)
+    {
+      Irp.Tail.Overlay.DriverContext[slot] = release();
+    }
+
+    /** The context attached to the \a Irp */
+    static Context * attached(const irp & Irp, unsigned slot = 0)
+    {
+      return reinterpret_cast<Context*>(Irp.Tail.Overlay.DriverContext[slot]);
+    }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+    request_pool &  pool;
+    Context *       p;
+};
+
+
+}//namspace km
+}//namespace ntl
+
+
+#endif//#ifndef NTL__KM_REQUEST_POOL
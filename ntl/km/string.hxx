@@ -9,6 +9,7 @@
 #pragma once
 
 #include "../nt/string.hxx"
+#include "../nt/string_view.hxx"
 #include "pool.hxx"
 
 namespace ntl {
@@ -39,6 +40,10 @@ using  nt::const_unicode_string;
 using  nt::ansi_string;
 using  nt::const_ansi_string;
 
+using  nt::unicode_string_view;
+using  nt::ci_unicode_string_view;
+using  nt::inline_unicode_string;
+
 }//namespace ntl
 }//namespace nt
 
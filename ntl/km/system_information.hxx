@@ -39,6 +39,16 @@ struct system_information
                                       ZwQuerySystemInformation>
 {};
 
+template<class InformationClass>
+class system_information_query
+: public nt::system_information_query<InformationClass,
+                                      ZwQuerySystemInformation>
+{};
+
+using nt::process_diff_visitor;
+
+typedef nt::basic_process_monitor<ZwQuerySystemInformation> process_monitor;
+
 
 /**@} system_information */
 
@@ -19,6 +19,9 @@ namespace ntl {
     using nt::system_time;
     using nt::systime_t;
     using nt::RtlTimeToTimeFields;
+    using nt::timer_type;
+    using nt::NotificationTimer;
+    using nt::SynchronizationTimer;
 
     struct ktimer
     {
@@ -45,6 +48,19 @@ namespace ntl {
       void __stdcall
       ExSystemTimeToLocalTime(systime_t* SystemTime, systime_t* LocalTime);
 
+    NTL__EXTERNAPI
+      void __stdcall
+      KeInitializeTimerEx(ktimer* Timer, timer_type Type);
+
+    /** Sets the \a Timer to fire at the \a DueTime (negative is relative, in 100ns) and then each \a Period ms, queueing the \a Dpc */
+    NTL__EXTERNAPI
+      bool __stdcall
+      KeSetTimerEx(ktimer* Timer, int64_t DueTime, int32_t Period, kdpc* Dpc);
+
+    NTL__EXTERNAPI
+      bool __stdcall
+      KeCancelTimer(ktimer* Timer);
+
 
   }//namespace km
 }//namespace ntl
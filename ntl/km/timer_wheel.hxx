@@ -0,0 +1,112 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Timer wheel driven by a periodic kernel timer
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__KM_TIMER_WHEEL
+#define NTL__KM_TIMER_WHEEL
+#pragma once
+
+#include "basedef.hxx"
+#include "dpc.hxx"
+#include "time.hxx"
+#include "../timer_wheel.hxx"
+
+
+namespace ntl {
+namespace km {
+
+
+/// The spin lock of the km::timer_wheel
+struct timer_wheel_lock
+{
+  void lock() { irql = guard.acquire(); }
+  void unlock() { guard.release(irql); }
+
+private:
+  kspin_lock  guard;
+  kirql       irql;
+};
+
+
+/**
+ *	Timer wheel of the driver: all the timeouts are served by one periodic ktimer and its DPC.
+ *
+ *  The tick is the \a resolution in milliseconds, the timeouts are rounded up to it.
+ *  The expire routines are called in batches by the DPC at DISPATCH_LEVEL.
+ *  The entries are scheduled at any IRQL <= DISPATCH_LEVEL without locking.
+ **/
+class timer_wheel:
+  public basic_timer_wheel<timer_wheel_lock>
+{
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    explicit timer_wheel(uint32_t resolution = 10)
+    : basic_timer_wheel<timer_wheel_lock>(interrupt_time() / (resolution * 10000)),
+      period(resolution), tick(int64_t(resolution) * 10000), running(false)
+    {
+      KeInitializeTimerEx(&timer, NotificationTimer);
+      KeInitializeDpc(&dpc, on_tick, this);
+    }
+
+    ~timer_wheel()
+    {
+      stop();
+    }
+
+    /** Starts the periodic timer */
+    void start()
+    {
+      running = true;
+      KeSetTimerEx(&timer, -tick, period, &dpc);
+    }
+
+    /** Stops the timer and waits for its DPC to finish, the scheduled entries stay in the wheel. IRQL == PASSIVE_LEVEL. */
+    void stop()
+    {
+      if ( !running )
+        return;
+      running = false;
+      KeCancelTimer(&timer);
+      KeFlushQueuedDpcs();
+    }
+
+    /** Schedules the \a entry to expire in not less than \a timeout milliseconds */
+    bool schedule_after(entry_type & entry, uint32_t timeout, expire_routine * routine, void * context = 0)
+    {
+      const uint64_t deadline = (interrupt_time() + int64_t(timeout) * 10000 + tick - 1) / tick;
+      return schedule(entry, deadline, routine, context);
+    }
+
+    /** The current tick */
+    uint64_t now() const { return interrupt_time() / tick; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    static uint64_t interrupt_time()
+    {
+      return user_shared_data::instance().InterruptTime.get();
+    }
+
+    static void __stdcall on_tick(const kdpc*, void * context, const void*, const void*)
+    {
+      timer_wheel * const self = static_cast<timer_wheel*>(context);
+      self->advance(self->now());
+    }
+
+    ktimer    timer;
+    kdpc      dpc;
+    int32_t   period;
+    int64_t   tick;     // in 100ns
+    bool      running;
+};
+
+
+}//namspace km
+}//namespace ntl
+
+
+#endif//#ifndef NTL__KM_TIMER_WHEEL
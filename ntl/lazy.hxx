@@ -0,0 +1,89 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Thread-safe lazy initialized object
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__LAZY
+#define NTL__LAZY
+#pragma once
+
+#include "stlx/mutex.hxx"
+#include "stlx/type_traits.hxx"
+
+namespace ntl {
+
+/**
+ *	Object constructed by the first access, e.g. a singleton or a heavy table used by some requests only.
+ *
+ *  The object is default constructed by the first get() through std::call_once, the threads which come meanwhile
+ *  are parked until it is done, and after that get() costs a single load. If the constructor throws, the next get() retries.
+ *  The object is destroyed with the lazy one if it has been constructed.
+ *  \code
+ *    ntl::lazy<codec_registry> codecs;
+ *
+ *    const codec* find_codec(const char* name)
+ *    {
+ *      return codecs->find(name);
+ *    }
+ *  \endcode
+ *  @note With the constexpr support the lazy static object is initialized statically and usable from the other static initializers.
+ *  In the kernel mode the lazy object must be in the nonpaged memory as its once_flag, e.g. a static object of the driver
+ *  or a member of a nonpaged allocation; the plain \c new allocates from the paged pool.
+ **/
+template<class T>
+class lazy
+{
+    lazy(const lazy&);
+    const lazy& operator=(const lazy&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef T value_type;
+
+    constexpr lazy()
+      :flag(), storage()
+    {}
+
+    ~lazy()
+    {
+      if(flag.ready())
+        ptr()->~T();
+    }
+
+    /** Constructs the object if it is not yet and returns it */
+    T& get()
+    {
+      if(!flag.ready())
+        std::call_once(flag, &lazy::construct, this);
+      return *ptr();
+    }
+
+    const T& get() const { return const_cast<lazy*>(this)->get(); }
+
+    /** Is the object constructed */
+    bool ready() const { return flag.ready() != 0; }
+
+    T& operator*()              { return get(); }
+    const T& operator*() const  { return get(); }
+    T* operator->()             { return &get(); }
+    const T* operator->() const { return &get(); }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    static void construct(lazy* self)
+    {
+      ::new (&self->storage) T();
+    }
+
+    T* ptr() { return reinterpret_cast<T*>(&storage); }
+
+    std::once_flag flag;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+
+} // namespace ntl
+
+#endif // NTL__LAZY
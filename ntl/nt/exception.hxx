@@ -18,6 +18,7 @@
 #include "../stlx/typeinfo.hxx"
 
 #include "../pe/image.hxx"
+#include "../atomic.hxx"
 
 #ifdef _NTL_EH_TRACE
   #include <iostream>
@@ -733,6 +734,93 @@ namespace cxxruntime {
 
 #endif // _M_X64
 
+  /**
+   *	The generation of the type caches of this module. The cached type matches and
+   *  dynamic_casts are keyed on the addresses of the type_info records and vftables,
+   *  and an unloaded module leaves these addresses to the next module loaded there.
+   *  The entries of the older generations are misses.
+   **/
+  inline volatile uint32_t& type_cache_epoch()
+  {
+    static volatile uint32_t epoch;
+    return epoch;
+  }
+
+  /**
+   *	Forgets the type matches and dynamic_casts cached by this module.
+   *  @note Call it after the unload of a module which objects or exceptions
+   *  were cast or caught here.
+   **/
+  inline void flush_type_caches()
+  {
+    atomic::increment(type_cache_epoch());
+  }
+
+  /**
+   *	The type of the catch clause against the catchable type of the thrown object:
+   *  the distinct type_info records are the same type if their names are equal.
+   *  The name comparisons are remembered in a direct-mapped cache, the entry is
+   *  versioned and the entry which is being written is a miss. The entry of
+   *  the earlier generation of flush_type_caches() is a miss too.
+   **/
+  class type_match_cache
+  {
+    enum { bits = 7, size = 1 << bits };
+
+    struct entry
+    {
+      volatile uint32_t version;
+      uint32_t          equal;
+      uint32_t          epoch;
+      const type_info*  catchtype;
+      const type_info*  thrown;
+    };
+
+    entry entries[size];
+
+    static uint32_t index(const type_info* catchtype, const type_info* thrown)
+    {
+      const uint64_t h = reinterpret_cast<uintptr_t>(catchtype) ^ reinterpret_cast<uintptr_t>(thrown) << 1;
+      return (static_cast<uint32_t>(h ^ h >> 32) * 0x9E3779B1u) >> (32 - bits);
+    }
+
+  public:
+    static type_match_cache& instance()
+    {
+      static type_match_cache cache;
+      return cache;
+    }
+
+    bool equal(const type_info* catchtype, const type_info* thrown)
+    {
+      if(catchtype == thrown)
+        return true;
+      // the names compared after a flush are stored with the new generation only
+      const uint32_t epoch = type_cache_epoch();
+      entry& e = entries[index(catchtype, thrown)];
+      const uint32_t version = e.version;
+      if(!(version & 1)){
+        intrinsic::_ReadWriteBarrier();
+        const bool hit = e.catchtype == catchtype && e.thrown == thrown && e.epoch == epoch;
+        const bool cached = e.equal != 0;
+        intrinsic::_ReadWriteBarrier();
+        if(hit && e.version == version)
+          return cached;
+      }
+      const bool equal = std::strcmp(catchtype->name(), thrown->name()) == 0;
+      if(!(version & 1) && atomic::compare_exchange(e.version, version + 1, version) == version){
+        intrinsic::_ReadWriteBarrier();
+        e.catchtype = catchtype;
+        e.thrown = thrown;
+        e.equal = equal;
+        e.epoch = epoch;
+        intrinsic::_ReadWriteBarrier();
+        atomic::exchange(e.version, version + 2);
+      }
+      return equal;
+    }
+  };
+
   /// This type represents the catch clause
   struct ehandler
   {
@@ -785,7 +873,7 @@ namespace cxxruntime {
         return true;
 
       // different TI record with different name?
-      if(ti1 != ti2 && std::strcmp(ti1->name(), ti2->name()))
+      if(ti1 != ti2 && !type_match_cache::instance().equal(ti1, ti2))
         return false;
 
       // reference?
@@ -1124,12 +1212,18 @@ namespace cxxruntime {
     void* frame_info;
     void* foreignException;
   #endif
+
+    /** is not allocated by _initptd */
+    bool external;
   };
 
-  inline tiddata* _initptd()
+  inline tiddata* _initptd(tiddata* storage = nullptr)
   {
     nt::teb& teb = nt::teb::instance();
-    tiddata* tid = new tiddata();
+    tiddata* tid = storage ? storage : new tiddata();
+    if(storage)
+      *storage = tiddata();
+    tid->external = storage != nullptr;
     tid->tid = teb.ClientId.UniqueThread;
     teb.EnvironmentPointer = tid;
     return tid;
@@ -1154,7 +1248,20 @@ namespace cxxruntime {
 
   inline void _freeptd()
   {
-    delete _getptd_noinit();
+    tiddata* td = _getptd_noinit();
+    if(td && !td->external)
+      delete td;
+  }
+
+  /**
+   *	Sets up the exception state of the current thread, which is allocated by
+   *  its first throw otherwise; \a storage is used instead of the heap if given,
+   *  it shall outlive the exceptions of the thread.
+   **/
+  inline void reserve_exception_state(tiddata* storage = nullptr)
+  {
+    if(!_getptd_noinit())
+      _initptd(storage);
   }
 
   struct cxxregistration
@@ -512,6 +512,31 @@ struct file_network_open_information
 	uint32_t FileAttributes;
 };
 
+///\name FileIdBothDirectoryInformation == 37
+struct file_id_both_dir_information
+{
+  static const file_information_class info_class_type = FileIdBothDirectoryInformation;
+
+  uint32_t  NextEntryOffset;
+  uint32_t  FileIndex;
+  int64_t   CreationTime;
+  int64_t   LastAccessTime;
+  int64_t   LastWriteTime;
+  int64_t   ChangeTime;
+  int64_t   EndOfFile;
+  int64_t   AllocationSize;
+  uint32_t  FileAttributes;
+  uint32_t  FileNameLength;
+  uint32_t  EaSize;
+  int8_t    ShortNameLength;
+  wchar_t   ShortName[12];
+  int64_t   FileId;
+  wchar_t   FileName[1];
+
+  const_unicode_string name() const { return const_unicode_string(FileName, FileNameLength / sizeof(wchar_t)); }
+};
+STATIC_ASSERT(offsetof(file_id_both_dir_information, FileName) == 0x68);
+
 
 ///}
 
@@ -10,10 +10,15 @@
 
 #include "../iterator"
 #include "../string"
+#include "../cstring"
 #include "../device_traits.hxx"
 #include "basedef.hxx"
 #include "handle.hxx"
 #include "object.hxx"
+#include "string_view.hxx"
+#ifndef NTL__SUBSYSTEM_KM
+#include "event.hxx"
+#endif
 
 #include <vector>
 
@@ -128,10 +133,177 @@ ntstatus __stdcall
     uint32_t *                    ResultLength
     );
 
+NTL__EXTERNAPI
+ntstatus __stdcall
+  ZwQueryKey(
+    legacy_handle         KeyHandle,
+    key_information_class KeyInformationClass,
+    void *                KeyInformation,
+    uint32_t              Length,
+    uint32_t *            ResultLength
+    );
+
+NTL__EXTERNAPI
+ntstatus __stdcall
+  ZwNotifyChangeKey(
+    legacy_handle         KeyHandle,
+    legacy_handle         Event             __optional,
+    io_apc_routine *      ApcRoutine        __optional,
+    const void *          ApcContext        __optional,
+    io_status_block *     IoStatusBlock,
+    uint32_t              CompletionFilter,
+    bool                  WatchTree,
+    void *                Buffer            __optional,
+    uint32_t              BufferSize,
+    bool                  Asynchronous
+    );
+
 ///@}
 
 class key;
 
+struct key_basic_information
+{
+  int64_t   LastWriteTime;
+  uint32_t  TitleIndex;
+  uint32_t  NameLength; // in bytes
+  wchar_t   Name[1];    // variable-length string
+};
+
+/**
+ *	Registry access through the native API.
+ *  This is the policy of the subkey enumeration, the snapshots and the cache, so they can run over another registry implementation.
+ **/
+struct registry_api
+{
+  typedef handle handle_type;
+
+  static ntstatus open_key(handle_type& h, const object_attributes& oa, uint32_t desired_access)
+  {
+    h.reset();
+    return ZwOpenKey(&h, desired_access, &oa);
+  }
+
+  static ntstatus query_key(legacy_handle h, key_information_class info_class, void* info, uint32_t length, uint32_t& result_length)
+  {
+    return ZwQueryKey(h, info_class, info, length, &result_length);
+  }
+
+  static ntstatus enumerate_key(legacy_handle h, uint32_t index, key_information_class info_class, void* info, uint32_t length, uint32_t& result_length)
+  {
+    return ZwEnumerateKey(h, index, info_class, info, length, &result_length);
+  }
+
+  static ntstatus enumerate_value_key(legacy_handle h, uint32_t index, key_value_information_class info_class, void* info, uint32_t length, uint32_t& result_length)
+  {
+    return ZwEnumerateValueKey(h, index, info_class, info, length, &result_length);
+  }
+
+  /** Requests the asynchronous notification, \a iosb stays status::pending and \a event is reset until the key is changed */
+  static ntstatus notify_change_key(legacy_handle h, legacy_handle event, io_status_block* iosb, uint32_t filter, bool watch_tree)
+  {
+    return ZwNotifyChangeKey(h, event, 0, 0, iosb, filter, watch_tree, 0, 0, true);
+  }
+
+#ifndef NTL__SUBSYSTEM_KM
+  /** Creates the manual-reset event of the notification */
+  static ntstatus create_event(handle_type& event)
+  {
+    event.reset();
+    return NtCreateEvent(&event, device_traits<user_event>::all_access, nullptr, NotificationEvent, false);
+  }
+
+  /** Closes the key, which completes the pending notification with status::notify_cleanup, and waits until it is written */
+  static void cancel_notify_change_key(handle_type& h, legacy_handle event)
+  {
+    h.reset();
+    NtWaitForSingleObject(event, false, infinite_timeout());
+  }
+#endif
+};
+
+/**
+ *	Subkey names iterator over a buffer of the longest key name.
+ *  The buffer is a part of the iterator, so the enumeration neither allocates nor retries.
+ **/
+template<class Api>
+class basic_subkey_iterator:
+  public std::iterator<std::input_iterator_tag, std::wstring>
+{
+  public:
+    /** The registry limit of the key name length, in characters */
+    static const uint32_t max_name_length = 255;
+
+    basic_subkey_iterator()
+    : hkey(), index(end_index), named(false)
+    {/**/}
+
+    basic_subkey_iterator(legacy_handle hkey, uint32_t index)
+    : hkey(hkey), index(index), named(false)
+    {
+      read();
+    }
+
+    /** The subkey name, valid until the iterator is incremented */
+    const_unicode_string view() const
+    {
+      const key_basic_information& info = *reinterpret_cast<const key_basic_information*>(buf);
+      return const_unicode_string(info.Name, info.NameLength / sizeof(wchar_t));
+    }
+
+    /** The copy of the subkey name, the string is reused by the iterator */
+    reference operator* ()
+    {
+      if ( !named )
+      {
+        const key_basic_information& info = *reinterpret_cast<const key_basic_information*>(buf);
+        name.assign(&info.Name[0], info.NameLength / sizeof(wchar_t));
+        named = true;
+      }
+      return name;
+    }
+    pointer   operator->()  { return &(operator*()); }
+
+    basic_subkey_iterator & operator++()
+    {
+      ///\note does not handle ++subkey_end()
+      ++index;
+      read();
+      return *this;
+    }
+
+  friend
+    bool operator==(const basic_subkey_iterator & x, const basic_subkey_iterator & y)
+      { return x.index == y.index; }
+
+  friend
+    bool operator!=(const basic_subkey_iterator & x, const basic_subkey_iterator & y)
+      { return !(x == y); }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    static const uint32_t end_index = static_cast<uint32_t>(-1);
+
+    void read()
+    {
+      named = false;
+      uint32_t length;
+      const ntstatus s = Api::enumerate_key(hkey, index, KeyBasicInformation, buf, sizeof(buf), length);
+      if ( !nt::success(s) )  // no_more_entries or the key is gone
+        index = end_index;
+    }
+
+    legacy_handle hkey;
+    uint32_t      index;
+    bool          named;
+    std::wstring  name;
+    uint64_t      buf[(sizeof(key_basic_information) + max_name_length * sizeof(wchar_t) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+};
+
+template<class Api> class basic_key_snapshot;
+typedef basic_key_snapshot<registry_api> key_snapshot;
+
 /**@} registry */
 
 }//namespace nt
@@ -255,7 +427,6 @@ class key : public handle, public device_traits<key>
         const access_mask         desired_access  = access_mask_default
         )
     {
-      __assume(subkey_end_ == subkey_iterator());
       open(oa, desired_access);
     }
 
@@ -265,7 +436,6 @@ class key : public handle, public device_traits<key>
         const access_mask             desired_access  = access_mask_default
         )
     {
-      __assume(subkey_end_ == subkey_iterator());
       open(name, desired_access);
     }
 
@@ -276,17 +446,10 @@ class key : public handle, public device_traits<key>
         const access_mask     desired_access  = access_mask_default
         )
     {
-      __assume(subkey_end_ == subkey_iterator());
       open(object_attributes(root.get(), const_unicode_string(name)),
             desired_access);
     }
 
-    __forceinline
-    ~key()
-    {
-      __assume(subkey_end_ == subkey_iterator());
-    }
-
     operator const handle &() const
     {
       return *this;
@@ -509,22 +672,40 @@ class key : public handle, public device_traits<key>
     }
 
 
-    struct basic_information
+    typedef key_basic_information basic_information;
+
+    struct key_node_information
     {
       int64_t   LastWriteTime;
       uint32_t  TitleIndex;
+      uint32_t  ClassOffset;
+      uint32_t  ClassLength;
       uint32_t  NameLength;
-      wchar_t   Name[1];  // variable-length string
+      wchar_t   Name[1];  //  Variable-length string
     };
 
-    struct key_node_information
+    struct full_information
     {
       int64_t   LastWriteTime;
       uint32_t  TitleIndex;
       uint32_t  ClassOffset;
       uint32_t  ClassLength;
-      uint32_t  NameLength;
-      wchar_t   Name[1];  //  Variable-length string
+      uint32_t  SubKeys;
+      uint32_t  MaxNameLen;       // in bytes
+      uint32_t  MaxClassLen;
+      uint32_t  Values;
+      uint32_t  MaxValueNameLen;  // in bytes
+      uint32_t  MaxValueDataLen;
+      wchar_t   Class[1];         // variable size
+    };
+
+    /** ZwNotifyChangeKey completion filter */
+    enum notify_filter
+    {
+      notify_change_name        = 0x00000001,
+      notify_change_attributes  = 0x00000002,
+      notify_change_last_set    = 0x00000004,
+      notify_change_security    = 0x00000008,
     };
 
     static
@@ -554,103 +735,384 @@ class key : public handle, public device_traits<key>
     }
 
 
-    struct subkey_iterator
-    : public std::iterator<std::input_iterator_tag, std::wstring>
-    {
-        __forceinline
-        ~subkey_iterator() {}
+    typedef basic_subkey_iterator<registry_api> subkey_iterator;
 
-        reference operator* ()  { return name; }
-        pointer   operator->()  { return &(operator*()); }
+    __forceinline
+    subkey_iterator subkey_begin() const
+    {
+      return subkey_iterator(get(), 0);
+    }
 
-        __forceinline
-        subkey_iterator & operator++()
-        {
-          ///\note does not handle ++subkey_end()
-          ++index;
-          read();
-          return *this;
-        }
+    /** The end of the enumeration, the iterators are compared by the index only */
+    __forceinline
+    static subkey_iterator subkey_end()
+    {
+      return subkey_iterator();
+    }
 
-      friend
-        bool operator==(const subkey_iterator & x, const subkey_iterator & y)
-          { return /*x.key == y.key &&*/ x.index == y.index; }
+    /** Captures the subkey names and the values of the key at once */
+    ntstatus snapshot(key_snapshot& snap) const;
 
-      friend
-        bool operator!=(const subkey_iterator & x, const subkey_iterator & y)
-          { return !(x == y); }
+}; // class key
 
-      ///////////////////////////////////////////////////////////////////////////
-      private:
+/**
+ *	Subkeys and values of a key captured at once.
+ *  Everything is stored in one arena sized by the ZwQueryKey counts, the records which don't fit grow it twice,
+ *  so a large value doesn't inflate the others. The arena is reused by the next capture if it fits.
+ *  The capture is repeated if the key changes in between, so the snapshot is consistent.
+ **/
+template<class Api>
+class basic_key_snapshot
+{
+    basic_key_snapshot(const basic_key_snapshot&);
+    const basic_key_snapshot& operator=(const basic_key_snapshot&);
 
-        __forceinline
-        subkey_iterator()
-        : index(end_index)
-        {/**/}
+  ////////////////////////////////////////////////////////////////////////////
+  public:
 
-        friend class key;
+    struct value_entry
+    {
+      const_unicode_string  name;
+      key::value_type       type;
+      uint32_t              size;
+      const void *          data;
+    };
 
-        static const uint32_t begin_index = 0;
-        static const uint32_t end_index = static_cast<uint32_t>(-1);
+    basic_key_snapshot()
+    : arena(), capacity(), subkeys_(), values_(), subkey_count_(), value_count_(), last_write_time_(), allocations_()
+    {/**/}
 
-        __forceinline
-        subkey_iterator(legacy_handle hkey, uint32_t index)
-        : hkey(hkey), index(index)
-        {
-          read();
-        }
+    ~basic_key_snapshot()
+    {
+      delete[] arena;
+    }
 
-        legacy_handle hkey;
-        uint32_t      index;
-        std::wstring  name;
+    void swap(basic_key_snapshot& r)
+    {
+      std::swap(arena, r.arena);
+      std::swap(capacity, r.capacity);
+      std::swap(subkeys_, r.subkeys_);
+      std::swap(values_, r.values_);
+      std::swap(subkey_count_, r.subkey_count_);
+      std::swap(value_count_, r.value_count_);
+      std::swap(last_write_time_, r.last_write_time_);
+      std::swap(allocations_, r.allocations_);
+    }
 
-        __forceinline
-        void read()
+    /** Captures the key opened with the query_value and enumerate_sub_keys access */
+    ntstatus capture(legacy_handle hkey)
+    {
+      static const unsigned max_attempts = 8;
+      ntstatus s = status::unsuccessful;
+      for ( unsigned attempt = 0; attempt < max_attempts; ++attempt )
+      {
+        key::full_information fi;
+        if ( !nt::success(s = query_info(hkey, fi)) )
+          break;
+        if ( !nt::success(s = reserve(fi)) )
+          break;
+        s = fill(hkey, fi);
+        if ( s == status::success )
         {
-          uint32_t size = query_buf_default_size;
-          STATIC_ASSERT(query_buf_default_size > sizeof(basic_information));
-          for ( ; ; )
+          // the key could be changed between the queries
+          key::full_information fi2;
+          if ( !nt::success(s = query_info(hkey, fi2)) )
+            break;
+          if ( fi2.LastWriteTime == fi.LastWriteTime && fi2.SubKeys == subkey_count_ && fi2.Values == value_count_ )
           {
-            uint8_t * const buf = new uint8_t[size];
-            const basic_information & p = *reinterpret_cast<basic_information*>(buf);
-            const ntstatus s = enumerate_key(hkey, index, KeyBasicInformation,
-                                              buf, size, size);
-            switch ( s )
-            {
-              //case status::buffer_too_small:  // may be only if size < sizeof(basic_information)
-              case status::buffer_overflow:
-                delete[] buf;
-                continue;
-              case status::success:
-                name.assign(&p.Name[0], p.NameLength / sizeof(wchar_t));
-                delete[] buf;
-                return; // true
-              case status::no_more_entries:
-                index = end_index;
-              default:
-                delete[] buf;
-                return; // false
-            }
+            last_write_time_ = fi.LastWriteTime;
+            return status::success;
           }
+          s = status::unsuccessful;
         }
+        else
+          break;
+      }
+      subkey_count_ = value_count_ = 0;
+      return s;
+    }
 
-    };
+    int64_t last_write_time() const { return last_write_time_; }
 
-    __forceinline
-    subkey_iterator subkey_begin() const
+    uint32_t subkey_count() const { return subkey_count_; }
+    const const_unicode_string& subkey(uint32_t i) const { return subkeys_[i]; }
+
+    uint32_t value_count() const { return value_count_; }
+    const value_entry& value(uint32_t i) const { return values_[i]; }
+
+    /** Looks up the value by name, the names are folded to the upper case by upcase_char_traits (RtlUpcaseUnicodeChar) */
+    const value_entry* find(const const_unicode_string& name) const
     {
-      return subkey_iterator(get() , subkey_iterator::begin_index);
+      for ( uint32_t i = 0; i != value_count_; ++i )
+        if ( equal_names(values_[i].name, name) )
+          return &values_[i];
+      return 0;
     }
 
-    __forceinline // God bless RVO
-    const subkey_iterator & subkey_end() const
+    bool query(const const_unicode_string& name, uint32_t& value) const
     {
-      return subkey_end_;
+      const value_entry* v = find(name);
+      if ( !v || v->type != key::reg_dword_little_endian || v->size != sizeof(uint32_t) )
+        return false;
+      value = *static_cast<const uint32_t*>(v->data);
+      return true;
     }
 
-    const subkey_iterator subkey_end_;
+    /** Returns the view of the string value without the terminating zeros */
+    bool query(const const_unicode_string& name, const_unicode_string& value) const
+    {
+      const value_entry* v = find(name);
+      if ( !v || (v->type != key::reg_sz && v->type != key::reg_expand_sz && v->type != key::reg_multi_sz) )
+        return false;
+      const wchar_t* const p = static_cast<const wchar_t*>(v->data);
+      size_t n = v->size / sizeof(wchar_t);
+      while ( n && !p[n-1] ) --n;
+      const_unicode_string(p, n).swap(value);
+      return true;
+    }
 
-}; // class key
+    /** The number of the arena allocations made by this object */
+    unsigned allocations() const { return allocations_; }
+
+  ////////////////////////////////////////////////////////////////////////////
+  private:
+
+    static size_t align(size_t n) { return (n + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1); }
+
+    // the value names are compared as the registry does, in the upper case
+    static bool equal_names(const const_unicode_string& x, const const_unicode_string& y)
+    {
+      return x.size() == y.size() && upcase_char_traits::compare(x.begin(), y.begin(), x.size()) == 0;
+    }
+
+    static ntstatus query_info(legacy_handle hkey, key::full_information& fi)
+    {
+      uint32_t length;
+      // the class name doesn't fit, the fixed part is returned anyway
+      const ntstatus s = Api::query_key(hkey, KeyFullInformation, &fi, sizeof(fi), length);
+      return s == status::buffer_overflow ? status::success : s;
+    }
+
+    // the value entries and the subkey names precede the records
+    static size_t entries(const key::full_information& fi)
+    {
+      return align(fi.Values * sizeof(value_entry) + fi.SubKeys * sizeof(const_unicode_string));
+    }
+
+    static size_t subkey_record(const key::full_information& fi)
+    {
+      return align(offsetof(key_basic_information, Name) + fi.MaxNameLen);
+    }
+
+    static size_t value_record(const key::full_information& fi)
+    {
+      // the data expected in the most of the values, the larger ones grow the arena
+      const uint32_t small_data = 64;
+      return align(offsetof(key::value_full_information, Name) + fi.MaxValueNameLen)
+           + align(fi.MaxValueDataLen < small_data ? fi.MaxValueDataLen : small_data);
+    }
+
+    ntstatus reserve(const key::full_information& fi)
+    {
+      const size_t size = entries(fi) + fi.SubKeys * subkey_record(fi) + fi.Values * value_record(fi);
+      if ( size > capacity )
+      {
+        delete[] arena;
+        arena = new (std::nothrow) uint64_t[size / sizeof(uint64_t)];
+        capacity = arena ? size : 0;
+        if ( !arena )
+          return status::insufficient_resources;
+        ++allocations_;
+      }
+      values_ = reinterpret_cast<value_entry*>(arena);
+      subkeys_ = reinterpret_cast<const_unicode_string*>(values_ + fi.Values);
+      return status::success;
+    }
+
+    uint32_t room(const char* raw) const
+    {
+      return static_cast<uint32_t>(capacity - (raw - reinterpret_cast<const char*>(arena)));
+    }
+
+    static void rebase(const_unicode_string& str, const char* from, char* to)
+    {
+      const wchar_t* const p = reinterpret_cast<const wchar_t*>(to + (reinterpret_cast<const char*>(str.begin()) - from));
+      const_unicode_string(p, str.size()).swap(str);
+    }
+
+    /** Moves the captured part to the arena twice as large, or larger by the record of \a length which doesn't fit at \a raw */
+    ntstatus grow(const key::full_information& fi, char*& raw, uint32_t length)
+    {
+      const char* const from = reinterpret_cast<const char*>(arena);
+      const size_t used = raw - from;
+      // the room estimated for the rest of the records is kept
+      size_t size = capacity * 2;
+      if ( size < capacity + align(length) )
+        size = capacity + align(length);
+      uint64_t* const p = new (std::nothrow) uint64_t[size / sizeof(uint64_t)];
+      if ( !p )
+        return status::insufficient_resources;
+      ++allocations_;
+      std::memcpy(p, arena, used);
+
+      char* const to = reinterpret_cast<char*>(p);
+      values_ = reinterpret_cast<value_entry*>(p);
+      subkeys_ = reinterpret_cast<const_unicode_string*>(values_ + fi.Values);
+      for ( uint32_t i = 0; i != subkey_count_; ++i )
+        rebase(subkeys_[i], from, to);
+      for ( uint32_t i = 0; i != value_count_; ++i )
+      {
+        rebase(values_[i].name, from, to);
+        values_[i].data = to + (static_cast<const char*>(values_[i].data) - from);
+      }
+      delete[] arena;
+      arena = p;
+      capacity = size;
+      raw = to + used;
+      return status::success;
+    }
+
+    ntstatus fill(legacy_handle hkey, const key::full_information& fi)
+    {
+      subkey_count_ = value_count_ = 0;
+      char* raw = reinterpret_cast<char*>(arena) + entries(fi);
+
+      for ( uint32_t i = 0; i != fi.SubKeys; ++i )
+      {
+        uint32_t length;
+        ntstatus s;
+        while ( (s = Api::enumerate_key(hkey, i, KeyBasicInformation, raw, room(raw), length)) == status::buffer_overflow
+              || s == status::buffer_too_small )
+          if ( !nt::success(s = grow(fi, raw, length)) )
+            return s;
+        if ( s == status::no_more_entries )
+          break;
+        if ( !nt::success(s) )
+          return s;
+        const key_basic_information& info = *reinterpret_cast<const key_basic_information*>(raw);
+        ::new(&subkeys_[subkey_count_++]) const_unicode_string(info.Name, info.NameLength / sizeof(wchar_t));
+        raw += align(length);
+      }
+
+      for ( uint32_t i = 0; i != fi.Values; ++i )
+      {
+        uint32_t length;
+        ntstatus s;
+        while ( (s = Api::enumerate_value_key(hkey, i, KeyValueFullInformation, raw, room(raw), length)) == status::buffer_overflow
+              || s == status::buffer_too_small )
+          if ( !nt::success(s = grow(fi, raw, length)) )
+            return s;
+        if ( s == status::no_more_entries )
+          break;
+        if ( !nt::success(s) )
+          return s;
+        const key::value_full_information& info = *reinterpret_cast<const key::value_full_information*>(raw);
+        value_entry& v = values_[value_count_++];
+        ::new(&v.name) const_unicode_string(info.Name, info.NameLength / sizeof(wchar_t));
+        v.type = info.Type;
+        v.size = info.DataLength;
+        v.data = raw + info.DataOffset;
+        raw += align(length);
+      }
+      return status::success;
+    }
+
+    uint64_t *              arena;
+    size_t                  capacity;
+    const_unicode_string *  subkeys_;
+    value_entry *           values_;
+    uint32_t                subkey_count_;
+    uint32_t                value_count_;
+    int64_t                 last_write_time_;
+    unsigned                allocations_;
+};
+
+inline ntstatus key::snapshot(key_snapshot& snap) const
+{
+  return snap.capture(get());
+}
+
+#ifndef NTL__SUBSYSTEM_KM
+/**
+ *	Snapshot of a key refreshed on the change notification.
+ *  The repeated reads are served from memory until ZwNotifyChangeKey reports a change of the key.
+ *  @note The notification is requested by the thread calling snapshot(), the change is not seen if the thread exits.
+ **/
+template<class Api = registry_api>
+class basic_key_cache
+{
+    basic_key_cache(const basic_key_cache&);
+    const basic_key_cache& operator=(const basic_key_cache&);
+
+  ////////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef basic_key_snapshot<Api> snapshot_type;
+
+    explicit basic_key_cache(const object_attributes& oa, bool watch_tree = false)
+    : watch_tree(watch_tree), armed(false), refreshes_()
+    {
+      iosb.Status = status::pending;
+      last_status_ = Api::open_key(h, oa, key::read);
+      if ( nt::success(last_status_) )
+        last_status_ = Api::create_event(event);
+    }
+
+    ~basic_key_cache()
+    {
+      // the kernel writes iosb until the pending request is completed
+      if ( armed )
+        Api::cancel_notify_change_key(h, event.get());
+    }
+
+    /** Returns the key snapshot, it is captured again if the key has changed since the last call */
+    const snapshot_type& snapshot()
+    {
+      if ( !armed || *static_cast<volatile ntstatus*>(&iosb.Status) != status::pending )
+        refresh();
+      return snap;
+    }
+
+    bool query(const const_unicode_string& name, uint32_t& value)
+    {
+      return snapshot().query(name, value);
+    }
+
+    bool query(const const_unicode_string& name, const_unicode_string& value)
+    {
+      return snapshot().query(name, value);
+    }
+
+    /** The number of the captures made */
+    unsigned refreshes() const { return refreshes_; }
+
+    ntstatus last_status() const { return last_status_; }
+
+  ////////////////////////////////////////////////////////////////////////////
+  private:
+
+    void refresh()
+    {
+      // request the next notification first, so the changes made during the capture aren't lost
+      iosb.Status = status::pending;
+      armed = event.get() && nt::success(Api::notify_change_key(h.get(), event.get(), &iosb,
+                          key::notify_change_name | key::notify_change_last_set, watch_tree));
+      last_status_ = snap.capture(h.get());
+      ++refreshes_;
+    }
+
+    io_status_block               iosb;
+    typename Api::handle_type     event;
+    typename Api::handle_type     h;
+    snapshot_type                 snap;
+    ntstatus                      last_status_;
+    bool                          watch_tree;
+    bool                          armed;
+    unsigned                      refreshes_;
+};
+
+typedef basic_key_cache<> key_cache;
+#endif // NTL__SUBSYSTEM_KM
 
 
 namespace rtl_registry {
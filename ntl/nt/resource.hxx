@@ -71,6 +71,7 @@ namespace ntl {
 
       static const uint32_t RunOnceCheckOnly = 1U;
       static const uint32_t RunOnceAsync     = 2U;
+      static const uint32_t RunOnceInitFailed= 4U;
 
       typedef uint32_t __stdcall run_once_init_t(
           rtl::run_once* RunOnce,
@@ -130,25 +131,26 @@ namespace ntl {
 
     // run once
     NTL__EXTERNAPI
-      void RtlRunOnceInitialize(rtl::run_once* RunOnce);
+      void __stdcall RtlRunOnceInitialize(rtl::run_once* RunOnce);
 
     NTL__EXTERNAPI
-      uint32_t RtlRunOnceExecuteOnce(
+      ntstatus __stdcall RtlRunOnceExecuteOnce(
         rtl::run_once*        RunOnce,
-        rtl::run_once_init_t  InitFn,
+        rtl::run_once_init_t* InitFn,
         void*                 Parameter,
         void**                Context
       );
 
+    /** Returns status::pending if the caller should initialize, status::success if it is initialized already */
     NTL__EXTERNAPI
-      uint32_t RtlRunOnceBeginInitialize(
+      ntstatus __stdcall RtlRunOnceBeginInitialize(
         rtl::run_once*        RunOnce,
         uint32_t              Flags,
         void**                Context
       );
 
     NTL__EXTERNAPI
-      uint32_t RtlRunOnceComplete(
+      ntstatus __stdcall RtlRunOnceComplete(
         rtl::run_once*        RunOnce,
         uint32_t              Flags,
         void**                Context
@@ -30,8 +30,15 @@ struct system_time
 #ifdef _M_X64
       return *reinterpret_cast<int64_t volatile const*>(this);
 #else
+      // the writer stores high2, low and high in this order, so reading them backwards
+      // gives a consistent value when both high parts are equal
       uint32_t l; int32_t h;
-      do { cpu::pause(); l = low; h = high; } while ( h != high2 );
+      for(;;){
+        h = high; l = low;
+        if(h == high2)
+          break;
+        cpu::pause();
+      }
       return (type)h << 32 | l;
 #endif
     }
@@ -0,0 +1,620 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  NT native string views and builders with an inline buffer
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__NT_STRING_VIEW
+#define NTL__NT_STRING_VIEW
+#pragma once
+
+#include "string.hxx"
+#ifndef NTL__STLX_MEMORY
+#include "../stlx/memory.hxx"
+#endif
+
+namespace ntl {
+namespace nt {
+
+/**\addtogroup  native_types_support *** NT Types support library ***********
+ *@{*/
+
+  /**
+   *	@brief Case-insensitive traits of the UTF-16 characters
+   *  @details The characters are compared as RtlCompareUnicodeString does with
+   *  CaseInSensitive set: both are converted to the upper case.
+   **/
+  struct upcase_char_traits:
+    public std::char_traits<wchar_t>
+  {
+    static wchar_t upcase(wchar_t c)
+    {
+      if ( c < 0x80 )
+        return static_cast<wchar_t>(static_cast<unsigned>(c - 'a') < 26 ? c - 'a' + 'A' : c);
+      return RtlUpcaseUnicodeChar(c);
+    }
+
+    static bool eq(const char_type& c1, const char_type& c2) { return c1 == c2 || upcase(c1) == upcase(c2); }
+    static bool lt(const char_type& c1, const char_type& c2) { return upcase(c1) < upcase(c2); }
+
+    static int compare(const char_type* s1, const char_type* s2, size_t n)
+    {
+      for ( ; n; --n, ++s1, ++s2 )
+        if ( *s1 != *s2 )
+        {
+          const wchar_t c1 = upcase(*s1), c2 = upcase(*s2);
+          if ( c1 != c2 )
+            return c1 < c2 ? -1 : 1;
+        }
+      return 0;
+    }
+
+    static const char_type* find(const char_type* s, size_t n, const char_type& a)
+    {
+      const wchar_t u = upcase(a);
+      for ( ; n; --n, ++s )
+        if ( *s == a || upcase(*s) == u )
+          return s;
+      return 0;
+    }
+  };
+
+
+/**
+ *	@brief Non-owning view of a UTF-16 string
+ *  @details The view is a pointer and a length: it is made of the native
+ *  strings, std::wstring and the literals without copying, and the native
+ *  string of the view is made without copying too.
+ *  \p traits decides how the characters are compared, \see upcase_char_traits.
+ **/
+template<class traits = std::char_traits<wchar_t> >
+class basic_unicode_string_view
+{
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    ///\name  basic_unicode_string_view types:
+
+    typedef           traits                      traits_type;
+    typedef           wchar_t                     value_type;
+    typedef const wchar_t *                       pointer;
+    typedef const wchar_t *                       const_pointer;
+    typedef const wchar_t &                       reference;
+    typedef const wchar_t &                       const_reference;
+    typedef           size_t                      size_type;
+    typedef           ptrdiff_t                   difference_type;
+    typedef const_pointer                         iterator;
+    typedef const_pointer                         const_iterator;
+    typedef std::reverse_iterator<const_iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    ///\name  basic_unicode_string_view constructors
+
+    basic_unicode_string_view()
+    : ptr_(), len_()
+    {/**/}
+
+    basic_unicode_string_view(const wchar_t* s, size_type n)
+    : ptr_(s), len_(n)
+    {/**/}
+
+    basic_unicode_string_view(const wchar_t* s)
+    : ptr_(s), len_(s ? std::char_traits<wchar_t>::length(s) : 0)
+    {/**/}
+
+    basic_unicode_string_view(const const_unicode_string& s)
+    : ptr_(s.begin()), len_(s.size())
+    {/**/}
+
+    basic_unicode_string_view(const unicode_string& s)
+    : ptr_(s.begin()), len_(s.size())
+    {/**/}
+
+    template<class StrTraits, class Allocator>
+    basic_unicode_string_view(const std::basic_string<wchar_t, StrTraits, Allocator>& s)
+    : ptr_(s.data()), len_(s.size())
+    {/**/}
+
+    /// Views the same characters with the other traits
+    template<class OtherTraits>
+    explicit basic_unicode_string_view(const basic_unicode_string_view<OtherTraits>& s)
+    : ptr_(s.data()), len_(s.size())
+    {/**/}
+
+    ///\name  basic_unicode_string_view conversions
+
+    /// The native string of the view, \c size() shall not exceed 0x7FFF
+    const_unicode_string native() const
+    {
+      assert(len_ <= 0x7FFF);
+      return const_unicode_string(ptr_, len_);
+    }
+
+    std::wstring get_string() const
+    {
+      return std::wstring(ptr_, len_);
+    }
+
+    ///\name  basic_unicode_string_view iterator support
+
+    const_iterator          begin()   const { return ptr_; }
+    const_iterator          end()     const { return ptr_ + len_; }
+    const_reverse_iterator  rbegin()  const { return const_reverse_iterator(end()); }
+    const_reverse_iterator  rend()    const { return const_reverse_iterator(begin()); }
+    const_iterator          cbegin()  const { return begin(); }
+    const_iterator          cend()    const { return end(); }
+    const_reverse_iterator  crbegin() const { return rbegin(); }
+    const_reverse_iterator  crend()   const { return rend(); }
+
+    ///\name  basic_unicode_string_view capacity
+
+    size_type size()      const { return len_; }
+    size_type length()    const { return len_; }
+    size_type max_size()  const { return npos / sizeof(wchar_t); }
+    bool empty()          const { return len_ == 0; }
+
+    ///\name  basic_unicode_string_view element access
+
+    const_reference operator[](size_type pos) const { return ptr_[pos]; }
+    const_reference front() const { return ptr_[0]; }
+    const_reference back()  const { return ptr_[len_ - 1]; }
+    const_pointer   data()  const { return ptr_; }
+
+    const_reference at(size_type pos) const
+    {
+      if ( pos >= len_ ) __ntl_throw (std::out_of_range(__FUNCTION__));
+      return ptr_[pos];
+    }
+
+    ///\name  basic_unicode_string_view modifiers
+
+    void remove_prefix(size_type n) { ptr_ += n; len_ -= n; }
+    void remove_suffix(size_type n) { len_ -= n; }
+
+    void swap(basic_unicode_string_view& s)
+    {
+      std::swap(ptr_, s.ptr_);
+      std::swap(len_, s.len_);
+    }
+
+    ///\name  basic_unicode_string_view string operations
+
+    basic_unicode_string_view substr(size_type pos = 0, size_type n = npos) const
+    {
+      if ( pos > len_ )
+      {
+        __ntl_throw (std::out_of_range(__FUNCTION__));
+        pos = len_;
+      }
+      return basic_unicode_string_view(ptr_ + pos, (std::min)(n, len_ - pos));
+    }
+
+    int compare(const basic_unicode_string_view& s) const
+    {
+      const int r = traits::compare(ptr_, s.ptr_, (std::min)(len_, s.len_));
+      return r ? r : len_ < s.len_ ? -1 : len_ != s.len_;
+    }
+
+    int compare(size_type pos, size_type n, const basic_unicode_string_view& s) const
+    {
+      return substr(pos, n).compare(s);
+    }
+
+    bool starts_with(const basic_unicode_string_view& s) const
+    {
+      return len_ >= s.len_ && traits::compare(ptr_, s.ptr_, s.len_) == 0;
+    }
+
+    bool starts_with(wchar_t c) const
+    {
+      return len_ && traits::eq(ptr_[0], c);
+    }
+
+    bool ends_with(const basic_unicode_string_view& s) const
+    {
+      return len_ >= s.len_ && traits::compare(ptr_ + len_ - s.len_, s.ptr_, s.len_) == 0;
+    }
+
+    bool ends_with(wchar_t c) const
+    {
+      return len_ && traits::eq(ptr_[len_ - 1], c);
+    }
+
+    ///\name  basic_unicode_string_view searching
+
+    size_type find(const basic_unicode_string_view& s, size_type pos = 0) const
+    {
+      if ( pos > len_ || s.len_ > len_ - pos )
+        return npos;
+      if ( s.empty() )
+        return pos;
+      // the first character is searched by traits::find
+      const wchar_t* const last = ptr_ + len_ - s.len_;
+      for ( const wchar_t* p = ptr_ + pos; p <= last; ++p )
+      {
+        p = traits::find(p, last - p + 1, s.ptr_[0]);
+        if ( !p )
+          break;
+        if ( traits::compare(p + 1, s.ptr_ + 1, s.len_ - 1) == 0 )
+          return p - ptr_;
+      }
+      return npos;
+    }
+
+    size_type find(wchar_t c, size_type pos = 0) const
+    {
+      if ( pos >= len_ )
+        return npos;
+      const wchar_t* const p = traits::find(ptr_ + pos, len_ - pos, c);
+      return p ? static_cast<size_type>(p - ptr_) : npos;
+    }
+
+    size_type rfind(const basic_unicode_string_view& s, size_type pos = npos) const
+    {
+      if ( s.len_ > len_ )
+        return npos;
+      for ( size_type i = (std::min)(pos, len_ - s.len_) + 1; i; --i )
+        if ( traits::compare(ptr_ + i - 1, s.ptr_, s.len_) == 0 )
+          return i - 1;
+      return npos;
+    }
+
+    size_type rfind(wchar_t c, size_type pos = npos) const
+    {
+      for ( size_type i = len_ ? (std::min)(pos, len_ - 1) + 1 : 0; i; --i )
+        if ( traits::eq(ptr_[i - 1], c) )
+          return i - 1;
+      return npos;
+    }
+
+    size_type find_first_of(const basic_unicode_string_view& s, size_type pos = 0) const
+    {
+      for ( ; pos < len_; ++pos )
+        if ( traits::find(s.ptr_, s.len_, ptr_[pos]) )
+          return pos;
+      return npos;
+    }
+
+    size_type find_first_of(wchar_t c, size_type pos = 0) const
+    {
+      return find(c, pos);
+    }
+
+    size_type find_last_of(const basic_unicode_string_view& s, size_type pos = npos) const
+    {
+      for ( size_type i = len_ ? (std::min)(pos, len_ - 1) + 1 : 0; i; --i )
+        if ( traits::find(s.ptr_, s.len_, ptr_[i - 1]) )
+          return i - 1;
+      return npos;
+    }
+
+    size_type find_last_of(wchar_t c, size_type pos = npos) const
+    {
+      return rfind(c, pos);
+    }
+
+    size_type find_first_not_of(const basic_unicode_string_view& s, size_type pos = 0) const
+    {
+      for ( ; pos < len_; ++pos )
+        if ( !traits::find(s.ptr_, s.len_, ptr_[pos]) )
+          return pos;
+      return npos;
+    }
+
+    size_type find_first_not_of(wchar_t c, size_type pos = 0) const
+    {
+      for ( ; pos < len_; ++pos )
+        if ( !traits::eq(ptr_[pos], c) )
+          return pos;
+      return npos;
+    }
+
+    size_type find_last_not_of(const basic_unicode_string_view& s, size_type pos = npos) const
+    {
+      for ( size_type i = len_ ? (std::min)(pos, len_ - 1) + 1 : 0; i; --i )
+        if ( !traits::find(s.ptr_, s.len_, ptr_[i - 1]) )
+          return i - 1;
+      return npos;
+    }
+
+    size_type find_last_not_of(wchar_t c, size_type pos = npos) const
+    {
+      for ( size_type i = len_ ? (std::min)(pos, len_ - 1) + 1 : 0; i; --i )
+        if ( !traits::eq(ptr_[i - 1], c) )
+          return i - 1;
+      return npos;
+    }
+
+    ///\name  basic_unicode_string_view splitting
+
+    /**
+     *	Splits the view at the first \a c.
+     *  @return the part before \a c, the view is left with the part after it;
+     *  the whole view if there is no \a c, the view is left empty then.
+     *  \code while ( !path.empty() ) component = path.split_front(L'\\'); \endcode
+     **/
+    basic_unicode_string_view split_front(wchar_t c)
+    {
+      const size_type pos = find(c);
+      const basic_unicode_string_view head(ptr_, pos == npos ? len_ : pos);
+      if ( pos == npos )
+        remove_prefix(len_);
+      else
+        remove_prefix(pos + 1);
+      return head;
+    }
+
+    /**
+     *	Splits the view at the last \a c.
+     *  @return the part after \a c, the view is left with the part before it;
+     *  the whole view if there is no \a c, the view is left empty then.
+     **/
+    basic_unicode_string_view split_back(wchar_t c)
+    {
+      const size_type pos = rfind(c);
+      const size_type tail = pos == npos ? 0 : pos + 1;
+      const basic_unicode_string_view head(ptr_ + tail, len_ - tail);
+      len_ = pos == npos ? 0 : pos;
+      return head;
+    }
+
+    ///\name  basic_unicode_string_view comparisons
+
+    friend bool operator==(const basic_unicode_string_view& x, const basic_unicode_string_view& y)
+    {
+      return x.len_ == y.len_ && traits::compare(x.ptr_, y.ptr_, x.len_) == 0;
+    }
+
+    friend bool operator!=(const basic_unicode_string_view& x, const basic_unicode_string_view& y) { return !(x == y); }
+    friend bool operator< (const basic_unicode_string_view& x, const basic_unicode_string_view& y) { return x.compare(y) < 0; }
+    friend bool operator> (const basic_unicode_string_view& x, const basic_unicode_string_view& y) { return x.compare(y) > 0; }
+    friend bool operator<=(const basic_unicode_string_view& x, const basic_unicode_string_view& y) { return x.compare(y) <= 0; }
+    friend bool operator>=(const basic_unicode_string_view& x, const basic_unicode_string_view& y) { return x.compare(y) >= 0; }
+
+    ///}
+
+  private:
+    const wchar_t * ptr_;
+    size_type       len_;
+};//class basic_unicode_string_view
+
+typedef basic_unicode_string_view<>                   unicode_string_view;
+typedef basic_unicode_string_view<upcase_char_traits> ci_unicode_string_view;
+
+
+/**
+ *	@brief UTF-16 string builder with an inline buffer
+ *  @details Up to \p N characters are kept in the object itself, so the builder
+ *  on the stack allocates nothing until the string exceeds \p N; then the
+ *  string is moved to the memory of \p Allocator, which is the paged pool in
+ *  the kernel mode. The string is kept null-terminated and it is a native
+ *  string itself: \c str() returns it without copying.
+ *
+ *  The native strings are limited to 0x7FFF characters; the operation which
+ *  exceeds it or fails to allocate leaves the string as it was and clears
+ *  \c good().
+ **/
+template<size_t N, class Allocator = std::allocator<wchar_t> >
+class inline_unicode_string
+{
+    static_assert(N > 0 && N <= 0x7FFF, "the inline buffer shall fit a native string");
+
+    typedef std::char_traits<wchar_t> traits;
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    ///\name  inline_unicode_string types:
+
+    typedef           wchar_t                     value_type;
+    typedef           Allocator                   allocator_type;
+    typedef           size_t                      size_type;
+    typedef           wchar_t *                   iterator;
+    typedef const     wchar_t *                   const_iterator;
+    typedef unicode_string_view                   view_type;
+
+    ///\name  inline_unicode_string constructors
+
+    inline_unicode_string()
+    {
+      init();
+    }
+
+    explicit inline_unicode_string(const view_type& s)
+    {
+      init();
+      append(s);
+    }
+
+    inline_unicode_string(const inline_unicode_string& s)
+    {
+      init();
+      append(s.view());
+    }
+
+    ~inline_unicode_string()
+    {
+      if ( spilled() )
+        alloc_.deallocate(str_.buffer_, capacity() + 1);
+    }
+
+    inline_unicode_string& operator=(const inline_unicode_string& s)
+    {
+      return assign(s.view());
+    }
+
+    inline_unicode_string& operator=(const view_type& s)
+    {
+      return assign(s);
+    }
+
+    ///\name  inline_unicode_string conversions
+
+    /// The native string of the builder, valid until it is changed
+    const const_unicode_string& str() const
+    {
+      return *reinterpret_cast<const const_unicode_string*>(&str_);
+    }
+
+    operator const const_unicode_string&() const { return str(); }
+
+    view_type view() const { return view_type(str_.buffer_, size()); }
+
+    ///\name  inline_unicode_string capacity
+
+    size_type size()      const { return str_.length_ / sizeof(wchar_t); }
+    size_type length()    const { return size(); }
+    size_type capacity()  const { return str_.max_length_ / sizeof(wchar_t); }
+    size_type max_size()  const { return 0x7FFF; }
+    bool empty()          const { return str_.length_ == 0; }
+
+    /// false if an operation has not fit into the native string or the memory
+    bool good()           const { return good_; }
+
+    bool reserve(size_type n)
+    {
+      return n <= capacity() || grow(n);
+    }
+
+    ///\name  inline_unicode_string element access
+
+    iterator        begin()       { return str_.buffer_; }
+    const_iterator  begin() const { return str_.buffer_; }
+    iterator        end()         { return str_.buffer_ + size(); }
+    const_iterator  end()   const { return str_.buffer_ + size(); }
+
+    wchar_t&        operator[](size_type pos)       { return str_.buffer_[pos]; }
+    const wchar_t&  operator[](size_type pos) const { return str_.buffer_[pos]; }
+    wchar_t&        back()        { return str_.buffer_[size() - 1]; }
+    const wchar_t&  back()  const { return str_.buffer_[size() - 1]; }
+
+    const wchar_t*  data()  const { return str_.buffer_; }
+    const wchar_t*  c_str() const { return str_.buffer_; }
+
+    ///\name  inline_unicode_string modifiers
+
+    inline_unicode_string& assign(const view_type& s)
+    {
+      // s may be a part of this string, it is not longer than the string then
+      if ( s.size() > size() && !reserve(s.size()) )
+        return *this;
+      traits::move(str_.buffer_, s.data(), s.size());
+      set_size(s.size());
+      return *this;
+    }
+
+    inline_unicode_string& append(const view_type& s)
+    {
+      const size_type n = size() + s.size();
+      if ( n > capacity() )
+      {
+        const size_type offset = s.data() - str_.buffer_;
+        const bool self = offset <= size();
+        if ( !grow(n) )
+          return *this;
+        if ( self )
+        {
+          traits::copy(end(), str_.buffer_ + offset, s.size());
+          set_size(n);
+          return *this;
+        }
+      }
+      traits::copy(end(), s.data(), s.size());
+      set_size(n);
+      return *this;
+    }
+
+    inline_unicode_string& append(size_type n, wchar_t c)
+    {
+      if ( size() + n > capacity() && !grow(size() + n) )
+        return *this;
+      traits::assign(end(), n, c);
+      set_size(size() + n);
+      return *this;
+    }
+
+    inline_unicode_string& append(wchar_t c)
+    {
+      return append(1, c);
+    }
+
+    /// Appends the path component \a s separated by one backslash
+    inline_unicode_string& append_path(view_type s)
+    {
+      const bool slash = !empty() && back() == '\\';
+      if ( s.starts_with('\\') )
+      {
+        if ( slash || empty() )
+          return append(slash ? s.substr(1) : s);
+      }
+      else if ( !slash && !empty() )
+        append('\\');
+      return append(s);
+    }
+
+    inline_unicode_string& operator+=(const view_type& s) { return append(s); }
+    inline_unicode_string& operator+=(wchar_t c) { return append(c); }
+
+    void push_back(wchar_t c) { append(1, c); }
+    void pop_back() { set_size(size() - 1); }
+    void clear() { set_size(0); }
+
+    void resize(size_type n, wchar_t c = wchar_t())
+    {
+      if ( n > size() )
+        append(n - size(), c);
+      else
+        set_size(n);
+    }
+
+    ///}
+
+  private:
+
+    raw_unicode_string  str_;
+    bool                good_;
+    allocator_type      alloc_;
+    wchar_t             buf_[N + 1];
+
+    void init()
+    {
+      str_.length_ = 0;
+      str_.max_length_ = N * sizeof(wchar_t);
+      str_.buffer_ = buf_;
+      buf_[0] = 0;
+      good_ = true;
+    }
+
+    bool spilled() const { return str_.buffer_ != buf_; }
+
+    void set_size(size_type n)
+    {
+      str_.length_ = static_cast<uint16_t>(n * sizeof(wchar_t));
+      str_.buffer_[n] = 0;
+    }
+
+    bool grow(size_type n)
+    {
+      if ( n > max_size() )
+        return good_ = false;
+      const size_type cap = (std::min)((std::max)(n, capacity() * 2), max_size());
+      wchar_t* const p = alloc_.allocate(cap + 1);
+      if ( !p )
+        return good_ = false;
+      traits::copy(p, str_.buffer_, size() + 1);
+      if ( spilled() )
+        alloc_.deallocate(str_.buffer_, capacity() + 1);
+      str_.buffer_ = p;
+      str_.max_length_ = static_cast<uint16_t>(cap * sizeof(wchar_t));
+      return true;
+    }
+};//class inline_unicode_string
+
+/**@} native_types_support */
+
+}//namespace nt
+}//namespace ntl
+
+#endif//#ifndef NTL__NT_STRING_VIEW
@@ -19,6 +19,9 @@
 
 #include "thread.hxx"
 
+#include "../vector"
+#include "../algorithm"
+
 namespace ntl {
 
 
@@ -138,6 +141,33 @@ NTL__EXTERNAPI query_system_information_t NtQuerySystemInformation;
 NTL__EXTERNAPI set_system_information_t NtSetSystemInformation;
 
 
+/// The size of the last successful query of the information class with a headroom.
+/// The variable size classes seldom shrink or grow much between the queries,
+/// so the next query starts from it instead of sizeof(InformationClass).
+template <class InformationClass>
+struct system_information_size_hint
+{
+  static uint32_t size;
+
+  static uint32_t with_headroom(uint32_t length)
+  {
+    return length + length / 8 + 4096;
+  }
+
+  static void update(uint32_t length)
+  {
+    size = with_headroom(length);
+  }
+
+  static uint32_t initial()
+  {
+    return size > sizeof(InformationClass) ? size : sizeof(InformationClass);
+  }
+};
+
+template <class InformationClass>
+uint32_t system_information_size_hint<InformationClass>::size;
+
 ///\note  most of SystemInformationClasses have either big or variable size,
 ///       so we stick to dinamic allocation in this generic implementation.
 template <class                     InformationClass,
@@ -155,19 +185,23 @@ class system_information_base
 
     system_information_base() __ntl_nothrow : ptr(0)
     {
-      unsigned long length = 0;
-      for ( unsigned long i = sizeof(info_class);
-            (ptr = new char[length = length ? length : i ]) != 0;
-            i *= 2 )
+      typedef system_information_size_hint<info_class> hint;
+      uint32_t length = hint::initial();
+      while ( (ptr = new char[length]) != 0 )
       {
-        const ntstatus s = query(ptr, length, &length);
+        uint32_t required = 0;
+        const ntstatus s = QueryInformation(info_class::info_class_type, ptr, length, &required);
         if ( s == status::success )
+        {
+          hint::update(required);
           break;
+        }
         delete[] ptr;
-        if ( s == status::info_length_mismatch )
-          continue;
         ptr = nullptr;
-        break;
+        if ( s != status::info_length_mismatch )
+          break;
+        // the required size may grow until the next query
+        length = hint::with_headroom(required > length ? required : length * 2);
       }
     }
 
@@ -207,6 +241,107 @@ struct system_information
                                 NtQuerySystemInformation>
 {};
 
+/**
+ *	Persistent query of the system information.
+ *  The buffer is kept between the update() calls and grows with a headroom only when the information doesn't fit,
+ *  so the periodic queries make one syscall and no allocations.
+ **/
+template <class                     InformationClass,
+          query_system_information_t  QueryInformation>
+class system_information_query
+{
+    system_information_query(const system_information_query&);
+    const system_information_query& operator=(const system_information_query&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef InformationClass info_class;
+
+    system_information_query() __ntl_nothrow
+    : ptr(0), capacity_(0), size_(0), queries_(0), allocations_(0)
+    {/**/}
+
+    ~system_information_query() __ntl_nothrow
+    {
+      delete[] ptr;
+    }
+
+    /** Queries the information again, the previous data is overwritten */
+    ntstatus update() __ntl_nothrow
+    {
+      typedef system_information_size_hint<info_class> hint;
+      size_ = 0;
+      if ( !ptr && !reserve(hint::initial()) )
+        return status::insufficient_resources;
+      for ( ; ; )
+      {
+        uint32_t required = 0;
+        ++queries_;
+        const ntstatus s = QueryInformation(info_class::info_class_type, ptr, capacity_, &required);
+        if ( s == status::info_length_mismatch || s == status::buffer_too_small || s == status::buffer_overflow )
+        {
+          if ( !reserve(hint::with_headroom(required > capacity_ ? required : capacity_ * 2)) )
+            return status::insufficient_resources;
+          continue;
+        }
+        if ( nt::success(s) )
+        {
+          size_ = required;
+          hint::update(required);
+        }
+        return s;
+      }
+    }
+
+    /** Are there data of the last successful update() */
+    bool valid() const { return size_ != 0; }
+
+    info_class * operator->() { return data(); }
+    const info_class * operator->() const { return data(); }
+
+    info_class * data() { return reinterpret_cast<info_class*>(ptr); }
+    const info_class * data() const { return reinterpret_cast<const info_class*>(ptr); }
+
+    /** Size of the data returned by the last update() */
+    uint32_t size() const { return size_; }
+    /** Size of the buffer */
+    uint32_t capacity() const { return capacity_; }
+
+    /** Number of the syscalls made */
+    unsigned queries() const { return queries_; }
+    /** Number of the buffer allocations made */
+    unsigned allocations() const { return allocations_; }
+
+    void swap(system_information_query& r) __ntl_nothrow
+    {
+      std::swap(ptr, r.ptr);
+      std::swap(capacity_, r.capacity_);
+      std::swap(size_, r.size_);
+      std::swap(queries_, r.queries_);
+      std::swap(allocations_, r.allocations_);
+    }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    bool reserve(uint32_t length) __ntl_nothrow
+    {
+      delete[] ptr;
+      // 8-byte aligned for the 64-bit fields of the information
+      ptr = reinterpret_cast<char*>(new (std::nothrow) uint64_t[(length + sizeof(uint64_t) - 1) / sizeof(uint64_t)]);
+      capacity_ = ptr ? length : 0;
+      ++allocations_;
+      return ptr != 0;
+    }
+
+    char *    ptr;
+    uint32_t  capacity_;
+    uint32_t  size_;
+    unsigned  queries_;
+    unsigned  allocations_;
+};
+
 //////////////////////////////////////////////////////////////////////////
 
 ///\name  SystemBasicInformation (0)
@@ -380,6 +515,174 @@ struct system_processes: public system_process_information
 };// struct system_processes
 
 
+/**
+ *	Empty process_monitor::diff() visitor to derive from.
+ *  The threads of the added and removed processes are not reported separately.
+ **/
+struct process_diff_visitor
+{
+  void process_added(const system_process_information&) {}
+  void process_removed(const system_process_information&) {}
+  void process_changed(const system_process_information& /*now*/, const system_process_information& /*before*/) {}
+  void thread_added(const system_process_information&, const system_thread_information&) {}
+  void thread_removed(const system_process_information&, const system_thread_information&) {}
+  void thread_changed(const system_process_information&, const system_thread_information& /*now*/, const system_thread_information& /*before*/) {}
+};
+
+/**
+ *	Double-buffered polling of the process list.
+ *  Each poll() queries the processes into the buffer of the poll before the last one, so both the last
+ *  and the previous lists stay valid and diff() reports the processes and threads added, removed or changed between them.
+ *  A process or a thread is identified by its id and creation time, so a reused id is reported as a removal and an addition.
+ **/
+template <query_system_information_t QueryInformation>
+class basic_process_monitor
+{
+    basic_process_monitor(const basic_process_monitor&);
+    const basic_process_monitor& operator=(const basic_process_monitor&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef system_information_query<system_processes, QueryInformation> query_type;
+
+    basic_process_monitor()
+    : current(0)
+    {/**/}
+
+    /** Queries the process list, the previous one is kept for diff() */
+    ntstatus poll()
+    {
+      current ^= 1;
+      index[current].clear();
+      const ntstatus s = buffers[current].update();
+      if ( nt::success(s) )
+      {
+        for ( system_processes::const_iterator it = buffers[current]->cbegin(); it != buffers[current]->cend(); ++it )
+          index[current].push_back(&*it);
+        std::sort(index[current].begin(), index[current].end(), process_less);
+      }
+      return s;
+    }
+
+    /** The last process list or null */
+    const system_processes * processes() const
+    {
+      return buffers[current].valid() ? buffers[current].data() : 0;
+    }
+
+    const query_type & query() const { return buffers[current]; }
+
+    /** Reports the changes between the last two polls to the \a visitor, the first poll reports all processes as added */
+    template<class Visitor>
+    void diff(Visitor & visitor)
+    {
+      const process_index & now = index[current], & before = index[current ^ 1];
+      size_t i = 0, j = 0;
+      while ( i != now.size() || j != before.size() )
+      {
+        if ( j == before.size() || (i != now.size() && process_less(now[i], before[j])) )
+          visitor.process_added(*now[i++]);
+        else if ( i == now.size() || process_less(before[j], now[i]) )
+          visitor.process_removed(*before[j++]);
+        else
+        {
+          const system_process_information & p = *now[i++], & q = *before[j++];
+          if ( changed(p, q) )
+            visitor.process_changed(p, q);
+          diff_threads(visitor, p, q);
+        }
+      }
+    }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    typedef std::vector<const system_process_information*> process_index;
+    typedef std::vector<const system_thread_information*> thread_index;
+
+    static bool process_less(const system_process_information * x, const system_process_information * y)
+    {
+      return x->UniqueProcessId < y->UniqueProcessId
+        || (x->UniqueProcessId == y->UniqueProcessId && x->CreateTime < y->CreateTime);
+    }
+
+    static bool thread_less(const system_thread_information * x, const system_thread_information * y)
+    {
+      return x->ClientId.UniqueThread < y->ClientId.UniqueThread
+        || (x->ClientId.UniqueThread == y->ClientId.UniqueThread && x->CreateTime < y->CreateTime);
+    }
+
+    static bool changed(const system_process_information & p, const system_process_information & q)
+    {
+      return p.NumberOfThreads != q.NumberOfThreads || p.UserTime != q.UserTime || p.KernelTime != q.KernelTime
+        || p.HandleCount != q.HandleCount || p.BasePriority != q.BasePriority
+        || p.VirtualSize != q.VirtualSize || p.WorkingSetSize != q.WorkingSetSize
+        || p.PagefileUsage != q.PagefileUsage || p.PrivatePageCount != q.PrivatePageCount
+        || p.ReadOperationCount != q.ReadOperationCount || p.WriteOperationCount != q.WriteOperationCount
+        || p.OtherOperationCount != q.OtherOperationCount;
+    }
+
+    static bool changed(const system_thread_information & t, const system_thread_information & u)
+    {
+      return t.UserTime != u.UserTime || t.KernelTime != u.KernelTime || t.ContextSwitches != u.ContextSwitches
+        || t.ThreadState != u.ThreadState || t.WaitReason != u.WaitReason || t.Priority != u.Priority;
+    }
+
+    static void sort_threads(thread_index & threads, const system_process_information & p)
+    {
+      threads.clear();
+      for ( system_process_information::const_iterator t = p.begin(); t != p.end(); ++t )
+        threads.push_back(t);
+      std::sort(threads.begin(), threads.end(), thread_less);
+    }
+
+    template<class Visitor>
+    void diff_threads(Visitor & visitor, const system_process_information & p, const system_process_information & q)
+    {
+      // the threads are usually listed in the same order, so compare them in place unless it doesn't match
+      if ( p.NumberOfThreads == q.NumberOfThreads )
+      {
+        system_process_information::const_iterator t = p.begin(), u = q.begin();
+        for ( ; t != p.end(); ++t, ++u )
+          if ( t->ClientId.UniqueThread != u->ClientId.UniqueThread || t->CreateTime != u->CreateTime )
+            break;
+        if ( t == p.end() )
+        {
+          for ( t = p.begin(), u = q.begin(); t != p.end(); ++t, ++u )
+            if ( changed(*t, *u) )
+              visitor.thread_changed(p, *t, *u);
+          return;
+        }
+      }
+      sort_threads(threads[0], p);
+      sort_threads(threads[1], q);
+      const thread_index & now = threads[0], & before = threads[1];
+      size_t i = 0, j = 0;
+      while ( i != now.size() || j != before.size() )
+      {
+        if ( j == before.size() || (i != now.size() && thread_less(now[i], before[j])) )
+          visitor.thread_added(p, *now[i++]);
+        else if ( i == now.size() || thread_less(before[j], now[i]) )
+          visitor.thread_removed(q, *before[j++]);
+        else
+        {
+          const system_thread_information & t = *now[i++], & u = *before[j++];
+          if ( changed(t, u) )
+            visitor.thread_changed(p, t, u);
+        }
+      }
+    }
+
+    query_type    buffers[2];
+    process_index index[2];
+    thread_index  threads[2];   // scratch, reused by diff()
+    unsigned      current;
+};
+
+typedef basic_process_monitor<NtQuerySystemInformation> process_monitor;
+
+
 ///\name  SystemModuleInformation
 
 struct rtl_process_module_information// RTL_PROCESS_MODULE_INFORMATION
@@ -255,6 +255,37 @@ struct teb: public tib
   static __forceinline
     teb & instance() { return *static_cast<teb*>(get(&tib::Self)); }
 
+  ///\name TLS slots, the cells of TlsGetValue() and TlsSetValue() for the indices below 64
+#if defined(_M_IX86)
+  static const uint32_t tls_slots_offset = 0xE10;
+#elif defined(_M_X64)
+  static const uint32_t tls_slots_offset = 0x1480;
+#endif
+  static const uint32_t tls_minimum_available = 64;
+
+  static __forceinline
+    void* tls_slot(uint32_t index)
+  {
+    return reinterpret_cast<void*>(
+#if defined(_M_IX86)
+      ntl::intrinsic::__readfsdword
+#elif defined(_M_X64)
+      ntl::intrinsic::__readgsqword
+#endif
+      (tls_slots_offset + index * static_cast<uint32_t>(sizeof(void*))));
+  }
+
+  static __forceinline
+    void set_tls_slot(uint32_t index, void* value)
+  {
+#if defined(_M_IX86)
+    ntl::intrinsic::__writefsdword(tls_slots_offset + index * static_cast<uint32_t>(sizeof(void*)), reinterpret_cast<uint32_t>(value));
+#elif defined(_M_X64)
+    ntl::intrinsic::__writegsqword(tls_slots_offset + index * static_cast<uint32_t>(sizeof(void*)), reinterpret_cast<uint64_t>(value));
+#endif
+  }
+  ///\}
+
 #ifdef _M_X64
   static __forceinline
     teb & instance32() { return *reinterpret_cast<teb*>( get(&tib::ExceptionList) ); }
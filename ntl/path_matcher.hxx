@@ -0,0 +1,487 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Case-insensitive matching of the NT paths
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__PATH_MATCHER
+#define NTL__PATH_MATCHER
+#pragma once
+
+#include "nt/string.hxx"
+#include "stlx/algorithm.hxx"
+#include "stlx/map.hxx"
+#include "stlx/vector.hxx"
+
+namespace ntl {
+
+/**
+ *	Matches the NT paths against a set of the paths and globs, e.g. the whitelist of a filter driver, ignoring the case.
+ *
+ *  The pattern which starts with '\' matches the whole path, any other pattern matches the trailing components of it:
+ *  "atapi.sys" and "drivers\*.sys" match "\SystemRoot\system32\DRIVERS\ATAPI.SYS".
+ *  '*' matches any characters but '\' and '?' matches one such character, the NT names never contain them.
+ *
+ *  build() folds the case of the patterns once by RtlUpcaseUnicodeChar and compiles them into the deterministic automata
+ *  which read the path backwards: one of the literal patterns, which is their trie with the runs of the single characters
+ *  packed into the labels, and one of the globs. The automata and the case folding table of their characters live in
+ *  a single nonpaged allocation, so find() takes O(length) without calls, allocations and locks and may run at DISPATCH_LEVEL.
+ **/
+class path_matcher
+{
+    path_matcher(const path_matcher&);
+    const path_matcher& operator=(const path_matcher&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /** The limit of the automaton states, build() fails if the globs need more of them */
+    static const uint32_t max_states = 1 << 22;
+
+    path_matcher()
+    : blob(0), states(0), targets(0), chars(0), labels(0), fold_from(0), fold_to(0), folds(0), glob_start(0), patterns(0)
+    {/**/}
+
+    ~path_matcher()
+    {
+      delete[] blob;
+    }
+
+    /**
+     *	Compiles the patterns of [first, last), the strings of wchar_t or of char which are widened as Latin-1.
+     *  The index of a pattern is its position in the range, the empty patterns never match.
+     *  @return false if the memory is out or the automaton would exceed max_states, the matcher is left as it was then
+     **/
+    template<class ForwardIterator>
+    bool build(ForwardIterator first, ForwardIterator last)
+    {
+      std::vector<key> keys;
+      uint32_t id = 0;
+      for ( ; first != last; ++first, ++id )
+      {
+        keys.push_back(key());
+        keys.back().id = id;
+        fold_pattern(first->begin(), first->end(), keys.back().text);
+      }
+      return compile(keys, id);
+    }
+
+    /** The least index of the patterns which match the path, npos if none does */
+    template<class Char>
+    size_t find(const Char* first, const Char* last) const
+    {
+      if ( !blob )
+        return npos;
+      const size_t found = walk(start, first, last);
+      return glob_start ? std::min(found, walk(glob_start, first, last)) : found;
+    }
+
+    template<class String>
+    size_t find(const String& path) const
+    {
+      return find(path.begin(), path.end());
+    }
+
+    template<class String>
+    bool match(const String& path) const
+    {
+      return find(path) != npos;
+    }
+
+    /** The number of the patterns given to build() */
+    size_t size() const { return patterns; }
+
+    bool empty() const { return !patterns; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    static const uint32_t no_pattern = 0xFFFFFFFF;
+    enum { dead, start };
+
+    struct state
+    {
+      uint32_t label;   // the first character of the label, the labels of the next state follow
+      uint32_t edges;   // the first edge, the edges of the next state follow
+      uint32_t other;   // the state on the characters without an edge
+      uint32_t pattern; // the least pattern matched if the path starts here
+    };
+
+    struct key
+    {
+      std::vector<uint16_t> text; // folded and reversed
+      uint32_t id;
+      bool glob() const { return std::find(text.begin(), text.end(), '*') != text.end() || std::find(text.begin(), text.end(), '?') != text.end(); }
+      bool operator<(const key& k) const { return text < k.text || (text == k.text && id < k.id); }
+    };
+
+    // the trie of the reversed patterns
+    struct node
+    {
+      uint32_t first_child, next_sibling;
+      uint32_t star, any;   // the '*' and '?' children
+      uint32_t pattern;     // the pattern which ends here
+      uint32_t least;       // the least pattern in the subtree
+      uint16_t c;
+    };
+
+    static uint16_t unit(char c) { return static_cast<unsigned char>(c); }
+    static uint16_t unit(wchar_t c) { return static_cast<uint16_t>(c); }
+
+    static uint16_t upcase(uint16_t c)
+    {
+      if ( c < 0x80 )
+        return static_cast<unsigned>(c - 'a') < 26 ? static_cast<uint16_t>(c - ('a' - 'A')) : c;
+      return static_cast<uint16_t>(nt::RtlUpcaseUnicodeChar(static_cast<wchar_t>(c)));
+    }
+
+    template<class Iterator>
+    static void fold_pattern(Iterator first, Iterator last, std::vector<uint16_t>& text)
+    {
+      for ( ; first != last; ++first )
+      {
+        const uint16_t c = upcase(unit(*first));
+        if ( c != '*' || text.empty() || text.back() != '*' )
+          text.push_back(c);
+      }
+      std::reverse(text.begin(), text.end());
+    }
+
+    uint16_t fold(uint16_t c) const
+    {
+      if ( c < 0x80 )
+        return upcase(c);
+      const uint16_t* const p = std::lower_bound(fold_from, fold_from + folds, c);
+      return p != fold_from + folds && *p == c ? fold_to[p - fold_from] : c;
+    }
+
+    template<class Char>
+    size_t walk(uint32_t s, const Char* first, const Char* last) const
+    {
+      for ( ;; )
+      {
+        const state& st = states[s];
+        // the label is the only way on
+        for ( const uint16_t* l = labels + st.label, * const end = labels + states[s + 1].label; l != end; ++l )
+          if ( last == first || fold(unit(*--last)) != *l )
+            return npos;
+        const uint32_t count = states[s + 1].edges - st.edges;
+        // nothing or a matched pattern whatever precedes
+        if ( last == first || (!count && st.other == s) )
+          break;
+        s = next(st, count, fold(unit(*--last)));
+      }
+      return states[s].pattern == no_pattern ? npos : states[s].pattern;
+    }
+
+    uint32_t next(const state& st, uint32_t count, uint16_t c) const
+    {
+      const uint16_t* p = chars + st.edges, * const end = p + count;
+      if ( count > 8 )
+        p = std::lower_bound(p, end, c);
+      else
+        while ( p != end && *p < c )
+          ++p;
+      return p != end && *p == c ? targets[p - chars] : st.other;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // the automaton state is the set of the trie nodes, the node N + p is the pattern p matched at a '\'
+
+    typedef std::vector<uint32_t> node_set;
+    typedef std::map<node_set, uint32_t> state_map;
+
+    struct compiler
+    {
+      std::vector<node> nodes;
+      uint32_t n;
+      state_map ids;
+      std::vector<const node_set*> sets;
+
+      void closure(node_set& set, uint32_t x) const
+      {
+        for ( ; x != no_pattern; x = nodes[x].star )
+          set.push_back(x);
+      }
+
+      // the set without the nodes which can't match a lesser pattern than the one matched already
+      void prune(node_set& set) const
+      {
+        std::sort(set.begin(), set.end());
+        set.erase(std::unique(set.begin(), set.end()), set.end());
+        if ( set.empty() || set.back() < n )
+          return;
+        const uint32_t matched = *std::lower_bound(set.begin(), set.end(), n);
+        node_set::iterator out = set.begin();
+        for ( node_set::const_iterator x = set.begin(); x != set.end(); ++x )
+          if ( *x < n ? nodes[*x].least < matched - n : *x == matched )
+            *out++ = *x;
+        set.erase(out, set.end());
+      }
+
+      uint32_t intern(node_set& set)
+      {
+        prune(set);
+        if ( set.empty() )
+          return dead;
+        const std::pair<state_map::iterator, bool> r = ids.insert(std::make_pair(set, static_cast<uint32_t>(sets.size())));
+        if ( r.second )
+          sets.push_back(&r.first->first);
+        return r.first->second;
+      }
+
+      uint32_t pattern(const node_set& set) const
+      {
+        uint32_t p = no_pattern;
+        for ( node_set::const_iterator x = set.begin(); x != set.end(); ++x )
+          p = std::min(p, *x >= n ? *x - n : nodes[*x].pattern);
+        return p;
+      }
+
+      // the trie in the preorder, the children in the order of their characters
+      void trie(const std::vector<key>& keys, bool globs, std::vector<uint32_t>& alphabet)
+      {
+        const uint32_t none = no_pattern;
+        const node root = { none, none, none, none, none, none, 0 };
+        nodes.push_back(root);
+        std::vector<uint32_t> last_child(1, none), parent(1, none), path;
+        const std::vector<uint16_t>* prev = 0;
+        for ( std::vector<key>::const_iterator k = keys.begin(); k != keys.end(); ++k )
+        {
+          const std::vector<uint16_t>& text = k->text;
+          if ( text.empty() || k->glob() != globs )
+            continue;
+          size_t common = 0;
+          if ( prev )
+            while ( common < prev->size() && common < text.size() && (*prev)[common] == text[common] )
+              ++common;
+          path.resize(common + 1);
+          for ( size_t i = common; i < text.size(); ++i )
+          {
+            const uint32_t p = path.back(), x = static_cast<uint32_t>(nodes.size());
+            node child = root;
+            child.c = text[i];
+            nodes.push_back(child);
+            last_child.push_back(none), parent.push_back(p), path.push_back(x);
+            if ( last_child[p] == no_pattern )
+              nodes[p].first_child = x;
+            else
+              nodes[last_child[p]].next_sibling = x;
+            last_child[p] = x;
+            if ( child.c == '*' )
+              nodes[p].star = x;
+            else if ( child.c == '?' )
+              nodes[p].any = x;
+            else
+              alphabet[child.c / 32] |= 1u << (child.c % 32);
+          }
+          if ( nodes[path.back()].pattern == no_pattern )
+            nodes[path.back()].pattern = k->id;
+          prev = &text;
+        }
+        n = static_cast<uint32_t>(nodes.size());
+        for ( uint32_t x = n - 1; x; --x )
+        {
+          node& nd = nodes[x];
+          nd.least = std::min(nd.least, nd.pattern);
+          nodes[parent[x]].least = std::min(nodes[parent[x]].least, nd.least);
+        }
+      }
+
+      // the subset construction appends the states in the order they are found, returns the start or dead if there are too many
+      uint32_t construct(std::vector<state>& st, std::vector<uint32_t>& edge_targets, std::vector<uint16_t>& edge_chars)
+      {
+        const uint32_t none = no_pattern, base = static_cast<uint32_t>(st.size()) - 1;
+        sets.push_back(0);
+        node_set set, other, backslash;
+        closure(set, 0);
+        intern(set);
+        std::vector<std::pair<uint16_t, uint32_t> > moves;
+        for ( uint32_t s = start; s < sets.size(); ++s )
+        {
+          if ( base + sets.size() > max_states )
+            return dead;
+          const node_set& from = *sets[s];
+          other.clear(), backslash.clear(), moves.clear();
+          for ( node_set::const_iterator x = from.begin(); x != from.end(); ++x )
+          {
+            if ( *x >= n )
+            {
+              other.push_back(*x), backslash.push_back(*x);
+              continue;
+            }
+            const node& nd = nodes[*x];
+            if ( nd.c == '*' )
+              other.push_back(*x);
+            closure(other, nd.any);
+            // a pattern without the leading '\' ends at a component
+            if ( nd.pattern != no_pattern && nd.c != '\\' )
+              backslash.push_back(n + nd.pattern);
+            for ( uint32_t c = nd.first_child; c != no_pattern; c = nodes[c].next_sibling )
+              if ( nodes[c].c != '*' && nodes[c].c != '?' )
+                moves.push_back(std::make_pair(nodes[c].c, c));
+          }
+          moves.push_back(std::make_pair(static_cast<uint16_t>('\\'), none));
+          std::sort(moves.begin(), moves.end());
+
+          state cur = { 0, static_cast<uint32_t>(edge_chars.size()), 0, pattern(from) };
+          set = other;
+          const uint32_t otherwise = intern(set);
+          cur.other = otherwise == dead ? uint32_t(dead) : base + otherwise;
+          for ( size_t i = 0; i != moves.size(); )
+          {
+            const uint16_t c = moves[i].first;
+            set = c == '\\' ? backslash : other;
+            for ( ; i != moves.size() && moves[i].first == c; ++i )
+              if ( moves[i].second != no_pattern )
+                closure(set, moves[i].second);
+            const uint32_t to = intern(set);
+            if ( to != otherwise )
+              edge_chars.push_back(c), edge_targets.push_back(to == dead ? uint32_t(dead) : base + to);
+          }
+          st.push_back(cur);
+        }
+        return base + start;
+      }
+    };
+
+    bool compile(std::vector<key>& keys, uint32_t count)
+    {
+      std::sort(keys.begin(), keys.end());
+      bool globs = false;
+      for ( std::vector<key>::const_iterator k = keys.begin(); k != keys.end(); ++k )
+        globs |= k->glob();
+
+      // the literal patterns and the globs make two automata, so the globs don't multiply the states of the literal trie
+      std::vector<uint32_t> alphabet(0x10000 / 32);
+      std::vector<state> st;
+      std::vector<uint32_t> edge_targets;
+      std::vector<uint16_t> edge_chars;
+      const state nothing = { 0, 0, dead, no_pattern };
+      st.push_back(nothing);
+      uint32_t starts[2] = { dead, dead };
+      for ( int g = 0; g != 1 + globs; ++g )
+      {
+        compiler cc;
+        cc.trie(keys, g != 0, alphabet);
+        starts[g] = cc.construct(st, edge_targets, edge_chars);
+        if ( starts[g] == dead )
+          return false;
+      }
+      const state end = { 0, static_cast<uint32_t>(edge_chars.size()), dead, no_pattern };
+      st.push_back(end);
+
+      // the chain of the states with a single edge and nothing else, e.g. the tail of a path, becomes the label of its first state;
+      // the rest are numbered in the depth-first order, so the walk of a path reads the adjacent states
+      const uint32_t total = static_cast<uint32_t>(st.size() - 1), none = no_pattern;
+      std::vector<uint32_t> refs(total), id(total, none), order;
+      std::vector<bool> chained(total);
+      refs[starts[0]]++, refs[starts[1]]++;
+      for ( uint32_t s = 0; s != total; ++s )
+      {
+        refs[st[s].other]++;
+        for ( uint32_t e = st[s].edges; e != st[s + 1].edges; ++e )
+          refs[edge_targets[e]]++;
+      }
+      for ( uint32_t s = start; s != total; ++s )
+      {
+        if ( st[s + 1].edges - st[s].edges != 1 || st[s].other != dead || st[s].pattern != no_pattern )
+          continue;
+        const uint32_t to = edge_targets[st[s].edges];
+        if ( to != s && to != dead && refs[to] == 1 && to != starts[0] && to != starts[1] )
+          chained[to] = true;
+      }
+      id[dead] = 0;
+      order.push_back(dead);
+      std::vector<uint32_t> stack;
+      if ( globs )
+        stack.push_back(starts[1]);
+      stack.push_back(starts[0]);
+      while ( !stack.empty() )
+      {
+        uint32_t s = stack.back();
+        stack.pop_back();
+        if ( id[s] != none )
+          continue;
+        id[s] = static_cast<uint32_t>(order.size());
+        order.push_back(s);
+        while ( st[s + 1].edges - st[s].edges == 1 && chained[edge_targets[st[s].edges]] )
+          s = edge_targets[st[s].edges];
+        stack.push_back(st[s].other);
+        for ( uint32_t e = st[s + 1].edges; e != st[s].edges; --e )
+          stack.push_back(edge_targets[e - 1]);
+      }
+
+      std::vector<state> packed;
+      std::vector<uint32_t> packed_targets;
+      std::vector<uint16_t> packed_chars, label_chars;
+      for ( std::vector<uint32_t>::const_iterator o = order.begin(); o != order.end(); ++o )
+      {
+        uint32_t s = *o;
+        state cur = { static_cast<uint32_t>(label_chars.size()), static_cast<uint32_t>(packed_chars.size()), 0, 0 };
+        while ( st[s + 1].edges - st[s].edges == 1 && chained[edge_targets[st[s].edges]] )
+        {
+          label_chars.push_back(edge_chars[st[s].edges]);
+          s = edge_targets[st[s].edges];
+        }
+        cur.other = id[st[s].other];
+        cur.pattern = st[s].pattern;
+        for ( uint32_t e = st[s].edges; e != st[s + 1].edges; ++e )
+          packed_chars.push_back(edge_chars[e]), packed_targets.push_back(id[edge_targets[e]]);
+        packed.push_back(cur);
+      }
+      const state last = { static_cast<uint32_t>(label_chars.size()), static_cast<uint32_t>(packed_chars.size()), dead, no_pattern };
+      packed.push_back(last);
+
+      // the case folding of the characters the patterns have
+      std::vector<uint16_t> from, to;
+      for ( uint32_t c = 0x80; c != 0x10000; ++c )
+      {
+        const uint16_t u = upcase(static_cast<uint16_t>(c));
+        if ( u != c && (alphabet[u / 32] & (1u << (u % 32))) )
+          from.push_back(static_cast<uint16_t>(c)), to.push_back(u);
+      }
+
+      // the single allocation: the states, the edge targets, the edge characters, the labels and the folding pairs
+      const size_t state_words = packed.size() * sizeof(state) / sizeof(uint32_t), edges = packed_chars.size();
+      const size_t units = edges + label_chars.size() + from.size() * 2;
+      uint32_t* const b = new (std::nothrow) uint32_t[state_words + edges + (units + 1) / 2];
+      if ( !b )
+        return false;
+      delete[] blob;
+      blob = b;
+      states = reinterpret_cast<state*>(b);
+      targets = b + state_words;
+      chars = reinterpret_cast<uint16_t*>(targets + edges);
+      labels = chars + edges;
+      fold_from = labels + label_chars.size();
+      fold_to = fold_from + from.size();
+      std::copy(packed.begin(), packed.end(), states);
+      std::copy(packed_targets.begin(), packed_targets.end(), targets);
+      std::copy(packed_chars.begin(), packed_chars.end(), chars);
+      std::copy(label_chars.begin(), label_chars.end(), labels);
+      std::copy(from.begin(), from.end(), fold_from);
+      std::copy(to.begin(), to.end(), fold_to);
+      folds = static_cast<uint32_t>(from.size());
+      glob_start = globs ? id[starts[1]] : uint32_t(dead);
+      patterns = count;
+      return true;
+    }
+
+    uint32_t* blob;
+    state*    states;
+    uint32_t* targets;
+    uint16_t* chars;
+    uint16_t* labels;
+    uint16_t* fold_from;
+    uint16_t* fold_to;
+    uint32_t  folds;
+    uint32_t  glob_start;
+    size_t    patterns;
+};
+
+}//namespace ntl
+
+#endif//#ifndef NTL__PATH_MATCHER
@@ -339,8 +339,11 @@ void __stdcall _CxxThrowException(void * object, _s__ThrowInfo const * info)
   std::array<uintptr_t, 3> args = { _EH_MAGIC, (uintptr_t)object, (uintptr_t)info };
 #endif
 #ifdef _M_X64
-  void* imagebase;
-  ntl::nt::RtlPcToFileHeader(info, &imagebase);
+  // RtlPcToFileHeader takes the loader lock, the throw info is mostly in this module
+  void* imagebase = pe::image::this_module();
+  const uintptr_t rva = (uintptr_t)info - (uintptr_t)imagebase;
+  if(rva >= pe::image::this_module()->get_nt_headers()->OptionalHeader64.SizeOfImage)
+    ntl::nt::RtlPcToFileHeader(info, &imagebase);
   std::array<uintptr_t, 4> args = { _EH_MAGIC, (uintptr_t)object, (uintptr_t)info, (uintptr_t)imagebase};
   const throwinfo* ti = reinterpret_cast<const throwinfo*>(info);
   if(info && (ti->e8 || !imagebase))
@@ -4,6 +4,7 @@
 #include "../pe/image.hxx"
 #include "../nt/exception.hxx"
 #include "../nt/status.hxx"
+#include "../atomic.hxx"
 
 #ifdef NTL__SUBSYSTEM_KM
 # include "../km/new.hxx"
@@ -361,7 +362,8 @@ namespace ntl { namespace cxxruntime
         if(!(*type == srctype))
           continue;
 
-        static const int* nil = 0;
+        // the offset of the source base in bytes
+        static const char* nil = 0;
         if(base->thiscast(nil)-nil != ptrdelta)
           continue;
 
@@ -425,6 +427,83 @@ namespace ntl { namespace cxxruntime
   #pragma pack(pop, rttidata)
 
 
+  /**
+   *	The results of dynamic_cast by the vftable of the object, the adjustment of
+   *  the vftable and the types. The result is the offset from the object, it does
+   *  not change for the same vftable unless the object has a vtordisp.
+   *
+   *  The cache is direct-mapped and lock-free: the entry is versioned, the version
+   *  is odd while the entry is written and the reader retries nothing, the entry
+   *  which is being written or has changed while it was read is a miss.
+   *
+   *  The entry keeps the generation of type_cache_epoch() read before the cast
+   *  was resolved, flush_type_caches() makes the entries of the unloaded modules
+   *  misses before their addresses are reused.
+   **/
+  class cast_cache
+  {
+    enum { bits = 8, size = 1 << bits };
+
+    struct entry
+    {
+      volatile uint32_t version;
+      int32_t           vfdelta;
+      uint32_t          epoch;
+      const void*       vftable;
+      const typeinfo*   srctype;
+      const typeinfo*   desttype;
+      ptrdiff_t         offset;
+    };
+
+    entry entries[size];
+
+    static uint32_t index(const void* vftable, int32_t vfdelta, const typeinfo& srctype, const typeinfo& desttype)
+    {
+      const uint64_t h = reinterpret_cast<uintptr_t>(vftable) ^ reinterpret_cast<uintptr_t>(&desttype) << 1
+        ^ reinterpret_cast<uintptr_t>(&srctype) >> 3 ^ static_cast<uint32_t>(vfdelta);
+      return (static_cast<uint32_t>(h ^ h >> 32) * 0x9E3779B1u) >> (32 - bits);
+    }
+
+  public:
+    /// the offset of the failed cast
+    static const ptrdiff_t failed = static_cast<ptrdiff_t>(~(~size_t() >> 1));
+
+    bool find(uint32_t epoch, const void* vftable, int32_t vfdelta, const typeinfo& srctype, const typeinfo& desttype, ptrdiff_t& offset) const
+    {
+      const entry& e = entries[index(vftable, vfdelta, srctype, desttype)];
+      const uint32_t version = e.version;
+      if ( version & 1 )
+        return false;
+      intrinsic::_ReadWriteBarrier();
+      const bool hit = e.vftable == vftable && e.srctype == &srctype && e.desttype == &desttype && e.vfdelta == vfdelta && e.epoch == epoch;
+      const ptrdiff_t cached = e.offset;
+      intrinsic::_ReadWriteBarrier();
+      if ( !hit || e.version != version )
+        return false;
+      offset = cached;
+      return true;
+    }
+
+    void insert(uint32_t epoch, const void* vftable, int32_t vfdelta, const typeinfo& srctype, const typeinfo& desttype, ptrdiff_t offset)
+    {
+      entry& e = entries[index(vftable, vfdelta, srctype, desttype)];
+      const uint32_t version = e.version;
+      // the entry which is being written is left to its writer
+      if ( (version & 1) || atomic::compare_exchange(e.version, version + 1, version) != version )
+        return;
+      intrinsic::_ReadWriteBarrier();
+      e.vftable = vftable;
+      e.vfdelta = vfdelta;
+      e.srctype = &srctype;
+      e.desttype = &desttype;
+      e.offset = offset;
+      e.epoch = epoch;
+      intrinsic::_ReadWriteBarrier();
+      atomic::exchange(e.version, version + 2);
+    }
+  };
+
+  static cast_cache dynamic_casts;
 
 }} // namespaces
 
@@ -436,6 +515,17 @@ namespace {
   {
     using namespace ntl::cxxruntime;
     __try {
+      const void* const vftable = *reinterpret_cast<const void* const*>(object);
+      const uint32_t epoch = type_cache_epoch();
+      ptrdiff_t offset;
+      if(dynamic_casts.find(epoch, vftable, vfdelta, srctype, desttype, offset)){
+        if(offset != cast_cache::failed)
+          return ntl::padd(object, offset);
+        if(isreference)
+          __ntl_throw(std::bad_cast(/*"Bad dynamic_cast<>"*/));
+        return nullptr;
+      }
+
       const object_locator2& locator = object_locator2::instance(object);
       locator.validate();
 
@@ -451,13 +541,15 @@ namespace {
       throwbase module_base(imagebase);
 
       // adjust object ptr by vptr diplacement
+      const void* const source = object;
       object = ntl::padd(object, -vfdelta);
       const base_class2* base = locator.find_instance(complete, (const char*)object - (const char*)complete, srctype, desttype, &module_base);
 
-      const void* result;
-      if(base)
-        result = base->thiscast(complete);
-      else {
+      const void* result = base ? base->thiscast(complete) : nullptr;
+      // the complete object of vtordisp depends on the construction state
+      if(!locator.cdoffset)
+        dynamic_casts.insert(epoch, vftable, vfdelta, srctype, desttype, base ? (const char*)result - (const char*)source : cast_cache::failed);
+      if(!base){
         result = nullptr;
         if(isreference)
           __ntl_throw(std::bad_cast(/*"Bad dynamic_cast<>"*/));
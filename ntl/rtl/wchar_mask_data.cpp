@@ -1,144 +1,712 @@
+// ctype<wchar_t> masks, generated by wchar_mask_gen.pl: do not edit.
+//
+// The mask of the character c is
+//   __wchar_mask_classes[__wchar_mask_pages[__wchar_mask_index[c >> 6]][c & 63]]
+// __wchar_mask_span numbers the spans of the adjacent pages of one class, it is 0 for the page of the different classes.
+// 14 classes, 153 distinct pages of 64 characters, 12124 bytes.
+
+#include "../stlx/cstdint.hxx"
+
 namespace std { namespace __ {
 
-const unsigned wchar_masks_size = 4128;
-extern const unsigned char wchar_masks[wchar_masks_size];
+extern "C" const int16_t __wchar_mask_classes[14] = {
+  0x0000,0x0004,0x0008,0x0010,0x0020,0x0028,0x0048,0x0068,0x0084,0x0100,0x0101,0x0102,0x0181,0x0182
+};
 
-extern "C" bool __wchar_masks_data(const unsigned char*& masks, unsigned& size)
-{
-  masks = wchar_masks,
-    size = wchar_masks_size;
-  return true;
-}
+extern "C" const int16_t __wchar_mask_ascii[128] = {
+  0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0068,0x0028,0x0028,0x0028,0x0028,0x0020,0x0020,
+  0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,0x0020,
+  0x0048,0x0010,0x0010,0x0010,0x0000,0x0010,0x0010,0x0010,0x0010,0x0010,0x0010,0x0000,0x0010,0x0010,0x0010,0x0010,
+  0x0084,0x0084,0x0084,0x0084,0x0084,0x0084,0x0084,0x0084,0x0084,0x0084,0x0010,0x0010,0x0000,0x0000,0x0000,0x0010,
+  0x0010,0x0181,0x0181,0x0181,0x0181,0x0181,0x0181,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,
+  0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0101,0x0010,0x0010,0x0010,0x0000,0x0010,
+  0x0000,0x0182,0x0182,0x0182,0x0182,0x0182,0x0182,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,
+  0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0102,0x0010,0x0000,0x0010,0x0000,0x0020
+};
 
-const unsigned char wchar_masks[wchar_masks_size] = {
-  0x03,0xb2,0xc4,0x20,0x00,0x0d,0x10,0x68,0x00,0x28,0x04,0x08,0x0f,0xd8,0xd1,0x0f,0x04,0x48,0x00,0x10,0x02,0x02,0x00,0x04,0x0e,0x0d,0x1a,0x9e,0x84,0x10,0x02,0x03,
-  0x42,0x01,0x00,0x01,0x12,0x81,0x01,0x07,0x01,0x43,0x25,0x00,0x07,0x65,0x00,0x00,0x82,0x01,0x07,0x01,0x02,0x7f,0x24,0x01,0x05,0x3b,0x09,0xc9,0xa3,0x77,0x91,0x7f,
-  0x0d,0x00,0x83,0x2f,0x20,0xbf,0x8e,0x0a,0x83,0x39,0x85,0x0f,0x83,0x7f,0x26,0x79,0x02,0x00,0x00,0x8c,0x17,0xff,0xa5,0x77,0x85,0x00,0x81,0x3d,0x8b,0x00,0x81,0x21,
-  0xff,0x00,0xe7,0x00,0x7f,0x08,0xff,0xfd,0x00,0xcb,0x1a,0x4b,0x04,0x45,0x01,0xc5,0x21,0xc5,0x02,0x4d,0x06,0x49,0x04,0xdf,0xd1,0x16,0xd1,0x13,0x47,0x04,0xc0,0x61,
-  0xc6,0x11,0x00,0x44,0x00,0xc0,0x76,0xff,0xc2,0x07,0x49,0x01,0xff,0x49,0x43,0x09,0x47,0x13,0xcd,0x2b,0xff,0x00,0x7f,0x00,0xff,0x27,0x2d,0x67,0x4e,0x69,0x21,0x27,
-  0x13,0xfd,0x06,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x34,0x67,0x7f,0x04,0xf4,0x06,0x3f,0x00,0x46,0x84,0xfd,0x03,0x11,0x00,0xb9,0x04,0xff,0x3b,0x07,0x7b,0x0e,0x3f,
-  0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x7f,0x2b,0xff,0x6e,0x1e,0xa7,0xc0,0xca,0x02,0x20,0x02,0xe7,0xac,0x63,0xad,0x67,0x53,0xbf,0xb2,0xff,0x3f,0xb3,0x3f,
-  0x00,0xf1,0xb5,0xeb,0x8e,0x7f,0x00,0xf1,0x67,0x61,0x01,0xe1,0x14,0xff,0xe9,0x6e,0x1f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x7f,0x10,0x1f,0x00,0x1f,0x00,0xff,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x3f,0x0f,0x3f,0x00,0x3f,0x00,0x3b,0x00,0x58,0x30,0xff,0x92,0x00,0x3f,0x02,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x5f,0x4f,
-  0xff,0x3f,0x5e,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x36,0x12,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xbf,0x31,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0xff,0x94,0x36,0x01,0x05,0x9b,0xa6,0x3f,0x21,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x15,0x37,0xff,0xd7,0xa9,0x1f,0x52,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x13,0x00,0x70,0x06,0xff,0x32,0x00,0x5a,0x00,0xff,0x59,0x1f,0x00,0x1f,0x00,0x5f,0x4f,0xfa,0x03,0x3e,0x0d,0xff,0x06,0x00,0x75,0xac,0x0d,0x00,0x16,0x03,0x5f,0x05,
-  0xb4,0xb3,0x36,0x02,0xdf,0x07,0xbf,0x1f,0x00,0xff,0x09,0xff,0x0d,0x1f,0x00,0x1f,0x00,0x7e,0x04,0x04,0x1f,0x00,0xff,0xb7,0x21,0xff,0x02,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xb6,0x22,0x1b,0x00,0x30,0x1b,0x7f,0x02,0xf7,0x36,0x4c,0x15,0x00,0xdf,0x11,0x04,
-  0xf5,0x01,0xbe,0x34,0x1d,0x00,0x32,0xcc,0xff,0xff,0x05,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xfb,0x21,0x5f,0x01,0xff,0x1f,0x00,0x1f,0x00,0x5f,0x26,
-  0x0f,0x00,0xff,0x35,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x7f,0x08,0x0a,0x00,0xdf,0x19,0xf6,0x19,0x1f,0x00,0x1f,0x00,0x1f,0x1f,0x00,0x1f,0x00,
-  0x78,0x08,0x76,0x31,0x06,0x00,0x94,0xb1,0xfa,0x00,0xff,0x01,0x01,0x7f,0x00,0x6c,0x00,0x65,0x1d,0xcb,0x09,0x5a,0x2b,0xa0,0x10,0x00,0x10,0x00,0x04,0x50,0x00,0x10,
-  0xdd,0x3c,0xff,0xc5,0x02,0x4f,0x16,0xc5,0x09,0xed,0x48,0x4d,0x0b,0xc1,0x03,0x4b,0x1d,0x53,0x14,0xff,0xd1,0x1b,0xcf,0x2d,0x49,0x30,0x4c,0x47,0xd1,0x3f,0x52,0x11,
-  0xd1,0x42,0x2b,0x12,0xff,0xab,0x0c,0xff,0x1f,0xfd,0x1f,0xad,0x00,0x23,0x19,0xfd,0x0d,0x7b,0x37,0xa9,0x21,0xff,0x02,0x00,0xf6,0x1f,0xb9,0x09,0xf7,0x3f,0x79,0x43,
-  0xff,0x1f,0xf3,0x1f,0xfb,0x5f,0xff,0xed,0x0d,0x2b,0x3e,0xbd,0x21,0xf3,0x1f,0x1f,0x00,0xff,0x5f,0xff,0x1f,0xff,0x1f,0xff,0xfd,0x1f,0xff,0x3f,0x6b,0x59,0xed,0x24,
-  0xf7,0x1f,0x3d,0x28,0xef,0x13,0xeb,0x75,0xff,0xad,0x71,0x67,0x4f,0xef,0x16,0x2b,0x12,0xf9,0x9a,0x77,0x9b,0xb7,0x7f,0x7c,0x19,0xff,0xff,0x3f,0xff,0x3f,0x7f,0x1c,
-  0x9f,0x01,0x1f,0x00,0x7f,0x03,0x5f,0x01,0xff,0x0f,0xff,0x1f,0x02,0xff,0x0f,0xdf,0x1f,0x5f,0x01,0xff,0x0f,0xff,0x0f,0x0f,0x00,0xff,0x1f,0xff,0xff,0x08,0x9f,0x01,
-  0x1f,0x00,0x7f,0x03,0x3f,0x01,0xff,0x0f,0x1f,0x02,0xff,0x06,0xff,0x5f,0x0a,0xdf,0x20,0xff,0x3f,0xff,0x0f,0x0f,0x00,0x9f,0x05,0x1f,0x09,0xff,0x08,0xff,0x1f,0x00,
-  0x1f,0x00,0xff,0x02,0x1f,0x00,0xff,0x1f,0x5c,0x3f,0xff,0x0f,0xff,0x2f,0xff,0x5f,0x11,0xdf,0x0f,0xff,0x0f,0x0f,0x00,0xff,0x0f,0x1f,0x00,0x7f,0x3a,0x1f,0x00,0xff,
-  0x1f,0x00,0x1f,0x11,0x5f,0x81,0x3f,0x30,0x5f,0x7e,0x1b,0x03,0x7f,0x04,0x0f,0x00,0xff,0xff,0x0d,0xf0,0x91,0x0f,0x00,0x3f,0x06,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0xff,0x1f,0x00,0x5f,0x0b,0xdf,0x07,0x1f,0x00,0x3f,0x9d,0x33,0x9d,0xdf,0x0c,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0xfc,0x5c,0xbd,0x00,0x5f,0x12,0x1f,0x18,0x59,
-  0x2b,0x5d,0x04,0xff,0x1f,0x00,0xff,0x7d,0xff,0x1d,0x3f,0x9d,0x3f,0x2d,0xdf,0x40,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x56,0x0e,0x31,0x15,0x1f,0x00,0x15,0x00,0xff,
-  0x36,0x3f,0x37,0x3f,0x37,0xff,0x9f,0x06,0x33,0x00,0x56,0x05,0x9f,0x11,0x7f,0x13,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x9f,0x1b,0x1f,0x00,0xbe,0x26,0x1f,0x04,0xdf,
-  0x03,0x1f,0x01,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0xdf,0x1b,0xdf,0x4d,0x75,0x19,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x01,0x0f,0x00,0x00,0x00,0x7e,0xb1,0xf4,
-  0x00,0x01,0x40,0x10,0x00,0x0e,0x16,0x09,0x22,0x03,0x1e,0x01,0x00,0xeb,0x0b,0x1a,0x02,0x00,0x04,0x10,0x01,0x10,0x08,0x01,0x14,0x6f,0x86,0x00,0xfe,0x01,0x48,0x00,
-  0x13,0x30,0xd1,0x00,0x82,0xab,0xd8,0x2f,0x7f,0x00,0xdc,0x9b,0xff,0x7f,0x47,0x7f,0x00,0x7f,0x24,0x7f,0x00,0x7d,0x2b,0xff,0x2b,0x3f,0x00,0x3f,0x00,0xff,0xb5,0x89,
-  0xef,0x13,0xe3,0x56,0xf7,0x03,0x3f,0x00,0x3f,0x00,0xff,0x0b,0x3f,0x00,0xff,0xff,0x09,0xff,0x19,0x3d,0xad,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x13,0x3f,0x00,0xff,
-  0x3f,0x00,0x3f,0x00,0x33,0x58,0x20,0x01,0xa9,0xc5,0x22,0xc6,0x1f,0x00,0xff,0x5f,0xff,0x7f,0xcd,0xff,0x07,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3d,0x19,0x9f,
-  0x02,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xbf,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x3e,0xae,0xdf,0xc3,0xcf,0x4f,0x48,0x3f,0x02,0xff,0x1f,0x00,0xbf,0x05,0x77,0x66,
-  0xdf,0x01,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xf6,0x09,0x9f,0x70,0x0f,0x00,0xff,0x0b,0x7f,0x7f,0xff,0xbf,0x13,0xff,0x03,
-  0x1f,0x00,0x1f,0x00,0x1f,0x09,0xff,0x03,0x1f,0x00,0xdf,0x07,0xff,0xff,0x03,0x1f,0x00,0xfa,0x0b,0x15,0xe9,0x0f,0x00,0xff,0x03,0x1f,0x00,0x1f,0x00,0xc7,0x1f,0x00,
-  0x1f,0x00,0x1e,0x00,0x20,0x00,0x20,0xbf,0x06,0x1f,0x00,0xdf,0x1f,0x00,0x1b,0x1d,0x97,0x1d,0x34,0x0d,0xdf,0xf3,0x04,0x3f,0x0e,0x0f,0x00,0x01,0x06,0x00,0x89,0xb1,
-  0x24,0x10,0x00,0x11,0x10,0x00,0x01,0x01,0x08,0x48,0x00,0xf8,0x00,0x00,0x04,0x10,0x04,0x0a,0x00,0x02,0x52,0xa8,0x02,0x0d,0x00,0xff,0xe1,0x31,0x7f,0x00,0x17,0x00,
-  0x7d,0x39,0xdd,0x40,0xe4,0x48,0x41,0x9d,0xd2,0x9a,0xff,0xfd,0x61,0x5d,0x65,0x7f,0x7b,0xdb,0x36,0xfc,0x0f,0xd9,0xdf,0x42,0xea,0xff,0x7f,0xff,0x3f,0x00,0x74,0x14,
-  0xff,0x0f,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x3f,0xff,0x3f,0x00,
-  0x3f,0x00,0x3f,0x00,0x7f,0x60,0xf1,0x5f,0x6c,0xd5,0xbf,0x1a,0x7f,0xb2,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,
-  0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,
-  0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xcf,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x00,0x00,0x02,0x01,0x1f,0x00,0x1f,
-  0x00,0xff,0x1f,0x00,0x1f,0x00,0x1b,0x00,0x1f,0x38,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0xdf,0x07,0x1f,0x00,0x77,0x09,0x3f,0x01,0x1f,0x00,0x1f,
-  0x00,0xdf,0x0d,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xdf,0x4a,0x0f,0x00,0x0f,0x00,0xf7,0x0f,0x00,0x0f,0x00,0x5f,0x52,0x01,0xd0,0x0c,0x3f,0x00,
-  0x3f,0x00,0x3f,0x00,0xff,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,
-  0x35,0x00,0x1a,0x20,0x25,0x14,0xff,0x7f,0x02,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x3f,0x00,0x3e,0x00,0xff,0x3f,0x17,0x00,
-  0x0d,0x00,0x3d,0x0f,0xb9,0x01,0xff,0x03,0xff,0xff,0x03,0xff,0x01,0xff,0x01,0xff,0x05,0xff,0x05,0x37,0x02,0x71,0x01,0x37,0x00,0xff,0xff,0x05,0xff,0x05,0x1f,0x00,
-  0xf7,0x06,0x9f,0x3d,0xbf,0x45,0xff,0x01,0xff,0x01,0xff,0xff,0x01,0xfd,0x01,0xb3,0x06,0xb6,0x0d,0xf2,0x00,0x39,0x18,0xff,0x01,0xf9,0x09,0x7f,0xb5,0x00,0xb9,0x11,
-  0xff,0x0b,0xf9,0x0f,0x3d,0x1e,0xff,0x05,0x01,0x00,0xaa,0xb1,0x54,0x48,0x00,0x11,0x10,0x20,0x06,0x08,0x10,0x2c,0x04,0x08,0xeb,0x00,0x02,0x07,0x7a,0x48,0x26,0x6e,
-  0x00,0x32,0x1b,0x07,0xa9,0x09,0x00,0xf3,0x07,0x7f,0x01,0x17,0x02,0x01,0x0a,0x1c,0x06,0x00,0x01,0x3f,0x15,0x1b,0xfb,0x85,0x0f,0x00,0x00,0x01,0x86,0x00,0x73,0x00,
-  0x87,0x3f,0xb3,0x00,0x21,0x31,0xd3,0x46,0x09,0x43,0x02,0x02,0x01,0x03,0x00,0x02,0x40,0x00,0x45,0x02,0xff,0x47,0x09,0x84,0x04,0x00,0x00,0xcd,0x10,0xc7,0x00,0xc5,
-  0x07,0xc5,0x0f,0x42,0x10,0xff,0x44,0x00,0xc3,0x5c,0xc5,0x16,0x49,0x10,0xc1,0x04,0x41,0x00,0x45,0x04,0x59,0x67,0xff,0x3f,0x00,0x4b,0x2f,0xff,0x1a,0x3f,0x00,0x3f,
-  0x00,0x3f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xe4,0xa6,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,
-  0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,
-  0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xdf,0x87,0x1f,0x00,0x76,0xe4,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0x0f,0x00,0x0f,0x00,0x7f,0x93,0x7f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xbf,0x0f,0x0f,0x00,0x0f,0x00,0x01,0x00,0x59,0xb1,0xfa,0x00,0x02,0x03,0x10,0x68,0x00,
-  0x3f,0x00,0x7f,0x2a,0x7f,0x21,0xff,0x10,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xdf,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x0b,0x00,0x01,0x0f,0x00,0x0f,0x00,0x0f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x00,0x00,0x00,0x00,0x02,0x01,0x5f,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x02,0xf0,0x05,0x01,0xff,0x50,0x00,0x03,0x00,0xf1,0x00,0xd3,0x00,0x33,0x00,0x7b,0x0e,0x33,0x01,0x5d,0x01,0xff,0xf5,0x03,0x3f,0x00,0x3f,0x00,0x3f,
-  0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3b,0x00,0x9f,0x0d,0x0f,0x00,0x1d,0x64,0x51,0x00,0xff,0x3f,0x15,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x08,0x05,0x16,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1e,0x00,0x0f,0x00,0x3f,0x01,0x1f,0x02,0x1f,0x00,0xff,0x1f,0x00,0x1f,
-  0x06,0xff,0x03,0xf3,0x01,0xff,0x00,0xff,0x00,0xff,0x00,0xff,0x00,0xff,0xff,0x00,0xff,0x00,0xff,0x08,0x0f,0x00,0x0f,0x00,0xdf,0x20,0x1f,0x00,0x1f,0x00,0xff,0x7c,
-  0x87,0xff,0x83,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0x0f,0x00,0x7f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0b,0x00,0x7b,0xb1,0xd8,0x48,0x00,0x10,0x02,0x10,0x00,0x00,0x01,0x00,0x10,
-  0x04,0xd0,0xff,0x0b,0x08,0x01,0x00,0x11,0x5c,0x05,0x6c,0x0e,0x00,0x01,0x92,0x04,0x02,0x00,0x42,0xff,0x07,0x1a,0x0a,0x42,0x06,0x76,0x08,0x2d,0x9e,0x01,0x86,0x93,
-  0x85,0x5b,0x8a,0x6f,0xff,0xff,0x00,0xa4,0x00,0x88,0x5a,0x52,0x6d,0x7f,0x00,0x48,0x16,0x7f,0x12,0x7f,0x00,0xff,0xfd,0x30,0x17,0x00,0x7f,0x14,0x3f,0x00,0xf9,0x27,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0xff,0x83,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x0f,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x01,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x90,
-  0xb0,0xfc,0x00,0x01,0x68,0x1b,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x01,0x00,0x5f,0x0a,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1c,0x00,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,
-  0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,
-  0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x15,0xb0,0xfc,0x00,0x01,0x74,0x1f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0x07,0x0f,0x00,0x0f,0x00,0x06,0x00,0xd6,0xb0,0xfc,0x00,0x01,0x16,0x19,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,
-  0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,
-  0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,
-  0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x01,0x00,0xbf,0x51,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0f,0x00,0x0f,0x00,0xff,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x3f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,
-  0x0c,0x00,0x4f,0xb1,0x3c,0x00,0x01,0x4c,0x10,0x2d,0x00,0x4d,0x7f,0x14,0x01,0x10,0x00,0xff,0x03,0x01,0xff,0x00,0x7f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,
-  0x3f,0x00,0xff,0x3f,0x00,0x3f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0xff,0xef,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,
-  0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x11,0x00,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,
-  0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x04,0xb0,0x04,0x00,0x01,0xfb,0x1f,0x1b,0xb0,0xfc,0x00,0x01,0x44,0x1f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,
-  0x00,0x3f,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x0f,0x00,0x00,0x00,0x03,0xb0,0x02,0x00,0xfc,0x0f,0x04,0xb0,0x04,0x20,0x00,0xfb,0x1f,0x04,0xb0,0x04,0x20,0x00,
-  0xfb,0x1f,0x04,0xb0,0x04,0x20,0x00,0xfb,0x1f,0x74,0xb1,0xe4,0x20,0x00,0xfb,0x11,0x00,0x01,0x7f,0x00,0x7f,0x00,0x7f,0x00,0xff,0x7f,0x00,0x7f,0x00,0x7f,0x00,0x7f,
-  0x00,0x7f,0x00,0x3f,0x00,0x3f,0x00,0x24,0x00,0xff,0x01,0x00,0xbf,0x04,0x3f,0x00,0x3f,0x00,0x31,0x0f,0x03,0x00,0x7f,0x05,0x3f,0x00,0x7f,0x3f,0x00,0x3f,0x00,0x3f,
-  0x00,0x3f,0x00,0xaf,0x1b,0x1f,0x00,0x1c,0x00,0x02,0xfe,0x01,0x29,0x00,0xbf,0x04,0x3f,0x2b,0x7a,0x2e,0x69,0x03,0x61,0x01,0xe3,0x01,0xff,0xa9,0x00,0x3f,0x00,0x3f,
-  0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0x3f,0x00,0xff,0x35,0xff,0x1f,0x00,0xbf,0x58,0x3f,0x00,0x3f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,
-  0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x7f,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1e,0x00,0x10,0xfc,
-  0x00,0x10,0x9f,0x2e,0x9f,0x2f,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x3f,0x08,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0xff,
-  0x1f,0x00,0xbf,0x42,0x0f,0x00,0x0f,0x00,0x0f,0x00,0xff,0x13,0x1f,0x00,0xff,0x01,0xff,0x1f,0x00,0x34,0x1a,0x1d,0x00,0xff,0x05,0x7f,0x0b,0x05,0x00,0xdf,0x03,0x1f,
-  0x00,0xff,0x1f,0x00,0x1f,0x07,0x3f,0x01,0xdb,0x01,0xf7,0x06,0xb3,0x02,0xff,0x0d,0xbf,0x0e,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,
-  0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x13,0x1b,0xf0,0xbf,0xbb,0x1f,0x16,0xda,0x00,0x04,0x1f,0x00,0xf8,0x15,0x91,0x00,
-  0x01,0x0f,0x00,0xbf,0x0f,0x00,0x0c,0x00,0x79,0x1b,0x1b,0x88,0x1f,0x00,0x1f,0x00,0x02,0xf0,0x03,0xff,0x97,0x1e,0x58,0x0b,0x3f,0x0e,0x1f,0x00,0x1f,0x00,0x1f,0x00,
-  0x1f,0x00,0x1f,0x00,0xff,0x1f,0x00,0x1f,0x00,0x1f,0x00,0x3f,0x18,0x3d,0x38,0xff,0x00,0xff,0x00,0x1f,0x37,0x1f,0x0f,0x00,0x0f,0x00,0x04,0x00,0x74,0xdf,0x04,0x00
+extern "C" const unsigned char __wchar_mask_index[1024] = {
+    0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 12, 26, 27, 28, 29, 30,
+   31, 31, 31, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+   60, 61, 62, 63, 12, 64, 65, 66, 12, 67, 68, 69, 70, 71, 72, 73, 74, 12, 12, 12, 12, 12, 12, 12, 12, 75, 76, 77, 78, 79, 80, 81,
+   82, 83, 84, 31, 85, 86, 87, 88, 89, 31, 31, 31, 12, 90, 31, 31, 31, 31, 31, 31, 91, 92, 93, 94, 95, 95, 96, 97, 98, 99,100,101,
+  102,103,104,105,106,107,108, 31, 31, 31, 31, 31,109, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,110, 31,111,
+   31, 31, 31, 31, 31, 31,112,113, 31, 31, 31, 31, 31, 31, 31, 31,114,115, 95,116,117,118,119,120,121, 31, 31, 31, 31, 31, 31, 31,
+  122, 74,123,124,125, 12,126,127, 31, 31, 31, 31, 31, 31, 31, 31, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,128, 31, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,129, 31,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,130, 31, 31, 31, 31, 31, 31, 31, 31, 31,131, 31, 31, 31,
+  132,133, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+   12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,134, 31,
+   31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+  135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,
+  135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,
+  135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,135,
+  135,135,135,135, 12, 12, 12, 12,136,137, 12,138,139,140, 29,141, 12, 12, 12, 12,142,143,144,145,146,147, 12,148,149,150,151,152
 };
+
+extern "C" const unsigned char __wchar_mask_span[1024] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,
+   3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 4, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0, 6, 6, 6, 6, 6, 6, 6, 6, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 7, 0, 0, 0, 0, 0, 8, 8, 8, 9, 0,10,10,10,10,10,10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0,11,11,11,11,11, 0,12,12,12,12,12,12,12,12,12,12,12,12,12,12,12,12, 0,13, 0,
+  14,14,14,14,14,14, 0, 0,15,15,15,15,15,15,15,15, 0, 0, 0, 0, 0, 0, 0, 0, 0,16,16,16,16,16,16,16,
+   0, 0, 0, 0, 0,17, 0, 0,18,18,18,18,18,18,18,18,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,
+  19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,
+  19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,
+  19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19,19, 0,20,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,
+  21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21,21, 0,22,
+  23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23,23, 0,24,24,24,24,24,24,24,24,24, 0,25,25,25,
+   0, 0,26,26,26,26,26,26,26,26,26,26,26,26,26,26,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,
+  27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,
+  27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,
+  27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,
+  27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,
+  27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27,27, 0,28,
+  28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,28,
+  29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,
+  29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,
+  29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,29,
+  29,29,29,29,30,30,30,30, 0, 0,31, 0, 0, 0, 0, 0,32,32,32,32, 0, 0, 0, 0, 0, 0,33, 0, 0, 0, 0, 0
+};
+
+extern "C" const unsigned char __wchar_mask_pages[153][64] = {
+  {
+   4, 4, 4, 4, 4, 4, 4, 4, 4, 7, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+   6, 3, 3, 3, 0, 3, 3, 3, 3, 3, 3, 0, 3, 3, 3, 3, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 3, 3, 0, 0, 0, 3
+  },
+  {
+   3,12,12,12,12,12,12,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10, 3, 3, 3, 0, 3,
+   0,13,13,13,13,13,13,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 3, 0, 3, 0, 4
+  },
+  {
+   4, 4, 4, 4, 4, 5, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+   6, 3, 0, 0, 0, 0, 0, 0, 0, 0,11, 3, 0, 4, 0, 0, 0, 0, 0, 0, 0,11, 0, 3, 0, 0,11, 3, 0, 0, 0, 3
+  },
+  {
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10, 0,10,10,10,10,10,10,10,11,
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 0,11,11,11,11,11,11,11,11
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,10,11,10,11,10,11,10
+  },
+  {
+  11,10,11,10,11,10,11,10,11,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,10,11,10,11,10,11,11
+  },
+  {
+  11,10,10,11,10,11,10,10,11,10,10,10,11,11,10,10,10,10,11,10,10,11,10,10,10,11,11,11,10,10,11,10,
+  10,11,10,11,10,11,10,10,11,10,11,11,10,11,10,10,11,10,10,10,11,10,11,10,10,11,11, 9,10,11,11,11
+  },
+  {
+   9, 9, 9, 9,10, 9,11,10, 9,11,10, 9,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,10, 9,11,10,11,10,10,10,11,10,11,10,11,10,11
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,11,11,11,11,11,10,10,11,10,10,11
+  },
+  {
+  11,10,11,10,10,10,10,11,10,11,10,11,10,11,10,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 9,11,11,11,11,11,11,11,11,11,11,11,
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9,11,11,11, 3, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0,10, 3,10,10,10, 0,10, 0,10,10,11,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,
+  10,10, 0,10,10,10,10,10,10,10,10,10,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 0,11,11,10,10,10,11,11,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,11,11,11,10,11, 0,10,11,10,10,11,11,10,10,10
+  },
+  {
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11
+  },
+  {
+  10,11, 0, 9, 9, 9, 9, 0, 9, 9,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11
+  },
+  {
+  10,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10
+  },
+  {
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10, 0, 0, 9, 3, 3, 3, 3, 3, 3,
+   0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11
+  },
+  {
+  11,11,11,11,11,11,11,11, 0, 3, 3, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 9
+  },
+  {
+   3, 9, 9, 3, 9, 9, 3, 9, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 9, 9, 9, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 0, 0, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 3, 0, 0, 3, 3,
+   0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0,
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 9, 9, 9, 9, 9, 9, 9, 9, 4, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 0, 0, 9
+  },
+  {
+   3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 4, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 3, 3, 3, 9, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9
+  },
+  {
+   0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 0, 0, 0, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 0, 0, 9, 9, 0, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 9, 9, 0, 9,
+   9, 9, 9, 9, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 0, 9, 9, 0, 9, 9, 0, 0, 9, 0, 9, 9
+  },
+  {
+   9, 9, 9, 0, 0, 0, 0, 9, 9, 0, 0, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 0, 9, 0,
+   0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 0, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 0, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 0, 0, 0, 9, 9, 0, 0, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 0, 0, 0, 0, 9, 9, 0, 9,
+   9, 9, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 0, 0, 0, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 0, 9, 9, 0, 9, 0, 9, 9,
+   0, 0, 0, 9, 9, 0, 0, 0, 9, 9, 9, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9
+  },
+  {
+   9, 9, 9, 0, 0, 0, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 9, 9, 0, 0, 0, 0, 0, 0, 0, 9, 0,
+   9, 9, 9, 9, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9
+  },
+  {
+   9, 9, 9, 9, 0, 0, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 9, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 0, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 0, 9, 0, 0, 9, 9, 0, 9, 0, 0, 9, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9,
+   0, 9, 9, 9, 0, 9, 0, 9, 0, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 0, 9, 0, 9, 9, 9, 9, 9, 9, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 9, 9, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 9, 9, 0, 0, 0, 0, 0, 0,
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 9, 0, 9, 3, 3, 3, 3, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 3, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 0, 9, 9, 9, 9, 9, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0
+  },
+  {
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10
+  },
+  {
+  10,10,10,10,10,10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 9, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 0, 9, 9, 9, 9, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 0
+  },
+  {
+   9, 0, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9,
+   0, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   6, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 0, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 4, 4, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 3, 9, 3, 3, 3, 0, 9, 9, 0, 0,
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 9, 9, 9, 6, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 3, 3,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 3, 3,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3,
+   3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,
+  11,11,11,11,11,11,11,11,11,11,11,11, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 9,11,11,11,11,11,11,11
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,11,11,11,11,11,11, 0, 0, 0, 0,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11, 0, 0, 0, 0, 0, 0
+  },
+  {
+  11,11,11,11,11,11,11,11,10,10,10,10,10,10,10,10,11,11,11,11,11,11, 0, 0,10,10,10,10,10,10, 0, 0,
+  11,11,11,11,11,11,11,11,10,10,10,10,10,10,10,10,11,11,11,11,11,11,11,11,10,10,10,10,10,10,10,10
+  },
+  {
+  11,11,11,11,11,11, 0, 0,10,10,10,10,10,10, 0, 0,11,11,11,11,11,11,11,11, 0,10, 0,10, 0,10, 0,10,
+  11,11,11,11,11,11,11,11,10,10,10,10,10,10,10,10,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 0, 0
+  },
+  {
+  11,11,11,11,11,11,11,11, 9, 9, 9, 9, 9, 9, 9, 9,11,11,11,11,11,11,11,11, 9, 9, 9, 9, 9, 9, 9, 9,
+  11,11,11,11,11,11,11,11, 9, 9, 9, 9, 9, 9, 9, 9,11,11,11,11,11, 0,11,11,10,10,10,10, 9, 0,11, 0
+  },
+  {
+   0, 0,11,11,11, 0,11,11,10,10,10,10, 9, 0, 0, 0,11,11,11,11, 0, 0,11,11,10,10,10,10, 0, 0, 0, 0,
+  11,11,11,11,11,11,11,11,10,10,10,10,10, 0, 0, 0, 0, 0,11,11,11, 0,11,11,10,10,10,10, 9, 0, 0, 0
+  },
+  {
+   6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+   3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 4, 4, 4, 4, 4, 6, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3
+  },
+  {
+   3, 3, 3, 3, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 6,
+   4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4, 0,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3,11
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 0, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0,10, 0, 0, 0, 0,10, 0, 0,11,10,10,10,11,11,10,10,10,11, 0,10, 0, 0, 0,10,10,10,10,10, 0, 0,
+   0, 0, 0, 0,10, 0,10, 0,10, 0,10,10,10,10, 0,11,10,10,10,10,11, 9, 9, 9, 9,11, 0, 0,11,11,10,10
+  },
+  {
+   0, 0, 0, 0, 0,10,11,11,11,11, 0, 0, 0, 0,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0,10,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 0, 0
+  },
+  {
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,
+  10,10,10,10,10,10,10,10,10,10,10,10,10,10,10, 0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 0,
+  10,11,10,10,10,11,11,10,11,10,11,10,11, 0, 0, 0, 0, 0, 0, 0,11,10,11,11, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+  10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,10,11,
+  10,11,10,11,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 0, 3, 3
+  },
+  {
+  11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,
+  11,11,11,11,11,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 3, 3, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   6, 3, 3, 3, 0, 9, 9, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 3, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 9, 9, 3, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 0, 0, 9, 9, 9,
+   3, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 9, 9, 9, 9
+  },
+  {
+   0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+   4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+   4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  },
+  {
+  11,11,11,11,11,11,11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,11,11,11,11,11, 0, 0, 0, 0, 0, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 0, 9, 0
+  },
+  {
+   9, 9, 0, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3
+  },
+  {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 0, 0
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0,
+   9, 9, 9, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3
+  },
+  {
+   3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+   3, 3, 0, 3, 0, 0, 0, 0, 3, 0, 3, 3, 0, 0, 0, 0, 9, 9, 9, 9, 9, 0, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0, 0, 4
+  },
+  {
+   0, 3, 3, 3, 0, 3, 3, 3, 3, 3, 3, 0, 3, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 0, 0, 0, 3,
+   3,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10, 3, 3, 3, 0, 3
+  },
+  {
+   0,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11, 3, 0, 3, 0, 3,
+   3, 3, 3, 3, 3, 3, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9
+  },
+  {
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9,
+   9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 0
+  },
+  {
+   0, 0, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 9, 9, 9, 0, 0, 9, 9, 9, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 0, 0, 0, 0
+  }
+};
+
 }}
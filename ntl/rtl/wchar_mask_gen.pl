@@ -0,0 +1,94 @@
+# Generates wchar_mask_data.cpp: the ctype<wchar_t> masks of the characters 0..0xFFFF
+# as the two-stage table of the 64-character pages.
+#
+# usage: perl wchar_mask_gen.pl masks.bin > wchar_mask_data.cpp
+#
+# masks.bin is 65536 little-endian 16-bit masks in the order of the characters,
+# i.e. GetStringTypeW(CT_CTYPE1) of every character.
+
+use strict;
+
+my $page_bits = 6;
+my $page_size = 1 << $page_bits;
+
+my $file = shift or die "usage: perl wchar_mask_gen.pl masks.bin > wchar_mask_data.cpp\n";
+open(IN, $file) or die "Can't open file: $!";
+binmode(IN);
+local $/;
+my @masks = unpack('s<*', <IN>);
+close(IN);
+die "$file: 65536 masks expected\n" unless @masks == 65536;
+
+# the distinct masks are the classes
+my %class;
+my @classes = sort { $a <=> $b } grep { !$class{$_}++ } @masks;
+%class = map { $classes[$_] => $_ } 0 .. $#classes;
+die "too many classes\n" if @classes >= 255;
+
+# the equal pages are stored once
+my (%page, @pages, @index, @uniform, @span);
+for ( my $c = 0; $c < 65536; $c += $page_size )
+{
+  my @p = map { $class{$_} } @masks[$c .. $c + $page_size - 1];
+  my $key = join(',', @p);
+  if ( !exists $page{$key} )
+  {
+    $page{$key} = scalar @pages;
+    push @pages, [@p];
+    my %distinct = map { $_ => 1 } @p;
+    push @uniform, keys(%distinct) == 1 ? $p[0] : 0xFF;
+  }
+  push @index, $page{$key};
+}
+die "too many pages\n" if @pages > 255;
+
+# the adjacent uniform pages of the same class are numbered as one span
+my $spans = 0;
+for ( my $p = 0; $p < @index; $p++ )
+{
+  my $u = $uniform[$index[$p]];
+  $spans++ if $u != 0xFF && ($p == 0 || $uniform[$index[$p - 1]] != $u);
+  $span[$p] = $u == 0xFF ? 0 : $spans;
+}
+die "too many spans\n" if $spans > 255;
+
+sub rows
+{
+  my ($format, $columns, @values) = @_;
+  my @rows;
+  push @rows, '  ' . join(',', map { sprintf($format, $_) } splice(@values, 0, $columns)) while @values;
+  return join(",\n", @rows);
+}
+
+my $bytes = @classes * 2 + 128 * 2 + @index * 2 + @pages * $page_size;
+print <<"END";
+// ctype<wchar_t> masks, generated by wchar_mask_gen.pl: do not edit.
+//
+// The mask of the character c is
+//   __wchar_mask_classes[__wchar_mask_pages[__wchar_mask_index[c >> $page_bits]][c & @{[$page_size - 1]}]]
+// __wchar_mask_span numbers the spans of the adjacent pages of one class, it is 0 for the page of the different classes.
+// @{[scalar @classes]} classes, @{[scalar @pages]} distinct pages of $page_size characters, $bytes bytes.
+
+#include "../stlx/cstdint.hxx"
+
+namespace std { namespace __ {
+
+extern "C" const int16_t __wchar_mask_classes[@{[scalar @classes]}] = {
+@{[rows('0x%04x', 16, map { $_ & 0xFFFF } @classes)]}
+};
+
+extern "C" const int16_t __wchar_mask_ascii[128] = {
+@{[rows('0x%04x', 16, map { $_ & 0xFFFF } @masks[0 .. 127])]}
+};
+
+extern "C" const unsigned char __wchar_mask_index[@{[scalar @index]}] = {
+@{[rows('%3u', 32, @index)]}
+};
+
+extern "C" const unsigned char __wchar_mask_span[@{[scalar @span]}] = {
+@{[rows('%2u', 32, @span)]}
+};
+
+extern "C" const unsigned char __wchar_mask_pages[@{[scalar @pages]}][$page_size] = {
+END
+print join(",\n", map { "  {\n" . rows('%2u', 32, @$_) . "\n  }" } @pages), "\n};\n\n}}\n";
@@ -0,0 +1,135 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Contiguous sequence view
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__SPAN
+#define NTL__SPAN
+#pragma once
+
+#ifndef NTL__STLX_ITERATOR
+#include "stlx/iterator.hxx"
+#endif
+#ifndef NTL__STLX_TYPE_TRAITS
+#include "stlx/type_traits.hxx"
+#endif
+#include "stlx/cassert.hxx"
+
+namespace ntl {
+
+/**
+ *	Non-owning view of the contiguous sequence of objects.
+ *  The iterators are the pointers, so the span works with any algorithm.
+ **/
+template<class T>
+class span
+{
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef T                                       element_type;
+    typedef typename std::remove_cv<T>::type        value_type;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+    typedef T *                                     pointer;
+    typedef T &                                     reference;
+    typedef T *                                     iterator;
+    typedef std::reverse_iterator<iterator>         reverse_iterator;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    span() __ntl_nothrow
+    : p(0), n(0)
+    {/**/}
+
+    span(pointer p, size_type n) __ntl_nothrow
+    : p(p), n(n)
+    {/**/}
+
+    span(pointer first, pointer last) __ntl_nothrow
+    : p(first), n(static_cast<size_type>(last - first))
+    {/**/}
+
+    template<size_t N>
+    span(element_type (&a)[N]) __ntl_nothrow
+    : p(a), n(N)
+    {/**/}
+
+    /** span<T> to span<const T> */
+    template<class U>
+    span(const span<U> & s) __ntl_nothrow
+    : p(s.data()), n(s.size())
+    {/**/}
+
+    ///\name iterators
+    iterator begin() const { return p; }
+    iterator end() const { return p + n; }
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    ///\name element access
+    reference operator[](size_type i) const { assert(i < n); return p[i]; }
+    reference front() const { assert(n); return p[0]; }
+    reference back() const { assert(n); return p[n - 1]; }
+    pointer data() const { return p; }
+
+    ///\name observers
+    size_type size() const { return n; }
+    size_type size_bytes() const { return n * sizeof(element_type); }
+    bool empty() const { return n == 0; }
+
+    ///\name subviews
+    span first(size_type count) const
+    {
+      assert(count <= n);
+      return span(p, count);
+    }
+
+    span last(size_type count) const
+    {
+      assert(count <= n);
+      return span(p + (n - count), count);
+    }
+
+    span subspan(size_type offset, size_type count = npos) const
+    {
+      assert(offset <= n);
+      return span(p + offset, count == npos || count > n - offset ? n - offset : count);
+    }
+    ///\}
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+    pointer   p;
+    size_type n;
+};
+
+template<class T>
+inline span<T> make_span(T * p, size_t n)
+{
+  return span<T>(p, n);
+}
+
+template<class T, size_t N>
+inline span<T> make_span(T (&a)[N])
+{
+  return span<T>(a);
+}
+
+/** Views the objects as bytes */
+template<class T>
+inline span<const uint8_t> as_bytes(const span<T> & s)
+{
+  return span<const uint8_t>(reinterpret_cast<const uint8_t*>(s.data()), s.size_bytes());
+}
+
+template<class T>
+inline span<uint8_t> as_writable_bytes(const span<T> & s)
+{
+  return span<uint8_t>(reinterpret_cast<uint8_t*>(s.data()), s.size_bytes());
+}
+
+}//namespace ntl
+
+#endif//#ifndef NTL__SPAN
@@ -0,0 +1,418 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Parallel initialization of the static objects
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__STATIC_INIT
+#define NTL__STATIC_INIT
+#pragma once
+
+#include "stlx/cassert.hxx"
+#include "stlx/cstdlib.hxx"
+#include "stlx/algorithm.hxx"
+#include "stlx/vector.hxx"
+#include "stlx/memory.hxx"
+#include "stlx/thread.hxx"
+#include "stlx/mutex.hxx"
+#include "nt/event.hxx"
+
+namespace ntl {
+
+/** How the object of parallel_static is torn down */
+enum static_teardown
+{
+  /** Destroyed at exit after the objects which depend on it */
+  destroy_on_exit,
+  /** Owns nothing but the process memory, e.g. a lookup table, so its destructor is skipped in the fast exit mode */
+  abandon_on_fast_exit
+};
+
+class static_objects;
+
+/**
+ *	Registration of a parallel_static object in the static_objects.
+ *
+ *  The node is a namespace scope object: its constructor runs by the CRT static initialization,
+ *  which is single-threaded, and only links the node into the registry, the heavy work is done later by static_objects::initialize().
+ *  The dependencies are the other nodes which should be initialized before this one and destroyed after it,
+ *  they may be defined in the other translation units.
+ **/
+class static_init_node
+{
+    static_init_node(const static_init_node&);
+    const static_init_node& operator=(const static_init_node&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    static const size_t max_dependencies = 4;
+
+    /** Is the object initialized and not destroyed yet */
+    bool ready() const { return ready_; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  protected:
+
+    typedef void action(static_init_node* node);
+
+    inline static_init_node(action* init, action* term, bool abandonable,
+      static_init_node* d1, static_init_node* d2, static_init_node* d3, static_init_node* d4);
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    friend class static_objects;
+
+    static_init_node* next;         // the registry
+    static_init_node* done_next;    // the initialized objects, the latest first
+    static_init_node* deps[max_dependencies];
+    action*           init;
+    action*           term;
+    size_t            index;        // position in the registry plus one, set by the scheduler
+    size_t            pending;      // dependencies not initialized yet
+    bool              abandonable;
+    volatile bool     ready_;
+};
+
+
+/**
+ *	Static object initialized in parallel with the other ones by static_objects::initialize().
+ *
+ *  The object is default constructed on a thread of the startup pool after the objects it depends on,
+ *  and destroyed at exit in the reverse order of the initialization, i.e. before its dependencies.
+ *  Until the initialization the object is not accessible, it is a usage error to touch it from the ordinary static initializers.
+ *  \code
+ *    ntl::parallel_static<crc_tables, ntl::abandon_on_fast_exit> crc;
+ *    ntl::parallel_static<codec_registry> codecs(crc);   // uses crc in its constructor
+ *
+ *    int main()
+ *    {
+ *      ntl::static_objects::initialize();
+ *      return codecs->run();
+ *    }
+ *  \endcode
+ *  @note The constructors of the objects run concurrently, so the objects which aren't the dependencies of each other
+ *  should not share the unsynchronized state. An exception escaping a constructor terminates the process.
+ **/
+template<class T, static_teardown Teardown = destroy_on_exit>
+class parallel_static:
+  public static_init_node
+{
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef T value_type;
+
+    parallel_static()
+      :static_init_node(construct, destroy, Teardown == abandon_on_fast_exit, 0, 0, 0, 0)
+    {}
+
+    explicit parallel_static(static_init_node& d1)
+      :static_init_node(construct, destroy, Teardown == abandon_on_fast_exit, &d1, 0, 0, 0)
+    {}
+
+    parallel_static(static_init_node& d1, static_init_node& d2)
+      :static_init_node(construct, destroy, Teardown == abandon_on_fast_exit, &d1, &d2, 0, 0)
+    {}
+
+    parallel_static(static_init_node& d1, static_init_node& d2, static_init_node& d3)
+      :static_init_node(construct, destroy, Teardown == abandon_on_fast_exit, &d1, &d2, &d3, 0)
+    {}
+
+    parallel_static(static_init_node& d1, static_init_node& d2, static_init_node& d3, static_init_node& d4)
+      :static_init_node(construct, destroy, Teardown == abandon_on_fast_exit, &d1, &d2, &d3, &d4)
+    {}
+
+    T& get()
+    {
+      assert(ready() && "parallel_static is used before static_objects::initialize()");
+      return *reinterpret_cast<T*>(&storage);
+    }
+
+    const T& get() const
+    {
+      assert(ready() && "parallel_static is used before static_objects::initialize()");
+      return *reinterpret_cast<const T*>(&storage);
+    }
+
+    T& operator*()              { return get(); }
+    const T& operator*() const  { return get(); }
+    T* operator->()             { return &get(); }
+    const T* operator->() const { return &get(); }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    static void construct(static_init_node* node)
+    {
+      ::new (&static_cast<parallel_static*>(node)->storage) T();
+    }
+
+    static void destroy(static_init_node* node)
+    {
+      static_cast<parallel_static*>(node)->get().~T();
+    }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+
+
+/**
+ *	Scheduler of the parallel_static objects.
+ *
+ *  initialize() is called once, usually at the start of main(). It builds the dependency graph of the registered objects
+ *  and constructs them by a pool of workers, the calling thread is one of them: an object is taken by a worker as soon as
+ *  all of its dependencies are initialized. The independent objects are taken in the order of their registration.
+ *  A cycle of the dependencies is a usage error; it is reported by assert and broken at the earliest registered object.
+ *
+ *  The teardown is registered by atexit() and runs before the destructors of the ordinary static objects,
+ *  destroying the objects in the reverse order of their initialization on the exiting thread.
+ *  In the fast exit mode the objects marked with \c abandon_on_fast_exit are skipped, the rest are destroyed in the same order.
+ **/
+class static_objects
+{
+    static_objects();
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    /**
+     *	Initializes the registered objects by \a threads workers including the calling thread,
+     *  zero means std::thread::hardware_concurrency().
+     *  @return the number of the objects initialized
+     **/
+    static size_t initialize(unsigned threads = 0)
+    {
+      state_type& st = state();
+      assert(!st.initialized && "static_objects::initialize() is called once");
+      if(st.initialized)
+        return 0;
+
+      scheduler s;
+      const size_t count = s.run(threads);
+      st.initialized = true;
+      std::atexit(teardown);
+      return count;
+    }
+
+    /** Have the objects been initialized */
+    static bool initialized() { return state().initialized; }
+
+    /** Skip the destructors of the objects marked with \c abandon_on_fast_exit at exit */
+    static void fast_exit_mode(bool enable = true) { state().fast_exit = enable; }
+
+    /** Is the fast exit mode on */
+    static bool fast_exit() { return state().fast_exit; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    friend class static_init_node;
+
+    // zero initialized before any static constructor runs
+    struct state_type
+    {
+      static_init_node* registry;
+      static_init_node* done;
+      bool initialized;
+      bool fast_exit;
+    };
+
+    static state_type& state()
+    {
+      static state_type s;
+      return s;
+    }
+
+    static void push_done(static_init_node* node)
+    {
+      state_type& st = state();
+      node->ready_ = true;
+      node->done_next = st.done;
+      st.done = node;
+    }
+
+    static void __cdecl teardown()
+    {
+      state_type& st = state();
+      while(static_init_node* node = st.done){
+        st.done = node->done_next;
+        if(st.fast_exit && node->abandonable)
+          continue;
+        node->term(node);
+        node->ready_ = false;
+      }
+    }
+
+    /** Object registered after the initialization, e.g. by a late loaded module, is initialized at once */
+    static void register_node(static_init_node* node)
+    {
+      state_type& st = state();
+      if(st.initialized){
+        for(size_t i = 0; i < static_init_node::max_dependencies; i++)
+          assert((!node->deps[i] || node->deps[i]->ready()) && "parallel_static depends on an uninitialized object");
+        node->init(node);
+        push_done(node);
+        return;
+      }
+      node->next = st.registry;
+      st.registry = node;
+    }
+
+    class scheduler
+    {
+      public:
+        scheduler()
+          :ready(nt::NotificationEvent), remaining(), running()
+        {}
+
+        size_t run(unsigned threads)
+        {
+          for(static_init_node* node = state().registry; node; node = node->next)
+            nodes.push_back(node);
+          state().registry = 0;
+          if(nodes.empty())
+            return 0;
+          std::reverse(nodes.begin(), nodes.end());
+          build();
+
+          unsigned workers = threads ? threads : std::thread::hardware_concurrency();
+          if(workers > nodes.size())
+            workers = static_cast<unsigned>(nodes.size());
+          if(!workers)
+            workers = 1;
+
+          const std::unique_ptr<std::thread[]> pool(new std::thread[--workers]);
+          for(unsigned i = 0; i < workers; i++){
+            std::thread t(&scheduler::worker, this);
+            pool[i].swap(t);
+          }
+          worker(this);
+          for(unsigned i = 0; i < workers; i++)
+            if(pool[i].joinable())
+              pool[i].join();
+          return nodes.size();
+        }
+
+      private:
+        bool known(const static_init_node* node) const
+        {
+          return node->index && node->index <= nodes.size() && nodes[node->index - 1] == node;
+        }
+
+        // the dependents of nodes[i] are dependents[first[i] .. first[i+1])
+        void build()
+        {
+          const size_t n = nodes.size();
+          for(size_t i = 0; i < n; i++){
+            nodes[i]->index = i + 1;
+            nodes[i]->pending = 0;
+          }
+          first.assign(n + 1, 0);
+          for(size_t i = 0; i < n; i++)
+            for(size_t k = 0; k < static_init_node::max_dependencies; k++){
+              static_init_node* const dep = nodes[i]->deps[k];
+              if(!dep)
+                continue;
+              if(!known(dep)){
+                // not constructed yet or not a static object at all
+                assert(!"parallel_static depends on an unregistered object");
+                nodes[i]->deps[k] = 0;
+                continue;
+              }
+              first[dep->index]++;
+              nodes[i]->pending++;
+            }
+          for(size_t i = 1; i <= n; i++)
+            first[i] += first[i - 1];
+
+          dependents.resize(first[n]);
+          std::vector<size_t> pos(first.begin(), first.end() - 1);
+          for(size_t i = 0; i < n; i++)
+            for(size_t k = 0; k < static_init_node::max_dependencies; k++)
+              if(static_init_node* const dep = nodes[i]->deps[k])
+                dependents[pos[dep->index - 1]++] = nodes[i];
+
+          // LIFO queue, so the earlier registered objects go first
+          for(size_t i = n; i-- > 0; )
+            if(!nodes[i]->pending)
+              queue.push_back(nodes[i]);
+          remaining = n;
+        }
+
+        void break_cycle()
+        {
+          assert(!"parallel_static objects have a dependency cycle");
+          for(size_t i = 0; i < nodes.size(); i++)
+            if(!nodes[i]->ready_){
+              nodes[i]->pending = 0;
+              queue.push_back(nodes[i]);
+              return;
+            }
+        }
+
+        static void worker(scheduler* self)
+        {
+          std::unique_lock<std::mutex> lock(self->guard);
+          for(;;){
+            while(self->queue.empty()){
+              if(self->remaining == 0){
+                // wake up the other workers to let them exit too
+                self->ready.set();
+                return;
+              }
+              if(self->running == 0){
+                self->break_cycle();
+                continue;
+              }
+              self->ready.reset();
+              lock.unlock();
+              self->ready.wait(false);
+              lock.lock();
+            }
+            static_init_node* const node = self->queue.back();
+            self->queue.pop_back();
+            self->running++;
+            lock.unlock();
+
+            node->init(node);
+
+            lock.lock();
+            self->running--;
+            self->remaining--;
+            push_done(node);
+            for(size_t i = self->first[node->index - 1]; i < self->first[node->index]; i++){
+              static_init_node* const dep = self->dependents[i];
+              if(dep->pending && --dep->pending == 0)
+                self->queue.push_back(dep);
+            }
+            if(!self->queue.empty() || self->remaining == 0)
+              self->ready.set();
+          }
+        }
+
+      private:
+        std::vector<static_init_node*> nodes;       // registration order
+        std::vector<size_t> first;
+        std::vector<static_init_node*> dependents;
+        std::vector<static_init_node*> queue;
+        std::mutex guard;
+        nt::user_event ready;
+        size_t remaining;     // not initialized objects
+        size_t running;       // objects being initialized
+    };
+};
+
+
+inline static_init_node::static_init_node(action* init, action* term, bool abandonable,
+  static_init_node* d1, static_init_node* d2, static_init_node* d3, static_init_node* d4)
+  :next(), done_next(), init(init), term(term), index(), pending(), abandonable(abandonable), ready_(false)
+{
+  deps[0] = d1; deps[1] = d2; deps[2] = d3; deps[3] = d4;
+  static_objects::register_node(this);
+}
+
+} // namespace ntl
+
+#endif // NTL__STATIC_INIT
@@ -20,6 +20,7 @@
 
 #include "cstring.hxx"
 #include "functional.hxx"
+#include "memory.hxx"
 
 namespace std
 {
@@ -725,7 +726,27 @@ OutputIterator
 template<class ForwardIterator>
 inline
 void
-  rotate(ForwardIterator first, ForwardIterator middle, ForwardIterator last);
+  rotate(ForwardIterator first, ForwardIterator middle, ForwardIterator last)
+{
+  if ( first == middle || middle == last )
+    return;
+  ForwardIterator next = middle;
+  for ( ; ; )
+  {
+    iter_swap(first, next);
+    ++first;
+    if ( ++next == last )
+    {
+      if ( first == middle )
+        return;
+      next = middle;
+    }
+    else if ( first == middle )
+    {
+      middle = next;
+    }
+  }
+}
 
 template<class ForwardIterator, class OutputIterator>
 inline
@@ -788,26 +809,222 @@ ForwardIterator partition_point(ForwardIterator first,
 
 ///\name 25.3, sorting and related operations:
 ///\name 25.3.1, sorting:
-template<class RandomAccessIterator>
-inline
-void
-  sort(RandomAccessIterator first, RandomAccessIterator last);
+namespace __
+{
+  template<class RandomAccessIterator, class Compare>
+  inline void insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+    if ( first == last )
+      return;
+    for ( RandomAccessIterator i = first + 1; i != last; ++i )
+    {
+      value_type value = std::move(*i);
+      RandomAccessIterator hole = i;
+      if ( comp(value, *first) )
+      {
+        move_backward(first, i, i + 1);
+        hole = first;
+      }
+      else
+      {
+        for ( RandomAccessIterator prev = i - 1; comp(value, *prev); --prev )
+        {
+          *hole = std::move(*prev);
+          hole = prev;
+        }
+      }
+      *hole = std::move(value);
+    }
+  }
+
+  template<class RandomAccessIterator, class Distance, class T, class Compare>
+  inline void push_heap(RandomAccessIterator first, Distance hole, Distance top, T value, Compare comp)
+  {
+    for ( Distance parent = (hole - 1) / 2; hole > top && comp(first[parent], value); parent = (hole - 1) / 2 )
+    {
+      first[hole] = std::move(first[parent]);
+      hole = parent;
+    }
+    first[hole] = std::move(value);
+  }
+
+  // sifts the hole down to the leaf and the value up from it
+  template<class RandomAccessIterator, class Distance, class T, class Compare>
+  inline void adjust_heap(RandomAccessIterator first, Distance hole, Distance len, T value, Compare comp)
+  {
+    const Distance top = hole;
+    Distance child = hole;
+    while ( child < (len - 1) / 2 )
+    {
+      child = 2 * (child + 1);
+      if ( comp(first[child], first[child - 1]) )
+        --child;
+      first[hole] = std::move(first[child]);
+      hole = child;
+    }
+    if ( (len & 1) == 0 && child == (len - 2) / 2 )
+    {
+      child = 2 * child + 1;
+      first[hole] = std::move(first[child]);
+      hole = child;
+    }
+    __::push_heap(first, hole, top, std::move(value), comp);
+  }
+
+  template<class RandomAccessIterator, class Compare>
+  inline void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+    const difference_type len = last - first;
+    for ( difference_type parent = len / 2; parent > 0; )
+    {
+      --parent;
+      value_type value = std::move(first[parent]);
+      __::adjust_heap(first, parent, len, std::move(value), comp);
+    }
+  }
+
+  template<class RandomAccessIterator, class Compare>
+  inline void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+    while ( last - first > 1 )
+    {
+      --last;
+      value_type value = std::move(*last);
+      *last = std::move(*first);
+      __::adjust_heap(first, difference_type(0), difference_type(last - first), std::move(value), comp);
+    }
+  }
+
+  template<class RandomAccessIterator, class Compare>
+  inline void move_median_to_first(RandomAccessIterator result, RandomAccessIterator a, RandomAccessIterator b, RandomAccessIterator c, Compare comp)
+  {
+    if ( comp(*a, *b) )
+    {
+      if ( comp(*b, *c) )       iter_swap(result, b);
+      else if ( comp(*a, *c) )  iter_swap(result, c);
+      else                      iter_swap(result, a);
+    }
+    else if ( comp(*a, *c) )    iter_swap(result, a);
+    else if ( comp(*b, *c) )    iter_swap(result, c);
+    else                        iter_swap(result, b);
+  }
+
+  // the median of three at the first stops both scans
+  template<class RandomAccessIterator, class Compare>
+  inline RandomAccessIterator partition_pivot(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    __::move_median_to_first(first, first + 1, first + (last - first) / 2, last - 1, comp);
+    const RandomAccessIterator pivot = first;
+    ++first;
+    for ( ; ; )
+    {
+      while ( comp(*first, *pivot) )
+        ++first;
+      --last;
+      while ( comp(*pivot, *last) )
+        --last;
+      if ( !(first < last) )
+        return first;
+      iter_swap(first, last);
+      ++first;
+    }
+  }
+
+  static const ptrdiff_t sort_threshold = 16;
+
+  // quick sort down to the small ranges left for the insertion sort, the heap sort beyond the depth limit
+  template<class RandomAccessIterator, class Size, class Compare>
+  void introsort_loop(RandomAccessIterator first, RandomAccessIterator last, Size depth, Compare comp)
+  {
+    while ( last - first > sort_threshold )
+    {
+      if ( depth == 0 )
+      {
+        __::make_heap(first, last, comp);
+        __::sort_heap(first, last, comp);
+        return;
+      }
+      --depth;
+      const RandomAccessIterator cut = __::partition_pivot(first, last, comp);
+      __::introsort_loop(cut, last, depth, comp);
+      last = cut;
+    }
+  }
+}
 
 template<class RandomAccessIterator, class Compare>
 inline
 void
-  sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+  sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+  if ( last - first < 2 )
+    return;
+  difference_type depth = 0;
+  for ( difference_type n = last - first; n > 1; n >>= 1 )
+    depth += 2;
+  __::introsort_loop(first, last, depth, comp);
+  __::insertion_sort(first, last, comp);
+}
 
 template<class RandomAccessIterator>
 inline
 void
-  stable_sort(RandomAccessIterator first, RandomAccessIterator last);
+  sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+  sort(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+}
 
+namespace __
+{
+  template<class BidirectionalIterator, class Distance, class T, class Compare>
+  void merge_adaptive(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last,
+                      Distance len1, Distance len2, T* buf, ptrdiff_t buf_size, Compare comp);
+}
+
+/// Insertion sorted runs merged bottom-up through a single temporary buffer
 template<class RandomAccessIterator, class Compare>
 inline
 void
   stable_sort(RandomAccessIterator first, RandomAccessIterator last,
-              Compare comp);
+              Compare comp)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+  const difference_type len = last - first;
+  for ( difference_type i = 0; i < len; i += __::sort_threshold )
+    __::insertion_sort(first + i, len - i > __::sort_threshold ? first + i + __::sort_threshold : last, comp);
+  if ( len <= __::sort_threshold )
+    return;
+
+  // the shorter run of a merge never exceeds the half
+  typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+  const pair<value_type*, ptrdiff_t> buffer = get_temporary_buffer<value_type>(len / 2);
+  for ( difference_type step = __::sort_threshold; step < len; step *= 2 )
+    for ( difference_type i = 0; len - i > step; i += 2 * step )
+    {
+      const RandomAccessIterator middle = first + i + step;
+      if ( comp(*middle, *(middle - 1)) )
+      {
+        const difference_type len2 = len - i > 2 * step ? step : len - i - step;
+        __::merge_adaptive(first + i, middle, middle + len2, step, len2, buffer.first, buffer.second, comp);
+      }
+    }
+  if ( buffer.first )
+    return_temporary_buffer(buffer.first);
+}
+
+template<class RandomAccessIterator>
+inline
+void
+  stable_sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+  stable_sort(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+}
 
 template<class RandomAccessIterator>
 inline
@@ -836,16 +1053,34 @@ RandomAccessIterator
                     RandomAccessIterator result_last,
                     Compare comp);
 
+template<class ForwardIterator, class Compare>
+ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last,
+                                Compare comp)
+{
+  if ( first != last )
+  {
+    for ( ForwardIterator next = first; ++next != last; first = next )
+      if ( comp(*next, *first) )
+        return next;
+  }
+  return last;
+}
 template<class ForwardIterator>
-bool is_sorted(ForwardIterator first, ForwardIterator last);
+ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last)
+{
+  return is_sorted_until(first, last, less<typename iterator_traits<ForwardIterator>::value_type>());
+}
 template<class ForwardIterator, class Compare>
 bool is_sorted(ForwardIterator first, ForwardIterator last,
-               Compare comp);
+               Compare comp)
+{
+  return is_sorted_until(first, last, comp) == last;
+}
 template<class ForwardIterator>
-ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last);
-template<class ForwardIterator, class Compare>
-ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last,
-                                Compare comp);
+bool is_sorted(ForwardIterator first, ForwardIterator last)
+{
+  return is_sorted_until(first, last) == last;
+}
 
 template<class RandomAccessIterator>
 inline
@@ -896,66 +1131,229 @@ ForwardIterator
   return lower_bound(first, last, value, less<T>());
 }
 
-template<class ForwardIterator, class T>
-inline
-ForwardIterator
-  upper_bound(ForwardIterator first, ForwardIterator last, const T& value);
-
 template<class ForwardIterator, class T, class Compare>
 inline
 ForwardIterator
   upper_bound(ForwardIterator first, ForwardIterator last,
-              const T& value, Compare comp);
+              const T& value, Compare comp)
+{
+  typedef typename iterator_traits<ForwardIterator>::difference_type difference_t;
+  difference_t len = distance(first, last);
+  while ( len > 0 )
+  {
+    difference_t const half = len / 2;
+    ForwardIterator middle = first;
+    advance(middle, half);
+    if ( comp(value, *middle) )
+    {
+      len = half;
+    }
+    else
+    {
+      first = middle;
+      ++first;
+      len = len - half - 1;
+    }
+  }
+  return first;
+}
 
 template<class ForwardIterator, class T>
 inline
-pair<ForwardIterator, ForwardIterator>
-  equal_range(ForwardIterator first, ForwardIterator last, const T& value);
+ForwardIterator
+  upper_bound(ForwardIterator first, ForwardIterator last, const T& value)
+{
+  return upper_bound(first, last, value, less<T>());
+}
 
 template<class ForwardIterator, class T, class Compare>
 inline
 pair<ForwardIterator, ForwardIterator>
   equal_range(ForwardIterator first, ForwardIterator last,
-              const T& value, Compare comp);
+              const T& value, Compare comp)
+{
+  first = lower_bound(first, last, value, comp);
+  return make_pair(first, upper_bound(first, last, value, comp));
+}
 
 template<class ForwardIterator, class T>
 inline
-bool
-  binary_search(ForwardIterator first, ForwardIterator last, const T& value);
+pair<ForwardIterator, ForwardIterator>
+  equal_range(ForwardIterator first, ForwardIterator last, const T& value)
+{
+  return equal_range(first, last, value, less<T>());
+}
 
 template<class ForwardIterator, class T, class Compare>
 inline
 bool
   binary_search(ForwardIterator first, ForwardIterator last,
-                const T& value, Compare comp);
+                const T& value, Compare comp)
+{
+  first = lower_bound(first, last, value, comp);
+  return first != last && !comp(value, *first);
+}
+
+template<class ForwardIterator, class T>
+inline
+bool
+  binary_search(ForwardIterator first, ForwardIterator last, const T& value)
+{
+  return binary_search(first, last, value, less<T>());
+}
 
 ///\name 25.3.4, merge:
-template<class InputIterator1, class InputIterator2, class OutputIterator>
+template<class InputIterator1, class InputIterator2, class OutputIterator,
+         class Compare>
 inline
 OutputIterator
   merge(InputIterator1 first1, InputIterator1 last1,
         InputIterator2 first2, InputIterator2 last2,
-        OutputIterator result);
+        OutputIterator result, Compare comp)
+{
+  for ( ; first1 != last1 && first2 != last2; ++result )
+  {
+    if ( comp(*first2, *first1) )
+    {
+      *result = *first2;
+      ++first2;
+    }
+    else
+    {
+      *result = *first1;
+      ++first1;
+    }
+  }
+  return copy(first2, last2, copy(first1, last1, result));
+}
 
-template<class InputIterator1, class InputIterator2, class OutputIterator,
-         class Compare>
+template<class InputIterator1, class InputIterator2, class OutputIterator>
 inline
 OutputIterator
   merge(InputIterator1 first1, InputIterator1 last1,
         InputIterator2 first2, InputIterator2 last2,
-        OutputIterator result, Compare comp);
+        OutputIterator result)
+{
+  return merge(first1, last1, first2, last2, result, less<typename iterator_traits<InputIterator1>::value_type>());
+}
 
-template<class BidirectionalIterator>
+namespace __
+{
+  // O(n log n) by the rotations when there is no memory for the buffer
+  template<class BidirectionalIterator, class Distance, class Compare>
+  void merge_without_buffer(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last,
+                            Distance len1, Distance len2, Compare comp)
+  {
+    if ( len1 == 0 || len2 == 0 )
+      return;
+    if ( len1 + len2 == 2 )
+    {
+      if ( comp(*middle, *first) )
+        iter_swap(first, middle);
+      return;
+    }
+    BidirectionalIterator first_cut = first, second_cut = middle;
+    Distance len11, len22;
+    if ( len1 > len2 )
+    {
+      len11 = len1 / 2;
+      advance(first_cut, len11);
+      second_cut = lower_bound(middle, last, *first_cut, comp);
+      len22 = distance(middle, second_cut);
+    }
+    else
+    {
+      len22 = len2 / 2;
+      advance(second_cut, len22);
+      first_cut = upper_bound(first, middle, *second_cut, comp);
+      len11 = distance(first, first_cut);
+    }
+    rotate(first_cut, middle, second_cut);
+    BidirectionalIterator new_middle = first_cut;
+    advance(new_middle, len22);
+    __::merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+    __::merge_without_buffer(new_middle, second_cut, last, len1 - len11, len2 - len22, comp);
+  }
+
+  // O(n) with the shorter run copied to the buffer, by the rotations if it does not fit
+  template<class BidirectionalIterator, class Distance, class T, class Compare>
+  void merge_adaptive(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last,
+                      Distance len1, Distance len2, T* buf, ptrdiff_t buf_size, Compare comp)
+  {
+    const Distance len = len1 < len2 ? len1 : len2;
+    if ( buf_size < len )
+    {
+      __::merge_without_buffer(first, middle, last, len1, len2, comp);
+      return;
+    }
+
+    T * const buf_end = buf + len;
+    if ( len1 <= len2 )
+    {
+      // forward into the place of the first run
+      uninitialized_copy(first, middle, buf);
+      T * b = buf;
+      for ( ; b != buf_end && middle != last; ++first )
+      {
+        if ( comp(*middle, *b) )
+        {
+          *first = std::move(*middle);
+          ++middle;
+        }
+        else
+        {
+          *first = std::move(*b);
+          ++b;
+        }
+      }
+      copy(b, buf_end, first);
+    }
+    else
+    {
+      // backward into the place of the second run
+      uninitialized_copy(middle, last, buf);
+      T * b = buf_end;
+      while ( b != buf && middle != first )
+      {
+        if ( comp(*(b - 1), *prev(middle)) )
+          *--last = std::move(*--middle);
+        else
+          *--last = std::move(*--b);
+      }
+      copy_backward(buf, b, last);
+    }
+    for ( T * p = buf; p != buf_end; ++p )
+      p->~T();
+  }
+}
+
+/// Merges in O(n) with the shorter run copied to a temporary buffer
+template<class BidirectionalIterator, class Compare>
 inline
 void
   inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
-                BidirectionalIterator last);
+                BidirectionalIterator last, Compare comp)
+{
+  typedef typename iterator_traits<BidirectionalIterator>::value_type value_type;
+  typedef typename iterator_traits<BidirectionalIterator>::difference_type difference_type;
+  const difference_type len1 = distance(first, middle), len2 = distance(middle, last);
+  if ( len1 == 0 || len2 == 0 || !comp(*middle, *prev(middle)) )
+    return;
+
+  const pair<value_type*, ptrdiff_t> buffer = get_temporary_buffer<value_type>(len1 < len2 ? len1 : len2);
+  __::merge_adaptive(first, middle, last, len1, len2, buffer.first, buffer.second, comp);
+  if ( buffer.first )
+    return_temporary_buffer(buffer.first);
+}
 
-template<class BidirectionalIterator, class Compare>
+template<class BidirectionalIterator>
 inline
 void
   inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
-                BidirectionalIterator last, Compare comp);
+                BidirectionalIterator last)
+{
+  inplace_merge(first, middle, last, less<typename iterator_traits<BidirectionalIterator>::value_type>());
+}
 
 ///\name 25.3.5, set operations on sorted structures:
 template<class InputIterator1, class InputIterator2>
@@ -1031,45 +1429,83 @@ OutputIterator
                            OutputIterator result, Compare comp);
 
 ///\name 25.3.6, heap operations:
-template<class RandomAccessIterator>
-inline
-void
-  push_heap(RandomAccessIterator first, RandomAccessIterator last);
-
 template<class RandomAccessIterator, class Compare>
 inline
 void
-  push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+  push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+  if ( last - first > 1 )
+  {
+    value_type value = std::move(*--last);
+    __::push_heap(first, difference_type(last - first), difference_type(0), std::move(value), comp);
+  }
+}
 
 template<class RandomAccessIterator>
 inline
 void
-  pop_heap(RandomAccessIterator first, RandomAccessIterator last);
+  push_heap(RandomAccessIterator first, RandomAccessIterator last)
+{
+  push_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+}
 
 template<class RandomAccessIterator, class Compare>
 inline
 void
-  pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+  pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  typedef typename iterator_traits<RandomAccessIterator>::value_type value_type;
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type difference_type;
+  if ( last - first > 1 )
+  {
+    --last;
+    value_type value = std::move(*last);
+    *last = std::move(*first);
+    __::adjust_heap(first, difference_type(0), difference_type(last - first), std::move(value), comp);
+  }
+}
 
 template<class RandomAccessIterator>
 inline
 void
-  make_heap(RandomAccessIterator first, RandomAccessIterator last);
+  pop_heap(RandomAccessIterator first, RandomAccessIterator last)
+{
+  pop_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+}
 
 template<class RandomAccessIterator, class Compare>
 inline
 void
-  make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+  make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  __::make_heap(first, last, comp);
+}
 
 template<class RandomAccessIterator>
 inline
 void
-  sort_heap(RandomAccessIterator first, RandomAccessIterator last);
+  make_heap(RandomAccessIterator first, RandomAccessIterator last)
+{
+  __::make_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+}
 
 template<class RandomAccessIterator, class Compare>
 inline
 void
-  sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+  sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  __::sort_heap(first, last, comp);
+}
+
+template<class RandomAccessIterator>
+inline
+void
+  sort_heap(RandomAccessIterator first, RandomAccessIterator last)
+{
+  __::sort_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+}
 
 template<class RandomAccessIterator>
 bool is_heap(RandomAccessIterator first, RandomAccessIterator last);
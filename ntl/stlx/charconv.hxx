@@ -0,0 +1,139 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Primitive numeric conversions [utility.to.chars, utility.from.chars]
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__STLX_CHARCONV
+#define NTL__STLX_CHARCONV
+#pragma once
+
+#ifndef NTL__EXT_NUMERIC_CONVERSIONS
+# include "ext/numeric_conversions.hxx"
+#endif
+#ifndef NTL__STLX_SYSTEM_ERROR
+# include "system_error.hxx"
+#endif
+
+namespace std
+{
+/**\addtogroup  lib_utilities *** 20 General utilities library [utilities]
+ *@{
+ **/
+
+  /**\defgroup lib_charconv ****** Primitive numeric conversions [charconv]
+   *  Locale-independent, non-allocating and non-throwing conversions between numbers and character sequences.
+   *  The result of to_chars is the shortest representation which can be read back exactly,
+   *  or the exactly rounded one if the precision is given.
+   *@{
+   **/
+
+  /** Floating-point format for primitive numerical conversion */
+  namespace chars_format
+  {
+    using ntl::numeric::chars_format::type;
+    using ntl::numeric::chars_format::scientific;
+    using ntl::numeric::chars_format::fixed;
+    using ntl::numeric::chars_format::general;
+  }
+
+  /** Result of to_chars: \c ec is value_too_large if the range is too small, \c ptr is the end of range in this case */
+  struct to_chars_result
+  {
+    char* ptr;
+    posix_error::posix_errno ec;
+  };
+
+  /** Result of from_chars: \c ec is invalid_argument if nothing is matched or result_out_of_range if the value is not representable */
+  struct from_chars_result
+  {
+    const char* ptr;
+    posix_error::posix_errno ec;
+  };
+
+  namespace __
+  {
+    inline to_chars_result make_to_chars_result(const ntl::numeric::to_chars_result& re)
+    {
+      const to_chars_result r = { re.ptr, re.ec == ntl::numeric::conv_result::ok ? posix_error::success
+        : re.ec == ntl::numeric::conv_result::bad_base ? posix_error::invalid_argument : posix_error::value_too_large };
+      return r;
+    }
+
+    inline from_chars_result make_from_chars_result(const ntl::numeric::from_chars_result& re)
+    {
+      const from_chars_result r = { re.ptr, re.ec == ntl::numeric::conv_result::ok ? posix_error::success
+        : re.ec == ntl::numeric::conv_result::overflow ? posix_error::result_out_of_range : posix_error::invalid_argument };
+      return r;
+    }
+  }
+
+  ///\name Primitive numerical output conversion [utility.to.chars]
+
+  template<typename T>
+  inline typename enable_if<is_integral<T>::value, to_chars_result>::type
+    to_chars(char* first, char* last, T value, int base = 10)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value, base));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, float value)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, double value)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, long double value)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, static_cast<double>(value)));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, float value, chars_format::type fmt)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value, fmt));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, double value, chars_format::type fmt)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value, fmt));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, long double value, chars_format::type fmt)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, static_cast<double>(value), fmt));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, float value, chars_format::type fmt, int precision)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value, fmt, precision));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, double value, chars_format::type fmt, int precision)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, value, fmt, precision));
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, long double value, chars_format::type fmt, int precision)
+  {
+    return __::make_to_chars_result(ntl::numeric::to_chars(first, last, static_cast<double>(value), fmt, precision));
+  }
+
+  ///\name Primitive numerical input conversion [utility.from.chars]
+
+  template<typename T>
+  inline typename enable_if<is_integral<T>::value, from_chars_result>::type
+    from_chars(const char* first, const char* last, T& value, int base = 10)
+  {
+    return __::make_from_chars_result(ntl::numeric::from_chars(first, last, value, base));
+  }
+  ///\}
+
+  /**@} lib_charconv */
+  /**@} lib_utilities */
+} // std
+
+#endif // NTL__STLX_CHARCONV
@@ -13,6 +13,9 @@
 #ifndef NTL__STLX_LIMITS
 #include "limits.hxx"
 #endif
+#ifndef NTL__ATOMIC
+#include "../atomic.hxx"
+#endif
 
 namespace std
 {
@@ -33,6 +36,8 @@ namespace std
 
     // Clocks
     class system_clock;
+    class steady_clock;
+    class high_resolution_clock;
 
     // convenience typedefs
     typedef duration<int64_t, nano>        nanoseconds;
@@ -664,24 +669,158 @@ namespace std
       static inline time_point now();
     };
 
+    /**
+     *	@brief Class steady_clock [time.clock.steady]
+     *
+     *  Objects of class steady_clock represent clocks for which values of time_point never decrease as physical time
+     *  advances and for which values of time_point advance at a steady rate relative to real time.
+     *
+     *  @note It is the system interrupt time, read from the shared data page without a system call.
+     **/
+    class steady_clock
+    {
+    public:
+      typedef int64_t rep;
+
+      // the interrupt time is stored as 100 nanoseconds units
+      typedef ratio_multiply<ratio<100>, nano>::type  period;
+      typedef chrono::duration<rep, period>           duration;
+      typedef chrono::time_point<steady_clock>        time_point;
+
+      static const bool is_monotonic = true;
+      static const bool is_steady = true;
+    public:
+      /** \c return the time_point representing a current monotonic time */
+      static inline time_point now();
+    };
+
+    namespace __
+    {
+      /** The system interrupt time in 100ns units, maintained by the kernel in the shared data page */
+      struct shared_data_time_source
+      {
+        static int64_t interrupt_time();
+      };
+
+      /**
+       *  Nanoseconds clock based on the time-stamp counter.
+       *
+       *  The counter is calibrated once against the \c TimeSource::interrupt_time() by calibrate(), which takes about two timer ticks.
+       *  Until then, or if the processor has no invariant counter, the interrupt time is used instead.
+       **/
+      template<class TimeSource>
+      class tsc_clock
+      {
+        enum state_type { uninitialized, calibrating, ready, unavailable };
+
+        struct scale
+        {
+          volatile uint32_t state;
+          uint32_t  mult, shift;
+          uint64_t  tsc0;
+          int64_t   ns0;
+        };
+
+        static scale& data()
+        {
+          // zero-initialized, so no dynamic initialization is involved
+          static scale s;
+          return s;
+        }
+
+      public:
+        /** Minimal calibration period in 100ns units */
+        static const int64_t calibration_period = 20 * 10000;
+
+        /** Calibrates the counter if it is not done yet, \c return true if the counter is used */
+        static bool calibrate()
+        {
+          scale& s = data();
+          for(;;){
+            const uint32_t state = s.state;
+            if(state == ready)
+              return true;
+            else if(state == unavailable)
+              return false;
+            else if(state == uninitialized && ntl::atomic::compare_exchange(s.state, uint32_t(calibrating), uint32_t(uninitialized)) == uninitialized)
+              break;
+            ntl::cpu::pause();
+          }
+
+          if(ntl::cpu::invariant_tsc()){
+            // both ends are sampled right after an update of the interrupt time
+            int64_t t0 = TimeSource::interrupt_time(), t1;
+            uint64_t c0, c1;
+            do {
+              t1 = TimeSource::interrupt_time();
+              c0 = ntl::intrinsic::rdtsc();
+            } while(t1 == t0);
+            t0 = t1;
+            do {
+              t1 = TimeSource::interrupt_time();
+              c1 = ntl::intrinsic::rdtsc();
+            } while(t1 - t0 < calibration_period);
+
+            const uint64_t ns = static_cast<uint64_t>(t1 - t0) * 100, ticks = c1 - c0;
+            if(ticks > ns / 1000){
+              // ns = ticks * mult >> shift, where mult fits in 32 bits
+              uint32_t shift = 32;
+              uint64_t mult;
+              while((mult = (ns << shift) / ticks) >> 32)
+                shift--;
+              s.mult = static_cast<uint32_t>(mult);
+              s.shift = shift;
+              s.tsc0 = c1;
+              s.ns0 = t1 * 100;
+              ntl::atomic::exchange(s.state, uint32_t(ready));
+              return true;
+            }
+          }
+          ntl::atomic::exchange(s.state, uint32_t(unavailable));
+          return false;
+        }
+
+        /** \c return the current time in nanoseconds, it never spins for the calibration */
+        static int64_t now()
+        {
+          const scale& s = data();
+          if(s.state != ready)
+            return TimeSource::interrupt_time() * 100;
+          int64_t d = static_cast<int64_t>(ntl::intrinsic::rdtsc() - s.tsc0);
+          if(d < 0) // the counters of other processors may lag slightly behind
+            d = 0;
+          const uint64_t u = static_cast<uint64_t>(d);
+          return s.ns0 + static_cast<int64_t>(((u >> 32) * s.mult << (32 - s.shift)) + ((u & 0xFFFFFFFF) * s.mult >> s.shift));
+        }
+      };
+    } // __
+
     /**
      *	@brief Class high_resolution_clock [20.8.5.3 time.clock.hires]
      *
      *  Objects of class high_resolution_clock represent clocks with the shortest tick period.
+     *
+     *  @note It is the calibrated invariant time-stamp counter if the processor has one, and the steady_clock otherwise.
+     *  The calibration spins for about two timer ticks, so now() never does it: the clock has the steady_clock resolution
+     *  until calibrate() is called once, e.g. at the startup (but not at the DISPATCH_LEVEL).
      **/
     class high_resolution_clock
     {
     public:
-      typedef uint64_t rep;
+      typedef int64_t rep;
 
-      typedef ratio_multiply<ratio<100>, nano>::type    period;
+      typedef nano                                      period;
       typedef chrono::duration<rep, period>             duration;
       typedef chrono::time_point<high_resolution_clock> time_point;
 
       static const bool is_monotonic = true;
+      static const bool is_steady = true;
     public:
-      /** \c return the time_point representing a current date and time */
+      /** \c return the time_point representing a current monotonic time */
       static inline time_point now();
+
+      /** Calibrates the clock, \c return true if the time-stamp counter is used */
+      static inline bool calibrate();
     };
 
 
@@ -732,12 +871,24 @@ namespace std
       return time_point( duration_cast<duration>(systime_duration(ntime)) );
     }
 
+    inline steady_clock::time_point steady_clock::now()
+    {
+      return time_point( duration(ntl::user_shared_data::instance().InterruptTime.get()) );
+    }
+
+    inline int64_t __::shared_data_time_source::interrupt_time()
+    {
+      return ntl::user_shared_data::instance().InterruptTime.get();
+    }
+
     inline high_resolution_clock::time_point high_resolution_clock::now()
     {
-      typedef ratio_multiply<ratio<100>, nano>::type systime_unit;
-      typedef chrono::duration<ntl::nt::systime_t, systime_unit> systime_duration;
-      const ntl::nt::systime_t ntime = ntl::user_shared_data::instance().InterruptTime.get();
-      return time_point( duration_cast<duration>(systime_duration(ntime)) );
+      return time_point( duration(__::tsc_clock<__::shared_data_time_source>::now()) );
+    }
+
+    inline bool high_resolution_clock::calibrate()
+    {
+      return __::tsc_clock<__::shared_data_time_source>::calibrate();
     }
 
 #endif
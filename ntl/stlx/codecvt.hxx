@@ -9,6 +9,7 @@
 #pragma once
 
 #include "locale.hxx"
+#include "ext/utf.hxx"
 
 namespace std
 {
@@ -25,11 +26,105 @@ namespace std
     consume_header = 4,
     /** the facet shall generate an initial header sequence */
     generate_header = 2,
-    /** the facet shall generate a multibyte sequence in little-endian order, 
+    /** the facet shall generate a multibyte sequence in little-endian order,
       as opposed to the default big-endian order */
     little_endian = 1
   };
 
+  namespace __
+  {
+    // the state of the standard facets: the header is done, the UTF-16 header is little-endian
+    enum { stdcvt_header_done = 1, stdcvt_header_le = 2 };
+
+    static const unsigned long stdcvt_max_code = 0x10ffff;
+
+    /** The UTF-8 facet of codecvt_utf8 and codecvt_utf8_utf16 */
+    template<class Elem, unsigned long Maxcode, codecvt_mode Mode, bool Pairs>
+    class codecvt_utf8_base
+      : public codecvt<Elem, char, mbstate_t>
+    {
+    public:
+      typedef Elem                  intern_type;
+      typedef char                  extern_type;
+      typedef mbstate_t             state_type;
+      typedef codecvt_base::result  result;
+
+      explicit codecvt_utf8_base(size_t refs = 0)
+        : codecvt<Elem, char, mbstate_t>(refs)
+      {}
+
+    protected:
+      static const uint32_t maxcode = Maxcode < stdcvt_max_code ? Maxcode : stdcvt_max_code;
+
+      // the largest code point of the element
+      static uint32_t max_code()
+      {
+        return Pairs || sizeof(Elem) > 2 || maxcode < 0xffff ? maxcode : 0xffff;
+      }
+
+      // skips the header at the start, partial if it can't be told yet
+      static bool consume(state_type& state, const extern_type*& from, const extern_type* from_end)
+      {
+        if ( !(Mode & consume_header) || (state & stdcvt_header_done) )
+          return true;
+        static const char bom[] = "\xEF\xBB\xBF";
+        const size_t n = static_cast<size_t>(from_end - from);
+        if ( n < 3 && memcmp(from, bom, n) == 0 )
+          return n == 0;
+        // the short input which is not a prefix of the header is the text
+        if ( n >= 3 && memcmp(from, bom, 3) == 0 )
+          from += 3;
+        state |= stdcvt_header_done;
+        return true;
+      }
+
+      virtual result do_out(state_type& state, const intern_type* from, const intern_type* from_end,
+        const intern_type*& from_next, extern_type* to, extern_type* to_limit, extern_type*& to_next) const
+      {
+        from_next = from, to_next = to;
+        if ( (Mode & generate_header) && !(state & stdcvt_header_done) )
+        {
+          if ( to_limit - to < 3 )
+            return codecvt_base::partial;
+          *to++ = '\xEF', *to++ = '\xBB', *to++ = '\xBF';
+          to_next = to;
+          state |= stdcvt_header_done;
+        }
+        // the values of ext::utf::result are the ones of codecvt_base::result
+        return static_cast<result>(ext::utf::to_utf8(from, from_end, from_next, to, to_limit, to_next, max_code(), Pairs));
+      }
+
+      virtual result do_in(state_type& state, const extern_type* from, const extern_type* from_end,
+        const extern_type*& from_next, intern_type* to, intern_type* to_limit, intern_type*& to_next) const
+      {
+        from_next = from, to_next = to;
+        if ( !consume(state, from, from_end) )
+          return codecvt_base::partial;
+        return static_cast<result>(ext::utf::from_utf8(from, from_end, from_next, to, to_limit, to_next, max_code(), Pairs));
+      }
+
+      virtual result do_unshift(state_type&, extern_type* to, extern_type*, extern_type*& to_next) const
+      {
+        to_next = to;
+        return codecvt_base::noconv;
+      }
+
+      virtual int do_encoding() const __ntl_nothrow { return 0; }
+
+      virtual bool do_always_noconv() const __ntl_nothrow { return false; }
+
+      virtual int do_length(state_type& state, const extern_type* from, const extern_type* end, size_t max) const
+      {
+        const extern_type* const first = from;
+        if ( !consume(state, from, end) )
+          return 0;
+        return static_cast<int>(from - first + ext::utf::utf8_units_length(from, end, max, max_code(), Pairs));
+      }
+
+      virtual int do_max_length() const __ntl_nothrow { return (Mode & consume_header) ? 7 : 4; }
+    };
+  }
+
 
   /**
    *	@brief Class template codecvt_utf8
@@ -38,27 +133,15 @@ namespace std
    **/
   template<class Elem, unsigned long Maxcode = 0x10ffff, codecvt_mode Mode = (codecvt_mode)0>
   class codecvt_utf8
-    : public codecvt<Elem, char, mbstate_t>
+    : public __::codecvt_utf8_base<Elem, Maxcode, Mode, false>
   {
-  protected:
-    virtual result do_out(state_type& state, const intern_type* from, const intern_type* from_end,
-      const intern_type*& from_next, extern_type* to, extern_type* to_limit, extern_type*& to_next) const;
-
-    virtual result do_in(state_type& state, const extern_type* from, const extern_type* from_end,
-      const extern_type*& from_next, intern_type* to, intern_type* to_limit, intern_type*& to_next) const;
-
-    virtual result do_unshift(state_type& state, extern_type* to, extern_type* to_limit, extern_type*& to_next) const;
-
-    virtual int do_encoding() const __ntl_nothrow;
-
-    virtual bool do_always_noconv() const __ntl_nothrow;
-
-    virtual int do_length(state_type&, const extern_type* from, const extern_type* end, size_t max) const;
-
-    virtual int do_max_length() const __ntl_nothrow;
+  public:
+    explicit codecvt_utf8(size_t refs = 0)
+      : __::codecvt_utf8_base<Elem, Maxcode, Mode, false>(refs)
+    {}
   };
 
-  
+
   /**
    *	@brief Class template codecvt_utf16
    *  @details The facet shall convert between UTF-16 multibyte sequences and UCS2 or UCS4 (depending on the
@@ -68,22 +151,161 @@ namespace std
   class codecvt_utf16
     : public codecvt<Elem, char, mbstate_t>
   {
+  public:
+    typedef Elem                  intern_type;
+    typedef char                  extern_type;
+    typedef mbstate_t             state_type;
+    typedef codecvt_base::result  result;
+
+    explicit codecvt_utf16(size_t refs = 0)
+      : codecvt<Elem, char, mbstate_t>(refs)
+    {}
+
   protected:
+    static const uint32_t maxcode = Maxcode < __::stdcvt_max_code ? Maxcode : __::stdcvt_max_code;
+
+    static uint32_t max_code() { return sizeof(Elem) > 2 || maxcode < 0xffff ? maxcode : 0xffff; }
+
+    static bool little(const state_type& state)
+    {
+      return (Mode & consume_header) && (state & __::stdcvt_header_done) ? (state & __::stdcvt_header_le) != 0 : (Mode & little_endian) != 0;
+    }
+
+    static uint16_t read(const extern_type* p, bool le)
+    {
+      const uint8_t* const b = reinterpret_cast<const uint8_t*>(p);
+      return static_cast<uint16_t>(le ? b[0] | b[1] << 8 : b[0] << 8 | b[1]);
+    }
+
+    static void write(extern_type* p, uint32_t u, bool le)
+    {
+      p[le ? 0 : 1] = static_cast<char>(u);
+      p[le ? 1 : 0] = static_cast<char>(u >> 8);
+    }
+
+    // skips the header at the start and takes its byte order, partial if it can't be told yet
+    static bool consume(state_type& state, const extern_type*& from, const extern_type* from_end)
+    {
+      if ( !(Mode & consume_header) || (state & __::stdcvt_header_done) )
+        return true;
+      if ( from_end - from < 2 )
+        return from == from_end;
+      const uint16_t bom = read(from, false);
+      state |= __::stdcvt_header_done;
+      if ( bom == 0xfeff || bom == 0xfffe )
+      {
+        from += 2;
+        if ( bom == 0xfffe )
+          state |= __::stdcvt_header_le;
+      }
+      else if ( Mode & little_endian )
+      {
+        state |= __::stdcvt_header_le;
+      }
+      return true;
+    }
+
     virtual result do_out(state_type& state, const intern_type* from, const intern_type* from_end,
-      const intern_type*& from_next, extern_type* to, extern_type* to_limit, extern_type*& to_next) const;
+      const intern_type*& from_next, extern_type* to, extern_type* to_limit, extern_type*& to_next) const
+    {
+      const bool le = (Mode & little_endian) != 0;
+      ext::utf::result r = ext::utf::ok;
+      if ( (Mode & generate_header) && !(state & __::stdcvt_header_done) )
+      {
+        if ( to_limit - to < 2 )
+          r = ext::utf::partial;
+        else
+          write(to, 0xfeff, le), to += 2, state |= __::stdcvt_header_done;
+      }
+      for ( ; r == ext::utf::ok && from != from_end; )
+      {
+        size_t units;
+        const uint32_t c = ext::utf::__::read_unit(from, from_end, max_code(), false, units, r);
+        if ( !units )
+          break;
+        if ( to_limit - to < (c > 0xffff ? 4 : 2) )
+        {
+          r = ext::utf::partial;
+          break;
+        }
+        if ( c > 0xffff )
+        {
+          write(to, 0xd800 + ((c - 0x10000) >> 10), le);
+          write(to + 2, 0xdc00 + (c & 0x3ff), le);
+          to += 4;
+        }
+        else
+        {
+          write(to, c, le);
+          to += 2;
+        }
+        ++from;
+      }
+      from_next = from, to_next = to;
+      return static_cast<result>(r);
+    }
 
     virtual result do_in(state_type& state, const extern_type* from, const extern_type* from_end,
-      const extern_type*& from_next, intern_type* to, intern_type* to_limit, intern_type*& to_next) const;
+      const extern_type*& from_next, intern_type* to, intern_type* to_limit, intern_type*& to_next) const
+    {
+      ext::utf::result r = ext::utf::ok;
+      if ( !consume(state, from, from_end) )
+        r = ext::utf::partial;
+      const bool le = little(state);
+      for ( ; r == ext::utf::ok && from != from_end; )
+      {
+        if ( from_end - from < 2 )
+        {
+          r = ext::utf::partial;
+          break;
+        }
+        const uint16_t units[2] = { read(from, le), from_end - from >= 4 ? read(from + 2, le) : uint16_t() };
+        size_t n;
+        const uint32_t c = ext::utf::__::read_unit(units, units + (from_end - from >= 4 ? 2 : 1), max_code(), true, n, r);
+        if ( !n )
+          break;
+        if ( to == to_limit )
+        {
+          r = ext::utf::partial;
+          break;
+        }
+        *to++ = static_cast<intern_type>(c);
+        from += n * 2;
+      }
+      from_next = from, to_next = to;
+      return static_cast<result>(r);
+    }
 
-    virtual result do_unshift(state_type& state, extern_type* to, extern_type* to_limit, extern_type*& to_next) const;
+    virtual result do_unshift(state_type&, extern_type* to, extern_type*, extern_type*& to_next) const
+    {
+      to_next = to;
+      return codecvt_base::noconv;
+    }
 
-    virtual int do_encoding() const __ntl_nothrow;
+    virtual int do_encoding() const __ntl_nothrow { return 0; }
 
-    virtual bool do_always_noconv() const __ntl_nothrow;
+    virtual bool do_always_noconv() const __ntl_nothrow { return false; }
 
-    virtual int do_length(state_type&, const extern_type* from, const extern_type* end, size_t max) const;
+    virtual int do_length(state_type& state, const extern_type* from, const extern_type* end, size_t max) const
+    {
+      const extern_type* const first = from;
+      if ( !consume(state, from, end) )
+        return 0;
+      const bool le = little(state);
+      for ( ; max && end - from >= 2; max-- )
+      {
+        const uint16_t units[2] = { read(from, le), end - from >= 4 ? read(from + 2, le) : uint16_t() };
+        ext::utf::result r = ext::utf::ok;
+        size_t n;
+        ext::utf::__::read_unit(units, units + (end - from >= 4 ? 2 : 1), max_code(), true, n, r);
+        if ( !n )
+          break;
+        from += n * 2;
+      }
+      return static_cast<int>(from - first);
+    }
 
-    virtual int do_max_length() const __ntl_nothrow;
+    virtual int do_max_length() const __ntl_nothrow { return (Mode & consume_header) ? 6 : 4; }
   };
 
 
@@ -94,25 +316,27 @@ namespace std
    **/
   template<class Elem, unsigned long Maxcode = 0x10ffff, codecvt_mode Mode = (codecvt_mode)0>
   class codecvt_utf8_utf16
-    : public codecvt<Elem, char, mbstate_t>
+    : public __::codecvt_utf8_base<Elem, Maxcode, Mode, true>
   {
-  protected:
-    virtual result do_out(state_type& state, const intern_type* from, const intern_type* from_end,
-      const intern_type*& from_next, extern_type* to, extern_type* to_limit, extern_type*& to_next) const;
-
-    virtual result do_in(state_type& state, const extern_type* from, const extern_type* from_end,
-      const extern_type*& from_next, intern_type* to, intern_type* to_limit, intern_type*& to_next) const;
-
-    virtual result do_unshift(state_type& state, extern_type* to, extern_type* to_limit, extern_type*& to_next) const;
-
-    virtual int do_encoding() const __ntl_nothrow;
-
-    virtual bool do_always_noconv() const __ntl_nothrow;
+  public:
+    explicit codecvt_utf8_utf16(size_t refs = 0)
+      : __::codecvt_utf8_base<Elem, Maxcode, Mode, true>(refs)
+    {}
+  };
 
-    virtual int do_length(state_type&, const extern_type* from, const extern_type* end, size_t max) const;
+  ///\name wstring_convert::to_bytes() allocates the exact UTF-8 length
+  template<class Elem, unsigned long Maxcode, codecvt_mode Mode>
+  inline size_t __codecvt_out_length(const codecvt_utf8<Elem, Maxcode, Mode>&, const Elem* from, const Elem* from_end)
+  {
+    return ext::utf::utf8_length(from, from_end) + ((Mode & generate_header) ? 3 : 0);
+  }
 
-    virtual int do_max_length() const __ntl_nothrow;
-  };
+  template<class Elem, unsigned long Maxcode, codecvt_mode Mode>
+  inline size_t __codecvt_out_length(const codecvt_utf8_utf16<Elem, Maxcode, Mode>&, const Elem* from, const Elem* from_end)
+  {
+    return ext::utf::utf8_length(from, from_end) + ((Mode & generate_header) ? 3 : 0);
+  }
+  ///\}
 
 
   /** @} */
@@ -0,0 +1,1046 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  B-tree of the ordered containers
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__EXT_BTREE
+#define NTL__EXT_BTREE
+#pragma once
+
+#include "../iterator.hxx"
+#include "../memory.hxx"
+#include "../functional.hxx"
+#include "../algorithm.hxx"
+#include "../type_traits.hxx"
+
+#if !defined(NTL_NO_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+# define NTL__BTREE_SSE2
+# include <emmintrin.h>
+#endif
+
+namespace std
+{
+  namespace ext
+  {
+    namespace tree
+    {
+      namespace __
+      {
+        /// Key of the set value
+        template<class Key>
+        struct btree_set_key
+        {
+          typedef Key value_type;
+
+          static const Key& get(const Key& v) { return v; }
+        };
+
+        /**
+         *	Key of the map value: the nodes keep the mutable pair<Key, T> to move it between the nodes,
+         *  the users see it as the value_type of the same layout.
+         **/
+        template<class Key, class T>
+        struct btree_map_key
+        {
+          typedef pair<const Key, T> value_type;
+
+          static const Key& get(const pair<Key, T>& v) { return v.first; }
+          static const Key& get(const value_type& v) { return v.first; }
+        };
+
+        /**
+         *	Search in the node: the index of the first of the \a n values which key isn't less than the \a key (lower)
+         *  or is greater than it (upper).
+         **/
+        template<class Key, class Value, class KeyOfValue, class Compare, bool Simd>
+        struct btree_search
+        {
+          static unsigned lower(const Value* v, unsigned n, const Key& key, const Compare& comp)
+          {
+            unsigned first = 0;
+            while ( n )
+            {
+              const unsigned half = n / 2;
+              if ( comp(KeyOfValue::get(v[first + half]), key) )
+                first += half + 1, n -= half + 1;
+              else
+                n = half;
+            }
+            return first;
+          }
+
+          static unsigned upper(const Value* v, unsigned n, const Key& key, const Compare& comp)
+          {
+            unsigned first = 0;
+            while ( n )
+            {
+              const unsigned half = n / 2;
+              if ( !comp(key, KeyOfValue::get(v[first + half])) )
+                first += half + 1, n -= half + 1;
+              else
+                n = half;
+            }
+            return first;
+          }
+        };
+
+        /// The SSE2 search is used for the 32-bit integer keys ordered by std::less in the values of 4 or 8 bytes
+        template<class Key, class Value, class Compare>
+        struct btree_simd_search:
+          integral_constant<bool, is_integral<Key>::value && sizeof(Key) == 4
+            && (sizeof(Value) == 4 || sizeof(Value) == 8) && is_same<Compare, less<Key> >::value>
+        {};
+
+#ifdef NTL__BTREE_SSE2
+        /// Compares 4 keys at once, the keys of the map values are the even ones
+        template<class Key, class Value, class KeyOfValue, class Compare>
+        struct btree_search<Key, Value, KeyOfValue, Compare, true>
+        {
+          static const unsigned stride = sizeof(Value) / sizeof(Key);
+          static const unsigned step = 4 / stride;
+          static const int lanes = stride == 1 ? 0xF : 0x5;
+
+          static unsigned lower(const Value* v, unsigned n, const Key& key, const Compare&)
+          {
+            // the number of keys less than the key
+            const int32_t* const keys = reinterpret_cast<const int32_t*>(v);
+            const __m128i x = _mm_set1_epi32(biased(key));
+            unsigned i = 0;
+            for ( ; i + step <= n; i += step )
+            {
+              const __m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i * stride)), bias());
+              const int less = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(k, x))) & lanes;
+              if ( less != lanes )
+                return i + ones(less);
+            }
+            for ( ; i < n && KeyOfValue::get(v[i]) < key; i++ )
+              ;
+            return i;
+          }
+
+          static unsigned upper(const Value* v, unsigned n, const Key& key, const Compare&)
+          {
+            // the number of keys not greater than the key
+            const int32_t* const keys = reinterpret_cast<const int32_t*>(v);
+            const __m128i x = _mm_set1_epi32(biased(key));
+            unsigned i = 0;
+            for ( ; i + step <= n; i += step )
+            {
+              const __m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i * stride)), bias());
+              const int greater = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, x))) & lanes;
+              if ( greater )
+                return i + step - ones(greater);
+            }
+            for ( ; i < n && !(key < KeyOfValue::get(v[i])); i++ )
+              ;
+            return i;
+          }
+
+        private:
+          // the unsigned keys are compared as signed with the flipped sign bit
+          static __m128i bias()
+          {
+            return _mm_set1_epi32(is_signed<Key>::value ? 0 : static_cast<int32_t>(0x80000000));
+          }
+
+          static int32_t biased(const Key& key)
+          {
+            return static_cast<int32_t>(static_cast<uint32_t>(key) ^ (is_signed<Key>::value ? 0 : 0x80000000));
+          }
+
+          static unsigned ones(int mask)
+          {
+            static const uint8_t bits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+            return bits[mask];
+          }
+        };
+#endif
+      } // __
+
+      /**
+       *	B-tree: the values are kept sorted in the wide nodes of about \a NodeSize bytes,
+       *  so the lookup touches a few cache lines per level and the iteration walks the arrays.
+       *
+       *  Unlike the rb_tree, the values move between the nodes, so the insertion and the erasure invalidate
+       *  all the iterators and the references to the values.
+       *  The \a Multi tree keeps the equal keys in the order of insertion.
+       *  The nodes keep the \a Value, the iterators expose it as the KeyOfValue::value_type of the same layout.
+       **/
+      template<class Key, class Value, class KeyOfValue, class Compare, class Allocator, bool Multi, size_t NodeSize = 256>
+      class btree
+      {
+      public:
+        typedef           Key                         key_type;
+        typedef typename  KeyOfValue::value_type      value_type;
+      private:
+        typedef typename
+          Allocator::template rebind<value_type>::other allocator;
+      public:
+        typedef           Compare                     key_compare;
+        typedef           Allocator                   allocator_type;
+
+        typedef typename  allocator::pointer          pointer;
+        typedef typename  allocator::const_pointer    const_pointer;
+        typedef typename  allocator::reference        reference;
+        typedef typename  allocator::const_reference  const_reference;
+        typedef typename  allocator::size_type        size_type;
+        typedef typename  allocator::difference_type  difference_type;
+
+        /** Values per node */
+        static const unsigned slots = (NodeSize - 2 * sizeof(void*)) / sizeof(Value) < 3 ? 3
+          : (NodeSize - 2 * sizeof(void*)) / sizeof(Value) > 0xFFFF ? 0xFFFF : (NodeSize - 2 * sizeof(void*)) / sizeof(Value);
+
+      protected:
+        static const unsigned min_values = slots / 2;
+
+        struct internal_node;
+
+        struct node
+        {
+          internal_node*  parent;
+          uint16_t        position;   // in the parent
+          uint16_t        count;
+          bool            leaf;
+          typename aligned_storage<sizeof(Value) * slots, alignment_of<Value>::value>::type storage;
+
+          Value*        values()                  { return reinterpret_cast<Value*>(&storage); }
+          const Value*  values() const            { return reinterpret_cast<const Value*>(&storage); }
+          Value&        value(unsigned i)         { return values()[i]; }
+          const Value&  value(unsigned i) const   { return values()[i]; }
+
+          node*         child(unsigned i) const   { return static_cast<const internal_node*>(this)->children[i]; }
+        };
+
+        struct internal_node: node
+        {
+          node* children[slots + 1];
+        };
+
+        typedef __::btree_search<Key, Value, KeyOfValue, Compare, __::btree_simd_search<Key, Value, Compare>::value> search;
+
+        template<class NodePtr, class Reference, class Pointer>
+        struct iterator_impl:
+          std::iterator<std::bidirectional_iterator_tag, value_type, difference_type, Pointer, Reference>
+        {
+          iterator_impl()
+            :n(), pos()
+          {}
+
+          /** iterator to const_iterator */
+          iterator_impl(const typename conditional<is_same<NodePtr, const node*>::value,
+            iterator_impl<node*, reference, pointer>, iterator_impl<const node*, void, void> >::type& i)
+            :n(i.n), pos(i.pos)
+          {}
+
+          Reference operator* () const { return reinterpret_cast<Reference>(n->value(pos)); }
+          Pointer   operator->() const { return reinterpret_cast<Pointer>(&n->value(pos)); }
+
+          iterator_impl& operator++()
+          {
+            if ( !n->leaf || ++pos == n->count )
+              increment_slow();
+            return *this;
+          }
+
+          iterator_impl& operator--()
+          {
+            if ( !n->leaf || pos-- == 0 )
+              decrement_slow();
+            return *this;
+          }
+
+          iterator_impl operator++(int) { iterator_impl tmp( *this ); ++*this; return tmp; }
+          iterator_impl operator--(int) { iterator_impl tmp( *this ); --*this; return tmp; }
+
+          friend bool operator==(const iterator_impl& x, const iterator_impl& y)
+          { return x.n == y.n && x.pos == y.pos; }
+          friend bool operator!=(const iterator_impl& x, const iterator_impl& y)
+          { return !(x == y); }
+
+        private:
+          template<class, class, class> friend struct iterator_impl;
+          friend class btree;
+
+          iterator_impl(NodePtr n, unsigned pos)
+            :n(n), pos(pos)
+          {}
+
+          void increment_slow()
+          {
+            if ( n->leaf )
+            {
+              // the last value of the leaf: up to the first parent which has the next value, or the end
+              const NodePtr leaf = n;
+              while ( pos == n->count && n->parent )
+                pos = n->position, n = n->parent;
+              if ( pos == n->count )
+                n = leaf, pos = leaf->count;
+            }
+            else
+            {
+              // the first value of the right subtree
+              n = n->child(pos + 1);
+              while ( !n->leaf )
+                n = n->child(0);
+              pos = 0;
+            }
+          }
+
+          void decrement_slow()
+          {
+            if ( n->leaf )
+            {
+              // pos is wrapped around: up to the first parent which has the previous value
+              const NodePtr leaf = n;
+              while ( pos == unsigned(-1) && n->parent )
+                pos = n->position - 1u, n = n->parent;
+              if ( pos == unsigned(-1) )
+                n = leaf, pos = 0;
+            }
+            else
+            {
+              // the last value of the left subtree
+              n = n->child(pos);
+              while ( !n->leaf )
+                n = n->child(n->count);
+              pos = n->count - 1u;
+            }
+          }
+
+          NodePtr   n;
+          unsigned  pos;
+        };
+
+      public:
+        typedef iterator_impl<node*, reference, pointer>                    iterator;
+        typedef iterator_impl<const node*, const_reference, const_pointer>  const_iterator;
+        typedef std::reverse_iterator<iterator>       reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+      public:
+        explicit btree(const Compare& comp, const Allocator& a = Allocator())
+          :comparator_(comp), leaf_allocator(a), internal_allocator(a),
+          root_(), leftmost_(), rightmost_(), count_(), leaves_(), internals_()
+        {}
+
+        btree(const btree& x)
+          :comparator_(x.comparator_), leaf_allocator(x.leaf_allocator), internal_allocator(x.internal_allocator),
+          root_(), leftmost_(), rightmost_(), count_(), leaves_(), internals_()
+        {
+          append(x.begin(), x.end());
+        }
+
+#ifdef NTL__CXX_RV
+        btree(btree&& x)
+          :comparator_(x.comparator_), leaf_allocator(x.leaf_allocator), internal_allocator(x.internal_allocator),
+          root_(), leftmost_(), rightmost_(), count_(), leaves_(), internals_()
+        {
+          swap(x);
+        }
+#endif
+
+        btree& operator=(const btree& x)
+        {
+          if ( this != &x )
+          {
+            clear();
+            comparator_ = x.comparator_;
+            append(x.begin(), x.end());
+          }
+          return *this;
+        }
+
+#ifdef NTL__CXX_RV
+        btree& operator=(btree&& x)
+        {
+          if ( this != &x )
+          {
+            clear();
+            swap(x);
+          }
+          return *this;
+        }
+#endif
+
+        ~btree() __ntl_nothrow
+        {
+          clear();
+        }
+
+        allocator_type get_allocator() const { return static_cast<allocator_type>(leaf_allocator); }
+
+        ///\name iterators
+        iterator                begin()        { return iterator(leftmost_, 0); }
+        const_iterator          begin()  const { return const_iterator(leftmost_, 0); }
+        iterator                end()          { return iterator(rightmost_, rightmost_ ? rightmost_->count : 0); }
+        const_iterator          end()    const { return const_iterator(rightmost_, rightmost_ ? rightmost_->count : 0); }
+
+        reverse_iterator        rbegin()       { return reverse_iterator(end()); }
+        const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+        reverse_iterator        rend()         { return reverse_iterator(begin()); }
+        const_reverse_iterator  rend()   const { return const_reverse_iterator(begin()); }
+
+        const_iterator          cbegin() const { return begin(); }
+        const_iterator          cend()   const { return end();   }
+        const_reverse_iterator  crbegin()const { return rbegin();}
+        const_reverse_iterator  crend()  const { return rend();  }
+
+        ///\name capacity
+        bool      empty() const     { return count_ == 0; }
+        size_type size()  const     { return count_; }
+        size_type max_size()  const { return leaf_allocator.max_size(); }
+
+        /** Memory taken by the nodes */
+        size_type bytes_used() const { return leaves_ * sizeof(node) + internals_ * sizeof(internal_node); }
+
+        /** Number of the nodes */
+        size_type nodes() const { return leaves_ + internals_; }
+
+        /** Number of the levels */
+        size_type height() const
+        {
+          if ( !root_ )
+            return 0;
+          size_type h = 1;
+          for ( const node* n = root_; !n->leaf; n = n->child(0) )
+            h++;
+          return h;
+        }
+
+        ///\name observers
+        key_compare key_comp() const { return comparator_; }
+
+        ///\name operations
+        iterator find(const key_type& x)
+        {
+          if ( Multi )
+          {
+            const iterator i = lower_bound(x);
+            return i == end() || comparator_(x, KeyOfValue::get(*i)) ? end() : i;
+          }
+          // the search stops at the first equal key, in the internal nodes too
+          for ( node* n = root_; n; )
+          {
+            const unsigned i = search::lower(n->values(), n->count, x, comparator_);
+            if ( i < n->count && !comparator_(x, KeyOfValue::get(n->value(i))) )
+              return iterator(n, i);
+            if ( n->leaf )
+              break;
+            n = n->child(i);
+          }
+          return end();
+        }
+
+        const_iterator find(const key_type& x) const { return const_cast<btree*>(this)->find(x); }
+
+        iterator lower_bound(const key_type& x)
+        {
+          node* n = root_;
+          if ( !n )
+            return end();
+          for ( ; ; )
+          {
+            const unsigned i = search::lower(n->values(), n->count, x, comparator_);
+            if ( n->leaf )
+              return normalize(iterator(n, i));
+            n = n->child(i);
+          }
+        }
+
+        iterator upper_bound(const key_type& x)
+        {
+          node* n = root_;
+          if ( !n )
+            return end();
+          for ( ; ; )
+          {
+            const unsigned i = search::upper(n->values(), n->count, x, comparator_);
+            if ( n->leaf )
+              return normalize(iterator(n, i));
+            n = n->child(i);
+          }
+        }
+
+        const_iterator lower_bound(const key_type& x) const { return const_cast<btree*>(this)->lower_bound(x); }
+        const_iterator upper_bound(const key_type& x) const { return const_cast<btree*>(this)->upper_bound(x); }
+
+        pair<iterator, iterator> equal_range(const key_type& x)
+        {
+          if ( !Multi )
+          {
+            const iterator i = find(x);
+            if ( i == end() )
+            {
+              const iterator l = lower_bound(x);
+              return make_pair(l, l);
+            }
+            iterator next(i);
+            return make_pair(i, ++next);
+          }
+          return make_pair(lower_bound(x), upper_bound(x));
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& x) const
+        {
+          const pair<iterator, iterator> r = const_cast<btree*>(this)->equal_range(x);
+          return pair<const_iterator, const_iterator>(r.first, r.second);
+        }
+
+        size_type count(const key_type& x) const
+        {
+          if ( !Multi )
+            return find(x) != end();
+          const pair<const_iterator, const_iterator> r = equal_range(x);
+          return static_cast<size_type>(std::distance(r.first, r.second));
+        }
+
+        ///\name modifiers
+        void clear()
+        {
+          if ( root_ )
+            destroy(root_);
+          root_ = leftmost_ = rightmost_ = nullptr;
+          count_ = 0;
+        }
+
+        void swap(btree& x)
+        {
+          if ( this != &x )
+          {
+            using std::swap;
+            swap(comparator_, x.comparator_);
+            swap(leaf_allocator, x.leaf_allocator);
+            swap(internal_allocator, x.internal_allocator);
+            swap(root_, x.root_);
+            swap(leftmost_, x.leftmost_);
+            swap(rightmost_, x.rightmost_);
+            swap(count_, x.count_);
+            swap(leaves_, x.leaves_);
+            swap(internals_, x.internals_);
+          }
+        }
+
+        iterator erase(const_iterator position)
+        {
+          iterator i(const_cast<node*>(position.n), position.pos);
+          bool internal = false;
+          if ( !i.n->leaf )
+          {
+            // replaced by the previous value, which is in a leaf
+            const iterator replaced(i);
+            --i;
+            replaced.n->value(replaced.pos) = move_value(i.n->value(i.pos));
+            internal = true;
+          }
+          remove_value(i.n, i.pos);
+          --count_;
+          iterator re = rebalance_after_erase(i);
+          if ( internal )
+            ++re;
+          return re;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+          if ( first == begin() && last == end() )
+          {
+            clear();
+            return end();
+          }
+          // the erasure moves the values, so the range is counted first
+          difference_type n = std::distance(first, last);
+          iterator i(const_cast<node*>(first.n), first.pos);
+          while ( n-- )
+            i = erase(i);
+          return i;
+        }
+
+        size_type erase(const key_type& x)
+        {
+          if ( !Multi )
+          {
+            const iterator i = find(x);
+            if ( i == end() )
+              return 0;
+            erase(i);
+            return 1;
+          }
+          const pair<iterator, iterator> r = equal_range(x);
+          const size_type n = static_cast<size_type>(std::distance(r.first, r.second));
+          erase(r.first, r.second);
+          return n;
+        }
+        ///\}
+
+      protected:
+        pair<iterator, bool> insert_unique(const value_type& v)
+        {
+          const key_type& key = KeyOfValue::get(v);
+          if ( !root_ )
+            root_ = leftmost_ = rightmost_ = new_node(true);
+          node* n = root_;
+          unsigned i;
+          for ( ; ; )
+          {
+            i = search::lower(n->values(), n->count, key, comparator_);
+            if ( i < n->count && !comparator_(key, KeyOfValue::get(n->value(i))) )
+              return make_pair(iterator(n, i), false);
+            if ( n->leaf )
+              break;
+            n = n->child(i);
+          }
+          return make_pair(insert_value(n, i, v), true);
+        }
+
+        iterator insert_multi(const value_type& v)
+        {
+          const key_type& key = KeyOfValue::get(v);
+          if ( !root_ )
+            root_ = leftmost_ = rightmost_ = new_node(true);
+          node* n = root_;
+          unsigned i;
+          for ( ; ; )
+          {
+            i = search::upper(n->values(), n->count, key, comparator_);
+            if ( n->leaf )
+              break;
+            n = n->child(i);
+          }
+          return insert_value(n, i, v);
+        }
+
+        /** The value is inserted before the \a hint if it belongs there, so the sorted input takes O(1) per value */
+        iterator insert_unique(const_iterator hint, const value_type& v)
+        {
+          iterator i(const_cast<node*>(hint.n), hint.pos);
+          if ( !empty() )
+          {
+            const key_type& key = KeyOfValue::get(v);
+            if ( i == end() || comparator_(key, KeyOfValue::get(*i)) )
+            {
+              iterator prev(i);
+              if ( i == begin() || comparator_(KeyOfValue::get(*--prev), key) )
+                return insert_before(i, prev, v);
+            }
+          }
+          return insert_unique(v).first;
+        }
+
+        iterator insert_multi(const_iterator hint, const value_type& v)
+        {
+          iterator i(const_cast<node*>(hint.n), hint.pos);
+          if ( !empty() )
+          {
+            const key_type& key = KeyOfValue::get(v);
+            if ( i == end() || !comparator_(KeyOfValue::get(*i), key) )
+            {
+              iterator prev(i);
+              if ( i == begin() || !comparator_(key, KeyOfValue::get(*--prev)) )
+                return insert_before(i, prev, v);
+            }
+          }
+          return insert_multi(v);
+        }
+
+        template<class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last)
+        {
+          for ( ; first != last; ++first )
+            insert_unique(end(), *first);
+        }
+
+        template<class InputIterator>
+        void insert_multi(InputIterator first, InputIterator last)
+        {
+          for ( ; first != last; ++first )
+            insert_multi(end(), *first);
+        }
+
+      private:
+        // appends the sorted values
+        template<class InputIterator>
+        void append(InputIterator first, InputIterator last)
+        {
+          for ( ; first != last; ++first )
+          {
+            if ( !root_ )
+              root_ = leftmost_ = rightmost_ = new_node(true);
+            insert_value(rightmost_, rightmost_->count, *first);
+          }
+        }
+
+        // inserts between prev and i
+        iterator insert_before(const iterator& i, const iterator& prev, const value_type& v)
+        {
+          if ( i.n->leaf )
+            return insert_value(i.n, i.pos, v);
+          // the previous value of the internal one is the last in its leaf
+          return insert_value(prev.n, prev.pos + 1, v);
+        }
+
+        // moves the iterator past the end of the leaf to the next value
+        iterator normalize(iterator i)
+        {
+          while ( i.pos == i.n->count )
+          {
+            if ( !i.n->parent )
+              return end();
+            i.pos = i.n->position;
+            i.n = i.n->parent;
+          }
+          return i;
+        }
+
+#ifdef NTL__CXX_RV
+        static Value&& move_value(Value& v) { return std::move(v); }
+#else
+        static Value& move_value(Value& v) { return v; }
+#endif
+
+        static void relocate(Value* to, Value* from)
+        {
+          ::new(static_cast<void*>(to)) Value(move_value(*from));
+          from->~Value();
+        }
+
+        // moves n values to the place which may overlap
+        static void relocate(Value* to, Value* from, unsigned n)
+        {
+          if ( to < from )
+            for ( unsigned i = 0; i < n; i++ )
+              relocate(to + i, from + i);
+          else
+            for ( unsigned i = n; i--; )
+              relocate(to + i, from + i);
+        }
+
+        static void set_child(node* n, unsigned i, node* child)
+        {
+          static_cast<internal_node*>(n)->children[i] = child;
+          child->parent = static_cast<internal_node*>(n);
+          child->position = static_cast<uint16_t>(i);
+        }
+
+        static void move_children(node* to, unsigned at, node* from, unsigned first, unsigned n)
+        {
+          if ( to == from && at > first )
+            for ( unsigned i = n; i--; )
+              set_child(to, at + i, from->child(first + i));
+          else
+            for ( unsigned i = 0; i < n; i++ )
+              set_child(to, at + i, from->child(first + i));
+        }
+
+        node* new_node(bool leaf)
+        {
+          node* n;
+          if ( leaf )
+          {
+            n = leaf_allocator.allocate(1);
+            leaves_++;
+          }
+          else
+          {
+            n = internal_allocator.allocate(1);
+            internals_++;
+          }
+          n->parent = nullptr;
+          n->position = 0;
+          n->count = 0;
+          n->leaf = leaf;
+          return n;
+        }
+
+        void delete_node(node* n)
+        {
+          if ( n->leaf )
+          {
+            leaf_allocator.deallocate(n, 1);
+            leaves_--;
+          }
+          else
+          {
+            internal_allocator.deallocate(static_cast<internal_node*>(n), 1);
+            internals_--;
+          }
+        }
+
+        void destroy(node* n)
+        {
+          if ( !n->leaf )
+            for ( unsigned i = 0; i <= n->count; i++ )
+              destroy(n->child(i));
+          for ( unsigned i = 0; i < n->count; i++ )
+            n->value(i).~Value();
+          delete_node(n);
+        }
+
+        // inserts the value at the position of the leaf
+        iterator insert_value(node* n, unsigned i, const value_type& v)
+        {
+          if ( n->count == slots )
+            split(n, i);
+          relocate(n->values() + i + 1, n->values() + i, n->count - i);
+          ::new(static_cast<void*>(n->values() + i)) Value(v);
+          n->count++;
+          ++count_;
+          return iterator(n, i);
+        }
+
+        // splits the full node to insert at the position i, which is updated with the node
+        void split(node*& n, unsigned& i)
+        {
+          internal_node* parent = n->parent;
+          if ( !parent )
+          {
+            node* const root = new_node(false);
+            set_child(root, 0, n);
+            root_ = root;
+            parent = n->parent;
+          }
+          else if ( parent->count == slots )
+          {
+            node* p = parent;
+            unsigned at = n->position;
+            split(p, at);
+            parent = n->parent;
+          }
+
+          // the appended and the prepended nodes are kept full
+          const unsigned move = i == 0 ? n->count - 1u : i == slots ? 0 : n->count / 2u;
+          node* const sibling = new_node(n->leaf);
+          relocate(sibling->values(), n->values() + n->count - move, move);
+          n->count = static_cast<uint16_t>(n->count - move);
+          sibling->count = static_cast<uint16_t>(move);
+          if ( !n->leaf )
+            move_children(sibling, 0, n, n->count, move + 1);
+          else if ( n == rightmost_ )
+            rightmost_ = sibling;
+
+          // the last value of the node goes up
+          n->count--;
+          const unsigned at = n->position;
+          relocate(parent->values() + at + 1, parent->values() + at, parent->count - at);
+          move_children(parent, at + 2, parent, at + 1, parent->count - at);
+          relocate(parent->values() + at, n->values() + n->count);
+          set_child(parent, at + 1, sibling);
+          parent->count++;
+
+          if ( i > n->count )
+          {
+            i -= n->count + 1u;
+            n = sibling;
+          }
+        }
+
+        // removes the value of the leaf
+        void remove_value(node* n, unsigned i)
+        {
+          n->value(i).~Value();
+          relocate(n->values() + i, n->values() + i + 1, n->count - i - 1u);
+          n->count--;
+        }
+
+        iterator rebalance_after_erase(iterator i)
+        {
+          iterator re(i);
+          bool first = true;
+          for ( ; ; )
+          {
+            if ( i.n == root_ )
+            {
+              shrink();
+              if ( empty() )
+                return end();
+              break;
+            }
+            if ( i.n->count >= min_values )
+              break;
+            const bool merged = merge_or_rebalance(i);
+            // the value of re could move
+            if ( first )
+            {
+              re = i;
+              first = false;
+            }
+            if ( !merged )
+              break;
+            i.pos = i.n->position;
+            i.n = i.n->parent;
+          }
+          return normalize(re);
+        }
+
+        // returns true if the node is merged into the left sibling, so the parent lost a value
+        bool merge_or_rebalance(iterator& i)
+        {
+          node* const n = i.n;
+          node* const parent = n->parent;
+          if ( n->position > 0 )
+          {
+            node* const left = parent->child(n->position - 1u);
+            if ( 1u + left->count + n->count <= slots )
+            {
+              i.pos += 1u + left->count;
+              merge(left, n);
+              i.n = left;
+              return true;
+            }
+          }
+          if ( n->position < parent->count )
+          {
+            node* const right = parent->child(n->position + 1u);
+            if ( 1u + n->count + right->count <= slots )
+            {
+              merge(n, right);
+              return true;
+            }
+            // not when the first value is erased, the front is erased often
+            if ( right->count > min_values && (n->count == 0 || i.pos > 0) )
+            {
+              unsigned k = (right->count - n->count) / 2u;
+              k = (std::min)(k, right->count - 1u);
+              rotate_left(n, right, k);
+              return false;
+            }
+          }
+          if ( n->position > 0 )
+          {
+            // not when the last value is erased, the back is erased often
+            node* const left = parent->child(n->position - 1u);
+            if ( left->count > min_values && (n->count == 0 || i.pos < n->count) )
+            {
+              unsigned k = (left->count - n->count) / 2u;
+              k = (std::min)(k, left->count - 1u);
+              rotate_right(left, n, k);
+              i.pos += k;
+            }
+          }
+          return false;
+        }
+
+        // moves the separator and the right node into the left one
+        void merge(node* left, node* right)
+        {
+          node* const parent = left->parent;
+          const unsigned at = left->position;
+          relocate(left->values() + left->count, parent->values() + at);
+          relocate(left->values() + left->count + 1, right->values(), right->count);
+          if ( !left->leaf )
+            move_children(left, left->count + 1u, right, 0, right->count + 1u);
+          else if ( right == rightmost_ )
+            rightmost_ = left;
+          left->count = static_cast<uint16_t>(left->count + 1 + right->count);
+          right->count = 0;
+
+          relocate(parent->values() + at, parent->values() + at + 1, parent->count - at - 1u);
+          move_children(parent, at + 1, parent, at + 2, parent->count - at - 1u);
+          parent->count--;
+          delete_node(right);
+        }
+
+        // moves k values from the right node to the left one through the parent
+        void rotate_left(node* left, node* right, unsigned k)
+        {
+          node* const parent = left->parent;
+          const unsigned at = left->position;
+          relocate(left->values() + left->count, parent->values() + at);
+          relocate(left->values() + left->count + 1, right->values(), k - 1);
+          relocate(parent->values() + at, right->values() + k - 1);
+          relocate(right->values(), right->values() + k, right->count - k);
+          if ( !left->leaf )
+          {
+            move_children(left, left->count + 1u, right, 0, k);
+            move_children(right, 0, right, k, right->count - k + 1u);
+          }
+          left->count = static_cast<uint16_t>(left->count + k);
+          right->count = static_cast<uint16_t>(right->count - k);
+        }
+
+        // moves k values from the left node to the right one through the parent
+        void rotate_right(node* left, node* right, unsigned k)
+        {
+          node* const parent = left->parent;
+          const unsigned at = left->position;
+          relocate(right->values() + k, right->values(), right->count);
+          relocate(right->values() + k - 1, parent->values() + at);
+          relocate(right->values(), left->values() + left->count - k + 1, k - 1);
+          relocate(parent->values() + at, left->values() + left->count - k);
+          if ( !left->leaf )
+          {
+            move_children(right, k, right, 0, right->count + 1u);
+            move_children(right, 0, left, left->count - k + 1u, k);
+          }
+          left->count = static_cast<uint16_t>(left->count - k);
+          right->count = static_cast<uint16_t>(right->count + k);
+        }
+
+        // removes the empty root
+        void shrink()
+        {
+          if ( root_->count )
+            return;
+          node* const root = root_;
+          if ( root->leaf )
+            root_ = leftmost_ = rightmost_ = nullptr;
+          else
+          {
+            root_ = root->child(0);
+            root_->parent = nullptr;
+          }
+          delete_node(root);
+        }
+
+      protected:
+        key_compare comparator_;
+        typename Allocator::template rebind<node>::other          leaf_allocator;
+        typename Allocator::template rebind<internal_node>::other internal_allocator;
+
+        node*     root_;
+        node*     leftmost_;
+        node*     rightmost_;
+        size_type count_;
+        size_type leaves_;
+        size_type internals_;
+      };
+
+      template<class K, class V, class KV, class C, class A, bool M, size_t S>
+      inline bool operator == (const btree<K, V, KV, C, A, M, S>& x, const btree<K, V, KV, C, A, M, S>& y)
+      {
+        return x.size() == y.size() && equal(x.cbegin(), x.cend(), y.cbegin());
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, size_t S>
+      inline bool operator != (const btree<K, V, KV, C, A, M, S>& x, const btree<K, V, KV, C, A, M, S>& y)
+      {
+        return !(x == y);
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, size_t S>
+      inline bool operator < (const btree<K, V, KV, C, A, M, S>& x, const btree<K, V, KV, C, A, M, S>& y)
+      {
+        return lexicographical_compare(x.cbegin(), x.cend(), y.cbegin(), y.cend());
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, size_t S>
+      inline bool operator > (const btree<K, V, KV, C, A, M, S>& x, const btree<K, V, KV, C, A, M, S>& y)
+      {
+        return y < x;
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, size_t S>
+      inline bool operator <= (const btree<K, V, KV, C, A, M, S>& x, const btree<K, V, KV, C, A, M, S>& y)
+      {
+        return !(y < x);
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, size_t S>
+      inline bool operator >= (const btree<K, V, KV, C, A, M, S>& x, const btree<K, V, KV, C, A, M, S>& y)
+      {
+        return !(x < y);
+      }
+    } // tree
+  } // ext
+} // std
+#endif // NTL__EXT_BTREE
@@ -0,0 +1,514 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Sorted vector of the ordered containers
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__EXT_FLAT_TREE
+#define NTL__EXT_FLAT_TREE
+#pragma once
+
+#include "../vector.hxx"
+#include "../algorithm.hxx"
+#include "../functional.hxx"
+
+namespace std
+{
+  namespace ext
+  {
+    namespace tree
+    {
+      namespace __
+      {
+        /// Key of the set value
+        template<class Key>
+        struct flat_set_key
+        {
+          typedef Key value_type;
+
+          static const Key& get(const Key& v) { return v; }
+        };
+
+        /**
+         *	Key of the map value: the vector keeps the mutable pair<Key, T> to sort and merge it,
+         *  the users see it as the value_type of the same layout.
+         **/
+        template<class Key, class T>
+        struct flat_map_key
+        {
+          typedef pair<const Key, T> value_type;
+
+          static const Key& get(const pair<Key, T>& v) { return v.first; }
+          static const Key& get(const value_type& v) { return v.first; }
+        };
+
+        /// The keys before the lower bound
+        template<class Key, class Compare>
+        struct flat_lower
+        {
+          flat_lower(const Compare& comp, const Key& key) :comp(comp), key(key) {}
+          bool operator()(const Key& x) const { return comp(x, key); }
+          const Compare& comp;
+          const Key&     key;
+        private:
+          flat_lower& operator=(const flat_lower&);
+        };
+
+        /// The keys before the upper bound
+        template<class Key, class Compare>
+        struct flat_upper
+        {
+          flat_upper(const Compare& comp, const Key& key) :comp(comp), key(key) {}
+          bool operator()(const Key& x) const { return !comp(key, x); }
+          const Compare& comp;
+          const Key&     key;
+        private:
+          flat_upper& operator=(const flat_upper&);
+        };
+      } // __
+
+      /**
+       *	The layouts of the flat_tree lookup. The index of a layout is rebuilt after every modification
+       *  and finds the first of the sorted values which key isn't \a before the bound.
+       **/
+
+      /// The binary search of the sorted values
+      struct flat_binary_layout
+      {
+        template<class Key, class Value, class KeyOfValue, class Allocator>
+        struct index
+        {
+          void build(const Value*, size_t) {}
+          void swap(index&) {}
+          size_t bytes_used() const { return 0; }
+
+          template<class Before>
+          size_t partition_point(const Value* values, size_t n, Before before) const
+          {
+            size_t first = 0;
+            while ( n )
+            {
+              const size_t half = n / 2;
+              if ( before(KeyOfValue::get(values[first + half])) )
+                first += half + 1, n -= half + 1;
+              else
+                n = half;
+            }
+            return first;
+          }
+        };
+      };
+
+      /// The binary search without the branches: the conditional moves don't stall on the mispredictions
+      struct flat_branchless_layout
+      {
+        template<class Key, class Value, class KeyOfValue, class Allocator>
+        struct index:
+          flat_binary_layout::index<Key, Value, KeyOfValue, Allocator>
+        {
+          template<class Before>
+          size_t partition_point(const Value* values, size_t n, Before before) const
+          {
+            if ( n == 0 )
+              return 0;
+            const Value* base = values;
+            while ( n > 1 )
+            {
+              const size_t half = n / 2;
+              base = before(KeyOfValue::get(base[half])) ? base + half : base;
+              n -= half;
+            }
+            return (base - values) + before(KeyOfValue::get(*base));
+          }
+        };
+      };
+
+      /**
+       *	The copy of the keys in the breadth-first order of the binary search (Eytzinger layout):
+       *  the top levels of the search share a few cache lines. Requires the default constructible keys.
+       **/
+      struct flat_eytzinger_layout
+      {
+        template<class Key, class Value, class KeyOfValue, class Allocator>
+        struct index
+        {
+          void build(const Value* values, size_t n)
+          {
+            keys.clear();
+            ranks.clear();
+            if ( n == 0 )
+              return;
+            keys.resize(n + 1);
+            ranks.resize(n + 1);
+            fill(values, 0, 1);
+          }
+
+          void swap(index& x)
+          {
+            keys.swap(x.keys);
+            ranks.swap(x.ranks);
+          }
+
+          size_t bytes_used() const { return keys.capacity() * sizeof(Key) + ranks.capacity() * sizeof(size_t); }
+
+          template<class Before>
+          size_t partition_point(const Value*, size_t n, Before before) const
+          {
+            size_t k = 1;
+            while ( k <= n )
+              k = 2 * k + before(keys[k]);
+            // the bound is where the search went left the last time
+            while ( k & 1 )
+              k >>= 1;
+            k >>= 1;
+            return k ? ranks[k] : n;
+          }
+
+        private:
+          // the in-order walk of the implicit tree (1-based: the children of k are 2k and 2k+1) visits the sorted values
+          size_t fill(const Value* values, size_t i, size_t k)
+          {
+            if ( k < keys.size() )
+            {
+              i = fill(values, i, 2 * k);
+              keys[k] = KeyOfValue::get(values[i]);
+              ranks[k] = i++;
+              i = fill(values, i, 2 * k + 1);
+            }
+            return i;
+          }
+
+          vector<Key, typename Allocator::template rebind<Key>::other>        keys;
+          vector<size_t, typename Allocator::template rebind<size_t>::other>  ranks;
+        };
+      };
+
+      /**
+       *	Flat tree: the values are kept sorted in the vector, so the lookup is the binary search of the array
+       *  and the iteration is the array walk, with no memory per value besides the value itself.
+       *
+       *  The insertion and the erasure of a value takes O(n) and invalidates the iterators,
+       *  it fits the containers which are built at once and then looked up: the range is inserted in O(n log n),
+       *  or O(n) when it is sorted already. The \a Multi tree keeps the equal keys in the order of insertion.
+       *  The vector keeps the \a Value, the iterators point to it as the KeyOfValue::value_type of the same layout.
+       **/
+      template<class Key, class Value, class KeyOfValue, class Compare, class Allocator, bool Multi, class Layout = flat_binary_layout>
+      class flat_tree
+      {
+      public:
+        typedef           Key                         key_type;
+        typedef typename  KeyOfValue::value_type      value_type;
+      private:
+        typedef typename
+          Allocator::template rebind<value_type>::other allocator;
+        typedef typename
+          Allocator::template rebind<Value>::other    stored_allocator;
+      public:
+        typedef           Compare                     key_compare;
+        typedef           Allocator                   allocator_type;
+        typedef vector<Value, stored_allocator>       container_type;
+
+        typedef typename  allocator::pointer          pointer;
+        typedef typename  allocator::const_pointer    const_pointer;
+        typedef typename  allocator::reference        reference;
+        typedef typename  allocator::const_reference  const_reference;
+        typedef typename  allocator::size_type        size_type;
+        typedef typename  allocator::difference_type  difference_type;
+
+        typedef           pointer                       iterator;
+        typedef           const_pointer                 const_iterator;
+        typedef std::reverse_iterator<iterator>         reverse_iterator;
+        typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+      protected:
+        typedef typename Layout::template index<Key, Value, KeyOfValue, stored_allocator> index_type;
+
+        struct value_less
+        {
+          explicit value_less(const Compare& comp) :comp(comp) {}
+          bool operator()(const Value& x, const Value& y) const { return comp(KeyOfValue::get(x), KeyOfValue::get(y)); }
+          Compare comp;
+        };
+
+        // the equal keys of the sorted values: y isn't before x
+        struct value_equivalent
+        {
+          explicit value_equivalent(const Compare& comp) :comp(comp) {}
+          bool operator()(const Value& x, const Value& y) const { return !comp(KeyOfValue::get(x), KeyOfValue::get(y)); }
+          Compare comp;
+        };
+
+      public:
+        explicit flat_tree(const Compare& comp, const Allocator& a = Allocator())
+          :comparator_(comp), values_(stored_allocator(a))
+        {}
+
+        flat_tree(const flat_tree& x)
+          :comparator_(x.comparator_), values_(x.values_), index_(x.index_)
+        {}
+
+        flat_tree& operator=(const flat_tree& x)
+        {
+          comparator_ = x.comparator_;
+          values_ = x.values_;
+          index_ = x.index_;
+          return *this;
+        }
+
+#ifdef NTL__CXX_RV
+        flat_tree(flat_tree&& x)
+          :comparator_(x.comparator_), values_(x.values_.get_allocator())
+        {
+          swap(x);
+        }
+
+        flat_tree& operator=(flat_tree&& x)
+        {
+          if ( this != &x )
+          {
+            clear();
+            swap(x);
+          }
+          return *this;
+        }
+#endif
+
+        allocator_type get_allocator() const { return values_.get_allocator(); }
+
+        ///\name iterators
+        iterator                begin()        { return reinterpret_cast<iterator>(values_.data()); }
+        const_iterator          begin()  const { return reinterpret_cast<const_iterator>(values_.data()); }
+        iterator                end()          { return begin() + values_.size(); }
+        const_iterator          end()    const { return begin() + values_.size(); }
+
+        reverse_iterator        rbegin()       { return reverse_iterator(end()); }
+        const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+        reverse_iterator        rend()         { return reverse_iterator(begin()); }
+        const_reverse_iterator  rend()   const { return const_reverse_iterator(begin()); }
+
+        const_iterator          cbegin() const { return begin(); }
+        const_iterator          cend()   const { return end();   }
+        const_reverse_iterator  crbegin()const { return rbegin();}
+        const_reverse_iterator  crend()  const { return rend();  }
+
+        ///\name capacity
+        bool      empty() const     { return values_.empty(); }
+        size_type size()  const     { return values_.size(); }
+        size_type max_size()  const { return values_.max_size(); }
+
+        size_type capacity() const  { return values_.capacity(); }
+        void reserve(size_type n)   { values_.reserve(n); }
+        void shrink_to_fit()        { values_.shrink_to_fit(); }
+
+        /** Memory taken by the values and the index */
+        size_type bytes_used() const { return values_.capacity() * sizeof(Value) + index_.bytes_used(); }
+
+        /** The sorted values */
+        const container_type& sequence() const { return values_; }
+
+        ///\name observers
+        key_compare key_comp() const { return comparator_; }
+
+        ///\name operations
+        iterator find(const key_type& x)
+        {
+          const iterator i = lower_bound(x);
+          return i == end() || comparator_(x, KeyOfValue::get(*i)) ? end() : i;
+        }
+
+        const_iterator find(const key_type& x) const { return const_cast<flat_tree*>(this)->find(x); }
+
+        iterator lower_bound(const key_type& x)
+        {
+          return begin() + index_.partition_point(values_.data(), values_.size(), __::flat_lower<Key, Compare>(comparator_, x));
+        }
+
+        iterator upper_bound(const key_type& x)
+        {
+          return begin() + index_.partition_point(values_.data(), values_.size(), __::flat_upper<Key, Compare>(comparator_, x));
+        }
+
+        const_iterator lower_bound(const key_type& x) const { return const_cast<flat_tree*>(this)->lower_bound(x); }
+        const_iterator upper_bound(const key_type& x) const { return const_cast<flat_tree*>(this)->upper_bound(x); }
+
+        pair<iterator, iterator> equal_range(const key_type& x)
+        {
+          const iterator i = lower_bound(x);
+          if ( !Multi )
+            return make_pair(i, i == end() || comparator_(x, KeyOfValue::get(*i)) ? i : i + 1);
+          return make_pair(i, upper_bound(x));
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& x) const
+        {
+          const pair<iterator, iterator> r = const_cast<flat_tree*>(this)->equal_range(x);
+          return pair<const_iterator, const_iterator>(r.first, r.second);
+        }
+
+        size_type count(const key_type& x) const
+        {
+          const pair<const_iterator, const_iterator> r = equal_range(x);
+          return static_cast<size_type>(r.second - r.first);
+        }
+
+        ///\name modifiers
+        void clear()
+        {
+          values_.clear();
+          index_.build(values_.data(), 0);
+        }
+
+        void swap(flat_tree& x)
+        {
+          if ( this != &x )
+          {
+            using std::swap;
+            swap(comparator_, x.comparator_);
+            values_.swap(x.values_);
+            index_.swap(x.index_);
+          }
+        }
+
+        iterator erase(const_iterator position)
+        {
+          const size_type i = offset(position);
+          values_.erase(values_.begin() + i);
+          rebuild();
+          return begin() + i;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+          const size_type i = offset(first);
+          values_.erase(values_.begin() + i, values_.begin() + offset(last));
+          rebuild();
+          return begin() + i;
+        }
+
+        size_type erase(const key_type& x)
+        {
+          const pair<iterator, iterator> r = equal_range(x);
+          const size_type n = static_cast<size_type>(r.second - r.first);
+          if ( n )
+            erase(r.first, r.second);
+          return n;
+        }
+        ///\}
+
+      protected:
+        pair<iterator, bool> insert_unique(const value_type& v)
+        {
+          const iterator i = lower_bound(KeyOfValue::get(v));
+          if ( i != end() && !comparator_(KeyOfValue::get(v), KeyOfValue::get(*i)) )
+            return make_pair(i, false);
+          return make_pair(insert_at(i, v), true);
+        }
+
+        iterator insert_multi(const value_type& v)
+        {
+          return insert_at(upper_bound(KeyOfValue::get(v)), v);
+        }
+
+        /** The value is inserted before the \a hint if it belongs there, without the search */
+        iterator insert_unique(const_iterator hint, const value_type& v)
+        {
+          const key_type& key = KeyOfValue::get(v);
+          if ( (hint == end() || comparator_(key, KeyOfValue::get(*hint)))
+            && (hint == begin() || comparator_(KeyOfValue::get(*(hint - 1)), key)) )
+            return insert_at(hint, v);
+          return insert_unique(v).first;
+        }
+
+        iterator insert_multi(const_iterator hint, const value_type& v)
+        {
+          const key_type& key = KeyOfValue::get(v);
+          if ( (hint == end() || !comparator_(KeyOfValue::get(*hint), key))
+            && (hint == begin() || !comparator_(key, KeyOfValue::get(*(hint - 1)))) )
+            return insert_at(hint, v);
+          return insert_multi(v);
+        }
+
+        /**
+         *	The range is appended, sorted and merged with the values in O(n log n) of its length and O(n) of the tree size.
+         *  The \a sorted range isn't sorted again. The first of the equal keys is kept in the unique tree.
+         **/
+        template<class InputIterator>
+        void insert_range(InputIterator first, InputIterator last, bool sorted)
+        {
+          const size_type n = values_.size();
+          values_.insert(values_.end(), first, last);
+          const typename container_type::iterator middle = values_.begin() + n;
+          if ( middle == values_.end() )
+            return;
+          if ( !sorted )
+            stable_sort(middle, values_.end(), value_less(comparator_));
+          inplace_merge(values_.begin(), middle, values_.end(), value_less(comparator_));
+          if ( !Multi )
+            values_.erase(unique(values_.begin(), values_.end(), value_equivalent(comparator_)), values_.end());
+          rebuild();
+        }
+
+      private:
+        iterator insert_at(const_iterator i, const value_type& v)
+        {
+          const size_type n = offset(i);
+          values_.insert(values_.begin() + n, Value(v));
+          rebuild();
+          return begin() + n;
+        }
+
+        size_type offset(const_iterator i) const
+        {
+          return static_cast<size_type>(i - begin());
+        }
+
+        void rebuild()
+        {
+          index_.build(values_.data(), values_.size());
+        }
+
+      protected:
+        Compare         comparator_;
+        container_type  values_;
+        index_type      index_;
+      };
+
+      template<class K, class V, class KV, class C, class A, bool M, class L>
+      inline bool operator == (const flat_tree<K, V, KV, C, A, M, L>& x, const flat_tree<K, V, KV, C, A, M, L>& y)
+      {
+        return x.size() == y.size() && equal(x.cbegin(), x.cend(), y.cbegin());
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, class L>
+      inline bool operator != (const flat_tree<K, V, KV, C, A, M, L>& x, const flat_tree<K, V, KV, C, A, M, L>& y)
+      {
+        return !(x == y);
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, class L>
+      inline bool operator < (const flat_tree<K, V, KV, C, A, M, L>& x, const flat_tree<K, V, KV, C, A, M, L>& y)
+      {
+        return lexicographical_compare(x.cbegin(), x.cend(), y.cbegin(), y.cend());
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, class L>
+      inline bool operator > (const flat_tree<K, V, KV, C, A, M, L>& x, const flat_tree<K, V, KV, C, A, M, L>& y)
+      {
+        return y < x;
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, class L>
+      inline bool operator <= (const flat_tree<K, V, KV, C, A, M, L>& x, const flat_tree<K, V, KV, C, A, M, L>& y)
+      {
+        return !(y < x);
+      }
+
+      template<class K, class V, class KV, class C, class A, bool M, class L>
+      inline bool operator >= (const flat_tree<K, V, KV, C, A, M, L>& x, const flat_tree<K, V, KV, C, A, M, L>& y)
+      {
+        return !(x < y);
+      }
+    } // tree
+  } // ext
+} // std
+#endif // NTL__EXT_FLAT_TREE
@@ -0,0 +1,499 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Memory-mapped file input streams (NTL extension)
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__STLX_EXT_MAPSTREAM
+#define NTL__STLX_EXT_MAPSTREAM
+#pragma once
+
+#include "../streambuf.hxx"
+#include "../istream.hxx"
+
+#if defined(__linux__)
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+#else
+# include "../../nt/file.hxx"
+# include "tr2/filesystem.hxx"
+#endif
+
+namespace std {
+
+  /**\addtogroup  lib_input_output ******* 27 Input/output library [input.output]
+   *@{*/
+  /**\addtogroup  lib_file_streams ******* 27.9 File-based streams [file.streams]
+   *@{*/
+
+  namespace __
+  {
+#if !defined(__linux__)
+    /**
+     *	@brief Read-only file view over an NT section object
+     *  @details A single view is mapped at a time; mapping a new window unmaps the previous one.
+     **/
+    class nt_file_view
+    {
+      typedef ntl::nt::file_handler native_file;
+
+      nt_file_view(const nt_file_view&) __deleted;
+      nt_file_view& operator=(const nt_file_view&) __deleted;
+    public:
+      /** View offsets must be aligned to the allocation granularity */
+      static const size_t granularity = 64 * 1024;
+
+      nt_file_view()
+        :base(), size_()
+      {}
+
+      ~nt_file_view()
+      {
+        close();
+      }
+
+      bool is_open() const { return !!f; }
+
+      bool open(const char* name, bool sequential)
+      {
+        return open(tr2::sys::filesystem::path(name), sequential);
+      }
+
+      template<class Path>
+      bool open(const Path& name, bool sequential)
+      {
+        using namespace ntl::nt;
+        const native_file::creation_options co = native_file::creation_options_default | (sequential ? native_file::sequental_only : native_file::random_access);
+        if(!success(f.open(name.external_file_string(), native_file::generic_read, native_file::share_read|native_file::share_delete, co)))
+          return false;
+
+        // an empty file can't be mapped, it is just an empty sequence
+        size_ = static_cast<uint64_t>(f.size());
+        if(size_ && !success(section::create(&s, section::map_read|section::query, nullptr, nullptr, page_protection::page_readonly, allocation_attributes::sec_commit, f.get()))){
+          close();
+          return false;
+        }
+        return true;
+      }
+
+      void close()
+      {
+        unmap();
+        s.reset();
+        f.close();
+        size_ = 0;
+      }
+
+      uint64_t size() const { return size_; }
+
+      const void* map(uint64_t offset, size_t length)
+      {
+        using namespace ntl::nt;
+        unmap();
+        int64_t view_offset = static_cast<int64_t>(offset);
+        size_t view_size = length;
+        void* p = nullptr;
+        if(!success(NtMapViewOfSection(s.get(), current_process(), &p, 0, 0, &view_offset, &view_size, section_inherit::ViewUnmap, allocation_attributes::none, page_protection::page_readonly)))
+          return nullptr;
+        return base = p;
+      }
+
+      void unmap()
+      {
+        if(base){
+          ntl::nt::NtUnmapViewOfSection(ntl::nt::current_process(), base);
+          base = nullptr;
+        }
+      }
+
+    private:
+      native_file f;
+      ntl::nt::handle s;
+      void* base;
+      uint64_t size_;
+    };
+    typedef nt_file_view native_file_view;
+
+#else
+    /**
+     *	@brief Read-only file view over mmap(2)
+     *  @details Makes the mapped streams usable (and testable) on Linux.
+     **/
+    class posix_file_view
+    {
+      posix_file_view(const posix_file_view&) __deleted;
+      posix_file_view& operator=(const posix_file_view&) __deleted;
+    public:
+      /** mmap offsets must be page aligned, use the largest common page size */
+      static const size_t granularity = 64 * 1024;
+
+      posix_file_view()
+        :fd(-1), base(), length(), size_(), sequential()
+      {}
+
+      ~posix_file_view()
+      {
+        close();
+      }
+
+      bool is_open() const { return fd != -1; }
+
+      bool open(const char* name, bool sequential)
+      {
+        fd = ::open(name, O_RDONLY);
+        if(fd == -1)
+          return false;
+        const off_t end = ::lseek(fd, 0, SEEK_END);
+        if(end == -1){
+          close();
+          return false;
+        }
+        size_ = static_cast<uint64_t>(end);
+        this->sequential = sequential;
+        return true;
+      }
+
+      void close()
+      {
+        unmap();
+        if(fd != -1)
+          ::close(fd);
+        fd = -1;
+        size_ = 0;
+      }
+
+      uint64_t size() const { return size_; }
+
+      const void* map(uint64_t offset, size_t length)
+      {
+        unmap();
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+        if(p == MAP_FAILED)
+          return nullptr;
+        if(sequential)
+          ::madvise(p, length, MADV_SEQUENTIAL);
+        this->length = length;
+        return base = p;
+      }
+
+      void unmap()
+      {
+        if(base){
+          ::munmap(base, length);
+          base = nullptr;
+        }
+      }
+
+    private:
+      int fd;
+      void* base;
+      size_t length;
+      uint64_t size_;
+      bool sequential;
+    };
+    typedef posix_file_view native_file_view;
+#endif
+  } // __
+
+
+/**
+ *	@brief Read-only stream buffer which uses the mapped file view as the get area (NTL extension)
+ *  @details There is no copying into an intermediate buffer: the characters are read straight from the mapped pages.
+ *  Files larger than the window (or the address space) are read through a sliding window,
+ *  which is remapped on underflow and on seeking out of the current window.
+ *
+ *  The file content is interpreted as raw \c charT sequence (like the binary mode of basic_filebuf),
+ *  a trailing incomplete character is ignored.
+ *
+ *  \tparam FileView the mapping backend: \c open(name, sequential), \c close(), \c size(), \c map(offset, length), \c unmap()
+ *  and \c granularity of the view offsets.
+ **/
+  template <class charT, class traits = char_traits<charT>, class FileView = __::native_file_view>
+  class basic_mapped_filebuf:
+    public basic_streambuf<charT, traits>
+  {
+    basic_mapped_filebuf(const basic_mapped_filebuf& rhs) __deleted;
+    basic_mapped_filebuf& operator=(const basic_mapped_filebuf& rhs) __deleted;
+  public:
+    typedef charT                     char_type;
+    typedef typename traits::int_type int_type;
+    typedef typename traits::pos_type pos_type;
+    typedef typename traits::off_type off_type;
+    typedef traits                    traits_type;
+    typedef FileView                  file_view;
+
+    /** Default window: 64 MB on 32-bit platforms, 1 GB on 64-bit ones */
+    static const size_t default_window_size = sizeof(void*) > 4 ? 1024*1024*1024 : 64*1024*1024;
+
+    ///\name constructors
+    basic_mapped_filebuf()
+      :window_size(default_window_size), window_offset(), next(), sequential(true)
+    {}
+
+    virtual ~basic_mapped_filebuf()
+    {
+      close();
+    }
+
+    ///\name Member functions
+    bool is_open() const { return view.is_open(); }
+
+    /** Opens the file for reading, \p mode must not request the output */
+    basic_mapped_filebuf* open(const char* s, ios_base::openmode mode = ios_base::in)
+    {
+      return do_open(s, mode) ? this : nullptr;
+    }
+    basic_mapped_filebuf* open(const string& s, ios_base::openmode mode = ios_base::in)
+    {
+      return do_open(s.c_str(), mode) ? this : nullptr;
+    }
+#if !defined(__linux__)
+    template<class Path>
+    basic_mapped_filebuf* open(const Path& name, ios_base::openmode mode = ios_base::in, typename enable_if<tr2::sys::filesystem::is_basic_path<Path>::value>::type* =0)
+    {
+      return do_open(name, mode) ? this : nullptr;
+    }
+#endif
+
+    basic_mapped_filebuf* close()
+    {
+      if(!view.is_open())
+        return nullptr;
+      view.close();
+      this->setg(nullptr, nullptr, nullptr);
+      window_offset = next = 0;
+      return this;
+    }
+
+    /** Sets the size of the mapped window in bytes, it is rounded up to the view granularity and applied at the next remapping */
+    void window(size_t bytes)
+    {
+      const size_t g = file_view::granularity;
+      window_size = bytes < g ? g : (bytes + g - 1) & ~(g - 1);
+    }
+    size_t window() const { return window_size; }
+
+    /** Hints the file will be read sequentially (the default), should be set before open() */
+    void advise_sequential(bool on) { sequential = on; }
+
+    /** Size of the file in characters */
+    streamsize size() const { return static_cast<streamsize>(view.size() / sizeof(char_type)); }
+    ///\}
+
+  protected:
+    ///\name Overridden virtual functions
+    virtual streamsize showmanyc()
+    {
+      if(!view.is_open())
+        return -1;
+      const uint64_t pos = position();
+      return pos < view.size() ? static_cast<streamsize>((view.size() - pos) / sizeof(char_type)) : -1;
+    }
+
+    virtual int_type underflow()
+    {
+      if(this->gptr() < this->egptr())
+        return traits_type::to_int_type(*this->gptr());
+      if(!view.is_open() || !map_at(position()))
+        return traits_type::eof();
+      return traits_type::to_int_type(*this->gptr());
+    }
+
+    virtual int_type pbackfail(int_type c = traits::eof())
+    {
+      // the view is read-only, so only the same character can be put back
+      const int_type eof = traits_type::eof();
+      const uint64_t pos = position();
+      if(!view.is_open() || pos < sizeof(char_type))
+        return eof;
+      if(this->gptr() != this->eback())
+        this->gbump(-1);
+      else if(!map_at(pos - sizeof(char_type)))
+        return eof;
+      const int_type prev = traits_type::to_int_type(*this->gptr());
+      if(!traits_type::eq_int_type(c, eof) && !traits_type::eq_int_type(c, prev)){
+        this->gbump(1);
+        return eof;
+      }
+      return prev;
+    }
+
+    virtual pos_type seekoff(off_type off, ios_base::seekdir way, ios_base::openmode which = ios_base::in | ios_base::out)
+    {
+      if(!view.is_open() || !(which & ios_base::in))
+        return pos_type(off_type(-1));
+      off_type base = 0;
+      if(way == ios_base::cur)
+        base = static_cast<off_type>(position() / sizeof(char_type));
+      else if(way == ios_base::end)
+        base = static_cast<off_type>(view.size() / sizeof(char_type));
+      return seek(base + off);
+    }
+
+    virtual pos_type seekpos(pos_type sp, ios_base::openmode which = ios_base::in | ios_base::out)
+    {
+      if(!view.is_open() || !(which & ios_base::in))
+        return pos_type(off_type(-1));
+      return seek(off_type(sp));
+    }
+    ///\}
+
+  private:
+    template<class Path>
+    bool do_open(const Path& name, ios_base::openmode mode)
+    {
+      if(view.is_open() || (mode & (ios_base::out|ios_base::app|ios_base::trunc)))
+        return false;
+      if(!view.open(name, sequential))
+        return false;
+      window_offset = next = 0;
+      this->setg(nullptr, nullptr, nullptr);
+      if(mode & ios_base::ate)
+        seekoff(0, ios_base::end, ios_base::in);
+      return true;
+    }
+
+    /** Byte position of the next character */
+    uint64_t position() const
+    {
+      return this->eback() ? window_offset + static_cast<uint64_t>(this->gptr() - this->eback()) * sizeof(char_type) : next;
+    }
+
+    pos_type seek(off_type off)
+    {
+      const uint64_t pos = static_cast<uint64_t>(off) * sizeof(char_type);
+      if(off < 0 || pos > view.size())
+        return pos_type(off_type(-1));
+      if(this->eback() && pos >= window_offset && pos < window_offset + static_cast<uint64_t>(this->egptr() - this->eback()) * sizeof(char_type)){
+        // inside of the current window
+        const size_t n = static_cast<size_t>((pos - window_offset) / sizeof(char_type));
+        this->setg(this->eback(), this->eback() + n, this->egptr());
+      }else{
+        // will be mapped on demand
+        view.unmap();
+        this->setg(nullptr, nullptr, nullptr);
+        next = pos;
+      }
+      return pos_type(off);
+    }
+
+    /** Maps the window which contains \p pos, returns false at end of file */
+    bool map_at(uint64_t pos)
+    {
+      const uint64_t offset = pos & ~static_cast<uint64_t>(file_view::granularity - 1);
+      uint64_t length = view.size() > offset ? view.size() - offset : 0;
+      if(length > window_size)
+        length = window_size;
+      length -= length % sizeof(char_type);
+      if(length <= pos - offset){
+        view.unmap();
+        this->setg(nullptr, nullptr, nullptr);
+        next = pos;
+        return false;
+      }
+      char_type* const p = static_cast<char_type*>(const_cast<void*>(view.map(offset, static_cast<size_t>(length))));
+      if(!p){
+        this->setg(nullptr, nullptr, nullptr);
+        next = pos;
+        return false;
+      }
+      window_offset = offset;
+      this->setg(p, p + static_cast<size_t>(pos - offset) / sizeof(char_type), p + static_cast<size_t>(length) / sizeof(char_type));
+      return true;
+    }
+
+  private:
+    file_view view;
+    size_t    window_size;
+    uint64_t  window_offset;  // file offset of eback()
+    uint64_t  next;           // position when no window is mapped
+    bool      sequential;
+  };
+
+
+/**
+ *	@brief Input file stream over basic_mapped_filebuf (NTL extension)
+ **/
+  template <class charT, class traits = char_traits<charT>, class FileView = __::native_file_view>
+  class basic_imapstream:
+    public basic_istream<charT, traits>
+  {
+  public:
+    typedef charT                     char_type;
+    typedef typename traits::int_type int_type;
+    typedef typename traits::pos_type pos_type;
+    typedef typename traits::off_type off_type;
+    typedef traits                    traits_type;
+    typedef basic_mapped_filebuf<charT, traits, FileView> filebuf_type;
+
+    ///\name constructors
+    basic_imapstream()
+      :basic_istream<charT, traits>(&sb)
+    {}
+
+    explicit basic_imapstream(const char* s, ios_base::openmode mode = ios_base::in)
+      :basic_istream<charT, traits>(&sb)
+    {
+      open(s, mode);
+    }
+    explicit basic_imapstream(const string& s, ios_base::openmode mode = ios_base::in)
+      :basic_istream<charT, traits>(&sb)
+    {
+      open(s, mode);
+    }
+#if !defined(__linux__)
+    template<class Path>
+    explicit basic_imapstream(const Path& name, ios_base::openmode mode = ios_base::in, typename enable_if<tr2::sys::filesystem::is_basic_path<Path>::value>::type* =0)
+      :basic_istream<charT, traits>(&sb)
+    {
+      open(name, mode);
+    }
+#endif
+
+    ///\name Member functions
+    filebuf_type* rdbuf() const { return const_cast<filebuf_type*>(&sb); }
+
+    bool is_open() const { return sb.is_open(); }
+
+    void open(const char* s, ios_base::openmode mode = ios_base::in)
+    {
+      if(!sb.open(s, mode|ios_base::in))
+        this->setstate(ios_base::failbit);
+    }
+    void open(const string& s, ios_base::openmode mode = ios_base::in)
+    {
+      if(!sb.open(s, mode|ios_base::in))
+        this->setstate(ios_base::failbit);
+    }
+#if !defined(__linux__)
+    template<class Path>
+    void open(const Path& name, ios_base::openmode mode = ios_base::in, typename enable_if<tr2::sys::filesystem::is_basic_path<Path>::value>::type* =0)
+    {
+      if(!sb.open(name, mode|ios_base::in))
+        this->setstate(ios_base::failbit);
+    }
+#endif
+    void close()
+    {
+      if(!sb.close())
+        this->setstate(ios_base::failbit);
+    }
+
+  private:
+    filebuf_type sb;
+
+    basic_imapstream(const basic_imapstream&) __deleted;
+    basic_imapstream& operator=(const basic_imapstream&) __deleted;
+  };
+
+  typedef basic_mapped_filebuf<char>    mapped_filebuf;
+  typedef basic_mapped_filebuf<wchar_t> wmapped_filebuf;
+  typedef basic_imapstream<char>        imapstream;
+  typedef basic_imapstream<wchar_t>     wimapstream;
+
+/**@} lib_file_streams */
+/**@} lib_input_output */
+}//namespace std
+
+#endif//#ifndef NTL__STLX_EXT_MAPSTREAM
@@ -16,6 +16,10 @@
 # include "../type_traits.hxx"
 #endif
 
+#ifndef NTL__STDLIB
+# include "../../stdlib.hxx"
+#endif
+
 namespace ntl { namespace numeric {
 
   namespace detail
@@ -365,6 +369,758 @@ namespace ntl { namespace numeric {
     return str;
   }
 
+  //////////////////////////////////////////////////////////////////////////
+  ///\name Locale-independent primitive conversions (to_chars/from_chars)
+
+  /** Floating point formatting style for to_chars */
+  namespace chars_format
+  {
+    enum type {
+      /** d.ddde&plusmn;dd */
+      scientific  = 1,
+      /** ddd.ddd */
+      fixed       = 2,
+      /** fixed for decimal exponents in [-4, 21), scientific otherwise */
+      general     = fixed | scientific
+    };
+  }
+
+  /** Result of to_chars: \c ptr is one past the last written character, \c ec is conv_result::overflow if the range is too small */
+  struct to_chars_result
+  {
+    char*       ptr;
+    convresult  ec;
+  };
+
+  /** Result of from_chars: \c ptr is the first character not matching the pattern */
+  struct from_chars_result
+  {
+    const char* ptr;
+    convresult  ec;
+  };
+
+  namespace detail
+  {
+    static const char digit_pairs[201] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+
+    static const char digits36[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    static const std::uint64_t powers_of_10[20] =
+    {
+      1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+      10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+      1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+    };
+
+  #if defined(_MSC_VER)
+    extern "C" unsigned char __cdecl _BitScanReverse(unsigned long* index, unsigned long mask);
+  # ifndef __ICL
+  # pragma intrinsic(_BitScanReverse)
+  # endif
+  #endif
+
+    /** Number of significant bits in \p v (\p v shall not be zero) */
+    static inline unsigned bit_width(std::uint64_t v)
+    {
+    #if defined(__GNUC__)
+      return 64 - __builtin_clzll(v);
+    #elif defined(_MSC_VER)
+      unsigned long i;
+      const std::uint32_t hi = static_cast<std::uint32_t>(v >> 32);
+      if(hi){
+        _BitScanReverse(&i, hi);
+        return i + 33;
+      }
+      _BitScanReverse(&i, static_cast<std::uint32_t>(v));
+      return i + 1;
+    #else
+      unsigned n = 0;
+      while(v) v >>= 1, ++n;
+      return n;
+    #endif
+    }
+
+    /** Number of decimal digits in \p v computed without a division loop */
+    static inline unsigned count_digits(std::uint64_t v)
+    {
+      // 1233/4096 ~ log10(2); v|1 has the same number of digits as v
+      v |= 1;
+      const unsigned t = (bit_width(v) * 1233) >> 12;
+      return t + 1 - (v < powers_of_10[t]);
+    }
+
+    /** Writes decimal representation of \p v backwards, two digits per step, ending at \p end */
+    template<typename uint_t>
+    static inline void write_dec(uint_t v, char* end)
+    {
+      while(v >= 100){
+        const unsigned i = static_cast<unsigned>(v % 100) * 2;
+        v /= 100;
+        *--end = digit_pairs[i+1];
+        *--end = digit_pairs[i];
+      }
+      if(v < 10){
+        *--end = static_cast<char>('0' + v);
+      }else{
+        const unsigned i = static_cast<unsigned>(v) * 2;
+        *--end = digit_pairs[i+1];
+        *--end = digit_pairs[i];
+      }
+    }
+
+    /** Value of the digit \p c in bases up to 36 or a value greater than 36 if \p c is not a digit */
+    template<typename charT>
+    static inline unsigned digit_value(charT c)
+    {
+      const unsigned u = static_cast<unsigned>(c);
+      if(u - '0' < 10)
+        return u - '0';
+      const unsigned a = (u | 0x20) - 'a';
+      return a < 26 ? a + 10 : 0xFF;
+    }
+
+    template<typename T>
+    struct charconv_storage
+    {
+      typedef typename std::conditional<(sizeof(T) > sizeof(std::uint32_t)), std::uint64_t, std::uint32_t>::type type;
+    };
+
+    template<typename uint_t>
+    static inline to_chars_result to_chars_unsigned(char* first, char* last, uint_t value, int base)
+    {
+      to_chars_result re = { last, conv_result::overflow };
+      const std::size_t room = static_cast<std::size_t>(last - first);
+      if(base == 10){
+        const unsigned n = count_digits(value);
+        if(room < n)
+          return re;
+        write_dec(value, first + n);
+        re.ptr = first + n, re.ec = conv_result::ok;
+        return re;
+      }
+      if(base < 2 || base > 36){
+        re.ptr = first, re.ec = conv_result::bad_base;
+        return re;
+      }
+
+      const unsigned shift = base == 16 ? 4 : base == 8 ? 3 : base == 2 ? 1 : base == 32 ? 5 : base == 4 ? 2 : 0;
+      if(shift){
+        const unsigned n = (bit_width(value | 1) + shift - 1) / shift;
+        if(room < n)
+          return re;
+        char* p = first + n;
+        do *--p = digits36[value & (base - 1)];
+        while(value >>= shift);
+        re.ptr = first + n, re.ec = conv_result::ok;
+        return re;
+      }
+
+      char buf[sizeof(uint_t) * 8];
+      char* const end = buf + sizeof(buf);
+      char* p = end;
+      do *--p = digits36[value % base];
+      while(value /= base);
+      const std::size_t n = static_cast<std::size_t>(end - p);
+      if(room < n)
+        return re;
+      for(char* d = first; p != end; )
+        *d++ = *p++;
+      re.ptr = first + n, re.ec = conv_result::ok;
+      return re;
+    }
+
+    // Grisu2 shortest round-trip floating point formatting (F. Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers")
+
+    struct diy_fp
+    {
+      std::uint64_t f;
+      int           e;
+    };
+
+    static inline diy_fp make_diy_fp(std::uint64_t f, int e)
+    {
+      const diy_fp x = { f, e };
+      return x;
+    }
+
+    static inline diy_fp normalize(diy_fp x)
+    {
+      const unsigned shift = 64 - bit_width(x.f);
+      x.f <<= shift;
+      x.e -= static_cast<int>(shift);
+      return x;
+    }
+
+    /** Rounded upper half of the 128-bit product */
+    static inline diy_fp multiply(const diy_fp& x, const diy_fp& y)
+    {
+      const std::uint64_t M32 = 0xFFFFFFFFULL;
+      const std::uint64_t a = x.f >> 32, b = x.f & M32, c = y.f >> 32, d = y.f & M32;
+      const std::uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+      std::uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+      tmp += 1U << 31;
+      return make_diy_fp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+    }
+
+    struct cached_power
+    {
+      std::uint64_t f;
+      std::int16_t  e;
+    };
+
+    /** Normalized 10^k for k = -348, -340, ..., 340 */
+    static const cached_power cached_powers[87] =
+    {
+      { 0xfa8fd5a0081c0288ULL, -1220 }, { 0xbaaee17fa23ebf76ULL, -1193 }, { 0x8b16fb203055ac76ULL, -1166 },
+      { 0xcf42894a5dce35eaULL, -1140 }, { 0x9a6bb0aa55653b2dULL, -1113 }, { 0xe61acf033d1a45dfULL, -1087 },
+      { 0xab70fe17c79ac6caULL, -1060 }, { 0xff77b1fcbebcdc4fULL, -1034 }, { 0xbe5691ef416bd60cULL, -1007 },
+      { 0x8dd01fad907ffc3cULL,  -980 }, { 0xd3515c2831559a83ULL,  -954 }, { 0x9d71ac8fada6c9b5ULL,  -927 },
+      { 0xea9c227723ee8bcbULL,  -901 }, { 0xaecc49914078536dULL,  -874 }, { 0x823c12795db6ce57ULL,  -847 },
+      { 0xc21094364dfb5637ULL,  -821 }, { 0x9096ea6f3848984fULL,  -794 }, { 0xd77485cb25823ac7ULL,  -768 },
+      { 0xa086cfcd97bf97f4ULL,  -741 }, { 0xef340a98172aace5ULL,  -715 }, { 0xb23867fb2a35b28eULL,  -688 },
+      { 0x84c8d4dfd2c63f3bULL,  -661 }, { 0xc5dd44271ad3cdbaULL,  -635 }, { 0x936b9fcebb25c996ULL,  -608 },
+      { 0xdbac6c247d62a584ULL,  -582 }, { 0xa3ab66580d5fdaf6ULL,  -555 }, { 0xf3e2f893dec3f126ULL,  -529 },
+      { 0xb5b5ada8aaff80b8ULL,  -502 }, { 0x87625f056c7c4a8bULL,  -475 }, { 0xc9bcff6034c13053ULL,  -449 },
+      { 0x964e858c91ba2655ULL,  -422 }, { 0xdff9772470297ebdULL,  -396 }, { 0xa6dfbd9fb8e5b88fULL,  -369 },
+      { 0xf8a95fcf88747d94ULL,  -343 }, { 0xb94470938fa89bcfULL,  -316 }, { 0x8a08f0f8bf0f156bULL,  -289 },
+      { 0xcdb02555653131b6ULL,  -263 }, { 0x993fe2c6d07b7facULL,  -236 }, { 0xe45c10c42a2b3b06ULL,  -210 },
+      { 0xaa242499697392d3ULL,  -183 }, { 0xfd87b5f28300ca0eULL,  -157 }, { 0xbce5086492111aebULL,  -130 },
+      { 0x8cbccc096f5088ccULL,  -103 }, { 0xd1b71758e219652cULL,   -77 }, { 0x9c40000000000000ULL,   -50 },
+      { 0xe8d4a51000000000ULL,   -24 }, { 0xad78ebc5ac620000ULL,     3 }, { 0x813f3978f8940984ULL,    30 },
+      { 0xc097ce7bc90715b3ULL,    56 }, { 0x8f7e32ce7bea5c70ULL,    83 }, { 0xd5d238a4abe98068ULL,   109 },
+      { 0x9f4f2726179a2245ULL,   136 }, { 0xed63a231d4c4fb27ULL,   162 }, { 0xb0de65388cc8ada8ULL,   189 },
+      { 0x83c7088e1aab65dbULL,   216 }, { 0xc45d1df942711d9aULL,   242 }, { 0x924d692ca61be758ULL,   269 },
+      { 0xda01ee641a708deaULL,   295 }, { 0xa26da3999aef774aULL,   322 }, { 0xf209787bb47d6b85ULL,   348 },
+      { 0xb454e4a179dd1877ULL,   375 }, { 0x865b86925b9bc5c2ULL,   402 }, { 0xc83553c5c8965d3dULL,   428 },
+      { 0x952ab45cfa97a0b3ULL,   455 }, { 0xde469fbd99a05fe3ULL,   481 }, { 0xa59bc234db398c25ULL,   508 },
+      { 0xf6c69a72a3989f5cULL,   534 }, { 0xb7dcbf5354e9beceULL,   561 }, { 0x88fcf317f22241e2ULL,   588 },
+      { 0xcc20ce9bd35c78a5ULL,   614 }, { 0x98165af37b2153dfULL,   641 }, { 0xe2a0b5dc971f303aULL,   667 },
+      { 0xa8d9d1535ce3b396ULL,   694 }, { 0xfb9b7cd9a4a7443cULL,   720 }, { 0xbb764c4ca7a44410ULL,   747 },
+      { 0x8bab8eefb6409c1aULL,   774 }, { 0xd01fef10a657842cULL,   800 }, { 0x9b10a4e5e9913129ULL,   827 },
+      { 0xe7109bfba19c0c9dULL,   853 }, { 0xac2820d9623bf429ULL,   880 }, { 0x80444b5e7aa7cf85ULL,   907 },
+      { 0xbf21e44003acdd2dULL,   933 }, { 0x8e679c2f5e44ff8fULL,   960 }, { 0xd433179d9c8cb841ULL,   986 },
+      { 0x9e19db92b4e31ba9ULL,  1013 }, { 0xeb96bf6ebadf77d9ULL,  1039 }, { 0xaf87023b9bf0ee6bULL,  1066 }
+    };
+
+    /** Cached power c = 10^-K such that the product with 2^e has a binary exponent in [-60, -32] */
+    static inline diy_fp cached_power_for(int e, int& K)
+    {
+      // k = ceil((-61 - e) * log10(2)), 78913/2^18 ~ log10(2)
+      const int x = -61 - e;
+      const int k = ((x * 78913) >> 18) + (x != 0) + 347;
+      const unsigned index = static_cast<unsigned>((k >> 3) + 1);
+      K = 348 - static_cast<int>(index << 3);
+      return make_diy_fp(cached_powers[index].f, cached_powers[index].e);
+    }
+
+    static inline void grisu_round(char* buffer, int len, std::uint64_t delta, std::uint64_t rest, std::uint64_t ten_kappa, std::uint64_t wp_w)
+    {
+      while(rest < wp_w && delta - rest >= ten_kappa &&
+        (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)){
+          buffer[len - 1]--;
+          rest += ten_kappa;
+      }
+    }
+
+    static inline int digit_gen(const diy_fp& W, const diy_fp& Mp, std::uint64_t delta, char* buffer, int& K)
+    {
+      const unsigned shift = static_cast<unsigned>(-Mp.e);
+      const std::uint64_t one = 1ULL << shift, mask = one - 1;
+      const std::uint64_t wp_w = Mp.f - W.f;
+      std::uint32_t p1 = static_cast<std::uint32_t>(Mp.f >> shift);
+      std::uint64_t p2 = Mp.f & mask;
+      int kappa = static_cast<int>(count_digits(p1));
+      int len = 0;
+      while(kappa > 0){
+        const std::uint32_t div = static_cast<std::uint32_t>(powers_of_10[kappa - 1]);
+        const std::uint32_t d = p1 / div;
+        p1 %= div;
+        if(d || len)
+          buffer[len++] = static_cast<char>('0' + d);
+        --kappa;
+        const std::uint64_t rest = (static_cast<std::uint64_t>(p1) << shift) + p2;
+        if(rest <= delta){
+          K += kappa;
+          grisu_round(buffer, len, delta, rest, powers_of_10[kappa] << shift, wp_w);
+          return len;
+        }
+      }
+      for(;;){
+        p2 *= 10;
+        delta *= 10;
+        const char d = static_cast<char>(p2 >> shift);
+        if(d || len)
+          buffer[len++] = static_cast<char>('0' + d);
+        p2 &= mask;
+        --kappa;
+        if(p2 < delta){
+          K += kappa;
+          grisu_round(buffer, len, delta, p2, one, wp_w * powers_of_10[-kappa]);
+          return len;
+        }
+      }
+    }
+
+    /** Shortest digits of f*2^e; returns the digit count, the value is digits*10^K */
+    static inline int grisu2(std::uint64_t f, int e, bool lower_closer, char* buffer, int& K)
+    {
+      const diy_fp v  = normalize(make_diy_fp(f, e));
+      const diy_fp mp = normalize(make_diy_fp((f << 1) + 1, e - 1));
+      diy_fp mm = lower_closer ? make_diy_fp((f << 2) - 1, e - 2) : make_diy_fp((f << 1) - 1, e - 1);
+      mm.f <<= mm.e - mp.e;
+      mm.e = mp.e;
+
+      const diy_fp c_mk = cached_power_for(mp.e, K);
+      const diy_fp W = multiply(v, c_mk);
+      diy_fp Wp = multiply(mp, c_mk), Wm = multiply(mm, c_mk);
+      ++Wm.f;
+      --Wp.f;
+      return digit_gen(W, Wp, Wp.f - Wm.f, buffer, K);
+    }
+
+    static inline char* write_exponent(int x, char* p)
+    {
+      *p++ = 'e';
+      *p++ = x < 0 ? '-' : '+';
+      unsigned u = static_cast<unsigned>(x < 0 ? -x : x);
+      if(u >= 100){
+        *p++ = static_cast<char>('0' + u / 100);
+        u %= 100;
+      }
+      *p++ = digit_pairs[u*2];
+      *p++ = digit_pairs[u*2+1];
+      return p;
+    }
+
+    /** Lays out \p n digits with decimal exponent \p X of the first digit */
+    static inline to_chars_result format_digits(char* first, char* last, bool minus, const char* digits, int n, int X, int fmt)
+    {
+      to_chars_result re = { last, conv_result::overflow };
+      const unsigned ax = static_cast<unsigned>(X < 0 ? -X : X);
+      const std::size_t sci_len = n + (n > 1) + 2 + (ax >= 100 ? 3 : 2);
+      const std::size_t fix_len = X >= 0
+        ? (n > X + 1 ? n + 1 : X + 1)
+        : 2 + (-X - 1) + n;
+
+      bool sci;
+      if(fmt == chars_format::general)
+        sci = X < -4 || X >= 21;
+      else if(fmt == 0)
+        sci = sci_len < fix_len;
+      else
+        sci = fmt == chars_format::scientific;
+
+      if(static_cast<std::size_t>(last - first) < (sci ? sci_len : fix_len) + minus)
+        return re;
+
+      char* p = first;
+      if(minus)
+        *p++ = '-';
+      if(sci){
+        *p++ = digits[0];
+        if(n > 1){
+          *p++ = '.';
+          for(int i = 1; i < n; i++)
+            *p++ = digits[i];
+        }
+        p = write_exponent(X, p);
+      }else if(X >= 0){
+        int i = 0;
+        for(; i < n && i <= X; i++)
+          *p++ = digits[i];
+        for(int z = i; z <= X; z++)
+          *p++ = '0';
+        if(i < n){
+          *p++ = '.';
+          for(; i < n; i++)
+            *p++ = digits[i];
+        }
+      }else{
+        *p++ = '0', *p++ = '.';
+        for(int z = -X - 1; z; z--)
+          *p++ = '0';
+        for(int i = 0; i < n; i++)
+          *p++ = digits[i];
+      }
+      re.ptr = p, re.ec = conv_result::ok;
+      return re;
+    }
+
+    static inline to_chars_result format_special(char* first, char* last, bool minus, const char* s, std::size_t len)
+    {
+      to_chars_result re = { last, conv_result::overflow };
+      if(static_cast<std::size_t>(last - first) < len + minus)
+        return re;
+      if(minus)
+        *first++ = '-';
+      while(len--)
+        *first++ = *s++;
+      re.ptr = first, re.ec = conv_result::ok;
+      return re;
+    }
+
+    /** Formats IEEE-754 value with \p mbits explicit mantissa bits and \p ebits exponent bits */
+    template<unsigned mbits, unsigned ebits>
+    static inline to_chars_result to_chars_ieee(char* first, char* last, std::uint64_t bits, int fmt)
+    {
+      const std::uint64_t hidden = 1ULL << mbits;
+      const unsigned emax = (1U << ebits) - 1;
+      const int bias = static_cast<int>(emax >> 1) + static_cast<int>(mbits);
+
+      const bool minus = (bits >> (mbits + ebits)) != 0;
+      const unsigned biased_e = static_cast<unsigned>(bits >> mbits) & emax;
+      const std::uint64_t significand = bits & (hidden - 1);
+
+      if(biased_e == emax)
+        return significand ? format_special(first, last, minus, "nan", 3) : format_special(first, last, minus, "inf", 3);
+      if(biased_e == 0 && significand == 0)
+        return format_special(first, last, minus, "0", 1);
+
+      std::uint64_t f;
+      int e;
+      if(biased_e){
+        f = significand | hidden;
+        e = static_cast<int>(biased_e) - bias;
+      }else{
+        f = significand;
+        e = 1 - bias;
+      }
+
+      char digits[32];
+      int K;
+      const int n = grisu2(f, e, significand == 0 && biased_e > 1, digits, K);
+      return format_digits(first, last, minus, digits, n, n + K - 1, fmt);
+    }
+
+    /** Exact decimal digits of f*2^e without the trailing zeros (\p f shall not be zero); returns the digit count, the value is digits*10^K */
+    static inline int exact_digits(std::uint64_t f, int e, char* buffer, int& K)
+    {
+      // f*2^e or f*5^-e*10^e, at most 2550 bits
+      std::uint32_t n[82];
+      int size = 0;
+      for(; f; f >>= 32)
+        n[size++] = static_cast<std::uint32_t>(f);
+      K = 0;
+      if(e < 0){
+        K = e;
+        for(int k = -e; k > 0; k -= 13){
+          // 5^13 is the largest power of 5 in 32 bits
+          const std::uint32_t m = static_cast<std::uint32_t>(k >= 13 ? 1220703125u : powers_of_10[k] >> k);
+          std::uint64_t carry = 0;
+          for(int i = 0; i < size; i++){
+            carry += static_cast<std::uint64_t>(n[i]) * m;
+            n[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+          }
+          if(carry)
+            n[size++] = static_cast<std::uint32_t>(carry);
+        }
+      }else if(e > 0){
+        const int words = e / 32, bits = e % 32;
+        if(bits){
+          std::uint32_t carry = 0;
+          for(int i = 0; i < size; i++){
+            const std::uint32_t w = n[i];
+            n[i] = w << bits | carry;
+            carry = w >> (32 - bits);
+          }
+          if(carry)
+            n[size++] = carry;
+        }
+        if(words){
+          for(int i = size; i--; )
+            n[i + words] = n[i];
+          for(int i = 0; i < words; i++)
+            n[i] = 0;
+          size += words;
+        }
+      }
+
+      // 9 digits per division, the lowest first
+      std::uint32_t chunks[90];
+      int count = 0;
+      while(size){
+        std::uint64_t rem = 0;
+        for(int i = size; i--; ){
+          rem = rem << 32 | n[i];
+          n[i] = static_cast<std::uint32_t>(rem / 1000000000u);
+          rem %= 1000000000u;
+        }
+        chunks[count++] = static_cast<std::uint32_t>(rem);
+        while(size && !n[size-1])
+          --size;
+      }
+
+      int len = static_cast<int>(count_digits(chunks[--count]));
+      write_dec(chunks[count], buffer + len);
+      while(count--){
+        std::uint32_t c = chunks[count];
+        for(int j = 9; j--; c /= 10)
+          buffer[len + j] = static_cast<char>('0' + c % 10);
+        len += 9;
+      }
+      while(buffer[len-1] == '0')
+        --len, ++K;
+      return len;
+    }
+
+    /**
+     *	Rounds \p n digits with decimal exponent \p X of the first digit to \p m digits, the half to even.
+     *  \p m becomes the count of the significant digits left, the carry out of the first digit increments \p X.
+     **/
+    static inline void round_digits(char* digits, int n, int& m, int& X)
+    {
+      if(m >= n){
+        m = n;
+        return;
+      }
+      if(m < 0){
+        // below the half of the last place
+        m = 0;
+        return;
+      }
+      const char next = digits[m];
+      bool up = next > '5';
+      if(next == '5'){
+        for(int i = m + 1; i < n && !up; i++)
+          up = digits[i] != '0';
+        if(!up && m)
+          up = (digits[m-1] - '0') & 1;
+      }
+      if(!up)
+        return;
+      for(int i = m; i--; ){
+        if(digits[i] != '9'){
+          ++digits[i];
+          return;
+        }
+        digits[i] = '0';
+      }
+      // 99.9 is 100, the missing digits are zeros
+      digits[0] = '1';
+      m = 1;
+      ++X;
+    }
+
+    /**
+     *	Lays out \p m rounded digits with decimal exponent \p X of the first digit and \p precision digits after the point,
+     *  the point without digits after it is written only if \p point is set.
+     **/
+    static inline to_chars_result format_precision(char* first, char* last, bool minus, const char* digits, int m, int X, bool sci, int precision, bool point)
+    {
+      to_chars_result re = { last, conv_result::overflow };
+      const unsigned ax = static_cast<unsigned>(X < 0 ? -X : X);
+      point |= precision != 0;
+      const std::size_t len = (sci ? 1 + 2 + (ax >= 100 ? 3 : 2) : (X >= 0 ? X + 1 : 1)) + precision + point;
+      if(static_cast<std::size_t>(last - first) < len + minus)
+        return re;
+
+      char* p = first;
+      if(minus)
+        *p++ = '-';
+      // the digit at the decimal exponent `at` of the mantissa or the value, the digits after the rounded ones are zeros
+      for(int at = sci || X < 0 ? 0 : X; at >= -precision; at--){
+        const int i = sci ? -at : X - at;
+        *p++ = i >= 0 && i < m ? digits[i] : '0';
+        if(at == 0 && point)
+          *p++ = '.';
+      }
+      if(sci)
+        p = write_exponent(X, p);
+      re.ptr = p, re.ec = conv_result::ok;
+      return re;
+    }
+
+    /**
+     *	Formats IEEE-754 value with \p precision digits after the point or \p precision significant digits for chars_format::general,
+     *  \p showpoint always writes the point and keeps the trailing zeros of chars_format::general as %#f, %#e and %#g do.
+     **/
+    template<unsigned mbits, unsigned ebits>
+    static inline to_chars_result to_chars_ieee(char* first, char* last, std::uint64_t bits, int fmt, int precision, bool showpoint)
+    {
+      const std::uint64_t hidden = 1ULL << mbits;
+      const unsigned emax = (1U << ebits) - 1;
+      const int bias = static_cast<int>(emax >> 1) + static_cast<int>(mbits);
+
+      const bool minus = (bits >> (mbits + ebits)) != 0;
+      const unsigned biased_e = static_cast<unsigned>(bits >> mbits) & emax;
+      const std::uint64_t significand = bits & (hidden - 1);
+
+      if(biased_e == emax)
+        return significand ? format_special(first, last, minus, "nan", 3) : format_special(first, last, minus, "inf", 3);
+      if(precision < 0)
+        precision = 6;
+
+      // the exact digits of the denormal 2^-1074 are 767
+      char digits[784];
+      int n = 1, K = 0;
+      if(biased_e == 0 && significand == 0)
+        digits[0] = '0';
+      else if(biased_e)
+        n = exact_digits(significand | hidden, static_cast<int>(biased_e) - bias, digits, K);
+      else
+        n = exact_digits(significand, 1 - bias, digits, K);
+      int X = n + K - 1;
+
+      int m;
+      if(fmt == chars_format::fixed){
+        m = X + 1 + precision;
+        round_digits(digits, n, m, X);
+        return format_precision(first, last, minus, digits, m, X, false, precision, showpoint);
+      }
+      if(fmt == chars_format::scientific){
+        m = precision + 1;
+        round_digits(digits, n, m, X);
+        return format_precision(first, last, minus, digits, m, X, true, precision, showpoint);
+      }
+
+      // %g: the style by the exponent of the rounded value, without the trailing zeros unless %#g
+      const int P = precision ? precision : 1;
+      m = P;
+      round_digits(digits, n, m, X);
+      int shown = P;
+      if(!showpoint){
+        while(m > 1 && digits[m-1] == '0')
+          --m;
+        shown = m;
+      }
+      if(X < P && X >= -4)
+        return format_precision(first, last, minus, digits, m, X, false, shown - 1 - X > 0 ? shown - 1 - X : 0, showpoint);
+      return format_precision(first, last, minus, digits, m, X, true, shown - 1, showpoint);
+    }
+  } // detail
+
+  /** Converts integer \p value to the characters in range [first, last) in the given \p base without any locale dependency */
+  template<typename T>
+  inline typename std::enable_if<std::is_integral<T>::value, to_chars_result>::type
+    to_chars(char* first, char* last, T value, int base = 10)
+  {
+    typedef typename detail::charconv_storage<T>::type storage_type;
+    if(std::is_signed<T>::value && value < 0){
+      if(first == last){
+        const to_chars_result re = { last, conv_result::overflow };
+        return re;
+      }
+      *first = '-';
+      to_chars_result re = detail::to_chars_unsigned(first + 1, last, static_cast<storage_type>(0 - static_cast<storage_type>(value)), base);
+      if(re.ec != conv_result::ok && re.ptr == first + 1)
+        re.ptr = first;
+      return re;
+    }
+    return detail::to_chars_unsigned(first, last, static_cast<storage_type>(value), base);
+  }
+
+  /** Converts \p value to the shortest representation which round-trips (fixed or scientific, whichever is shorter) */
+  inline to_chars_result to_chars(char* first, char* last, double value)
+  {
+    return detail::to_chars_ieee<52, 11>(first, last, ntl::brute_cast<std::uint64_t>(value), 0);
+  }
+
+  /** Converts \p value to the shortest representation which round-trips using \p fmt style */
+  inline to_chars_result to_chars(char* first, char* last, double value, chars_format::type fmt)
+  {
+    return detail::to_chars_ieee<52, 11>(first, last, ntl::brute_cast<std::uint64_t>(value), fmt);
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, float value)
+  {
+    return detail::to_chars_ieee<23, 8>(first, last, ntl::brute_cast<std::uint32_t>(value), 0);
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, float value, chars_format::type fmt)
+  {
+    return detail::to_chars_ieee<23, 8>(first, last, ntl::brute_cast<std::uint32_t>(value), fmt);
+  }
+
+  /**
+   *	@brief Converts \p value exactly rounded to \p precision digits, as printf does with %f, %e and %g
+   *  @details \p precision is the count of the digits after the point for chars_format::fixed and scientific
+   *  or the count of the significant digits for chars_format::general, the negative \p precision is 6.
+   **/
+  inline to_chars_result to_chars(char* first, char* last, double value, chars_format::type fmt, int precision)
+  {
+    return detail::to_chars_ieee<52, 11>(first, last, ntl::brute_cast<std::uint64_t>(value), fmt, precision, false);
+  }
+
+  inline to_chars_result to_chars(char* first, char* last, float value, chars_format::type fmt, int precision)
+  {
+    return detail::to_chars_ieee<23, 8>(first, last, ntl::brute_cast<std::uint32_t>(value), fmt, precision, false);
+  }
+
+  /** Converts \p value as to_chars with \p precision does, \p showpoint is the alternative form of printf (%#f, %#e and %#g) */
+  inline to_chars_result to_chars(char* first, char* last, double value, chars_format::type fmt, int precision, bool showpoint)
+  {
+    return detail::to_chars_ieee<52, 11>(first, last, ntl::brute_cast<std::uint64_t>(value), fmt, precision, showpoint);
+  }
+
+  /**
+   *	@brief Parses integer from the characters in range [first, last) without any locale dependency
+   *  @details Unlike str2num, neither leading whitespace nor '+' sign nor base prefix is accepted, '-' is accepted for signed types only.
+   *  On error \p value is unmodified; conv_result::bad_format is returned if no digits were found, conv_result::overflow if
+   *  the value is out of range (\c ptr points after the digits in this case).
+   **/
+  template<typename T>
+  inline typename std::enable_if<std::is_integral<T>::value, from_chars_result>::type
+    from_chars(const char* first, const char* last, T& value, int base = 10)
+  {
+    typedef typename detail::charconv_storage<T>::type storage_type;
+    from_chars_result re = { first, conv_result::bad_format };
+    if(base < 2 || base > 36){
+      re.ec = conv_result::bad_base;
+      return re;
+    }
+
+    const char* p = first;
+    const bool minus = std::is_signed<T>::value && p != last && *p == '-';
+    if(minus)
+      ++p;
+    const char* const digits = p;
+
+    storage_type v = 0;
+    if(base == 10){
+      // no overflow is possible in the first digits10 digits
+      const std::size_t safe = std::numeric_limits<storage_type>::digits10;
+      const char* const safe_end = static_cast<std::size_t>(last - p) > safe ? p + safe : last;
+      for(; p != safe_end; ++p){
+        const unsigned d = static_cast<unsigned char>(*p) - static_cast<unsigned>('0');
+        if(d >= 10)
+          break;
+        v = v * 10 + d;
+      }
+    }
+
+    const storage_type limit = static_cast<storage_type>(std::numeric_limits<T>::__max) + (minus ? 1 : 0);
+    const storage_type cutoff = limit / static_cast<storage_type>(base);
+    const unsigned cutlim = static_cast<unsigned>(limit % static_cast<storage_type>(base));
+    bool overflow = v > limit;
+    for(; p != last; ++p){
+      const unsigned d = detail::digit_value(*p);
+      if(d >= static_cast<unsigned>(base))
+        break;
+      if(overflow || v > cutoff || (v == cutoff && d > cutlim))
+        overflow = true;
+      else
+        v = v * base + d;
+    }
+
+    if(p == digits)
+      return re;
+    re.ptr = p;
+    if(overflow){
+      re.ec = conv_result::overflow;
+      return re;
+    }
+    value = static_cast<T>(minus ? 0 - v : v);
+    re.ec = conv_result::ok;
+    return re;
+  }
+  ///\}
+
 }}
 #endif // NTL__EXT_NUMERIC_CONVERSIONS
 
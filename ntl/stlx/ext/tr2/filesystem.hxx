@@ -1089,5 +1089,8 @@ namespace std
 
 #include "fs_operations.hxx"
 #include "fs_directory.hxx"
+#ifndef NTL__SUBSYSTEM_KM
+# include "fs_parallel.hxx"
+#endif
 
 #endif
@@ -49,6 +49,22 @@ namespace std
         typedef basic_recursive_directory_iterator<wpath> wrecursive_directory_iterator;
 
 
+        /**
+         *  File information cached by the directory iteration (an extension), the times are in 100ns units since 1601.
+         *  The file id is unavailable on the file systems which don't support FileIdBothDirectoryInformation.
+         **/
+        struct directory_entry_info
+        {
+          uint32_t  attributes;
+          int64_t   file_size;
+          int64_t   allocation_size;
+          int64_t   creation_time;
+          int64_t   last_access_time;
+          int64_t   last_write_time;
+          int64_t   file_id;
+          bool      has_file_id;
+        };
+
         //////////////////////////////////////////////////////////////////////////
         /**
          *	@brief Class template basic_directory_entry
@@ -68,15 +84,16 @@ namespace std
 
           ///\name constructors
           basic_directory_entry()
+            :inf()
           {}
 
           explicit basic_directory_entry(const path_type& p, file_status st = file_status(), file_status symlink_st = file_status())
-            :p(p),st(st), lst(symlink_st)
+            :p(p),st(st), lst(symlink_st), inf()
           {}
 
 #ifdef NTL__CXX_RV
           explicit basic_directory_entry(path_type&& p, file_status st = file_status(), file_status symlink_st = file_status())
-            :p(forward<path_type>(p)),st(st), lst(symlink_st)
+            :p(forward<path_type>(p)),st(st), lst(symlink_st), inf()
           {}
           basic_directory_entry(basic_directory_entry&& r)
           {
@@ -89,7 +106,7 @@ namespace std
 
           void assign(path_type&& p, file_status st = file_status(), file_status symlink_st = file_status())
           {
-            this->p = move(p), this->st = st, lst = symlink_st;
+            this->p = move(p), this->st = st, lst = symlink_st, inf = directory_entry_info();
           }
 
           friend void swap(basic_directory_entry&&x, basic_directory_entry& y) { x.swap(y); }
@@ -102,6 +119,7 @@ namespace std
             p.swap(r.p);
             std::swap(st,r.st);
             std::swap(lst,r.lst);
+            std::swap(inf,r.inf);
           }
 
           friend void swap(basic_directory_entry& x, basic_directory_entry& y) { x.swap(y); }
@@ -110,14 +128,20 @@ namespace std
           /** Assigns the stored path and statuses with the new values */
           void assign(const path_type& p, file_status st = file_status(), file_status symlink_st = file_status())
           {
-            this->p = p, this->st = st, lst = symlink_st;
+            this->p = p, this->st = st, lst = symlink_st, inf = directory_entry_info();
+          }
+
+          /** Assigns the stored path, statuses and the cached file information */
+          void assign(const path_type& p, file_status st, file_status symlink_st, const directory_entry_info& info)
+          {
+            this->p = p, this->st = st, lst = symlink_st, inf = info;
           }
 
           /** Replaces the base filename and statuses of the stored path with the new values */
           void replace_leaf(const string_type& s, file_status st = file_status(), file_status symlink_st = file_status())
           {
             p = p.branch() / s;
-            this->st = st, lst = symlink_st;
+            this->st = st, lst = symlink_st, inf = directory_entry_info();
           }
 
           ///\name observers
@@ -143,12 +167,15 @@ namespace std
           file_status symlink_status(error_code& ec = throws()) const
           {
             if(!status_known(lst))
-              lst = symlink_status(p, ec);
+              lst = filesystem::symlink_status(p, ec);
             else if(&ec != &throws())
               ec.clear();
             return lst;
           }
 
+          /** Returns the file information cached by the directory iteration, the attributes are zero if there is none */
+          const directory_entry_info& info() const { return inf; }
+
           ///\name comparisons
           bool operator<(const basic_directory_entry<Path>& rhs);
           bool operator==(const basic_directory_entry<Path>& rhs) { return st == rhs.st && lst == rhs.lst && p == rhs.p; }
@@ -162,8 +189,181 @@ namespace std
           path_type            p;
           mutable file_status  st;
           mutable file_status  lst;
+          directory_entry_info inf;
         };
 
+        namespace __
+        {
+          /** Directory access through the native API: a synchronous directory handle and ZwQueryDirectoryFile */
+          struct nt_directory_api
+          {
+            typedef ntl::nt::file_handler handle_type;
+
+            static ntl::nt::ntstatus open(handle_type& h, const ntl::nt::const_unicode_string& name)
+            {
+              using namespace ntl::nt;
+              return h.open(name, file::list_directory|synchronize, file::share_valid_flags,
+                file::directory_file|file::open_for_backup_intent|file::synchronous_io_nonalert);
+            }
+
+            static ntl::nt::ntstatus query(handle_type& h, void* buf, uint32_t size, bool restart, ntl::nt::file_information_class info_class)
+            {
+              using namespace ntl::nt;
+              io_status_block iosb;
+              return ZwQueryDirectoryFile(h.get(), nullptr, nullptr, nullptr, &iosb, buf, size,
+                info_class, false, nullptr, restart);
+            }
+
+            static void close(handle_type& h)
+            {
+              h.reset();
+            }
+          };
+
+          /**
+           *  Reads the directory entries in batches into a fixed buffer, reused by every query.
+           *  The scan continues from the last query, so each entry is transferred once whatever the directory size is.
+           *  The '.' and '..' entries are skipped.
+           *
+           *  The entries are queried with FileIdBothDirectoryInformation. The redirectors and the file systems which reject it
+           *  are read with FileDirectoryInformation since the first rejection, then the file ids and the short names are unavailable.
+           **/
+          template<class Api = nt_directory_api>
+          class directory_stream:
+            noncopyable
+          {
+          public:
+            /** The fields common to both information classes, except the FileName: see name() */
+            typedef ntl::nt::file_directory_information entry_type;
+            typedef ntl::nt::file_id_both_dir_information id_entry_type;
+
+          #ifdef NTL__SUBSYSTEM_KM
+            static const uint32_t buffer_size = 8 * 1024;   // ~80 entries with the names of 20 characters
+          #else
+            static const uint32_t buffer_size = 64 * 1024;  // ~640 entries with the names of 20 characters
+          #endif
+
+            directory_stream() __ntl_nothrow
+              :entry_(), buf(), ids(true)
+            {}
+
+            ~directory_stream() __ntl_nothrow
+            {
+              delete[] buf;
+            }
+
+            /** Opens the directory and reads the first entry */
+            ntl::nt::ntstatus open(const ntl::nt::const_unicode_string& name) __ntl_nothrow
+            {
+              using namespace ntl::nt;
+              ntstatus st = Api::open(h, name);
+              if(success(st)){
+                if(!buf)
+                  buf = new (nothrow) int64_t[buffer_size / sizeof(int64_t)];
+                if(!buf)
+                  return status::insufficient_resources;
+                st = fill(true);
+                if(entry_ && is_dots())
+                  st = next();
+              }
+              return st;
+            }
+
+            /** Closes the directory, the buffer is kept for the next open() */
+            void close() __ntl_nothrow
+            {
+              entry_ = nullptr;
+              Api::close(h);
+            }
+
+            /** Current entry or null at the end */
+            const entry_type* entry() const __ntl_nothrow { return entry_; }
+
+            /** Current entry with the file id and the short name, null at the end or if the file system doesn't report them */
+            const id_entry_type* id_entry() const __ntl_nothrow
+            {
+              return ids ? reinterpret_cast<const id_entry_type*>(entry_) : nullptr;
+            }
+
+            /** The file name of the current entry */
+            ntl::nt::const_unicode_string name() const __ntl_nothrow
+            {
+              return ids ? id_entry()->name() : ntl::nt::const_unicode_string(entry_->FileName, entry_->FileNameLength / sizeof(wchar_t));
+            }
+
+            /** Moves to the next entry, queries the next batch if the buffer is exhausted */
+            ntl::nt::ntstatus next() __ntl_nothrow
+            {
+              using namespace ntl::nt;
+              for(;;){
+                if(entry_->NextEntryOffset){
+                  entry_ = reinterpret_cast<const entry_type*>(reinterpret_cast<uintptr_t>(entry_) + entry_->NextEntryOffset);
+                }else{
+                  const ntstatus st = fill(false);
+                  if(!entry_)
+                    return st;
+                }
+                if(!is_dots())
+                  return status::success;
+              }
+            }
+
+          private:
+            ntl::nt::ntstatus fill(bool restart) __ntl_nothrow
+            {
+              using namespace ntl::nt;
+              entry_ = nullptr;
+              ntstatus st = Api::query(h, buf, buffer_size, restart, ids ? id_entry_type::info_class_type : entry_type::info_class_type);
+              if(ids && (st == status::invalid_info_class || st == status::invalid_parameter || st == status::not_supported)){
+                ids = false;
+                st = Api::query(h, buf, buffer_size, restart, entry_type::info_class_type);
+              }
+              if(st == status::no_more_files || st == status::no_such_file)
+                return status::success;
+              if(success(st))
+                entry_ = reinterpret_cast<const entry_type*>(buf);
+              return st;
+            }
+
+            bool is_dots() const __ntl_nothrow
+            {
+              const ntl::nt::const_unicode_string n = name();
+              return n.begin()[0] == '.' && (n.size() == 1 || (n.size() == 2 && n.begin()[1] == '.'));
+            }
+
+          private:
+            typename Api::handle_type h;
+            const entry_type* entry_;
+            int64_t* buf;
+            bool ids;   // FileIdBothDirectoryInformation isn't rejected yet
+          };
+
+          /** Assigns the current entry of the directory stream \a s of the directory \a dp to \a de, its path is \a dp with the entry name appended */
+          template<class Path, class Stream>
+          inline void assign_directory_entry(basic_directory_entry<Path>& de, const Path& dp, const Stream& s)
+          {
+            using ntl::nt::file_attribute;
+            const typename Stream::entry_type* const di = s.entry();
+            const typename Stream::id_entry_type* const xi = s.id_entry();
+            file_type ft = regular_file;
+            if(di->FileAttributes & file_attribute::directory)
+              ft = directory_file;
+            else if(di->FileAttributes & file_attribute::device)
+              ft = device_file;
+            const file_status lst(di->FileAttributes & file_attribute::reparse_point ? symlink_file : ft);
+            // the status of the symlink target is unknown until it is queried,
+            // after the fallback to the plain directory information status() opens the file
+            const file_status st(!xi || di->FileAttributes & file_attribute::reparse_point ? status_unknown : ft);
+
+            const directory_entry_info info = { di->FileAttributes, di->EndOfFile, di->AllocationSize, 
+              di->CreationTime, di->LastAccessTime, di->LastWriteTime, xi ? xi->FileId : 0, xi != nullptr };
+            const ntl::nt::const_unicode_string name = s.name();
+            Path p(dp);
+            p /= Path::traits_type::to_internal(dp, typename Path::external_string_type(name.begin(), name.size()));
+            de.assign(p, st, lst, info);
+          }
+        } // __
+
         //////////////////////////////////////////////////////////////////////////
         /**
          *	@brief Class template basic_directory_iterator
@@ -190,22 +390,21 @@ namespace std
         class basic_directory_iterator:
           public iterator<input_iterator_tag, basic_directory_entry<Path> >
         {
-          typedef const ntl::nt::file_directory_information  fdi_t;
+          typedef __::directory_stream<> stream_type;
         public:
           typedef Path path_type;
 
           ///\name Constructors
           basic_directory_iterator() __ntl_nothrow
-            :di(), base(), memsize()
           {}
           explicit basic_directory_iterator(const Path& dp) __ntl_nothrow
-            :dp(dp), di(), base(), memsize()
+            :dp(dp)
           {
             error_code ec;
             ReadDirectory(dp, ec);
           }
           basic_directory_iterator(const Path& dp, error_code& ec) __ntl_nothrow
-            :dp(dp), di(), base(), memsize()
+            :dp(dp)
           {
             error_code e;
             ReadDirectory(dp, e);
@@ -213,48 +412,42 @@ namespace std
               ec = e;
           }
           basic_directory_iterator(const basic_directory_iterator& r) __ntl_nothrow
-            :dp(r.dp), di(r.di), base(r.base), bdi(r.bdi), memsize(r.memsize)
+            :stream(r.stream), bdi(r.bdi), dp(r.dp)
           {
           }
           basic_directory_iterator& operator=(const basic_directory_iterator& r) __ntl_nothrow
           {
             dp = r.dp,
-            base = r.base,
-            di = r.di,
-            bdi = r.bdi,
-            memsize = r.memsize;
+            stream = r.stream,
+            bdi = r.bdi;
             return *this;
           }
           ~basic_directory_iterator() __ntl_nothrow
           {}
 #ifdef NTL__CXX_RV
           explicit basic_directory_iterator(Path&& dp) __ntl_nothrow
-            :dp(forward<Path>(dp)), di(), base(), memsize()
+            :dp(forward<Path>(dp))
           {
             error_code ec;
-            ReadDirectory(dp, ec);
+            ReadDirectory(this->dp, ec);
           }
           basic_directory_iterator(Path&& dp, error_code& ec) __ntl_nothrow
-            :dp(forward<Path>(dp)), di(), base(), memsize()
+            :dp(forward<Path>(dp))
           {
             error_code e;
-            ReadDirectory(dp, e);
+            ReadDirectory(this->dp, e);
             if(&ec != &throws())
               ec = e;
           }
           basic_directory_iterator(basic_directory_iterator&& r) __ntl_nothrow
-            :di()
           {
             swap(r);
           }
           basic_directory_iterator& operator=(basic_directory_iterator&& r) __ntl_nothrow
           {
             dp = move(r.dp),
-              base = move(r.base),
-              di = r.di,
-              bdi = r.bdi,
-              memsize = r.memsize;
-            r.di = nullptr;
+            stream = move(r.stream),
+            bdi = r.bdi;
             return *this;
           }
           void swap(basic_directory_iterator&& r)
@@ -263,24 +456,19 @@ namespace std
 #endif
           {
             dp.swap(r.dp);
-            base.swap(r.base);
-            std::swap(di,r.di);
+            stream.swap(r.stream);
             bdi.swap(r.bdi);
-            std::swap(memsize,r.memsize);
           }
 
 
 
           ///\name Input iterator operations
-          const basic_directory_entry<Path>& operator*()  const { assert(di != nullptr); return bdi;  }
-          const basic_directory_entry<Path>* operator->() const { assert(di != nullptr); return &bdi; }
+          const basic_directory_entry<Path>& operator*()  const { assert(stream); return bdi;  }
+          const basic_directory_entry<Path>* operator->() const { assert(stream); return &bdi; }
 
           basic_directory_iterator& operator++()
           {
-            assert(di != nullptr);
-            di = step(di);
-            sync();
-            return *this;
+            return increment();
           }
           basic_directory_iterator operator++(int)
           {
@@ -289,8 +477,23 @@ namespace std
             return move(tmp);
           }
 
+          /** Moves to the next entry, reading the next batch of the entries if needed. The iterator becomes the end iterator on error. */
+          basic_directory_iterator& increment(error_code& ec = throws()) __ntl_nothrow
+          {
+            assert(stream);
+            const ntl::nt::ntstatus st = stream->next();
+            if(ntl::nt::success(st)){
+              if(&ec != &throws())
+                ec.clear();
+            }else if(&ec != &throws())
+              ec = make_error_code(st);
+            sync();
+            return *this;
+          }
+
           ///\name Comparsions
-          friend inline bool operator== (const basic_directory_iterator& x, const basic_directory_iterator& y) { return x.di == y.di; }
+          /** All copies of an iterator share the position, so they are equal unless one of them is the end iterator */
+          friend inline bool operator== (const basic_directory_iterator& x, const basic_directory_iterator& y) { return x.stream == y.stream; }
           friend inline bool operator!= (const basic_directory_iterator& x, const basic_directory_iterator& y) { return !(x == y); }
           ///\}
 
@@ -302,116 +505,30 @@ namespace std
             if(dp.empty())
               return false;
 
-            using namespace ntl::nt;
-            file_handler f;
-            ntstatus st = f.open(const_unicode_string(dp.external_file_string()), file::generic_read, file::share_valid_flags, 
-              file::directory_file|file::open_for_backup_intent|file::synchronous_io_nonalert);
-            if(success(st)){
-              io_status_block iosb;
-              char* buf = nullptr;
-            #ifdef NTL__SUBSYSTEM_KM
-              static const uint32_t multiplier = 2;
-              memsize = (sizeof(file_directory_information)+32)*16; // ~32 files by default (~3KB), multiplies by 2
-            #else
-              static const uint32_t multiplier = 4;
-              memsize = (sizeof(file_directory_information)+32)*64; // 256 files by default (26KB), multiplies by 4
-            #endif
-              do{
-                if(buf)
-                  delete[] buf;
-                buf = new (nothrow) char[ memsize *= multiplier ];
-                if(!buf){
-                  ec = make_error_code(status::insufficient_resources);
-                  return false;
-                }
-                st = ZwQueryDirectoryFile(f.get(), nullptr, nullptr, nullptr, &iosb, buf, memsize, FileDirectoryInformation, false, nullptr, true);
-                if(success(st)){
-                  file_directory_information tmp;
-                  io_status_block iosb;
-                  st = ZwQueryDirectoryFile(f.get(), nullptr, nullptr, nullptr, &iosb, &tmp, sizeof(tmp), FileDirectoryInformation, false, nullptr, false);
-                  if(st != status::no_more_files)
-                    st = status::buffer_overflow;
-                }
-              } while(st == status::buffer_overflow);
-
-              memsize = static_cast<uint32_t>(iosb.Information);
-              base.reset(di = reinterpret_cast<fdi_t*>(buf));
+            stream.reset(new (nothrow) stream_type());
+            if(!stream){
+              ec = make_error_code(ntl::nt::status::insufficient_resources);
+              return false;
             }
-            if(status::is_error(st))
+            const ntl::nt::ntstatus st = stream->open(ntl::nt::const_unicode_string(dp.external_file_string()));
+            if(ntl::nt::status::is_error(st))
               ec = make_error_code(st);
-            else
-              sync();
+            sync();
             return !ec;
           }
-          #if 0
-          void copy(const basic_directory_iterator& bdi)
-          {
-            if(!bdi.base)
-              return;
-
-            memsize = bdi.memsize;
-            di = bdi.di;
-            
-            //difference_type idx = 0;
-            //for(fdi_t p = bdi.base.get(); p != bdi.di; p = step(p), idx++);
-
-            //base = reinterpret_cast<fdi_t>( new (nothrow) char[memsize = bdi.memsize] );
-            //if(!base)
-            //  return;
-
-            //memcpy((void*)base, bdi.base, memsize);
-
-            //for(difference_type n = 0; n < idx; n++)
-            //  di = step(di);
-          }
-          void free() __ntl_nothrow
-          {
-            if(base){
-              delete[] reinterpret_cast<const char*>(base);
-              base = di = nullptr;
-              memsize = 0;
-            }
-          }
-          #endif
-          static fdi_t* step(fdi_t* p) __ntl_nothrow
-          {
-            return p->NextEntryOffset ? reinterpret_cast<fdi_t*>( uintptr_t(p) + p->NextEntryOffset ) : nullptr;
-          }
 
           void sync()
           {
-            // skip the '.' and '..'
-            while(di && 
-                  (
-                    (di->FileNameLength == 2 && di->FileName[0] == '.') || 
-                    (di->FileNameLength == 4 && di->FileName[0] == '.' && di->FileName[1] == '.')
-                  )
-                 )
-            {
-              di = step(di);
-            }
-            if(!di){
-              base.reset();
+            if(!stream || !stream->entry()){
+              stream.reset();
               bdi.assign(Path());
               return;
             }
-            using ntl::nt::file_attribute;
-            file_type ft = regular_file;
-            if(di->FileAttributes & file_attribute::directory)
-              ft = directory_file;
-            else if(di->FileAttributes & file_attribute::reparse_point)
-              ft = symlink_file;
-            else if(di->FileAttributes & file_attribute::device)
-              ft = device_file;
-            path_type p( Path::traits_type::to_internal(dp, Path::external_string_type(di->FileName, di->FileNameLength/sizeof(wchar_t))) );
-            bdi.assign(p, file_status(ft));
-            //bdi.assign(Path::traits_type::to_internal(dp, Path::external_string_type(di->FileName, di->FileNameLength/sizeof(wchar_t))), file_status(ft));
+            __::assign_directory_entry(bdi, dp, *stream);
           }
 
         private:
-          shared_ptr<fdi_t> base;
-          fdi_t* di;
-          uint32_t memsize;
+          shared_ptr<stream_type> stream;
           value_type bdi;
           Path dp;
         };
@@ -0,0 +1,376 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Filesystem library: parallel directory tree walk
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__STLX_TR2_FILESYSTEM
+#error internal header
+#endif
+
+#include "../../vector.hxx"
+#include "../../thread.hxx"
+#include "../../mutex.hxx"
+#include "../../exception2.hxx"
+#include "../../../nt/event.hxx"
+
+namespace std
+{
+  namespace tr2
+  {
+    namespace sys
+    {
+      namespace filesystem
+      {
+      /**
+       *  \addtogroup tr2
+       *  @{
+       *  \addtogroup tr2_filesystem
+       *  @{
+       *  \addtogroup tr2_filesystem_dir
+       *  @{
+       **/
+
+        /** Options of the parallel_directory_walk() (an extension) */
+        struct directory_walk_options
+        {
+          /** Number of the workers, including the calling thread. Zero means thread::hardware_concurrency() */
+          unsigned threads;
+          /** Limit of the directories opened at once. Each worker reads one directory at a time, so it limits the workers count too. Zero means no limit */
+          unsigned max_open_handles;
+          /** Maximum number of the entries passed to the visitor at once */
+          unsigned batch_size;
+          /** Maximum depth of the walk, the root directory entries are at level 0 */
+          unsigned max_depth;
+          /** Descend into the directory symlinks and junctions. The walk does not detect the cycles, max_depth bounds them */
+          bool follow_reparse_points;
+          /** Calls the visitor under the lock, otherwise the visitor should be thread-safe */
+          bool serialize_visitor;
+          /** External cancellation flag, the walk stops as soon as it is set */
+          const volatile bool* cancel;
+
+          directory_walk_options()
+            :threads(), max_open_handles(), batch_size(256), max_depth(~0u),
+            follow_reparse_points(false), serialize_visitor(true), cancel()
+          {}
+        };
+
+        /** Result of the parallel_directory_walk() */
+        struct directory_walk_result
+        {
+          /** Number of the directories read */
+          uint64_t directories;
+          /** Number of the entries passed to the visitor */
+          uint64_t entries;
+          /** Number of the directories failed to read */
+          uint32_t errors;
+          /** Walk was cancelled by the visitor or by the external flag */
+          bool cancelled;
+          /** The first error */
+          error_code ec;
+        };
+
+        /**
+         *	@brief Batch of the directory entries passed to the parallel_directory_walk() visitor
+         *  @details All entries belong to the same directory, a large directory is delivered in several batches.
+         *  The subdirectories are queued for the walk after the visitor returns, unless they were pruned.
+         **/
+        template <class Path>
+        class directory_walk_batch
+        {
+        public:
+          typedef basic_directory_entry<Path> value_type;
+          typedef const value_type* const_iterator;
+          typedef size_t size_type;
+
+          ///\name observers
+          /** The directory being read */
+          const Path& directory() const  { return *dir; }
+          /** Depth of the entries, the root directory entries are at level 0 */
+          unsigned level() const          { return level_; }
+          /** Is it the last batch of the directory */
+          bool last() const               { return last_; }
+
+          size_type size() const          { return count; }
+          bool empty() const              { return count == 0; }
+          const value_type& operator[](size_type i) const { assert(i < count); return entries[i]; }
+          const_iterator begin() const    { return &entries[0]; }
+          const_iterator end() const      { return &entries[0] + count; }
+
+          ///\name modifiers
+          /** Excludes the \a i-th entry from the walk if it is a directory */
+          void prune(size_type i)         { assert(i < count); pruned[i] = true; }
+          /** Excludes every entry of the batch from the walk */
+          void prune_all()                { std::fill_n(pruned.begin(), count, true); }
+          /** Stops the walk, the entries of this batch are not walked into */
+          void cancel()                   { cancelled = true; }
+          ///\}
+
+        protected:
+          directory_walk_batch(size_t batch_size)
+            :entries(batch_size), pruned(batch_size), dir(), count(), level_(), last_(), cancelled()
+          {}
+
+          vector<value_type> entries;
+          vector<bool> pruned;
+          const Path* dir;
+          size_type count;
+          unsigned level_;
+          bool last_;
+          bool cancelled;
+        };
+
+        namespace __
+        {
+          /**
+           *  Walks the directory tree by the pool of the workers.
+           *  The workers take the directories from the shared queue, read each of them through the directory_stream<Api>
+           *  and pass the entries to the visitor in batches, then queue the subdirectories.
+           *  The calling thread is one of the workers, so the walk with one thread starts no threads.
+           *  An exception of the visitor cancels the walk and the first one is rethrown by the calling thread after the workers are joined.
+           **/
+          template<class Path, class Visitor, class Api = nt_directory_api>
+          class directory_walker:
+            noncopyable
+          {
+            typedef directory_stream<Api> stream_type;
+
+            struct work_item
+            {
+              Path dir;
+              unsigned level;
+              work_item(const Path& dir, unsigned level)
+                :dir(dir), level(level)
+              {}
+            };
+
+            struct batch_type:
+              directory_walk_batch<Path>
+            {
+              explicit batch_type(size_t batch_size)
+                :directory_walk_batch<Path>(batch_size)
+              {}
+              // the exception of the visitor, moved to the walker under its lock
+              exception_ptr failure;
+              friend class directory_walker;
+            };
+
+          public:
+            directory_walker(Visitor& visitor, const directory_walk_options& opt)
+              :visitor(visitor), opt(opt), ready(ntl::nt::NotificationEvent), pending(), cancelled(false)
+            {
+              result.directories = result.entries = 0;
+              result.errors = 0;
+              result.cancelled = false;
+              if(!this->opt.batch_size)
+                this->opt.batch_size = 1;
+            }
+
+            directory_walk_result operator()(const Path& root)
+            {
+              queue.push_back(work_item(root, 0));
+              pending = 1;
+
+              unsigned workers = opt.threads ? opt.threads : thread::hardware_concurrency();
+              if(opt.max_open_handles && workers > opt.max_open_handles)
+                workers = opt.max_open_handles;
+              if(!workers)
+                workers = 1;
+
+              const unique_ptr<thread[]> pool(new thread[--workers]);
+              for(unsigned i = 0; i < workers; i++){
+                thread t(&directory_walker::worker, this);
+                pool[i].swap(t);
+              }
+              worker(this);
+              for(unsigned i = 0; i < workers; i++)
+                if(pool[i].joinable())
+                  pool[i].join();
+
+              result.cancelled = is_cancelled();
+            #if STLX__USE_EXCEPTIONS == 1
+              if(failure)
+                rethrow_exception(failure);
+            #endif
+              return result;
+            }
+
+          private:
+            bool is_cancelled() const
+            {
+              return cancelled || (opt.cancel && *opt.cancel);
+            }
+
+            static void worker(directory_walker* self)
+            {
+              stream_type stream;
+              batch_type batch(self->opt.batch_size);
+              vector<work_item> found;
+              for(;;){
+                unique_lock<mutex> lock(self->guard);
+                while(self->queue.empty()){
+                  if(self->pending == 0 || self->is_cancelled()){
+                    // wake up the other workers to let them exit too
+                    self->ready.set();
+                    return;
+                  }
+                  self->ready.reset();
+                  lock.unlock();
+                  self->ready.wait(false);
+                  lock.lock();
+                }
+                // LIFO keeps the queue short and the reads close to each other
+                const work_item item = self->queue.back();
+                self->queue.pop_back();
+                lock.unlock();
+
+                found.clear();
+                if(!self->is_cancelled())
+                  self->read(item, stream, batch, found);
+
+                lock.lock();
+                const bool cancelled = self->is_cancelled();
+                if(!cancelled){
+                  for(size_t i = 0; i < found.size(); i++)
+                    self->queue.push_back(found[i]);
+                  self->pending += found.size();
+                }
+                if(--self->pending == 0 || !found.empty() || cancelled)
+                  self->ready.set();
+              }
+            }
+
+            void read(const work_item& item, stream_type& stream, batch_type& batch, vector<work_item>& found)
+            {
+              using namespace ntl::nt;
+              ntstatus st = stream.open(const_unicode_string(item.dir.external_file_string()));
+              if(success(st)){
+                batch.dir = &item.dir;
+                batch.level_ = item.level;
+                do{
+                  batch.count = 0;
+                  while(stream.entry() && batch.count < opt.batch_size){
+                    assign_directory_entry(batch.entries[batch.count], item.dir, stream);
+                    batch.pruned[batch.count] = false;
+                    batch.count++;
+                    st = stream.next();
+                  }
+                  batch.last_ = !stream.entry();
+                  if(batch.count || batch.last_)
+                    visit(batch);
+                  if(batch.cancelled){
+                    cancelled = true;
+                    break;
+                  }
+                  if(item.level < opt.max_depth)
+                    for(size_t i = 0; i < batch.count; i++)
+                      if(!batch.pruned[i] && walk_into(batch.entries[i]))
+                        found.push_back(work_item(batch.entries[i].path(), item.level + 1));
+                } while(!batch.last_ && !is_cancelled());
+                stream.close();
+              }
+
+              lock_guard<mutex> lock(guard);
+              if(batch.failure){
+                if(!failure)
+                  failure = batch.failure;
+                batch.failure = exception_ptr();
+              }
+              if(success(st))
+                result.directories++;
+              else if(!result.errors++)
+                result.ec = make_error_code(st);
+            }
+
+            bool walk_into(const basic_directory_entry<Path>& e) const
+            {
+              const uint32_t attributes = e.info().attributes;
+              if(!(attributes & ntl::nt::file_attribute::directory))
+                return false;
+              return opt.follow_reparse_points || !(attributes & ntl::nt::file_attribute::reparse_point);
+            }
+
+            void visit(batch_type& batch)
+            {
+              if(opt.serialize_visitor){
+                lock_guard<mutex> lock(guard);
+                result.entries += batch.count;
+                call(batch);
+              }else{
+                {
+                  lock_guard<mutex> lock(guard);
+                  result.entries += batch.count;
+                }
+                call(batch);
+              }
+            }
+
+            // the exception must not leave the worker thread, it cancels the walk instead
+            void call(batch_type& batch)
+            {
+            #if STLX__USE_EXCEPTIONS == 1
+              try{
+                visitor(static_cast<directory_walk_batch<Path>&>(batch));
+              }
+              catch(...){
+                batch.failure = current_exception();
+                batch.cancelled = true;
+              }
+            #else
+              visitor(static_cast<directory_walk_batch<Path>&>(batch));
+            #endif
+            }
+
+          private:
+            Visitor& visitor;
+            directory_walk_options opt;
+            directory_walk_result result;
+            mutex guard;
+            ntl::nt::user_event ready;
+            vector<work_item> queue;
+            size_t pending;       // queued and being read directories
+            volatile bool cancelled;
+            exception_ptr failure;
+          };
+        } // __
+
+        /**
+         *	@brief Walks the directory tree rooted at \a root by several threads (an extension)
+         *  @details The directories are read in parallel by up to \c opt.threads workers, at most \c opt.max_open_handles
+         *  directories are opened at once. The visitor is called as <tt>visitor(directory_walk_batch<Path>&)</tt> for each batch of
+         *  up to \c opt.batch_size entries of a directory, and it may prune the subdirectories or cancel the walk through the batch.
+         *  The order of the directories is not specified, the batches of one directory come in order.
+         *
+         *  The reparse points are reported with the \c symlink_file symlink status and aren't walked into unless \c opt.follow_reparse_points is set.
+         *  A failure to read a subdirectory doesn't stop the walk, it is counted in the result.
+         *  An exception thrown by the visitor cancels the walk and is rethrown to the caller once all workers are stopped.
+         *  @note This is useful for the full volume scans which are bound by the I/O latency rather than by the CPU.
+         **/
+#ifdef NTL__CXX_RV
+        template <class Path, class Visitor>
+        inline directory_walk_result parallel_directory_walk(const Path& root, Visitor&& visitor, const directory_walk_options& opt = directory_walk_options())
+        {
+          // the temporary visitor lives until the walk returns
+          return __::directory_walker<Path, typename remove_reference<Visitor>::type>(visitor, opt)(root);
+        }
+#else
+        template <class Path, class Visitor>
+        inline directory_walk_result parallel_directory_walk(const Path& root, Visitor& visitor, const directory_walk_options& opt = directory_walk_options())
+        {
+          return __::directory_walker<Path, Visitor>(visitor, opt)(root);
+        }
+
+        template <class Path, class Visitor>
+        inline directory_walk_result parallel_directory_walk(const Path& root, const Visitor& visitor, const directory_walk_options& opt = directory_walk_options())
+        {
+          return __::directory_walker<Path, const Visitor>(visitor, opt)(root);
+        }
+#endif
+
+        /** @} tr2_filesystem_dir */
+        /** @} tr2_filesystem */
+        /** @} tr2 */
+      }
+    }
+  }
+}
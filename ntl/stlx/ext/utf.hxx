@@ -0,0 +1,344 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  UTF-8 and UTF-16 transcoding
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__EXT_UTF
+#define NTL__EXT_UTF
+#pragma once
+
+#include "../cstdint.hxx"
+#include "../cstddef.hxx"
+
+#if !defined(NTL_NO_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+# define NTL__UTF_SSE2
+# include <emmintrin.h>
+#endif
+
+namespace std
+{
+  namespace ext
+  {
+    /**
+     *	The validating conversions between UTF-8 and the 16-bit (UCS-2, UTF-16) or 32-bit (UCS-4) code units.
+     *
+     *  The conversions follow codecvt::in() and codecvt::out(): they stop at the invalid sequence with \c error,
+     *  at the incomplete source sequence or at the full destination with \c partial.
+     *  The overlong sequences, the surrogate code points and the code points above \a maxcode are invalid.
+     *  With \a pairs the code points above 0xFFFF are the surrogate pairs, without it they are the single code units.
+     *
+     *  The 16-bit units are converted by 8 with SSE2 unless NTL_NO_SIMD is defined: the blocks of the ASCII
+     *  or of the two-byte sequences only, other blocks are converted by the code points.
+     **/
+    namespace utf
+    {
+      /// The result of the conversion, the values are the ones of codecvt_base::result
+      enum result { ok, partial, error };
+
+      namespace __
+      {
+        template<size_t UnitSize>
+        struct simd
+        {
+          static const bool enabled = false;
+          template<class Char> static bool out(const Char*&, char*&) { return false; }
+          template<class Char> static bool in(const char*&, Char*&) { return false; }
+          template<class Char> static size_t utf8_length(const Char*&, const Char*) { return 0; }
+        };
+
+#ifdef NTL__UTF_SSE2
+        template<>
+        struct simd<2>
+        {
+          static const bool enabled = true;
+
+          // 8 ASCII units into 8 bytes, 8 units of 0x80..0x7FF into 16 bytes
+          template<class Char>
+          static bool out(const Char*& from, char*& to)
+          {
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+            const __m128i zero = _mm_setzero_si128();
+            if ( _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(c, _mm_set1_epi16(-0x80)), zero)) == 0xFFFF )
+            {
+              _mm_storel_epi64(reinterpret_cast<__m128i*>(to), _mm_packus_epi16(c, c));
+              from += 8, to += 8;
+              return true;
+            }
+            // no ASCII and no three-byte sequences: the lead byte is the low one of the word
+            const __m128i two = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_and_si128(c, _mm_set1_epi16(-0x80)), zero),
+                                                 _mm_cmpeq_epi16(_mm_and_si128(c, _mm_set1_epi16(-0x800)), zero));
+            if ( _mm_movemask_epi8(two) != 0xFFFF )
+              return false;
+            const __m128i lead  = _mm_or_si128(_mm_srli_epi16(c, 6), _mm_set1_epi16(0xC0)),
+                          trail = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(0x3F)), 8), _mm_set1_epi16(-0x8000));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(to), _mm_or_si128(lead, trail));
+            from += 8, to += 16;
+            return true;
+          }
+
+          // 16 ASCII bytes into 16 units, 8 two-byte sequences into 8 units
+          template<class Char>
+          static bool in(const char*& from, Char*& to)
+          {
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+            const __m128i zero = _mm_setzero_si128();
+            if ( _mm_movemask_epi8(b) == 0 )
+            {
+              _mm_storeu_si128(reinterpret_cast<__m128i*>(to), _mm_unpacklo_epi8(b, zero));
+              _mm_storeu_si128(reinterpret_cast<__m128i*>(to + 8), _mm_unpackhi_epi8(b, zero));
+              from += 16, to += 16;
+              return true;
+            }
+            // the words of the lead byte 0xC2..0xDF and of the continuation byte
+            const __m128i shape = _mm_cmpeq_epi16(_mm_and_si128(b, _mm_set1_epi16(-0x3F20)), _mm_set1_epi16(-0x7F40)),
+                          overlong = _mm_cmpeq_epi16(_mm_and_si128(b, _mm_set1_epi16(0x1E)), zero);
+            if ( _mm_movemask_epi8(_mm_andnot_si128(overlong, shape)) != 0xFFFF )
+              return false;
+            const __m128i c = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, _mm_set1_epi16(0x1F)), 6),
+                                           _mm_and_si128(_mm_srli_epi16(b, 8), _mm_set1_epi16(0x3F)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(to), c);
+            from += 16, to += 8;
+            return true;
+          }
+
+          // 3 bytes per unit less the ASCII, the two-byte and the surrogate units
+          template<class Char>
+          static size_t utf8_length(const Char*& first, const Char* last)
+          {
+            const __m128i ascii = _mm_set1_epi16(-0x80), two = _mm_set1_epi16(-0x800), surrogate = _mm_set1_epi16(-0x2800);
+            size_t length = 0;
+            while ( last - first >= 8 )
+            {
+              // the 16-bit counters take up to 2 per block
+              __m128i sum = _mm_setzero_si128();
+              for ( size_t blocks = (last - first) / 8 > 16000 ? 16000 : (last - first) / 8; blocks; blocks--, first += 8 )
+              {
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                sum = _mm_add_epi16(sum, _mm_cmpeq_epi16(_mm_and_si128(c, ascii), _mm_setzero_si128()));
+                sum = _mm_add_epi16(sum, _mm_cmpeq_epi16(_mm_and_si128(c, two), _mm_setzero_si128()));
+                sum = _mm_add_epi16(sum, _mm_cmpeq_epi16(_mm_and_si128(c, two), surrogate));
+              }
+              sum = _mm_madd_epi16(sum, _mm_set1_epi16(1));
+              sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1,0,3,2)));
+              sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2,3,0,1)));
+              length -= static_cast<size_t>(-_mm_cvtsi128_si32(sum));
+            }
+            return length;
+          }
+        };
+#endif
+
+        inline size_t utf8_size(uint32_t c)
+        {
+          return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        }
+
+        // the code point at from, 0 units for error and for the incomplete pair
+        template<class Char>
+        inline uint32_t read_unit(const Char* from, const Char* from_end, uint32_t maxcode, bool pairs, size_t& units, result& r)
+        {
+          uint32_t c = static_cast<uint32_t>(*from);
+          units = 1;
+          if ( c - 0xD800 < 0x800 )
+          {
+            if ( !pairs || c >= 0xDC00 )
+              units = 0;
+            else if ( from_end - from < 2 )
+              units = 0, r = partial;
+            else if ( static_cast<uint32_t>(from[1]) - 0xDC00 >= 0x400 )
+              units = 0;
+            else
+              c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<uint32_t>(from[1]) - 0xDC00), units = 2;
+            if ( !units && r != partial )
+              r = error;
+          }
+          if ( c > maxcode )
+            units = 0, r = error;
+          return c;
+        }
+
+        // the code point at from, 0 bytes for error and for the incomplete sequence
+        inline uint32_t read_utf8(const char* from, const char* from_end, uint32_t maxcode, size_t& bytes, result& r)
+        {
+          const uint8_t* const s = reinterpret_cast<const uint8_t*>(from);
+          uint32_t c = s[0];
+          size_t n = 0;
+          bytes = 0;
+          if ( c < 0x80 )       n = 1;
+          else if ( c < 0xC2 )  n = 0;
+          else if ( c < 0xE0 )  n = 2, c &= 0x1F;
+          else if ( c < 0xF0 )  n = 3, c &= 0x0F;
+          else if ( c < 0xF5 )  n = 4, c &= 0x07;
+          const size_t available = static_cast<size_t>(from_end - from) < n ? static_cast<size_t>(from_end - from) : n;
+          for ( size_t i = 1; i < available; i++ )
+          {
+            if ( (s[i] & 0xC0) != 0x80 )
+              n = 0;
+            c = c << 6 | (s[i] & 0x3F);
+          }
+          if ( n && available < n )
+          {
+            // the truncated sequence is partial only if some of its completions are valid
+            const unsigned shift = 6 * static_cast<unsigned>(n - available);
+            const uint32_t low = c << shift, high = low | ((1u << shift) - 1);
+            r = (n == 3 && high < 0x800) || (n == 4 && high < 0x10000) || (low >= 0xD800 && high < 0xE000) || low > maxcode ? error : partial;
+          }
+          else if ( !n || (n == 3 && c < 0x800) || (n == 4 && c < 0x10000) || c - 0xD800 < 0x800 || c > maxcode )
+            r = error;
+          else
+            bytes = n;
+          return c;
+        }
+      }
+
+      /// The exact length of UTF-8 of the valid UTF-16 range, an unpaired surrogate is counted as 2 bytes
+      template<class Char>
+      inline size_t utf8_length(const Char* first, const Char* last)
+      {
+        size_t length = (last - first) * 3;
+        length += __::simd<sizeof(Char)>::utf8_length(first, last);
+        for ( ; first != last; ++first )
+        {
+          const uint32_t c = static_cast<uint32_t>(*first);
+          length -= c < 0x80 ? 2 : c < 0x800 || c - 0xD800 < 0x800 ? 1 : 0;
+          if ( c > 0xFFFF )
+            length++;
+        }
+        return length;
+      }
+
+      /// Converts the code units to UTF-8
+      template<class Char>
+      inline result to_utf8(const Char* from, const Char* from_end, const Char*& from_next, char* to, char* to_limit, char*& to_next,
+                            uint32_t maxcode = 0x10FFFF, bool pairs = true)
+      {
+        result r = ok;
+        size_t scalar = 8;
+        while ( from != from_end )
+        {
+          const Char* block_end = from_end;
+          if ( __::simd<sizeof(Char)>::enabled && from_end - from >= 8 )
+          {
+            if ( maxcode >= 0x7FF && to_limit - to >= 16 && __::simd<sizeof(Char)>::out(from, to) )
+            {
+              scalar = 8;
+              continue;
+            }
+            // the text which does not fit the blocks is tried less often
+            block_end = from + (static_cast<size_t>(from_end - from) < scalar ? from_end - from : scalar);
+            if ( scalar < 128 )
+              scalar *= 2;
+          }
+          do
+          {
+            size_t units;
+            const uint32_t c = __::read_unit(from, from_end, maxcode, pairs, units, r);
+            if ( !units )
+              goto done;
+            const size_t bytes = __::utf8_size(c);
+            if ( static_cast<size_t>(to_limit - to) < bytes )
+            {
+              r = partial;
+              goto done;
+            }
+            switch ( bytes )
+            {
+            case 1:
+              to[0] = static_cast<char>(c);
+              break;
+            case 2:
+              to[0] = static_cast<char>(0xC0 | c >> 6);
+              to[1] = static_cast<char>(0x80 | (c & 0x3F));
+              break;
+            case 3:
+              to[0] = static_cast<char>(0xE0 | c >> 12);
+              to[1] = static_cast<char>(0x80 | (c >> 6 & 0x3F));
+              to[2] = static_cast<char>(0x80 | (c & 0x3F));
+              break;
+            default:
+              to[0] = static_cast<char>(0xF0 | c >> 18);
+              to[1] = static_cast<char>(0x80 | (c >> 12 & 0x3F));
+              to[2] = static_cast<char>(0x80 | (c >> 6 & 0x3F));
+              to[3] = static_cast<char>(0x80 | (c & 0x3F));
+              break;
+            }
+            from += units, to += bytes;
+          } while ( from < block_end );
+        }
+      done:
+        from_next = from, to_next = to;
+        return r;
+      }
+
+      /// Converts UTF-8 to the code units
+      template<class Char>
+      inline result from_utf8(const char* from, const char* from_end, const char*& from_next, Char* to, Char* to_limit, Char*& to_next,
+                              uint32_t maxcode = 0x10FFFF, bool pairs = true)
+      {
+        result r = ok;
+        size_t scalar = 16;
+        while ( from != from_end )
+        {
+          const char* block_end = from_end;
+          if ( __::simd<sizeof(Char)>::enabled && from_end - from >= 16 )
+          {
+            if ( maxcode >= 0x7FF && to_limit - to >= 16 && __::simd<sizeof(Char)>::in(from, to) )
+            {
+              scalar = 16;
+              continue;
+            }
+            // the text which does not fit the blocks is tried less often
+            block_end = from + (static_cast<size_t>(from_end - from) < scalar ? from_end - from : scalar);
+            if ( scalar < 256 )
+              scalar *= 2;
+          }
+          do
+          {
+            size_t bytes;
+            const uint32_t c = __::read_utf8(from, from_end, maxcode, bytes, r);
+            if ( !bytes )
+              goto done;
+            const size_t units = pairs && c > 0xFFFF ? 2 : 1;
+            if ( static_cast<size_t>(to_limit - to) < units )
+            {
+              r = partial;
+              goto done;
+            }
+            if ( units == 2 )
+            {
+              to[0] = static_cast<Char>(0xD800 + ((c - 0x10000) >> 10));
+              to[1] = static_cast<Char>(0xDC00 + (c & 0x3FF));
+            }
+            else
+            {
+              to[0] = static_cast<Char>(c);
+            }
+            from += bytes, to += units;
+          } while ( from < block_end );
+        }
+      done:
+        from_next = from, to_next = to;
+        return r;
+      }
+
+      /// The UTF-8 bytes of [from, end) that make no more than \a max code units
+      inline size_t utf8_units_length(const char* from, const char* end, size_t max, uint32_t maxcode = 0x10FFFF, bool pairs = true)
+      {
+        const char* const first = from;
+        for ( result r; from != end; )
+        {
+          size_t bytes;
+          const uint32_t c = __::read_utf8(from, end, maxcode, bytes, r);
+          const size_t units = pairs && c > 0xFFFF ? 2 : 1;
+          if ( !bytes || units > max )
+            break;
+          from += bytes, max -= units;
+        }
+        return from - first;
+      }
+    }
+  }
+}
+
+#endif//#ifndef NTL__EXT_UTF
@@ -10,6 +10,9 @@
 
 #include "streambuf.hxx"
 #include "istream.hxx"
+#ifndef NTL__STLX_CSTRING
+# include "cstring.hxx"
+#endif
 
 #ifdef NTL__SUBSYSTEM_KM
 # include "../km/file.hxx"
@@ -53,8 +56,6 @@ namespace std {
   class basic_filebuf:
     public basic_streambuf<charT, traits>
   {
-    /** 16 KB default buffer size */
-    static const streamsize default_file_buffer_size = 1024 * 16;
     typedef typename traits::state_type state_type;
 
     basic_filebuf(const basic_filebuf& rhs) __deleted;
@@ -66,10 +67,15 @@ namespace std {
     typedef typename traits::off_type off_type;
     typedef traits                    traits_type;
 
+    /** 64 KB default buffer size, use pubsetbuf(nullptr, n) to change it */
+    static const streamsize default_file_buffer_size = 1024 * 64;
+    /** Alignment of the own buffer and the transfer granularity of the direct I/O (enough for the 4K-sector disks) */
+    static const size_t sector_size = 4096;
+
     ///\name 27.9.1.2 basic_filebuf constructors [filebuf.cons]
 
     basic_filebuf()
-      :mode(), our_buffer(true),encoding(Encoding::Default)
+      :buf_storage(), encoding(Encoding::Default), mode(), our_buffer(true)
     {}
 
 #ifdef NTL__CXX_RV
@@ -124,10 +130,8 @@ namespace std {
 
       // flush
       bool ok = true;
-      if(pbase()){
-        const int_type eof = traits_type::eof();
-        ok = !traits_type::eq_int_type(overflow(eof), eof);
-      }
+      if(pbase())
+        ok = write_pending(true) && flush();
 
       /* ???
       If the last virtual member function called on *this (between underflow, overflow,
@@ -178,7 +182,12 @@ namespace std {
       const bool writeable = (mode&ios_base::out) != 0;
       streamsize cb;
       char_type* p = eback();
-      if(!writeable){
+      if(!writeable && (mode & ios_base::direct)){
+        // sector-aligned transfers to the whole buffer, no putback sequence
+        p = buf.first;
+        cb = buf.second;
+        setg(p, p, p);
+      }else if(!writeable){
         // use all buffer
         if(egptr() == p){
           // possible first call, read 128 characters
@@ -236,21 +245,42 @@ namespace std {
       return c;
     }
 
+    virtual streamsize xsgetn(char_type* s, streamsize n)
+    {
+      // large binary reads go straight to the caller's memory
+      if(!f || n < buf.second || (mode & (ios_base::binary|ios_base::direct|ios_base::out)) != ios_base::binary)
+        return basic_streambuf::xsgetn(s, n);
+
+      // take the buffered characters first
+      streamsize copied = egptr()-gptr();
+      if(copied > 0){
+        traits_type::copy(s, gptr(), static_cast<size_t>(copied));
+        setg(eback(), egptr(), egptr());
+      }else
+        copied = 0;
+
+      while(copied < n){
+        streamsize readed;
+        if(!read_binary(s+copied, s+n, readed))
+          break;
+        copied += readed;
+      }
+      return copied;
+    }
+
     virtual streamsize xsputn(const char_type* s, streamsize n)
     {
-      if(n <= default_file_buffer_size)
-        return basic_streambuf::xsputn(s, n);
-      else if(!f)
+      if(!f)
         return 0;
-      // directly put the large data
+      // the direct I/O needs aligned transfers, so it always goes through the buffer
+      if(n < buf.second || (mode & ios_base::direct))
+        return basic_streambuf::xsputn(s, n);
 
-      // put the pending data
-      overflow();
-      // request file space & write data
-      f.size(f.tell() + n);
+      // put the pending data and the large block directly
+      if(!write_pending(false))
+        return 0;
       streamsize written;
       write(s, n, &written);
-      f.flush();
       return written;
     }
 
@@ -261,33 +291,44 @@ namespace std {
       if(!f || (!pbase() && eofc))
         return eof;
 
-      bool ok = true;
-      if(const streamsize pending = pptr()-pbase()) {
-        // write buffer
-        if(ok = write(pbase(), pending), ok)
-          reset();
-      }
+      if(!write_pending(false))
+        return eof;
 
-      if(ok && !eofc){
-        // write c
+      if(!eofc){
         const char_type cc = traits_type::to_char_type(c);
-        ok = write(&cc, 1);
+        if(pptr() < epptr() && buf.second > 1){
+          // buffer c
+          *pptr() = cc;
+          pbump(1);
+        }else if(!write(&cc, 1)){
+          return eof;
+        }
       }
-      ok &= flush();
-      if(!ok)
-        return eof;
       return eofc ? traits_type::not_eof(c) : c;
     }
 
+    /**
+     *	setbuf(nullptr, 0) makes the stream unbuffered, setbuf(nullptr, n) allocates the own buffer of \p n characters (NTL extension).
+     *  The direct I/O keeps the tail of the last sector in the buffer until close, the buffer can not be changed then.
+     **/
     virtual basic_streambuf<charT,traits>* setbuf(char_type* s, streamsize n)
     {
-      if(!s && !n){
-        // unbuffered io
-        our_buffer = true;
-        reallocate_buffer(1);
+      if(f && pbase() && sync() == -1)
+        return nullptr;
+      if((mode & ios_base::direct) && pptr() != pbase())
+        return nullptr;
+      if(!s){
+        if(!n && (mode & ios_base::direct))
+          return nullptr;
+        if(!our_buffer)
+          buf.first = nullptr, buf.second = 0, our_buffer = true;
+        if(!reallocate_buffer(n ? n : 1))
+          return nullptr;
         reset();
         return this;
       }
+      if((mode & ios_base::direct) && !is_aligned(s, n))
+        return nullptr;
       if(buf.second) reallocate_buffer(0);
       buf.first = s,
         buf.second = n;
@@ -312,6 +353,20 @@ namespace std {
       if(off != 0 && width <= 0)
         return re;
 
+      if((mode & ios_base::direct) && (way != ios_base::cur || off != 0)){
+        // the direct I/O moves between the sector boundaries only and can not leave the pending tail behind
+        if(sync() == -1 || pptr() != pbase())
+          return re;
+        using namespace NTL__SUBSYSTEM_NS;
+        const native_file::size_type base = way == ios_base::beg ? 0
+          : way == ios_base::end ? f.size() : f.tell() - (egptr()-gptr()) * width;
+        const native_file::size_type target = base + off * width;
+        if(target < 0 || target % sector_size || !success(f.seek(target, native_file::file_begin)))
+          return re;
+        setg(buf.first, buf.first, buf.first);
+        return pos_type(off_type(target / width));
+      }
+
       if(way != ios_base::cur || off != 0 && pptr()-pbase()){
         if(sync() == -1)
           return re;
@@ -328,14 +383,9 @@ namespace std {
       return re;
     }
 
-    virtual pos_type seekpos(pos_type sp, ios_base::openmode = ios_base::in | ios_base::out)
+    virtual pos_type seekpos(pos_type sp, ios_base::openmode which = ios_base::in | ios_base::out)
     {
-      pos_type re = pos_type(off_type(-1));
-      if(!f)
-        return re;
-      _assert_msg("not implemented yet");
-      (void)sp;
-      return re;
+      return seekoff(off_type(sp), ios_base::beg, which);
     }
 
     virtual int sync()
@@ -345,9 +395,9 @@ namespace std {
 
       const streamsize pending = pptr()-pbase();
       if(pending){
-        if(!write(pbase(), pending) || !flush())
+        // the direct I/O writes only the whole sectors here, the tail is written on close
+        if(!write_pending(false) || !flush())
           return -1;
-        reset();
       }
       return static_cast<int>(pending);
     }
@@ -365,20 +415,70 @@ namespace std {
 
       if(n == 0) {
         // free buffer
+        buf.first = nullptr;
         buf.second = n;
-        delete[] buf.first;
+        delete[] buf_storage;
+        buf_storage = nullptr;
+        return true;
+      }
+
+      // the direct I/O needs the buffer of whole sectors at the sector boundary;
+      // the single character of unbuffered stream is left as is
+      const bool direct = (mode & ios_base::direct) && n != 1;
+      const size_t size = direct ? (static_cast<size_t>(n) * sizeof(char_type) + sector_size - 1) & ~(sector_size - 1)
+        : static_cast<size_t>(n) * sizeof(char_type);
+      if(buf.second && static_cast<size_t>(buf.second) * sizeof(char_type) == size && (!direct || is_aligned(buf.first, buf.second)))
         return true;
 
-      } else if(n > buf.second) {
+      // [re]allocate buffer
+      delete[] buf_storage;
+      buf_storage = new char[direct ? size + sector_size - 1 : size];
+      buf.first = !buf_storage ? nullptr : direct
+        ? reinterpret_cast<char_type*>((reinterpret_cast<uintptr_t>(buf_storage) + sector_size - 1) & ~static_cast<uintptr_t>(sector_size - 1))
+        : reinterpret_cast<char_type*>(buf_storage);
+      buf.second = buf.first ? static_cast<streamsize>(size / sizeof(char_type)) : 0;
+      return buf.second != 0;
+    }
 
-        // [re]allocate buffer
-        if(buf.second)
-          delete[] buf.first;
+    static bool is_aligned(const char_type* s, streamsize n)
+    {
+      return (reinterpret_cast<uintptr_t>(s) & (sector_size - 1)) == 0 && (static_cast<size_t>(n) * sizeof(char_type)) % sector_size == 0;
+    }
 
-        buf.first = new char_type[n];
-        buf.second = buf.first ? n : 0;
+    /**
+     *	Writes the put area.
+     *  The direct I/O writes only the whole sectors and keeps the tail in the buffer, unless \p final,
+     *  in which case the last sector is padded and the file is truncated to the actual size.
+     **/
+    bool write_pending(bool final)
+    {
+      const streamsize pending = pptr()-pbase();
+      if(!pending)
+        return true;
+      if(!(mode & ios_base::direct)){
+        if(!write(pbase(), pending))
+          return false;
+        reset();
+        return true;
       }
-      return buf.second != 0;
+
+      const size_t bytes = static_cast<size_t>(pending) * sizeof(char_type),
+        whole = bytes & ~(sector_size - 1), tail = bytes - whole;
+      if(final && tail){
+        using namespace NTL__SUBSYSTEM_NS;
+        const native_file::size_type end = f.tell() + bytes;
+        const size_t padded = whole + sector_size;
+        std::memset(reinterpret_cast<char*>(pbase()) + bytes, 0, padded - bytes);
+        const bool ok = write_binary(pbase(), pbase() + padded / sizeof(char_type), nullptr) && success(f.size(end));
+        reset();
+        return ok;
+      }
+      if(whole && !write_binary(pbase(), pbase() + whole / sizeof(char_type), nullptr))
+        return false;
+      traits_type::move(buf.first, pbase() + whole / sizeof(char_type), tail / sizeof(char_type));
+      setp(buf.first, buf.first+buf.second);
+      pbump(static_cast<int>(tail / sizeof(char_type)));
+      return true;
     }
 
     template<typename toT>
@@ -455,17 +555,21 @@ namespace std {
     }
     bool write_binary(const char_type* from, const char_type* to, streamsize* written)
     {
-      streamsize pending = to-from, write_size = pending*sizeof(char_type), actual = 0;
+      // a single request is limited to 4 GB
+      static const size_t max_chunk = 0xFFFFF000 / sizeof(char_type);
+      streamsize pending = to-from, actual = 0;
       do{
+        const size_t chunk = min(static_cast<size_t>(pending), max_chunk), write_size = chunk*sizeof(char_type);
         assert(write_size > 0);
         if(!NTL__SUBSYSTEM_NS::success(f.write(from, static_cast<uint32_t>(write_size))))
           break;
-        const streamsize fwritten = static_cast<streamsize>(f.get_io_status_block().Information);
-        actual += fwritten;
+        const size_t fwritten = f.get_io_status_block().Information;
+        actual += static_cast<streamsize>(fwritten / sizeof(char_type));
         assert(fwritten == write_size);
-        if(fwritten != pending)
+        if(fwritten != write_size)
           break;
-        pending = 0;
+        from += chunk;
+        pending -= static_cast<streamsize>(chunk);
       }while(pending > 0);
       if(written) *written = actual;
       return pending == 0;
@@ -474,10 +578,11 @@ namespace std {
     bool read_binary(char_type* to, char_type* to_end, streamsize& readed)
     {
       readed = 0;
-      streamsize read_size = to_end - to;
+      // a single request is limited to 4 GB
+      const size_t read_size = min(static_cast<size_t>(to_end - to) * sizeof(char_type), static_cast<size_t>(0xFFFFF000));
       if(!NTL__SUBSYSTEM_NS::success(f.read(to, static_cast<uint32_t>(read_size))))
         return false;
-      readed = static_cast<streamsize>(f.get_io_status_block().Information);
+      readed = static_cast<streamsize>(f.get_io_status_block().Information / sizeof(char_type));
       return readed > 0;
     }
 
@@ -567,6 +672,18 @@ namespace std {
       }
 
       // open file
+      native_file::creation_options co = native_file::creation_options_default;
+      if(mode & ios_base::direct){
+        // the direct I/O needs sector-aligned positions, so neither text conversions nor appending are allowed
+        if((mode & (ios_base::binary|ios_base::app|ios_base::ate)) != ios_base::binary || (mode & (ios_base::in|ios_base::out)) == (ios_base::in|ios_base::out))
+          return false;
+        if(!our_buffer && !is_aligned(buf.first, buf.second))
+          return false;
+        co = co | native_file::no_intermediate_buffering;
+      }
+      if(mode & ios_base::sequential)
+        co = co | native_file::sequental_only;
+
       native_file::creation_disposition cd;
       native_file::access_mask am;
       native_file::share_mode sm;
@@ -583,7 +700,7 @@ namespace std {
         sm = native_file::share_valid_flags;
       }
       using namespace NTL__SUBSYSTEM_NS;
-      bool ok = success(f.create(name.external_file_string(), cd, am, sm));
+      bool ok = success(f.create(name.external_file_string(), cd, am, sm, co));
       if(!ok)
         return false;
 
@@ -595,10 +712,13 @@ namespace std {
         }
       }
 
-      // setup buffer
-      if(!buf.second){
+      // setup buffer, the own one set before the direct open is realigned
+      if(!buf.second || ((mode & ios_base::direct) && buf.second == 1)){
         reallocate_buffer(default_file_buffer_size);
         reset();
+      }else if((mode & ios_base::direct) && !is_aligned(buf.first, buf.second)){
+        reallocate_buffer(buf.second);
+        reset();
       }
 
       // detect encoding on nonempty file
@@ -723,6 +843,7 @@ namespace std {
 
     native_file f;
     pair<char_type*, streamsize> buf;
+    char* buf_storage;  // own buffer allocation, buf.first is aligned in it
     EncodingType encoding;
     ios_base::openmode mode;
     bool our_buffer;
@@ -1018,4 +1139,10 @@ inline void swap(basic_ofstream<charT, traits>& x, basic_ofstream<charT, traits>
 /**@} lib_file_streams */
 /**@} lib_string_streams */
 }//namespace std
+
+#ifndef NTL__SUBSYSTEM_KM
+// memory-mapped input streams
+# include "ext/mapstream.hxx"
+#endif
+
 #endif//#ifndef NTL__STLX_FSTREAM
@@ -2,6 +2,7 @@
  *                                                                     \brief
  *  20.7 Function objects [function.objects]
  *  Implementation of polymorphic function wrappers for legacy compilers
+ *  Small targets are stored inline and invoked through a single trampoline
  ****************************************************************************
  */
 #ifndef NTL__STLX_FUNCTION
@@ -9,6 +10,9 @@
 #pragma once
 
 #include "stdexception.hxx"
+#ifndef NTL__STLX_NEW
+#include "new.hxx"
+#endif
 
 #include "mem_fn.hxx"
 #ifndef NTL__STLX_FNCALLER
@@ -39,12 +43,10 @@ namespace std
   namespace __ { namespace func {
 
     /// function<> implementation
-    /// \version 1
+    /// \version 2
     /// \internal
-    namespace v1 
+    namespace v2
     {
-      //template<class> struct function;
-
       namespace impl
       {
         using ttl::meta::empty_type;
@@ -58,51 +60,316 @@ namespace std
         template<typename R, class Args>
         struct fun_arity<R,Args,2>: binary_function<typename tuple_element<0, Args>::type, typename tuple_element<1, Args>::type, R>{};
 
-        //////////////////////////////////////////////////////////////////////////
         /************************************************************************/
-        /* Base Caller                                                          */
+        /* Storage                                                              */
         /************************************************************************/
-        template<typename R, class Args>
-        struct caller
+
+        /** Inline storage of the target: a pointer with a few captures is stored without allocation */
+        union storage
+        {
+          void*   p;
+          double  align_d;
+          int64_t align_i;
+          char    buf[4 * sizeof(void*)];
+        };
+
+        /** Is the target \c F stored inline */
+        template<class F>
+        struct is_local:
+          integral_constant<bool, sizeof(F) <= sizeof(storage) && alignment_of<storage>::value % alignment_of<F>::value == 0>
+        {};
+
+        /** Constructs, moves and destroys the target of type \c F in the storage */
+        template<class F, bool Local = is_local<F>::value>
+        struct manager
+        {
+          static F& get(const storage& s) { return *reinterpret_cast<F*>(const_cast<char*>(s.buf)); }
+          static void create(storage& s, const F& f) { ::new (s.buf) F(f); }
+    #ifdef NTL__CXX_RV
+          static void create(storage& s, F&& f) { ::new (s.buf) F(move(f)); }
+    #endif
+          static void copy(storage& dst, const storage& src) { ::new (dst.buf) F(get(src)); }
+          static void relocate(storage& dst, storage& src) { ::new (dst.buf) F(move(get(src))); destroy(src); }
+          static void destroy(storage& s) { get(s).~F(); }
+        };
+
+        template<class F>
+        struct manager<F, false>
+        {
+          static F& get(const storage& s) { return *static_cast<F*>(s.p); }
+          static void create(storage& s, const F& f) { s.p = new F(f); }
+    #ifdef NTL__CXX_RV
+          static void create(storage& s, F&& f) { s.p = new F(move(f)); }
+    #endif
+          static void copy(storage& dst, const storage& src) { dst.p = new F(get(src)); }
+          static void relocate(storage& dst, storage& src) { dst.p = src.p; src.p = nullptr; }
+          static void destroy(storage& s) { delete &get(s); }
+        };
+
+        /** The callable behind the target: the referenced object for the reference_wrapper */
+        template<class F>
+        struct target_of
         {
-          virtual R operator()(const Args&) const = 0;
-          virtual caller* clone() const = 0;
-          virtual ~caller(){}
-          virtual const type_info& target_type() const = 0;
-          virtual void* target() = 0;
+          typedef F type;
+          static F& get(F& f) { return f; }
+        };
+
+        template<class T>
+        struct target_of<reference_wrapper<T> >
+        {
+          typedef T type;
+          static T& get(reference_wrapper<T>& f) { return f.get(); }
+        };
+
+        enum manager_op { op_copy, op_move, op_destroy, op_type, op_target };
+
+        /** The only per-type operation besides the invocation, used instead of a virtual table */
+        typedef const void* (*manager_type)(manager_op op, storage& dst, storage* src);
+
+        template<class F, bool Copyable>
+        struct manage
+        {
+          typedef manager<F> M;
+          typedef typename target_of<F>::type T;
+
+          static const void* call(manager_op op, storage& dst, storage* src)
+          {
+            switch(op){
+            case op_copy:    copy(dst, *src, bool_type<Copyable>()); break;
+            case op_move:    M::relocate(dst, *src); break;
+            case op_destroy: M::destroy(dst); break;
+            case op_type:    return &__ntl_typeid(T);
+            case op_target:  return &target_of<F>::get(M::get(dst));
+            }
+            return nullptr;
+          }
+        private:
+          static void copy(storage& dst, const storage& src, true_type) { M::copy(dst, src); }
+          static void copy(storage&, const storage&, false_type) {}
         };
 
         /************************************************************************/
-        /* Caller                                                               */
+        /* Invocation                                                           */
         /************************************************************************/
-        template<typename R, class F, class Args>
-        struct fun_caller:
-          caller<R,Args>,
-          noncopyable
+
+        /** Calls the target with the arguments as is; member pointers go through fn_caller */
+        template<typename R, class Args, class F, bool IsMember = is_member_pointer<typename target_of<F>::type>::value>
+        struct target_call
         {
-          explicit fun_caller(const F& f)
-            :f(f)
+          typedef target_of<F> T;
+          static R call(F& f) { return static_cast<R>(T::get(f)()); }
+          template<class A1>
+          static R call(F& f, A1& a1) { return static_cast<R>(T::get(f)(a1)); }
+          template<class A1, class A2>
+          static R call(F& f, A1& a1, A2& a2) { return static_cast<R>(T::get(f)(a1, a2)); }
+          template<class A1, class A2, class A3>
+          static R call(F& f, A1& a1, A2& a2, A3& a3) { return static_cast<R>(T::get(f)(a1, a2, a3)); }
+        };
+
+        template<typename R, class Args, class F>
+        struct target_call<R, Args, F, true>
+        {
+          typedef target_of<F> T;
+          typedef fn_caller<typename T::type, Args, R> caller;
+          template<class A1>
+          static R call(F& f, A1& a1) { return caller::call(T::get(f), Args(a1)); }
+          template<class A1, class A2>
+          static R call(F& f, A1& a1, A2& a2) { return caller::call(T::get(f), Args(a1, a2)); }
+          template<class A1, class A2, class A3>
+          static R call(F& f, A1& a1, A2& a2, A3& a3) { return caller::call(T::get(f), Args(a1, a2, a3)); }
+        };
+
+        /**
+         *  Trampolines which take the arguments directly instead of a packed tuple.
+         *  \c Get extracts the target of type \c F from the storage \c S.
+         **/
+        template<typename R, class Args, class S, size_t Argc = tuple_size<Args>::value>
+        struct invoker;
+
+        template<typename R, class Args, class S>
+        struct invoker<R, Args, S, 0>
+        {
+          typedef R (*type)(const S&);
+          template<class F, class Get>
+          static R call(const S& s) { return target_call<R, Args, F>::call(Get::get(s)); }
+          static R apply(type f, const S& s, const Args&) { return f(s); }
+        };
+
+        template<typename R, class Args, class S>
+        struct invoker<R, Args, S, 1>
+        {
+          typedef typename tuple_element<0, Args>::type A1;
+          typedef R (*type)(const S&, A1);
+          template<class F, class Get>
+          static R call(const S& s, A1 a1) { return target_call<R, Args, F>::call(Get::get(s), a1); }
+          static R apply(type f, const S& s, const Args& args) { return f(s, get<0>(args)); }
+        };
+
+        template<typename R, class Args, class S>
+        struct invoker<R, Args, S, 2>
+        {
+          typedef typename tuple_element<0, Args>::type A1;
+          typedef typename tuple_element<1, Args>::type A2;
+          typedef R (*type)(const S&, A1, A2);
+          template<class F, class Get>
+          static R call(const S& s, A1 a1, A2 a2) { return target_call<R, Args, F>::call(Get::get(s), a1, a2); }
+          static R apply(type f, const S& s, const Args& args) { return f(s, get<0>(args), get<1>(args)); }
+        };
+
+        template<typename R, class Args, class S>
+        struct invoker<R, Args, S, 3>
+        {
+          typedef typename tuple_element<0, Args>::type A1;
+          typedef typename tuple_element<1, Args>::type A2;
+          typedef typename tuple_element<2, Args>::type A3;
+          typedef R (*type)(const S&, A1, A2, A3);
+          template<class F, class Get>
+          static R call(const S& s, A1 a1, A2 a2, A3 a3) { return target_call<R, Args, F>::call(Get::get(s), a1, a2, a3); }
+          static R apply(type f, const S& s, const Args& args) { return f(s, get<0>(args), get<1>(args), get<2>(args)); }
+        };
+
+        /************************************************************************/
+        /* Owning wrapper base                                                  */
+        /************************************************************************/
+
+        /**
+         *  Common part of function and move_only_function: the target is kept in the inline storage if it fits,
+         *  is invoked through a single trampoline pointer and is managed through a single function pointer.
+         **/
+        template<typename R, class Args, bool Copyable>
+        class function_base:
+          public fun_arity<R, Args>
+        {
+        protected:
+          typedef invoker<R, Args, storage> invoker_t;
+          typedef typename invoker_t::type  invoker_type;
+
+          function_base() __ntl_nothrow
+            :manager_(), invoker_()
           {}
 
-          R operator()(const Args& args) const
+          ~function_base()
           {
-            return fn_caller<F,Args,R>::call(f, args);
+            clear();
           }
-          caller<R,Args>* clone() const
+
+          template<class F>
+          void assign_impl(const F& f)
           {
-            return new fun_caller(f);
+            if(check_ptr(f, is_pointer<F>())){
+              manager<F>::create(store, f);
+              set<F>();
+            }
           }
-          const type_info& target_type() const { return target_type<false>(__::is_refwrap<F>()); }
-          void* target() { return target<false>(__::is_refwrap<F>()); }
-        protected:
-          template<bool> const type_info& target_type(false_type) const { return __ntl_typeid(f); }
-          template<bool> const type_info& target_type(true_type)  const { return __ntl_typeid(f.get()); }
-          template<bool> void* target(false_type) { return reinterpret_cast<void*>(&f); }
-          template<bool> void* target(true_type)  { return reinterpret_cast<void*>(&f.get()); }
+    #ifdef NTL__CXX_RV
+          template<class F>
+          void assign_impl(F&& f, typename enable_if<!is_reference<F>::value>::type* = 0)
+          {
+            if(check_ptr(f, is_pointer<F>())){
+              manager<F>::create(store, move(f));
+              set<F>();
+            }
+          }
+    #endif
+
+          void copy_from(const function_base& r)
+          {
+            if(r.manager_){
+              r.manager_(op_copy, store, const_cast<storage*>(&r.store));
+              manager_ = r.manager_, invoker_ = r.invoker_;
+            }
+          }
+
+          void move_from(function_base& r) __ntl_nothrow
+          {
+            if(r.manager_){
+              r.manager_(op_move, store, &r.store);
+              manager_ = r.manager_, invoker_ = r.invoker_;
+              r.manager_ = nullptr, r.invoker_ = nullptr;
+            }
+          }
+
+          void swap_with(function_base& r) __ntl_nothrow
+          {
+            function_base tmp;
+            tmp.move_from(r);
+            r.move_from(*this);
+            move_from(tmp);
+          }
+
+          void clear()
+          {
+            if(manager_){
+              manager_(op_destroy, store, nullptr);
+              manager_ = nullptr, invoker_ = nullptr;
+            }
+          }
+
+          bool empty() const { return manager_ == nullptr; }
+
+    #if STLX__USE_RTTI
+          const std::type_info& target_type_impl() const __ntl_nothrow
+          {
+            return manager_ ? *static_cast<const std::type_info*>(manager_(op_type, const_cast<storage&>(store), nullptr)) : typeid(void);
+          }
+
+          void* target_impl(const std::type_info& ti) const __ntl_nothrow
+          {
+            return manager_ && ti == target_type_impl() ? const_cast<void*>(manager_(op_target, const_cast<storage&>(store), nullptr)) : nullptr;
+          }
+    #endif
+
+          R call(const Args& args) const __ntl_throws(bad_function_call)
+          {
+            if(!invoker_) __ntl_throw(bad_function_call());
+            return invoker_t::apply(invoker_, store, args);
+          }
+
         private:
-          F f;
+          template<class F>
+          void set()
+          {
+            manager_ = &manage<F, Copyable>::call;
+            invoker_ = &invoker_t::template call<F, manager<F> >;
+          }
+
+          /** Checks pointer if it is */
+          template<class F> static bool check_ptr(const F& f, true_type){ return f != nullptr; }
+          /** Check pointer stub for nonpointer callables */
+          template<class F> static bool check_ptr(const F&,  false_type){ return true; }
+
+          function_base(const function_base&) __deleted;
+          function_base& operator=(const function_base&) __deleted;
+
+        protected:
+          storage       store;
+          manager_type  manager_;
+          invoker_type  invoker_;
+        };
+
+        /************************************************************************/
+        /* Non-owning wrapper storage                                           */
+        /************************************************************************/
+
+        /** function_ref refers to an object or keeps a function pointer */
+        union ref_storage
+        {
+          void* obj;
+          char  fn[sizeof(void(*)())];
+        };
+
+        template<class F>
+        struct ref_object
+        {
+          static F& get(const ref_storage& s) { return *static_cast<F*>(s.obj); }
         };
-      }
+
+        template<class F>
+        struct ref_function
+        {
+          static F& get(const ref_storage& s) { return *reinterpret_cast<F*>(const_cast<char*>(s.fn)); }
+        };
+      } // impl
 
 
       /************************************************************************/
@@ -114,9 +381,11 @@ namespace std
        **/
       template<typename R, class Args = tuple<> >
       struct function:
-        impl::fun_arity<R, Args>
+        impl::function_base<R, Args, true>
       {
       protected:
+        typedef impl::function_base<R, Args, true> base;
+        typedef typename base::invoker_t invoker_t;
         typedef int nullptr_t;
       public:
         enum { 
@@ -124,65 +393,43 @@ namespace std
           arity = tuple_size<Args>::value
         };
 
-        using impl::fun_arity<R, Args>::result_type;
+        typedef typename impl::fun_arity<R, Args>::result_type result_type;
 
         ///\name 20.7.15.2.1, construct/copy/destroy:
-        // allocator-aware:
-        //template<class A> function(allocator_arg_t, const A&);
-        //template<class A> function(allocator_arg_t, const A&, unspecified-null-pointer-type );
-        //template<class A> function(allocator_arg_t, const A&, const function&);
-        //template<class A> function(allocator_arg_t, const A&, function&&);
-        //template<class F, class A> function(allocator_arg_t, const A&, F);
-        //template<class F, class A> function(allocator_arg_t, const A&, F&&);
 
         /** default ctor */
         explicit function() __ntl_nothrow
-          :caller()
         {}
 
         /** Creates copy of \c r target */
         function(const function& r)
         {
-          caller = r.caller ? r.caller->clone() : 0;
-        }
-
-        /** dtor */
-        ~function()
-        {
-          clear();
+          this->copy_from(r);
         }
 
         /** Constructs function wrapper from reference to callable object */
         template<typename F>
         explicit function(reference_wrapper<F> rf)
         {
-          caller = new impl::fun_caller<R, reference_wrapper<F>, Args>(rf);
+          this->assign_impl(rf);
         }
 
         /** Copies \c r target */
         function& operator=(const function& r)
         {
-          clear();
-          if(r.caller)
-            caller = r.caller->clone();
+          if(this != &r){
+            this->clear();
+            this->copy_from(r);
+          }
           return *this;
         }
 
     #ifdef NTL__CXX_RV
-        ///** Constructs function wrapper from copy of callable \c f */
-        //template<typename F>
-        //explicit function(const F& f)
-        //  :caller()
-        //{
-        //  assign_impl(f, is_member_function_pointer<F>());
-        //}
-
         /** Constructs function wrapper from callable \c f */
         template<typename F>
         explicit function(F&& f)
-          :caller()
         {
-          assign_impl<F>(forward<F>(f));
+          this->assign_impl(forward<F>(f));
         }
 
         /** Moves \c f to this wrapper */
@@ -194,64 +441,46 @@ namespace std
 
         /** Constructs function wrapper from target of \c r */
         function(function&& r)
-          :caller()
         {
-          if(r.caller)
-            std::swap(caller, r.caller);
+          this->move_from(r);
         }
 
         /** Replaces the target of this wrapper with the target of \c r */
         function& operator=(function&& r)
         {
-          clear();
-          if(r.caller)
-            std::swap(caller, r.caller);
+          if(this != &r){
+            this->clear();
+            this->move_from(r);
+          }
+          return *this;
         }
 
     #else
         /** Constructs function wrapper from copy of callable \c f */
         template<typename F>
         explicit function(const F& f)
-          :caller()
         {
-          assign_impl<F>(f);
+          this->assign_impl(f);
         }
         template<typename F>
         explicit function(_rvalue<F> f)
-          :caller()
         {
-          assign_impl<F>(f);
+          this->assign_impl(static_cast<F&>(f));
         }
 
-        ///** Constructs function wrapper from copy of callable \c f */
-        //template<typename F>
-        //explicit function(F& f)
-        //  :caller()
-        //{
-        //  assign_impl(f, is_member_function_pointer<F>());
-        //}
-
         /** Copies \c f to this wrapper */
         template<class F> function& operator=(const F& f) 
         {
-          clear();
-          assign_impl<F>(f);
+          this->clear();
+          this->assign_impl(f);
           return *this;
         }
         template<class F> function& operator=(_rvalue<F> f) 
         {
-          clear();
-          assign_impl<F>(f);
+          this->clear();
+          this->assign_impl(static_cast<F&>(f));
           return *this;
         }
-
-        ///** Copies \c f to this wrapper */
-        //template<class F> function& operator=(F& f)
-        //{
-        //  clear();
-        //  assign_impl(f, is_member_function_pointer<F>());
-        //  return *this;
-        //}
     #endif
 
         /** Takes referenced callable to this wrapper */
@@ -264,24 +493,26 @@ namespace std
         ///\name 20.7.15.2.4, function invocation:
         result_type operator()(const Args& args) const __ntl_throws(bad_function_call)
         {
-          if(!caller) __ntl_throw(bad_function_call());
-          return (*caller)(args);
+          return this->call(args);
         }
 
         result_type operator()() const __ntl_throws(bad_function_call)
-        { if(!caller) __ntl_throw(bad_function_call()); return (*caller)(Args()); }
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store); }
 
         result_type operator()(typename __::arg_t<0, Args>::type a1) const __ntl_throws(bad_function_call)
-        { if(!caller) __ntl_throw(bad_function_call()); return (*caller)(Args(a1)); }
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store, a1); }
 
         result_type operator()(typename __::arg_t<0, Args>::type a1, typename __::arg_t<1, Args>::type a2) const __ntl_throws(bad_function_call)
-        { if(!caller) __ntl_throw(bad_function_call()); return (*caller)(Args(a1,a2)); }
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store, a1, a2); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1, typename __::arg_t<1, Args>::type a2, typename __::arg_t<2, Args>::type a3) const __ntl_throws(bad_function_call)
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store, a1, a2, a3); }
 
 
         ///\name 20.7.15.2.3 function capacity
 
         /** Returns true if this has target */
-        operator __::explicit_bool_type() const __ntl_nothrow { return __::explicit_bool(caller); }
+        operator __::explicit_bool_type() const __ntl_nothrow { return __::explicit_bool(!this->empty()); }
 
 
         ///\name 20.7.15.2.2, function modifiers:
@@ -293,7 +524,7 @@ namespace std
         void swap(function&  r) __ntl_nothrow
     #endif
         {
-          std::swap(caller, r.caller);
+          this->swap_with(r);
         }
 
         /** Assigns this object with callable \c f */
@@ -309,67 +540,201 @@ namespace std
         /** Returns type info of the target if exists; otherwise returns <tt>typeid(void)</tt> */
         const std::type_info& target_type() const __ntl_nothrow
         {
-          return caller ? caller->target_type() : typeid(void);
+          return this->target_type_impl();
         }
 
         /** Returns pointer to target if T is type of the target or null pointer otherwise */
         template <typename T> T* target() __ntl_nothrow
         {
-          return caller && typeid(T) == target_type() ? reinterpret_cast<T*>(caller->target()) : nullptr;
+          return reinterpret_cast<T*>(this->target_impl(typeid(T)));
         }
 
         /** Returns pointer to constant target if T is type of the target or null pointer otherwise */
         template <typename T> const T* target() const __ntl_nothrow
         {
-          return caller && typeid(T) == target_type() ? reinterpret_cast<const T*>(caller->target()) : nullptr;
+          return reinterpret_cast<const T*>(this->target_impl(typeid(T)));
         }
     #endif
         ///\}
+      };
+
+      /************************************************************************/
+      /* Move-only function implementation                                    */
+      /************************************************************************/
+
+      /**
+       *	move_only_function<> implementation: the same as function<> but the target needs not be copyable
+       **/
+      template<typename R, class Args = tuple<> >
+      struct move_only_function:
+        impl::function_base<R, Args, false>
+      {
       protected:
-        ///\cond __
-        inline void clear()
+        typedef impl::function_base<R, Args, false> base;
+        typedef int nullptr_t;
+      public:
+        typedef typename impl::fun_arity<R, Args>::result_type result_type;
+
+        /** default ctor */
+        explicit move_only_function() __ntl_nothrow
+        {}
+
+    #ifdef NTL__CXX_RV
+        /** Constructs function wrapper from callable \c f */
+        template<typename F>
+        explicit move_only_function(F&& f)
         {
-          if(caller){
-            delete caller;
-            caller = nullptr;
-          }
+          this->assign_impl(forward<F>(f));
         }
-        ///\endcond
 
-    #ifndef NTL__CXX_RV
-        template<class Fn> inline void assign_impl(const Fn& f)
+        /** Constructs function wrapper from target of \c r */
+        move_only_function(move_only_function&& r)
         {
-          if(check_ptr(f, is_pointer<Fn>()))
-            caller = new impl::fun_caller<result_type, Fn, Args>(f);
+          this->move_from(r);
         }
-        template<class Fn> inline void assign_impl(_rvalue<Fn> f)
+
+        /** Replaces the target of this wrapper with the target of \c r */
+        move_only_function& operator=(move_only_function&& r)
         {
-          if(check_ptr(f, is_pointer<Fn>()))
-            caller = new impl::fun_caller<result_type, Fn, Args>(f);
+          if(this != &r){
+            this->clear();
+            this->move_from(r);
+          }
+          return *this;
         }
-        //template<class Fn> inline void assign_impl(Fn& f)
-        //{
-        //  caller = new impl::functor_caller<Fn, result_type, Args>(f);
-        //}
     #else
-        template<class Fn> inline void assign_impl(Fn&& f)
+        /** Constructs function wrapper from callable \c f, the move-only callables transfer the ownership on copy */
+        template<typename F>
+        explicit move_only_function(const F& f)
+        {
+          this->assign_impl(f);
+        }
+
+        /** Constructs function wrapper from target of \c r */
+        move_only_function(_rvalue<move_only_function> r)
         {
-          static_assert(!is_reference<Fn>::value, "reference to reference isn't allowed");
-          if(check_ptr(f, is_pointer<typename remove_reference<Fn>::type>()))
-            caller = new impl::fun_caller<result_type, typename remove_reference<Fn>::type, Args>(forward<Fn>(f));
+          this->move_from(r.x);
+        }
+
+        /** Replaces the target of this wrapper with the target of \c r */
+        move_only_function& operator=(_rvalue<move_only_function> r)
+        {
+          if(this != &r.x){
+            this->clear();
+            this->move_from(r.x);
+          }
+          return *this;
         }
     #endif
 
-        /** Checks pointer if it is */
-        template<class F> inline bool check_ptr(const F& f, true_type){ return f != nullptr; }
-        /** Check pointer stub for nonpointer callables */
-        template<class F> inline bool check_ptr(const F&,  false_type){ return true; }
+        ///\name invocation
+        result_type operator()(const Args& args) const __ntl_throws(bad_function_call)
+        {
+          return this->call(args);
+        }
+
+        result_type operator()() const __ntl_throws(bad_function_call)
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1) const __ntl_throws(bad_function_call)
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store, a1); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1, typename __::arg_t<1, Args>::type a2) const __ntl_throws(bad_function_call)
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store, a1, a2); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1, typename __::arg_t<1, Args>::type a2, typename __::arg_t<2, Args>::type a3) const __ntl_throws(bad_function_call)
+        { if(!this->invoker_) __ntl_throw(bad_function_call()); return this->invoker_(this->store, a1, a2, a3); }
+
+        ///\name capacity
+
+        /** Returns true if this has target */
+        operator __::explicit_bool_type() const __ntl_nothrow { return __::explicit_bool(!this->empty()); }
+
+        ///\name modifiers
 
+        /** Swaps this target with the target of \c r */
+        void swap(move_only_function& r) __ntl_nothrow
+        {
+          this->swap_with(r);
+        }
+        ///\}
       private:
-        impl::caller<result_type, Args>* caller;
+        move_only_function(const move_only_function&) __deleted;
+        move_only_function& operator=(const move_only_function&) __deleted;
       };
-    } // namespace v1
-    namespace detail = v1;
+
+      /************************************************************************/
+      /* Function reference implementation                                    */
+      /************************************************************************/
+
+      /**
+       *	function_ref<> implementation: refers to a callable object without owning it or keeps a function pointer.
+       *  It is never empty and costs two pointers.
+       **/
+      template<typename R, class Args = tuple<> >
+      struct function_ref:
+        impl::fun_arity<R, Args>
+      {
+      protected:
+        typedef impl::invoker<R, Args, impl::ref_storage> invoker_t;
+        typedef typename invoker_t::type                  invoker_type;
+      public:
+        typedef typename impl::fun_arity<R, Args>::result_type result_type;
+
+        /** Refers to the callable \c f, which must outlive this object */
+        template<typename F>
+        function_ref(const F& f) __ntl_nothrow
+        {
+          store.obj = const_cast<F*>(&f);
+          invoker = &invoker_t::template call<F, impl::ref_object<F> >;
+        }
+
+        /** Keeps the function pointer \c f */
+        template<typename F>
+        function_ref(F* f) __ntl_nothrow
+        {
+          assign_ptr(f, is_function<F>());
+        }
+
+        ///\name invocation
+        result_type operator()(const Args& args) const
+        {
+          return invoker_t::apply(invoker, store, args);
+        }
+
+        result_type operator()() const
+        { return invoker(store); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1) const
+        { return invoker(store, a1); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1, typename __::arg_t<1, Args>::type a2) const
+        { return invoker(store, a1, a2); }
+
+        result_type operator()(typename __::arg_t<0, Args>::type a1, typename __::arg_t<1, Args>::type a2, typename __::arg_t<2, Args>::type a3) const
+        { return invoker(store, a1, a2, a3); }
+        ///\}
+
+      private:
+        template<typename F>
+        void assign_ptr(F* f, true_type)
+        {
+          _assert_msg(f != nullptr, "function_ref can't be empty");
+          ::new (store.fn) F*(f);
+          invoker = &invoker_t::template call<F*, impl::ref_function<F*> >;
+        }
+        template<typename F>
+        void assign_ptr(F* f, false_type)
+        {
+          store.obj = f;
+          invoker = &invoker_t::template call<F, impl::ref_object<F> >;
+        }
+
+        impl::ref_storage store;
+        invoker_type      invoker;
+      };
+    } // namespace v2
+    namespace detail = v2;
     } // func
   } // __
 
@@ -438,6 +803,230 @@ namespace std
       template<class F> function& operator=(F f) { base::operator=(forward<F>(f)); return *this; }
     };
 
+    /** function<> specialization for 3 arguments */
+    template<class R, class A1, class A2, class A3>
+    class function<R(A1, A2, A3)>: 
+      public __::func::detail::function<R, FUNARGS(A1,A2,A3)>
+    {
+      typedef __::func::detail::function<R, FUNARGS(A1,A2,A3)> base;
+    public:
+      template<typename F>
+      explicit function(F f)
+        :base(forward<F>(f))
+      {}
+      explicit function() __ntl_nothrow {}
+      function(nullptr_t) __ntl_nothrow {}
+      function(function& r)
+        :base(static_cast<base&>(r)){}
+      function& operator=(function& r) { base::operator=(static_cast<base&>(r)); return *this; }
+      function& operator=(nullptr_t) { clear(); return *this; }
+      template<class F> function& operator=(F f) { base::operator=(forward<F>(f)); return *this; }
+    };
+
+    /************************************************************************/
+    /* Move-only function interface wrapper                                 */
+    /************************************************************************/
+    /**
+     *  Owning polymorphic function wrapper for targets which can't be copied (a callable holding a unique_ptr, for example).
+     *  The small targets are stored inline without allocation. \sa v2::move_only_function
+     **/
+    template<class> class move_only_function;
+
+    /** move_only_function<> specialization for 0 arguments */
+    template<class R>
+    class move_only_function<R()>:
+      public __::func::detail::move_only_function<R>
+    {
+      typedef __::func::detail::move_only_function<R> base;
+    public:
+#ifdef NTL__CXX_RV
+      template<typename F>
+      explicit move_only_function(F&& f)
+        :base(forward<F>(f))
+      {}
+      move_only_function(move_only_function&& r)
+        :base(move(static_cast<base&>(r))){}
+      move_only_function& operator=(move_only_function&& r) { base::operator=(move(static_cast<base&>(r))); return *this; }
+#else
+      template<typename F>
+      explicit move_only_function(const F& f)
+        :base(f)
+      {}
+      move_only_function(_rvalue<move_only_function> r)
+        :base(_rvalue<base>(r.x)){}
+      move_only_function& operator=(_rvalue<move_only_function> r) { base::operator=(_rvalue<base>(r.x)); return *this; }
+#endif
+      explicit move_only_function() __ntl_nothrow {}
+      move_only_function(nullptr_t) __ntl_nothrow {}
+      move_only_function& operator=(nullptr_t) { this->clear(); return *this; }
+    };
+
+    /** move_only_function<> specialization for 1 argument */
+    template<class R, class A1>
+    class move_only_function<R(A1)>:
+      public __::func::detail::move_only_function<R, FUNARGS(A1)>
+    {
+      typedef __::func::detail::move_only_function<R, FUNARGS(A1)> base;
+    public:
+#ifdef NTL__CXX_RV
+      template<typename F>
+      explicit move_only_function(F&& f)
+        :base(forward<F>(f))
+      {}
+      move_only_function(move_only_function&& r)
+        :base(move(static_cast<base&>(r))){}
+      move_only_function& operator=(move_only_function&& r) { base::operator=(move(static_cast<base&>(r))); return *this; }
+#else
+      template<typename F>
+      explicit move_only_function(const F& f)
+        :base(f)
+      {}
+      move_only_function(_rvalue<move_only_function> r)
+        :base(_rvalue<base>(r.x)){}
+      move_only_function& operator=(_rvalue<move_only_function> r) { base::operator=(_rvalue<base>(r.x)); return *this; }
+#endif
+      explicit move_only_function() __ntl_nothrow {}
+      move_only_function(nullptr_t) __ntl_nothrow {}
+      move_only_function& operator=(nullptr_t) { this->clear(); return *this; }
+    };
+
+    /** move_only_function<> specialization for 2 arguments */
+    template<class R, class A1, class A2>
+    class move_only_function<R(A1, A2)>:
+      public __::func::detail::move_only_function<R, FUNARGS(A1,A2)>
+    {
+      typedef __::func::detail::move_only_function<R, FUNARGS(A1,A2)> base;
+    public:
+#ifdef NTL__CXX_RV
+      template<typename F>
+      explicit move_only_function(F&& f)
+        :base(forward<F>(f))
+      {}
+      move_only_function(move_only_function&& r)
+        :base(move(static_cast<base&>(r))){}
+      move_only_function& operator=(move_only_function&& r) { base::operator=(move(static_cast<base&>(r))); return *this; }
+#else
+      template<typename F>
+      explicit move_only_function(const F& f)
+        :base(f)
+      {}
+      move_only_function(_rvalue<move_only_function> r)
+        :base(_rvalue<base>(r.x)){}
+      move_only_function& operator=(_rvalue<move_only_function> r) { base::operator=(_rvalue<base>(r.x)); return *this; }
+#endif
+      explicit move_only_function() __ntl_nothrow {}
+      move_only_function(nullptr_t) __ntl_nothrow {}
+      move_only_function& operator=(nullptr_t) { this->clear(); return *this; }
+    };
+
+    /** move_only_function<> specialization for 3 arguments */
+    template<class R, class A1, class A2, class A3>
+    class move_only_function<R(A1, A2, A3)>:
+      public __::func::detail::move_only_function<R, FUNARGS(A1,A2,A3)>
+    {
+      typedef __::func::detail::move_only_function<R, FUNARGS(A1,A2,A3)> base;
+    public:
+#ifdef NTL__CXX_RV
+      template<typename F>
+      explicit move_only_function(F&& f)
+        :base(forward<F>(f))
+      {}
+      move_only_function(move_only_function&& r)
+        :base(move(static_cast<base&>(r))){}
+      move_only_function& operator=(move_only_function&& r) { base::operator=(move(static_cast<base&>(r))); return *this; }
+#else
+      template<typename F>
+      explicit move_only_function(const F& f)
+        :base(f)
+      {}
+      move_only_function(_rvalue<move_only_function> r)
+        :base(_rvalue<base>(r.x)){}
+      move_only_function& operator=(_rvalue<move_only_function> r) { base::operator=(_rvalue<base>(r.x)); return *this; }
+#endif
+      explicit move_only_function() __ntl_nothrow {}
+      move_only_function(nullptr_t) __ntl_nothrow {}
+      move_only_function& operator=(nullptr_t) { this->clear(); return *this; }
+    };
+
+
+    /************************************************************************/
+    /* Function reference interface wrapper                                 */
+    /************************************************************************/
+    /**
+     *  Non-owning reference to a callable: two pointers, no allocation, nothing to destroy.
+     *  The referred callable must outlive the reference. \sa v2::function_ref
+     **/
+    template<class> class function_ref;
+
+    /** function_ref<> specialization for 0 arguments */
+    template<class R>
+    class function_ref<R()>:
+      public __::func::detail::function_ref<R>
+    {
+      typedef __::func::detail::function_ref<R> base;
+    public:
+      template<typename F>
+      function_ref(const F& f) __ntl_nothrow
+        :base(f)
+      {}
+      template<typename F>
+      function_ref(F* f) __ntl_nothrow
+        :base(f)
+      {}
+    };
+
+    /** function_ref<> specialization for 1 argument */
+    template<class R, class A1>
+    class function_ref<R(A1)>:
+      public __::func::detail::function_ref<R, FUNARGS(A1)>
+    {
+      typedef __::func::detail::function_ref<R, FUNARGS(A1)> base;
+    public:
+      template<typename F>
+      function_ref(const F& f) __ntl_nothrow
+        :base(f)
+      {}
+      template<typename F>
+      function_ref(F* f) __ntl_nothrow
+        :base(f)
+      {}
+    };
+
+    /** function_ref<> specialization for 2 arguments */
+    template<class R, class A1, class A2>
+    class function_ref<R(A1, A2)>:
+      public __::func::detail::function_ref<R, FUNARGS(A1,A2)>
+    {
+      typedef __::func::detail::function_ref<R, FUNARGS(A1,A2)> base;
+    public:
+      template<typename F>
+      function_ref(const F& f) __ntl_nothrow
+        :base(f)
+      {}
+      template<typename F>
+      function_ref(F* f) __ntl_nothrow
+        :base(f)
+      {}
+    };
+
+    /** function_ref<> specialization for 3 arguments */
+    template<class R, class A1, class A2, class A3>
+    class function_ref<R(A1, A2, A3)>:
+      public __::func::detail::function_ref<R, FUNARGS(A1,A2,A3)>
+    {
+      typedef __::func::detail::function_ref<R, FUNARGS(A1,A2,A3)> base;
+    public:
+      template<typename F>
+      function_ref(const F& f) __ntl_nothrow
+        :base(f)
+      {}
+      template<typename F>
+      function_ref(F* f) __ntl_nothrow
+        :base(f)
+      {}
+    };
+
+
   /**@} lib_func_wrap        */
   /**@} lib_function_objects */
   /**@} lib_utilities        */
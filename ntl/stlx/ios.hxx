@@ -179,6 +179,11 @@ class ios_base
     static const openmode out     = 1 << 4;
     /** perform input and output in binary mode (as opposed to text mode) (0x20) */
     static const openmode binary  = 1 << 5;
+    /** NTL extension: transfer the file data between the device and the sector-aligned stream buffer bypassing the system cache;
+        binary input or output only, positions must be sector-aligned (0x40) */
+    static const openmode direct  = 1 << 6;
+    /** NTL extension: hint that the file is accessed sequentially (0x80) */
+    static const openmode sequential = 1 << 7;
 
     /// 27.4.2.1.5 Type ios_base::seekdir [ios::seekdir]
     ///\todo must be static const
@@ -309,6 +314,8 @@ class ios_base
 
     // these 2 moved here from basic_ios for size optimization
     template <class charT, class traits> friend class basic_ios;
+    // sets failbit if a value can not be formatted
+    template <class charT, class OutputIterator> friend class num_put;
     iostate state;
     iostate exceptmask;
 
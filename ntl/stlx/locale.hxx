@@ -28,6 +28,11 @@
 #endif
 
 #include "cwctype.hxx"
+#include "new.hxx"
+
+#ifndef NTL__EXT_NUMERIC_CONVERSIONS
+# include "ext/numeric_conversions.hxx"
+#endif
 
 #include "../nt/string.hxx"
 
@@ -254,6 +259,11 @@ public:
 
 ///\name 22.1.3.2.2 string conversions [conversions.string]
 
+/// The bytes of the conversion of [from, from_end) by the facet if it knows them exactly, 0 otherwise;
+/// the facets of \<codecvt\> overload it.
+template<class Codecvt, class Elem>
+inline size_t __codecvt_out_length(const Codecvt&, const Elem*, const Elem*) { return 0; }
+
 /**
  *	@brief Class template wstring_convert
  *
@@ -283,13 +293,13 @@ public:
   typedef typename wide_string::traits_type::int_type       int_type;
 
   wstring_convert(Codecvt *pcvt = new Codecvt)
-    :cvt(pcvt), cvtstate(), count(0)
+    :cvt(pcvt), cvtstate(), count(0), keepstate(false)
   {}
   wstring_convert(Codecvt *pcvt, state_type state)
-    :cvt(pcvt), state(state), count(0)
+    :cvt(pcvt), cvtstate(state), count(0), keepstate(true)
   {}
   wstring_convert(const byte_string& byte_err, const wide_string& wide_err = wide_string())
-    :cvt(new Codecvt), cvtstate(), serr(byte_err), werr(wide_err), count(0)
+    :cvt(new Codecvt), cvtstate(), serr(byte_err), werr(wide_err), count(0), keepstate(false)
   {}
   ~wstring_convert()
   {
@@ -300,6 +310,7 @@ public:
   wide_string from_bytes(char one_byte) __ntl_throws(range_error)
   {
     assert(cvt);
+    reset();
     const char bytes[1] = {one_byte}, *bnext;
     Elem chars[1], *wnext;
     codecvt_base::result re = cvt->in(cvtstate, bytes, bytes+_countof(bytes), bnext, chars, chars+_countof(chars), wnext);
@@ -334,6 +345,7 @@ public:
     char bytes[max_wide_size], *bnext;
     const Elem chars[1] = {wchar}, *wnext;
     assert(cvt);
+    reset();
     codecvt_base::result re = cvt->out(cvtstate, chars, chars+_countof(chars), wnext, bytes, bytes+_countof(bytes), bnext);
     count = bnext - bytes;
     if(re == codecvt_base::error){
@@ -364,6 +376,13 @@ public:
   state_type state() const { return cvtstate; }
 
 private:
+  // the conversion starts at the initial state unless the object was constructed with a state
+  void reset()
+  {
+    if(!keepstate)
+      cvtstate = state_type();
+  }
+
   wide_string from_bytes(const char *ptr, size_t len) __ntl_throws(range_error)
   {
     wide_string ws(len, Elem(0)); // assume that wide string can't be large than multibyte
@@ -371,33 +390,54 @@ private:
       return ws;
     const char* bnext; Elem* wnext;
     assert(cvt);
+    reset();
     codecvt_base::result re = cvt->in(cvtstate, ptr, ptr+len, bnext, ws.begin(), ws.end(), wnext);
     count = wnext - ws.begin();
-    if(re == codecvt_base::error){
+    // a truncated sequence fails as well
+    if(re != codecvt_base::ok){
       if(werr.empty())
         __ntl_throw(range_error("conversion from bytes failed"));
       return werr;
     }
-    assert(re == codecvt_base::ok);
     ws.resize(count);
     return move(ws);
   }
   byte_string to_bytes(const Elem *wptr, size_t len) __ntl_throws(range_error)
   {
-    byte_string bs(len*max_wide_size, '\0');
+    assert(cvt);
+    reset();
+    // allocate once: the exact size or the bound of max_wide_size bytes per element
+    const size_t exact = __codecvt_out_length(*cvt, wptr, wptr+len);
+    byte_string bs(exact ? exact : len*max_wide_size, '\0');
     if(len == 0)
       return bs;
-    char* bnext; const Elem *wnext;
-    assert(cvt);
-    codecvt_base::result re = cvt->out(cvtstate, wptr, wptr+len, wnext, bs.begin(), bs.end(), bnext);
-    count = bnext - bs.begin();
-    if(re == codecvt_base::error){
+    const Elem *wnext = wptr, * const wend = wptr+len;
+    size_t done = 0;
+    codecvt_base::result re;
+    for(;;){
+      char* bnext;
+      const Elem* const wfrom = wnext;
+      const size_t room = bs.size() - done;
+      re = cvt->out(cvtstate, wnext, wend, wnext, bs.begin()+done, bs.end(), bnext);
+      const bool stalled = wnext == wfrom && size_t(bnext - bs.begin()) == done;
+      done = bnext - bs.begin();
+      if(re != codecvt_base::partial || wnext == wend)
+        break;
+      if(stalled && room >= max_wide_size){
+        // no progress with enough room: the input ends inside a sequence, e.g. in a lone high surrogate
+        re = codecvt_base::error;
+        break;
+      }
+      // the size of a derived facet may be short
+      bs.resize(bs.size() + (wend-wnext)*max_wide_size);
+    }
+    count = wnext - wptr;
+    if(re != codecvt_base::ok){
       if(serr.empty())
         __ntl_throw(range_error("conversion to bytes failed"));
       return serr;
     }
-    assert(re == codecvt_base::ok);
-    bs.resize(count);
+    bs.resize(done);
     return move(bs);
   }
 
@@ -412,6 +452,8 @@ private:
   state_type cvtstate;
   // a conversion count
   size_t count;
+  // the conversions continue from cvtstate
+  bool keepstate;
 };
 
 
@@ -813,10 +855,30 @@ template <> class ctype_byname<char>
     void operator=(const ctype_byname&) __deleted;
 };
 
+#if !defined(NTL_NO_SIMD) && WCHAR_MAX == 0xFFFF && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+# define NTL__CTYPE_SSE2
+# include <emmintrin.h>
+#endif
+
+namespace __
+{
+  /// The masks of the characters 0..0xFFFF in rtl/wchar_mask_data.cpp, generated by rtl/wchar_mask_gen.pl.
+  /// The mask of \c c is <tt>classes[pages[index[c >> 6]][c & 63]]</tt>, \c span numbers the adjacent pages
+  /// of one class (0 for the page of the different classes) and \c ascii holds the masks of the characters below 0x80.
+  extern "C" const int16_t __wchar_mask_classes[];
+  extern "C" const int16_t __wchar_mask_ascii[128];
+  extern "C" const unsigned char __wchar_mask_index[1024];
+  extern "C" const unsigned char __wchar_mask_span[1024];
+  extern "C" const unsigned char __wchar_mask_pages[][64];
+}
+
 /**
  *	@brief 22.2.1.3 ctype<wchar_t> specialization [facet.ctype.special]
  *  @details A specialization ctype<wchar_t> is provided so that the member functions on type \c wchar_t can be implemented inline.
  *  The implementation-defined value of member \c table_size is 65536.
+ *
+ *  The masks are the constant two-stage table of the 64-character pages, the characters above 0xFFFF have no class.
+ *  The sequences are classified by 8 characters with SSE2 unless NTL_NO_SIMD is defined.
  **/
 template <> class ctype<wchar_t>
 : public locale::facet, public ctype_base
@@ -827,28 +889,57 @@ public:
 
   typedef wchar_t char_type;
 
-  explicit ctype(const mask* table, size_t refs = 0)
-    : locale::facet(refs), tab(table)
+  explicit ctype(size_t refs = 0)
+    : locale::facet(refs)
   {}
 
   /** Classifies a character. */
   bool is(mask m, char_type c) const
   {
-    return (tab[c] & m) != 0;
+    return (classify(c) & m) != 0;
   }
 
   /** Classifies a character or sequence of characters. @return \a high */
   const char_type* is(const char_type* low, const char_type* high, mask* vec) const
   {
+#ifdef NTL__CTYPE_SSE2
+    for ( ; high - low >= 8; low += 8, vec += 8 )
+    {
+      const unsigned b = block_class(low);
+      if ( b == ascii_block )
+        for ( unsigned i = 0; i < 8; i++ )
+          vec[i] = __::__wchar_mask_ascii[low[i]];
+      else if ( b != mixed_block )
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vec), _mm_set1_epi16(__::__wchar_mask_classes[b]));
+      else
+        for ( unsigned i = 0; i < 8; i++ )
+          vec[i] = classify(low[i]);
+    }
+#endif
     while ( low != high )
-      *vec++ = tab[*low++];
+      *vec++ = classify(*low++);
     return high;
   }
 
   /** Locates a character in a buffer that conforms to a classification \a m. */
   const char_type* scan_is(mask m, const char_type* low, const char_type* high) const
   {
-    while ( low != high && !(tab[*low] & m) )
+#ifdef NTL__CTYPE_SSE2
+    for ( ; high - low >= 8; low += 8 )
+    {
+      const unsigned b = block_class(low);
+      if ( b < mixed_block )
+      {
+        if ( __::__wchar_mask_classes[b] & m )
+          return low;
+        continue;
+      }
+      for ( unsigned i = 0; i < 8; i++ )
+        if ( (b == ascii_block ? __::__wchar_mask_ascii[low[i]] : classify(low[i])) & m )
+          return low + i;
+    }
+#endif
+    while ( low != high && !(classify(*low) & m) )
       ++low;
     return low;
   }
@@ -856,7 +947,22 @@ public:
   /** Locates a character in a buffer that fails to conform to a classification \a m. */
   const char_type* scan_not(mask m, const char_type* low, const char_type* high) const
   {
-    while ( low != high && (tab[*low] & m) )
+#ifdef NTL__CTYPE_SSE2
+    for ( ; high - low >= 8; low += 8 )
+    {
+      const unsigned b = block_class(low);
+      if ( b < mixed_block )
+      {
+        if ( !(__::__wchar_mask_classes[b] & m) )
+          return low;
+        continue;
+      }
+      for ( unsigned i = 0; i < 8; i++ )
+        if ( !((b == ascii_block ? __::__wchar_mask_ascii[low[i]] : classify(low[i])) & m) )
+          return low + i;
+    }
+#endif
+    while ( low != high && (classify(*low) & m) )
       ++low;
     return low;
   }
@@ -951,8 +1057,35 @@ protected:
   ///\}
 
 private:
-private:
-  const mask* const tab;
+  static mask classify(char_type c)
+  {
+    const uint32_t u = static_cast<uint32_t>(c);
+    return u > 0xFFFF ? 0 : __::__wchar_mask_classes[__::__wchar_mask_pages[__::__wchar_mask_index[u >> page_bits]][u & page_mask]];
+  }
+
+  enum { page_bits = 6, page_mask = (1 << page_bits) - 1, mixed_block = 0xFF, ascii_block = 0x100 };
+
+#ifdef NTL__CTYPE_SSE2
+  // the class of the 8 characters in the pages of one class, ascii_block for the 8 characters below 0x80 or mixed_block
+  static unsigned block_class(const char_type* p)
+  {
+    // the signed minimum and maximum of the characters biased by 0x8000 are the unsigned ones
+    const __m128i c = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi16(-0x8000));
+    __m128i lo = _mm_min_epi16(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(1,0,3,2))),
+            hi = _mm_max_epi16(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(1,0,3,2)));
+    lo = _mm_min_epi16(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2,3,0,1)));
+    hi = _mm_max_epi16(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2,3,0,1)));
+    lo = _mm_min_epi16(lo, _mm_shufflelo_epi16(lo, _MM_SHUFFLE(2,3,0,1)));
+    hi = _mm_max_epi16(hi, _mm_shufflelo_epi16(hi, _MM_SHUFFLE(2,3,0,1)));
+    const unsigned first = (_mm_cvtsi128_si32(lo) ^ 0x8000) & 0xFFFF, last = (_mm_cvtsi128_si32(hi) ^ 0x8000) & 0xFFFF;
+    if ( last < 0x80 )
+      return ascii_block;
+    const unsigned page = first >> page_bits, span = __::__wchar_mask_span[page];
+    if ( !span || span != __::__wchar_mask_span[last >> page_bits] )
+      return mixed_block;
+    return __::__wchar_mask_pages[__::__wchar_mask_index[page]][0];
+  }
+#endif
 
   ctype(const ctype&) __deleted;
   void operator=(const ctype&) __deleted;
@@ -1933,7 +2066,6 @@ private:
 
     // initialization
     const numpunct<char_type>& np = use_facet< numpunct<char_type> >(str.getloc());
-    const ctype<char_type>& ct = use_facet< ctype<char_type> >(str.getloc());
 
     const ios_base::fmtflags flags = str .flags();
     const ios_base::fmtflags basefield = (flags & ios_base::basefield);
@@ -1943,7 +2075,6 @@ private:
 
     const unsigned base = basefield == ios_base::oct ? 8 : basefield == ios_base::hex ? 16 : 10;
     unsigned rem = static_cast<unsigned>(max_val % base);
-    const ctype_base::mask base_mask = base == 16 ? ctype_base::xdigit : ctype_base::digit;
 
     // parse state
     bool minus = false, sign_extracted = false, prefix_extracted = false, overflow = false;
@@ -1987,17 +2118,8 @@ private:
       }
       prefix_extracted = true;
 
-      // check is it a valid digit
-      if(!ct.is(base_mask, c))
-        break;
-
-      // its a valid character, use it
-      unsigned digit;
-      if(ct.is(ctype_base::alpha, c))
-        //digit = ct.toupper(c) - 'A' + 10;
-        digit = (c & ~(1 << 5)) - 'A' + 10;
-      else
-        digit = c - '0';
+      // check is it a valid digit (the classic locale digits, no ctype lookup needed)
+      const unsigned digit = ntl::numeric::detail::digit_value(c);
       if(digit >= base)
         break;
 
@@ -2118,89 +2240,132 @@ class num_put : public locale::facet
     {
       return put_int(out, str, fill, v, false, true);
     }
-    _NTL_LOC_VIRTUAL iter_type do_put(iter_type out, ios_base&, char_type, double) const
+    _NTL_LOC_VIRTUAL iter_type do_put(iter_type out, ios_base& str, char_type fill, double v) const
     {
-      return out;
+      return put_float(out, str, fill, v);
     }
-    _NTL_LOC_VIRTUAL iter_type do_put(iter_type out, ios_base&, char_type, long double) const
+    _NTL_LOC_VIRTUAL iter_type do_put(iter_type out, ios_base& str, char_type fill, long double v) const
     {
-      return out;
+      return put_float(out, str, fill, static_cast<double>(v));
     }
     _NTL_LOC_VIRTUAL iter_type do_put(iter_type out, ios_base& str, char_type fill, const void* v) const
     {
-      return put_int(out,str,fill,reinterpret_cast<unsigned long long>(v), false, sizeof(void*) > sizeof(long), true);
+      return put_int(out,str,fill,reinterpret_cast<uintptr_t>(v), false, sizeof(void*) > sizeof(long), true);
     }
     ///\}
   private:
     static iter_type put_int(iter_type out, ios_base& str, char_type fill, unsigned long long v, bool signed_v, bool long_v = false, bool pointer_v = false)
     {
       const ios_base::fmtflags flags = str.flags();
-      const ios_base::fmtflags adjust = flags & ios_base::adjustfield;
       const ios_base::fmtflags basefield = flags & ios_base::basefield;
       const bool               uppercase = (flags & ios_base::uppercase) != 0;
-      //const ios_base::fmtflags floatfield = flags & ios_base::floatfield;
-      const bool               showpos = (flags & ios_base::showpos) != 0;
-      const bool               showbase = (flags & ios_base::showbase) != 0;
-
-      const streamsize width = str.width();
-
-      // [dec, oct, hex] = [0, 2, 4]
-      static const char bases[] = {'u', 'o', 'x'};
-
-      // %[flags] [width] [.precision] [{h | l | ll | I | I32 | I64}]type
-      char fmtbuf[16];
-      char* fmt = fmtbuf;
-      *fmt++ = '%';
-
-      if(showpos)
-        *fmt++ = '+';
-      if(showbase && !pointer_v) // pointer have a custom prefix always
-        *fmt++ = '#';
-      if(adjust == ios_base::internal){
-        *fmt++ = '0';
-        if(width)
-          *fmt++ = '*';
+      const int base = pointer_v || basefield == ios_base::hex ? 16 : basefield == ios_base::oct ? 8 : 10;
+
+      if(!long_v)
+        v = signed_v && base == 10 ? static_cast<unsigned long long>(static_cast<long>(v)) : static_cast<unsigned long>(v);
+
+      // sign or base prefix
+      char prefix[2];
+      size_t prefix_len = 0;
+      if(base == 10){
+        if(signed_v && static_cast<long long>(v) < 0)
+          prefix[prefix_len++] = '-', v = 0 - v;
+        else if(flags & ios_base::showpos)
+          prefix[prefix_len++] = '+';
+      }else if(pointer_v || (flags & ios_base::showbase)){
+        if(base == 16)
+          prefix[prefix_len++] = '0', prefix[prefix_len++] = uppercase && !pointer_v ? 'X' : 'x';
+        else if(v != 0)
+          prefix[prefix_len++] = '0';
       }
 
+      char buf[64];
+      char* const end = ntl::numeric::to_chars(buf, buf + _countof(buf), v, base).ptr;
+      size_t len = end - buf;
       if(pointer_v){
-        *fmt = 'p';
-      }else{
-        if(long_v)
-          *fmt++ = 'I', *fmt++ = '6', *fmt++ = '4';
-
-        *fmt = bases[basefield >> 6]; // (base >> 5) / 2
-
-        if(basefield == ios_base::dec && signed_v)
-          *fmt = 'd';
-        else if(basefield == ios_base::hex && uppercase)
-          *fmt = 'X';
+        // pointers are always printed with all digits in upper case, as %p does
+        const size_t digits = sizeof(void*) * 2;
+        const size_t zeros = digits - len;
+        for(size_t i = len; i; i--)
+          buf[zeros + i - 1] = buf[i - 1];
+        for(size_t i = 0; i != zeros; i++)
+          buf[i] = '0';
+        len = digits;
       }
-      *++fmt = 0;
-
-      char buf[32]; // may not enough if large width
-      streamsize l = adjust == ios_base::internal && width
-        ? _snprintf(buf, _countof(buf), fmtbuf, width, long_v ? v : static_cast<unsigned long>(v))
-      : _snprintf(buf, _countof(buf), fmtbuf, long_v ? v : static_cast<unsigned long>(v));
-
-      // adjust
-      if(width && width > l){
-        streamsize pad = width - l;
-        if(pointer_v)
-          pad -= 2;
-        if(adjust != ios_base::left && adjust != ios_base::internal) // before
-          out = __::fill_n(out, pad, fill);
-
-        if(pointer_v)
-          out = copy_n("0x",2,out);
-        out = copy_n(buf,l,out);
-
-        if(adjust == ios_base::left)
-          out = __::fill_n(out, pad, fill);
-      }else{
-        if(pointer_v)
-          out = copy_n("0x",2,out);
-        out = copy_n(buf,l,out);
+      if(base == 16 && (uppercase || pointer_v))
+        for(size_t i = 0; i != len; i++)
+          if(buf[i] >= 'a')
+            buf[i] -= 'a' - 'A';
+      return put_adjusted(out, str, fill, prefix, prefix_len, buf, len);
+    }
+
+    static iter_type put_float(iter_type out, ios_base& str, char_type fill, double v)
+    {
+      // %f, %e and %g rounded to precision(), showpoint is the alternative form
+      const ios_base::fmtflags flags = str.flags();
+      const ios_base::fmtflags floatfield = flags & ios_base::floatfield;
+      const ntl::numeric::chars_format::type fmt = floatfield == ios_base::fixed ? ntl::numeric::chars_format::fixed
+        : floatfield == ios_base::scientific ? ntl::numeric::chars_format::scientific : ntl::numeric::chars_format::general;
+      const streamsize precision = str.precision() < 0 ? 6 : str.precision();
+
+      // the integral digits of the fixed notation by the binary exponent (log10(2) < 0.30103), the sign, the point and the exponent
+      const int e2 = static_cast<int>((ntl::brute_cast<uint64_t>(v) >> 52) & 0x7FF) - 1023;
+      const size_t digits = fmt == ntl::numeric::chars_format::fixed && e2 > 0 ? e2 * 30103 / 100000 + 1 : 1;
+      const bool representable = precision <= numeric_limits<int>::__max - 400;
+      const size_t need = representable ? digits + static_cast<size_t>(precision) + 8 : 0;
+
+      struct heap_buffer
+      {
+        char* p;
+        explicit heap_buffer(size_t size) : p(size ? new (std::nothrow) char[size] : nullptr) {}
+        ~heap_buffer() { delete[] p; }
+      };
+      char stack[512];
+      const bool large = need > _countof(stack);
+      const heap_buffer heap(large ? need : 0);
+      char* const buf = large ? heap.p : stack;
+
+      ntl::numeric::to_chars_result re = { buf, ntl::numeric::conv_result::overflow };
+      if(buf && representable)
+        re = ntl::numeric::to_chars(buf, buf + (large ? need : _countof(stack)), v,
+          fmt, static_cast<int>(precision), (flags & ios_base::showpoint) != 0);
+      if(re.ec != ntl::numeric::conv_result::ok){
+        // the precision is too large to allocate the buffer
+        str.state = static_cast<ios_base::iostate>(str.state | ios_base::failbit);
+        str.width(0);
+        return out;
       }
+      const char* const end = re.ptr;
+      char* p = buf;
+      char prefix[1];
+      size_t prefix_len = 0;
+      if(*p == '-')
+        prefix[prefix_len++] = '-', ++p;
+      else if(flags & ios_base::showpos)
+        prefix[prefix_len++] = '+';
+      const size_t len = end - p;
+      if(flags & ios_base::uppercase)
+        for(char* c = p; c != end; c++)
+          if(*c >= 'a')
+            *c -= 'a' - 'A';
+      return put_adjusted(out, str, fill, prefix, prefix_len, p, len);
+    }
+
+    static iter_type put_adjusted(iter_type out, ios_base& str, char_type fill, const char* prefix, size_t prefix_len, const char* s, size_t len)
+    {
+      const ios_base::fmtflags adjust = str.flags() & ios_base::adjustfield;
+      const streamsize width = str.width();
+      const streamsize l = static_cast<streamsize>(prefix_len + len);
+      const streamsize pad = width > l ? width - l : 0;
+
+      if(pad && adjust != ios_base::left && adjust != ios_base::internal)
+        out = __::fill_n(out, pad, fill);
+      out = copy_n(prefix, prefix_len, out);
+      if(pad && adjust == ios_base::internal)
+        out = __::fill_n(out, pad, fill);
+      out = copy_n(s, len, out);
+      if(pad && adjust == ios_base::left)
+        out = __::fill_n(out, pad, fill);
       str.width(0);
       return out;
     }
@@ -2311,8 +2476,6 @@ inline basic_string<char> locale::name() const { return "C"; }
 
 namespace __
 {
-  extern "C" bool __wchar_masks_data(const unsigned char*& masks, unsigned& size);
-
   struct facets
   {
     // has_facet
@@ -2350,33 +2513,6 @@ namespace __
     {
       return *static_storage<DefaultFacet>::get_object();
     }
-#if 1
-    static __forceinline const ctype<wchar_t>& get_facet(const locale&, type2type<ctype<wchar_t> >/*, enable_if<has_facet<ctype<wchar_t>>::value>::type* =0*/)
-    {
-      //static void * f[sizeof(ctype<wchar_t>)/sizeof(void*)];
-      //ctype<wchar_t> * const p = reinterpret_cast<ctype<wchar_t>*>(f);
-      static ctype_base::mask* table = 0;
-      if(!table){
-        // get table
-        const unsigned char* wchar_masks;
-        unsigned wchar_masks_size;
-        if(__wchar_masks_data(wchar_masks, wchar_masks_size)){
-          table = new ctype_base::mask[ctype<wchar_t>::table_size];
-          using namespace ntl::nt;
-
-          uint32_t dsize;
-          ntstatus st = RtlDecompressBuffer(compression::default_format, table, ctype<wchar_t>::table_size, wchar_masks, wchar_masks_size, &dsize);
-          if(!success(st)){
-            delete[] table;
-            table = nullptr;
-          }
-        }
-      }
-      //if ( !f[0] ) new (p) ctype<wchar_t>(table);
-      //return *p;
-      return *static_storage<ctype<wchar_t> >::get_object(table);
-    }
-#endif
   };
 }
 
@@ -459,9 +459,11 @@ template<class T1, class T2> struct pair;
 template <class T>
 __forceinline
 pair<T*,ptrdiff_t>
-  get_temporary_buffer(ptrdiff_t n)
+  get_temporary_buffer(ptrdiff_t n) __ntl_nothrow
 {
-  T* p = allocator<T>().allocate(static_cast<typename allocator<T>::size_type>(n));
+  // no storage rather than bad_alloc, the callers have a fallback
+  T* p = n > 0 && static_cast<size_t>(n) <= allocator<T>().max_size()
+    ? static_cast<T*>(::operator new(sizeof(T) * n, nothrow)) : 0;
   return make_pair(p, p ? n : 0);
 }
 
@@ -470,11 +472,7 @@ __forceinline
 void
   return_temporary_buffer(T* p)
 {
-  // 20.8.1.1/7  n shall equal the value passed as the first argument
-  //             to the invocation of allocate which returned p.
-  // but allocator::deallocate() does not use n
-  typename allocator<T>::size_type const n = 0;
-  allocator<T>().deallocate(p, n);
+  ::operator delete(p);
 }
 
 ///\name  20.8.10 Specialized algorithms [specialized.algorithms]
@@ -14,6 +14,9 @@
 
 #ifndef NTL__SUBSYSTEM_KM
 # include "../nt/mutex.hxx"
+#else
+# include "../km/event.hxx"
+# include "../km/handle.hxx"
 #endif
 
 #include "../atomic.hxx"
@@ -434,12 +437,24 @@ namespace std
    *	@brief Call once [30.3.5 thread.once]
    *
    *  The class once_flag is an opaque data structure that call_once uses to initialize data without causing a data race or deadlock.
+   *
+   *  The initialized flag is checked by a single load. The threads which come while the initialization runs are parked:
+   *  on the RtlRunOnce in the user mode (Vista and later), on an event in the kernel mode.
+   *  If the initialization throws, one of the waiters takes it over.
+   *  @note In the kernel mode the flag holds a dispatcher object, so it must be in the nonpaged memory:
+   *  a static object of the driver image or a nonpaged pool allocation, i.e. <tt>new (nonpaged)</tt> rather than the plain \c new
+   *  which allocates from the paged pool. The debug build asserts it.
    **/
   struct once_flag
   {
     /** Constructs an object of type once_flag */
     constexpr once_flag()
-      :inited_(false), locked_(unlocked)
+      :inited_(false),
+#ifndef NTL__SUBSYSTEM_KM
+      once_()
+#else
+      locked_(unlocked), event_ready_(false)
+#endif
     {}
 
     /** Internal lock \internal */
@@ -447,48 +462,88 @@ namespace std
       private noncopyable
     {
       inline lock(once_flag& flag)
-        :flag_(flag)
-      {
-        flag_.enter();
-      }
+        :flag_(flag), owner_(flag.enter())
+      {}
       inline 
       ~lock()
       {
-        flag_.exit();
+        if(owner_)
+          flag_.exit();
       }
     private:
       once_flag& flag_;
+      const bool owner_;
     };
 
+    /** The volatile load has the acquire semantics */
     inline uint32_t ready() const volatile { return inited_; }
     inline void set_ready()
     {
-      inited_ = true;
+      ntl::atomic::exchange(inited_, 1u);
     }
 
   protected:
+#ifndef NTL__SUBSYSTEM_KM
+    /**
+     *	@brief Takes or waits for the object's ownership.
+     *  @return true if the caller should initialize, false if the object is initialized by the other %thread.
+     **/
+    bool enter()
+    {
+      return ntl::nt::RtlRunOnceBeginInitialize(&once_, 0, nullptr) == ntl::nt::status::pending;
+    }
+    /** Releases object's ownership and wakes the waiters */
+    inline void exit()
+    {
+      ntl::nt::RtlRunOnceComplete(&once_, inited_ ? 0 : ntl::nt::rtl::RunOnceInitFailed, nullptr);
+    }
+#else
     enum state_t { unlocked, locked };
     /**
      *	@brief Takes or waits for the object's ownership.
      *
-     *  The wait implemented through a simple cycle with the short %thread sleep. 
-     *  Such wait takes about 60 times more CPU time than kernel synchronization object,
-     *  but it's still invisible to the common system performance and it is faster and lightweight.
+     *  The event is initialized by the first owner and reset by the next ones after a failed initialization,
+     *  so it is signaled only while nobody owns the flag. Above the APC level the waiters spin.
+     *  @return true if the caller should initialize, false if the object is initialized by the other %thread.
      **/
-    void enter()
+    bool enter()
     {
-      for(ntl::atomic::backoff b; ntl::atomic::compare_exchange(locked_, locked, unlocked) == locked;)
-        b.pause();
+      for(ntl::atomic::backoff b; !ready(); ){
+        if(ntl::atomic::compare_exchange(locked_, locked, unlocked) == unlocked){
+          if(event_ready_){
+            ntl::km::KeResetEvent(&event_);
+          }else{
+            assert(ntl::km::MmIsNonPagedSystemAddressValid(&event_) && "once_flag must be in the nonpaged memory");
+            ntl::km::KeInitializeEvent(&event_, ntl::km::NotificationEvent, false);
+            ntl::atomic::exchange(event_ready_, 1u);
+          }
+          return true;
+        }
+        if(event_ready_ && ntl::km::KeGetCurrentIrql() <= ntl::km::kirql::apc_level)
+          ntl::km::KeWaitForSingleObject(&event_, ntl::km::kwait_reason::Executive, ntl::km::KernelMode, false, nullptr);
+        else
+          b.pause();
+      }
+      return false;
     }
-    /** Releases object's ownership */
+    /** Releases object's ownership and wakes the waiters */
     inline void exit()
     {
+      // signaled before the unlock, so the next owner resets it after
+      ntl::km::KeSetEvent(&event_, 0, false);
       ntl::atomic::exchange(locked_, unlocked);
     }
+#endif
   private:
     // native platform types (faster)
-    volatile uint32_t locked_;
     volatile uint32_t inited_;
+#ifndef NTL__SUBSYSTEM_KM
+    ntl::nt::rtl::run_once once_;
+#else
+    volatile uint32_t locked_;
+    volatile uint32_t event_ready_;
+    ntl::km::kevent   event_;
+#endif
 
     once_flag(const once_flag&) __deleted;
     once_flag& operator=(const once_flag&) __deleted;
@@ -198,6 +198,8 @@ class basic_ostream
         typedef num_put<charT, iterator> facet_t;
         if(use_facet<facet_t>(this->getloc()).put(iterator(*this), *this, this->fill(), value).failed())
           state = ios_base::badbit;
+        // the facet sets failbit for the value it could not format
+        state = static_cast<ios_base::iostate>(state | (this->rdstate() & ios_base::failbit));
       }
       __ntl_catch(...)
       {
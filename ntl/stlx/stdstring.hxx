@@ -1924,14 +1924,8 @@ wstring to_wstring(long double val);
 
 namespace __
 {
-  template<typename T>
-  inline T stoi(const char* str, size_t length, size_t* idx, int base)
+  inline void stoi_check(ntl::numeric::convresult re)
   {
-    size_t l;
-    typedef typename conditional<(sizeof(T) > sizeof(long)), unsigned long long, unsigned long>::type storage_type;
-    storage_type value;
-    ntl::numeric::convresult re = ntl::numeric::str2num<storage_type, typename make_signed<storage_type>::type>(value, str, length, base, numeric_limits<T>::__max, numeric_limits<T>::__min, &l);
-    if(idx) *idx = l;
     if(re <= ntl::numeric::conv_result::bad_format){
   #if STLX__USE_EXCEPTIONS
       __throw_invalid_argument("stoi: no conversion could be performed");
@@ -1945,6 +1939,36 @@ namespace __
       _assert_msg("stoi: converted value is outside the range of representable values");
   #endif
     }
+  }
+
+  template<typename T>
+  inline T stoi(const char* str, size_t length, size_t* idx, int base)
+  {
+    if(base == 10){
+      // decimal fast path: strtol-like prefix is handled here, digits are parsed by from_chars
+      using ntl::numeric::detail::mini_ctype;
+      const char* p = str, * const end = str + length;
+      while(p != end && mini_ctype::is(mini_ctype::space, *p))
+        ++p;
+      const char* const sign = p;
+      if(p != end && *p == '+')
+        ++p;
+      // negative unsigned values are wrapped as strtoul does, leave them for str2num
+      if(p == end || *p != '-' || (p == sign && is_signed<T>::value)){
+        T value = 0;
+        const ntl::numeric::from_chars_result re = ntl::numeric::from_chars(p, end, value, 10);
+        if(idx) *idx = re.ptr - str;
+        stoi_check(re.ec);
+        return value;
+      }
+    }
+
+    size_t l;
+    typedef typename conditional<(sizeof(T) > sizeof(long)), unsigned long long, unsigned long>::type storage_type;
+    storage_type value;
+    ntl::numeric::convresult re = ntl::numeric::str2num<storage_type, typename make_signed<storage_type>::type>(value, str, length, base, numeric_limits<T>::__max, numeric_limits<T>::__min, &l);
+    if(idx) *idx = l;
+    stoi_check(re);
     return static_cast<T>(value);
   }
 }
@@ -2028,38 +2052,26 @@ inline unsigned long long stoull(const wstring& str, size_t *idx, int base)
 //////////////////////////////////////////////////////////////////////////
 inline string to_string(long long val)
 {
-  string s(ntl::numeric::max_number_size, '\0');
-  size_t len;
-  ntl::numeric::itoa(val, s.begin(), s.size(), 10, &len);
-  s.resize(len);
-  return s;
+  char buf[ntl::numeric::max_number_size];
+  return string(buf, ntl::numeric::to_chars(buf, buf + _countof(buf), val).ptr);
 }
 
 inline string to_string(unsigned long long val)
 {
-  string s(ntl::numeric::max_number_size, '\0');
-  size_t len;
-  ntl::numeric::itoa(val, s.begin(), s.size(), 10, &len);
-  s.resize(len);
-  return s;
+  char buf[ntl::numeric::max_number_size];
+  return string(buf, ntl::numeric::to_chars(buf, buf + _countof(buf), val).ptr);
 }
 
 inline wstring to_wstring(long long val)
 {
-  wstring s(ntl::numeric::max_number_size, '\0');
-  size_t len;
-  ntl::numeric::itow(val, s.begin(), s.size(), 10, &len);
-  s.resize(len);
-  return s;
+  char buf[ntl::numeric::max_number_size];
+  return wstring(buf, ntl::numeric::to_chars(buf, buf + _countof(buf), val).ptr);
 }
 
 inline wstring to_wstring(unsigned long long val)
 {
-  wstring s(ntl::numeric::max_number_size, '\0');
-  size_t len;
-  ntl::numeric::itow(val, s.begin(), s.size(), 10, &len);
-  s.resize(len);
-  return s;
+  char buf[ntl::numeric::max_number_size];
+  return wstring(buf, ntl::numeric::to_chars(buf, buf + _countof(buf), val).ptr);
 }
 
 // eliminate to_string(-1) ambiguity
@@ -50,6 +50,15 @@ namespace std
 
     };
 
+    typedef void thread_exit_routine();
+
+    /** Called by the threads started by std::thread before their exit, e.g. to release the thread specific storage */
+    inline thread_exit_routine*& thread_exit_hook()
+    {
+      static thread_exit_routine* hook;
+      return hook;
+    }
+
     struct thread_params_base
     {
       volatile uint32_t cleanup, start;
@@ -373,6 +382,8 @@ namespace std
     //  NTL__SUBSYSTEM_NS::close(tp->handle);
     //}
     delete tp;
+    if(__::thread_exit_routine* const hook = __::thread_exit_hook())
+      hook();
   #ifdef NTL__SUBSYSTEM_KM
     ntl::km::system_thread::exit(ntl::nt::status::success);
   #endif
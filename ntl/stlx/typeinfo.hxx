@@ -48,7 +48,8 @@ class type_info
      **/
     bool operator==(const type_info& rhs) const
     {
-      return std::strcmp(mname()+1, rhs.mname()+1) == 0;
+      // the names are compared for the types of the different modules only
+      return this == &rhs || std::strcmp(mname()+1, rhs.mname()+1) == 0;
     }
 
     /**
@@ -57,7 +58,7 @@ class type_info
      **/
     bool operator!=(const type_info& rhs) const
     {
-      return std::strcmp(mname()+1, rhs.mname()+1) != 0;
+      return !(*this == rhs);
     }
 
     /**
@@ -444,7 +444,9 @@ class vector
                          InputIterator last, const random_access_iterator_tag &)
     {
       size_t const n = static_cast<size_type>(last - first);
-      bool const insert_from_self = begin() <= &*first && &*first < end();
+      // the range may be of another value type, which is converted
+      const void* const from = &*first;
+      bool const insert_from_self = static_cast<const void*>(begin()) <= from && from < static_cast<const void*>(end());
       iterator i = insert__blank_space(position, n);
       const difference_type disp = insert_from_self ? i - position - n : 0;
       position = i;
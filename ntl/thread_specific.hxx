@@ -0,0 +1,426 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Thread specific storage
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__THREAD_SPECIFIC
+#define NTL__THREAD_SPECIFIC
+#pragma once
+
+#include "atomic.hxx"
+#include "stlx/cassert.hxx"
+#include "stlx/new.hxx"
+#include "stlx/thread.hxx"
+
+#ifndef NTL__SUBSYSTEM_KM
+# include "nt/teb.hxx"
+# include "nt/peb.hxx"
+# include "nt/thread.hxx"
+#else
+# include "km/thread.hxx"
+# include "km/process.hxx"
+# include "stlx/cstdlib.hxx"
+#endif
+
+namespace ntl {
+
+namespace __ {
+
+  /**
+   *	Keys and the per-thread tables of values behind thread_specific.
+   *
+   *  Each thread has a table of the values indexed by the key, the table is found through one TLS slot of the TEB
+   *  in the user mode and through the lock-free table of the threads in the kernel mode.
+   *  The key has a generation, so a value left by a deleted key is never returned for the next key with the same index.
+   **/
+  class thread_storage
+  {
+    ///////////////////////////////////////////////////////////////////////////
+    public:
+
+      typedef void destructor(void* value);
+
+      static const uint32_t max_keys = 1024;
+
+      struct key_type
+      {
+        uint32_t index;
+        uint32_t generation;
+      };
+
+      /** Allocates a key, the index is \c max_keys if all keys are in use */
+      static key_type create_key(destructor* dtor)
+      {
+        initialize();
+        key_type key = { max_keys, 0 };
+        key_slot* const keys = state().keys;
+        for(uint32_t i = 0; i < max_keys; i++){
+          if(ntl::atomic::compare_exchange(keys[i].used, 1u, 0u) == 0){
+            keys[i].dtor = dtor;
+            key.index = i;
+            key.generation = ntl::atomic::increment(keys[i].generation);
+            break;
+          }
+        }
+        assert(key.index < max_keys && "too many thread_specific objects");
+        return key;
+      }
+
+      /** Frees the key. The values of the other threads are left as is, they can't be reached anymore */
+      static void delete_key(key_type key)
+      {
+        if(key.index >= max_keys)
+          return;
+        key_slot& slot = state().keys[key.index];
+        ntl::atomic::increment(slot.generation);
+        slot.dtor = 0;
+        ntl::atomic::exchange(slot.used, 0u);
+      }
+
+      /** The value of the calling thread */
+      static void* get(key_type key)
+      {
+        const thread_values* const t = current();
+        if(t && key.index < t->capacity){
+          const entry& e = t->entries[key.index];
+          if(e.generation == key.generation)
+            return e.value;
+        }
+        return 0;
+      }
+
+      /** Sets the value of the calling thread, it fails only if the table can't be allocated */
+      static bool set(key_type key, void* value)
+      {
+        if(key.index >= max_keys)
+          return false;
+        thread_values* t = current();
+        if(!t || key.index >= t->capacity){
+          uint32_t capacity = t ? t->capacity : 0;
+          while(capacity <= key.index)
+            capacity = capacity ? capacity * 2 : 16;
+          thread_values* const grown = static_cast<thread_values*>(
+            ::operator new(sizeof(thread_values) + (capacity - 1) * sizeof(entry), std::nothrow));
+          if(!grown)
+            return false;
+          grown->capacity = capacity;
+          for(uint32_t i = 0; i < capacity; i++)
+            grown->entries[i] = t && i < t->capacity ? t->entries[i] : entry();
+          if(!set_current(grown)){
+            ::operator delete(grown);
+            return false;
+          }
+          ::operator delete(t);
+          t = grown;
+        }
+        t->entries[key.index].value = value;
+        t->entries[key.index].generation = key.generation;
+        return true;
+      }
+
+      /**
+       *	Destroys the values of the calling thread, called at the exit of the threads started by std::thread.
+       *  A destructor may use the other thread_specific objects, their new values are destroyed too.
+       **/
+      static void release_thread()
+      {
+        for(int pass = 0; pass < 4; pass++){
+          thread_values* const t = current();
+          if(!t)
+            return;
+          set_current(0);
+          const key_slot* const keys = state().keys;
+          for(uint32_t i = t->capacity; i-- > 0; ){
+            const entry& e = t->entries[i];
+            if(e.value && keys[i].generation == e.generation && keys[i].dtor)
+              keys[i].dtor(e.value);
+          }
+          ::operator delete(t);
+        }
+      }
+
+    ///////////////////////////////////////////////////////////////////////////
+    private:
+
+      struct entry
+      {
+        void*    value;
+        uint32_t generation;
+        entry(): value(), generation() {}
+      };
+
+      struct thread_values
+      {
+        uint32_t  capacity;
+        entry     entries[1];
+      };
+
+      struct key_slot
+      {
+        destructor* volatile dtor;
+        volatile uint32_t    generation;
+        volatile uint32_t    used;
+      };
+
+#ifdef NTL__SUBSYSTEM_KM
+      static const uint32_t max_threads = 4096;
+
+      struct thread_slot
+      {
+        volatile uintptr_t  thread;
+        thread_values*      values;
+      };
+#endif
+
+      // zero initialized before any static constructor runs
+      struct state_type
+      {
+        volatile uint32_t initialized;
+        key_slot        keys[max_keys];
+#ifndef NTL__SUBSYSTEM_KM
+        uint32_t        tls_index;
+#else
+        thread_slot     threads[max_threads];
+        // the threads holding a slot and the longest probe of them
+        volatile uint32_t live;
+        volatile uint32_t max_probe;
+#endif
+      };
+
+      static state_type& state()
+      {
+        static state_type s;
+        return s;
+      }
+
+      enum { uninitialized, initializing, ready };
+
+      static void initialize()
+      {
+        volatile uint32_t& initialized = state().initialized;
+        if(initialized == ready)
+          return;
+        if(ntl::atomic::compare_exchange(initialized, uint32_t(initializing), uint32_t(uninitialized)) != uninitialized){
+          // the keys are created by the static constructors mostly, so the wait is rare
+          for(ntl::atomic::backoff b; initialized != ready; )
+            b.pause();
+          return;
+        }
+#ifndef NTL__SUBSYSTEM_KM
+        // the same bitmap as TlsAlloc() uses
+        using namespace ntl::nt;
+        uint32_t index = teb::tls_minimum_available;
+        RtlAcquirePebLock();
+        uint32_t* const bits = static_cast<peb52&>(peb::instance()).TlsBitmapBits;
+        for(uint32_t i = 0; i < teb::tls_minimum_available; i++)
+          if(!(bits[i / 32] & (1u << i % 32))){
+            bits[i / 32] |= 1u << i % 32;
+            index = i;
+            break;
+          }
+        RtlReleasePebLock();
+        assert(index < teb::tls_minimum_available && "no free TLS slot");
+        state().tls_index = index;
+#else
+        // the threads not started by std::thread release their values at the exit too, the routine is removed at the unload
+        if(nt::success(km::PsSetCreateThreadNotifyRoutine(thread_notify)))
+          std::atexit(remove_thread_notify);
+#endif
+        std::__::thread_exit_hook() = release_thread;
+        ntl::atomic::exchange(initialized, uint32_t(ready));
+      }
+
+#ifndef NTL__SUBSYSTEM_KM
+      static thread_values* current()
+      {
+        const uint32_t index = state().tls_index;
+        return index < nt::teb::tls_minimum_available ? static_cast<thread_values*>(nt::teb::tls_slot(index)) : 0;
+      }
+
+      static bool set_current(thread_values* t)
+      {
+        const uint32_t index = state().tls_index;
+        if(index >= nt::teb::tls_minimum_available)
+          return false;
+        nt::teb::set_tls_slot(index, t);
+        return true;
+      }
+#else
+      // open addressing by the thread object, the slots of the exited threads are marked as deleted and reused;
+      // only the owner thread reads or writes the values of its slot
+      static const uintptr_t deleted = 1;
+
+      // called in the context of the exiting thread
+      static void __stdcall thread_notify(nt::legacy_handle, nt::legacy_handle, bool create)
+      {
+        if(!create && state().live)
+          release_thread();
+      }
+
+      static void __cdecl remove_thread_notify()
+      {
+        km::PsRemoveCreateThreadNotifyRoutine(thread_notify);
+      }
+
+      static uint32_t hash(uintptr_t thread)
+      {
+        const uint64_t h = thread >> 4;
+        return (static_cast<uint32_t>(h ^ (h >> 32)) * 0x9E3779B1u) % max_threads;
+      }
+
+      static uintptr_t current_thread()
+      {
+        return reinterpret_cast<uintptr_t>(km::KeGetCurrentThread());
+      }
+
+      static thread_slot* find_slot(uintptr_t thread)
+      {
+        thread_slot* const threads = state().threads;
+        // no slot is farther than the longest probe of the insertions
+        const uint32_t probes = state().max_probe + 1;
+        for(uint32_t i = hash(thread), n = 0; n < probes && n < max_threads; i = (i + 1) % max_threads, n++){
+          const uintptr_t owner = threads[i].thread;
+          if(owner == thread)
+            return &threads[i];
+          if(!owner)
+            break;
+        }
+        return 0;
+      }
+
+      static thread_values* current()
+      {
+        const thread_slot* const slot = find_slot(current_thread());
+        return slot ? slot->values : 0;
+      }
+
+      static bool set_current(thread_values* t)
+      {
+        const uintptr_t thread = current_thread();
+        thread_slot* slot = find_slot(thread);
+        if(slot){
+          slot->values = t;
+          if(!t){
+            ntl::atomic::exchange(slot->thread, deleted);
+            ntl::atomic::decrement(state().live);
+          }
+          return true;
+        }
+        if(!t)
+          return true;
+        thread_slot* const threads = state().threads;
+        for(uint32_t i = hash(thread), n = 0; n < max_threads; i = (i + 1) % max_threads, n++){
+          const uintptr_t owner = threads[i].thread;
+          if((!owner || owner == deleted) && ntl::atomic::compare_exchange(threads[i].thread, thread, owner) == owner){
+            threads[i].values = t;
+            ntl::atomic::increment(state().live);
+            for(uint32_t top = state().max_probe; n > top; top = state().max_probe)
+              if(ntl::atomic::compare_exchange(state().max_probe, n, top) == top)
+                break;
+            return true;
+          }
+        }
+        return false;
+      }
+#endif
+  };
+
+} // __
+
+
+/**
+ *	Object of which each thread has its own instance, e.g. a cache of an allocator, a formatter buffer or a random generator.
+ *
+ *  The instance is default constructed by the first access of the thread and destroyed at the exit of the thread,
+ *  so the access needs no lock: it takes the thread table from the TEB slot and the value by the key index.
+ *  The thread_specific objects share one TLS slot of the process, allocated in the TEB without TlsAlloc().
+ *  In the kernel mode the thread tables are found by the current thread in a lock-free table of 4096 threads,
+ *  they are released by a thread notify routine at the exit of any thread, so a new thread never sees the instances of a dead one.
+ *  get() returns null while 4096 other threads hold the instances.
+ *  \code
+ *    ntl::thread_specific<random_engine> rng;
+ *
+ *    uint32_t roll() { return (*rng)() % 6 + 1; }
+ *  \endcode
+ *  @note The instances are destroyed automatically at the exit of the threads started by std::thread.
+ *  In the user mode the other threads call release_thread_specific() before their exit, otherwise the instances are leaked.
+ *  The destruction of thread_specific destroys the instance of the calling thread only, the other instances are leaked.
+ **/
+template<class T>
+class thread_specific
+{
+    thread_specific(const thread_specific&);
+    const thread_specific& operator=(const thread_specific&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef T value_type;
+
+    thread_specific()
+      :key(__::thread_storage::create_key(destroy))
+    {}
+
+    ~thread_specific()
+    {
+      reset();
+      __::thread_storage::delete_key(key);
+    }
+
+    /** The instance of the calling thread, constructs it at the first call. Returns null if the storage can't be allocated */
+    T* get()
+    {
+      if(void* const p = __::thread_storage::get(key))
+        return static_cast<T*>(p);
+      return create();
+    }
+
+    /** The instance of the calling thread if it exists */
+    T* get_if_exists() const
+    {
+      return static_cast<T*>(__::thread_storage::get(key));
+    }
+
+    /** Destroys the instance of the calling thread, the next access constructs it again */
+    void reset()
+    {
+      if(T* const p = get_if_exists()){
+        __::thread_storage::set(key, 0);
+        destroy(p);
+      }
+    }
+
+    T& operator*()  { T* const p = get(); assert(p); return *p; }
+    T* operator->() { T* const p = get(); assert(p); return p; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    T* create()
+    {
+      T* const p = new (std::nothrow) T();
+      if(p && !__::thread_storage::set(key, p)){
+        delete p;
+        return 0;
+      }
+      return p;
+    }
+
+    static void destroy(void* value)
+    {
+      delete static_cast<T*>(value);
+    }
+
+    const __::thread_storage::key_type key;
+};
+
+/** Destroys the thread_specific instances of the calling thread, for the threads not started by std::thread */
+inline void release_thread_specific()
+{
+  __::thread_storage::release_thread();
+}
+
+} // namespace ntl
+
+#endif // NTL__THREAD_SPECIFIC
@@ -0,0 +1,395 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  Hierarchical timer wheel
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__TIMER_WHEEL
+#define NTL__TIMER_WHEEL
+#pragma once
+
+#include "atomic.hxx"
+#include "stlx/cassert.hxx"
+
+namespace ntl {
+
+template<class Lock> class basic_timer_wheel;
+
+/**
+ *	Timeout of the basic_timer_wheel, embedded into the object which needs it, e.g. a connection or a request.
+ *  The wheel doesn't allocate, so the entry should live until it expires or is cancelled.
+ **/
+class timer_wheel_entry
+{
+    timer_wheel_entry(const timer_wheel_entry&);
+    const timer_wheel_entry& operator=(const timer_wheel_entry&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef void expire_routine(timer_wheel_entry & entry, void * context);
+
+    timer_wheel_entry()
+    : prev(0), next(0), pending_next(0), deadline_(0), routine(0), context(0), slot(0), state(idle)
+    {/**/}
+
+    /** The tick the entry expires at */
+    uint64_t deadline() const { return deadline_; }
+
+    /** Is the entry scheduled and not expired or cancelled yet */
+    bool active() const { return state == pending || state == armed; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    template<class> friend class basic_timer_wheel;
+
+    enum state_type
+    {
+      idle,
+      pending,    // in the inbox of the wheel
+      armed,      // in a slot of the wheel
+      cancelled,  // cancelled in the inbox
+      firing      // expired, the routine is about to run
+    };
+
+    timer_wheel_entry * prev, * next;
+    timer_wheel_entry * pending_next;
+    uint64_t            deadline_;
+    expire_routine *    routine;
+    void *              context;
+    uint32_t            slot;
+    volatile uint32_t   state;
+};
+
+
+/**
+ *	Hierarchical timer wheel: many timeouts driven by a single periodic tick.
+ *
+ *  The time is measured in the ticks of the caller, advance() is called on each tick (or less often) by one thread at a time,
+ *  e.g. by the DPC of a periodic kernel timer. The entries are kept in 6 levels of 64 slots each,
+ *  the level N slot covers 64^N ticks and is redistributed to the lower levels when the time reaches it,
+ *  so scheduling, cancelling and expiring an entry take O(1) and the ticks without events are skipped by the bitmap of each level.
+ *  The deadlines beyond the current 2^36 ticks epoch are kept in an overflow list which is redistributed when the epoch rolls over.
+ *
+ *  schedule() is lock-free: the entries are pushed into an inbox which the next advance() moves into the wheel.
+ *  cancel() takes the \a Lock, which also guards advance(), for the short O(1) unlink. If the entry is still in the inbox,
+ *  cancel() moves the whole inbox into the wheel first; each entry is moved once either way, so it is O(1) amortized.
+ *  The expired entries are collected under the lock and their routines run in a batch after it is released,
+ *  so a routine may schedule its entry again.
+ **/
+template<class Lock>
+class basic_timer_wheel
+{
+    basic_timer_wheel(const basic_timer_wheel&);
+    const basic_timer_wheel& operator=(const basic_timer_wheel&);
+
+  ///////////////////////////////////////////////////////////////////////////
+  public:
+
+    typedef timer_wheel_entry entry_type;
+    typedef timer_wheel_entry::expire_routine expire_routine;
+
+    static const unsigned slot_bits = 6;
+    static const unsigned slots = 1 << slot_bits;
+    static const unsigned levels = 6;
+
+    /** Starts the wheel at the tick \a now */
+    explicit basic_timer_wheel(uint64_t now = 0)
+    : inbox(0), now_(now), armed_(0)
+    {
+      overflow.prev = overflow.next = &overflow;
+      due.prev = due.next = &due;
+      for ( unsigned l = 0; l < levels; l++ )
+      {
+        occupied[l] = 0;
+        for ( unsigned s = 0; s < slots; s++ )
+          heads[l][s].prev = heads[l][s].next = &heads[l][s];
+      }
+    }
+
+    /**
+     *	Schedules the \a entry to expire at the tick \a deadline, the past deadline expires at the next advance().
+     *  Returns false if the entry is active or its routine is running.
+     **/
+    bool schedule(entry_type & entry, uint64_t deadline, expire_routine * routine, void * context = 0)
+    {
+      for ( ; ; )
+      {
+        const uint32_t state = entry.state;
+        if ( state != entry_type::idle && state != entry_type::cancelled )
+          return false;
+        entry.deadline_ = deadline;
+        entry.routine = routine;
+        entry.context = context;
+        if ( atomic::compare_exchange(entry.state, uint32_t(entry_type::pending), state) != state )
+          continue;
+        // the cancelled entry is still in the inbox
+        if ( state == entry_type::idle )
+          push(entry);
+        return true;
+      }
+    }
+
+    /**
+     *	Cancels the \a entry, which may be freed then unless schedule() of it runs concurrently.
+     *  Returns false if the entry isn't active, i.e. it was not scheduled or its routine is about to run or running.
+     **/
+    bool cancel(entry_type & entry)
+    {
+      lock.lock();
+      bool re = false;
+      for ( ; ; )
+      {
+        const uint32_t state = entry.state;
+        if ( state == entry_type::armed )
+        {
+          unlink(entry);
+          entry.state = entry_type::idle;
+          re = true;
+        }
+        else if ( state == entry_type::pending )
+        {
+          // the entry in the inbox becomes armed
+          drain();
+          if ( entry.state != entry_type::pending )
+            continue;
+          // the concurrent schedule() has not pushed it yet, the next advance() drops it
+          if ( atomic::compare_exchange(entry.state, uint32_t(entry_type::cancelled), state) != state )
+            continue;
+          re = true;
+        }
+        break;
+      }
+      lock.unlock();
+      return re;
+    }
+
+    /**
+     *	Moves the time to the tick \a now and runs the routines of the expired entries.
+     *  Returns the number of the expired entries.
+     **/
+    size_t advance(uint64_t now)
+    {
+      entry_type batch;
+      batch.prev = batch.next = &batch;
+
+      lock.lock();
+      drain();
+      if ( due.next != &due )
+        expire(due, batch);
+      while ( now_ < now )
+      {
+        const uint64_t t = now_ + 1;
+        const unsigned s = static_cast<unsigned>(t & (slots - 1));
+        if ( s == 0 )
+          cascade(t);
+        if ( occupied[0] & (uint64_t(1) << s) )
+          expire(heads[0][s], batch);
+        now_ = t;
+
+        // the ticks without events are skipped
+        const uint64_t next = next_event(t);
+        if ( next - 1 > now_ )
+          now_ = next - 1 < now ? next - 1 : now;
+      }
+      lock.unlock();
+
+      size_t count = 0;
+      for ( entry_type * e = batch.next; e != &batch; count++ )
+      {
+        entry_type * const next = e->next;
+        expire_routine * const routine = e->routine;
+        void * const context = e->context;
+        e->state = entry_type::idle;
+        routine(*e, context);
+        e = next;
+      }
+      return count;
+    }
+
+    /** The last tick passed to advance() */
+    uint64_t current() const { return now_; }
+
+    /** The number of the entries in the wheel, not counting the ones scheduled since the last advance() */
+    size_t size() const { return armed_; }
+
+  ///////////////////////////////////////////////////////////////////////////
+  private:
+
+    void push(entry_type & entry)
+    {
+      for ( ; ; )
+      {
+        const uintptr_t head = inbox;
+        entry.pending_next = reinterpret_cast<entry_type*>(head);
+        if ( atomic::compare_exchange(inbox, reinterpret_cast<uintptr_t>(&entry), head) == head )
+          break;
+      }
+    }
+
+    // moves the inbox into the wheel, the past deadlines are kept in the due list until the next advance()
+    void drain()
+    {
+      entry_type * e = reinterpret_cast<entry_type*>(atomic::exchange(inbox, uintptr_t(0)));
+      while ( e )
+      {
+        entry_type * const next = e->pending_next;
+        const uint32_t state = e->state;
+        if ( state == entry_type::cancelled )
+        {
+          // schedule() may take it back
+          if ( atomic::compare_exchange(e->state, uint32_t(entry_type::idle), state) != state )
+            continue;
+        }
+        else
+        {
+          e->state = entry_type::armed;
+          if ( e->deadline_ <= now_ )
+          {
+            e->slot = levels * slots + 1;
+            link(*e, due);
+          }
+          else
+            insert(*e, now_);
+          ++armed_;
+        }
+        e = next;
+      }
+    }
+
+    // places the entry relative to the tick `base`, the level 0 slot of which is not expired yet
+    void insert(entry_type & e, uint64_t base)
+    {
+      // beyond the 2^36 ticks epoch of the base: kept aside until the epoch rolls over
+      if ( (e.deadline_ >> (slot_bits * levels)) != (base >> (slot_bits * levels)) )
+      {
+        e.slot = levels * slots;
+        link(e, overflow);
+        return;
+      }
+      unsigned l = 0;
+      while ( l < levels - 1 && (e.deadline_ >> (slot_bits * (l + 1))) != (base >> (slot_bits * (l + 1))) )
+        l++;
+      const unsigned s = static_cast<unsigned>((e.deadline_ >> (slot_bits * l)) & (slots - 1));
+      e.slot = l * slots + s;
+      link(e, heads[l][s]);
+      occupied[l] |= uint64_t(1) << s;
+    }
+
+    void unlink(entry_type & e)
+    {
+      e.prev->next = e.next;
+      e.next->prev = e.prev;
+      const unsigned l = e.slot / slots, s = e.slot % slots;
+      if ( l < levels && heads[l][s].next == &heads[l][s] )
+        occupied[l] &= ~(uint64_t(1) << s);
+      --armed_;
+    }
+
+    static void link(entry_type & e, entry_type & head)
+    {
+      e.next = &head;
+      e.prev = head.prev;
+      head.prev->next = &e;
+      head.prev = &e;
+    }
+
+    // redistributes the higher level slots reached at the tick t
+    void cascade(uint64_t t)
+    {
+      if ( (t & ((uint64_t(1) << (slot_bits * levels)) - 1)) == 0 && overflow.next != &overflow )
+      {
+        // the new epoch
+        entry_type * e = overflow.next;
+        overflow.prev->next = 0;
+        overflow.prev = overflow.next = &overflow;
+        while ( e )
+        {
+          entry_type * const next = e->next;
+          insert(*e, t);
+          e = next;
+        }
+      }
+      unsigned top = 1;
+      while ( top < levels - 1 && ((t >> (slot_bits * top)) & (slots - 1)) == 0 )
+        top++;
+      for ( unsigned l = top; l > 0; l-- )
+      {
+        const unsigned s = static_cast<unsigned>((t >> (slot_bits * l)) & (slots - 1));
+        if ( !(occupied[l] & (uint64_t(1) << s)) )
+          continue;
+        entry_type & head = heads[l][s];
+        entry_type * e = head.next;
+        head.prev = head.next = &head;
+        occupied[l] &= ~(uint64_t(1) << s);
+        while ( e != &head )
+        {
+          entry_type * const next = e->next;
+          insert(*e, t);
+          e = next;
+        }
+      }
+    }
+
+    // moves the level 0 slot or the due list to the batch
+    void expire(entry_type & head, entry_type & batch)
+    {
+      for ( entry_type * e = head.next; e != &head; e = e->next )
+      {
+        e->state = entry_type::firing;
+        --armed_;
+      }
+      head.next->prev = batch.prev;
+      batch.prev->next = head.next;
+      head.prev->next = &batch;
+      batch.prev = head.prev;
+      head.prev = head.next = &head;
+      if ( &head != &due )
+        occupied[0] &= ~(uint64_t(1) << (&head - heads[0]));
+    }
+
+    // the first tick after t which expires or cascades an occupied slot
+    uint64_t next_event(uint64_t t) const
+    {
+      for ( unsigned l = 0; l < levels; l++ )
+      {
+        // the slots of the level up to the current one are empty
+        const unsigned shift = slot_bits * l;
+        const unsigned current = static_cast<unsigned>((t >> shift) & (slots - 1));
+        const uint64_t above = current == slots - 1 ? 0 : occupied[l] & (~uint64_t(0) << (current + 1));
+        const uint64_t block = t >> (shift + slot_bits) << (shift + slot_bits);
+        if ( above )
+          return block + (uint64_t(lowest_bit(above)) << shift);
+      }
+      // the next epoch brings the overflow entries
+      if ( overflow.next != &overflow )
+        return ((t >> (slot_bits * levels)) + 1) << (slot_bits * levels);
+      return ~uint64_t(0);
+    }
+
+    static unsigned lowest_bit(uint64_t x)
+    {
+      static const uint8_t debruijn[64] =
+      {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+      };
+      return debruijn[((x & (0 - x)) * 0x03F79D71B4CB0A89ULL) >> 58];
+    }
+
+    entry_type          heads[levels][slots];
+    entry_type          overflow;
+    entry_type          due;
+    uint64_t            occupied[levels];
+    volatile uintptr_t  inbox;
+    uint64_t            now_;
+    size_t              armed_;
+    Lock                lock;
+};
+
+}//namespace ntl
+
+#endif//#ifndef NTL__TIMER_WHEEL
@@ -0,0 +1,44 @@
+/**\file*********************************************************************
+ *                                                                     \brief
+ *  UTF-8 of the native strings
+ *
+ ****************************************************************************
+ */
+#ifndef NTL__UTF8
+#define NTL__UTF8
+#pragma once
+
+#include "nt/string.hxx"
+#include "stlx/ext/utf.hxx"
+
+namespace ntl {
+
+/// The exact length of UTF-8 of the UTF-16 string
+inline size_t utf8_length(const nt::const_unicode_string& s)
+{
+  return std::ext::utf::utf8_length(s.begin(), s.end());
+}
+
+/**
+ *	Appends UTF-8 of the UTF-16 string \a s to \a out, \a out is resized once.
+ *  @return false if \a s has an unpaired surrogate, \a out is left as it was then
+ **/
+inline bool append_utf8(std::string& out, const nt::const_unicode_string& s)
+{
+  if ( s.empty() )
+    return true;
+  const size_t size = out.size();
+  out.resize(size + utf8_length(s));
+  const wchar_t* from_next;
+  char* to_next;
+  if ( std::ext::utf::to_utf8(s.begin(), s.end(), from_next, &out[0] + size, &out[0] + out.size(), to_next) != std::ext::utf::ok )
+  {
+    out.resize(size);
+    return false;
+  }
+  return true;
+}
+
+}//namespace ntl
+
+#endif//#ifndef NTL__UTF8
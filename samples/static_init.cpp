@@ -0,0 +1,155 @@
+/**
+ *	@file static_init.cpp
+ *	@brief Sample which measures the startup time of the static objects initialized in parallel by ntl::static_objects
+ *	@note Compilation command-line: cl /nologo /I../ntl /DWIN32 /D_UNICODE /DUNICODE /GS- /O2 static_init.cpp /link /subsystem:console /libpath:your_lib_path_with_ntdll.lib
+ *  @details Usage: static_init.exe [threads] [-fast]. Run it with 1 thread to get the sequential startup time.
+ **/
+
+#include <consoleapp.hxx>
+#include <static_init.hxx>
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+using namespace ntl;
+using namespace std;
+
+namespace
+{
+  typedef chrono::high_resolution_clock clock_type;
+
+  uint64_t microseconds(clock_type::duration d)
+  {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(d).count());
+  }
+
+  // the time spent in the constructors by all threads, i.e. the sequential startup time
+  volatile uint64_t constructors_time;
+
+  struct timed
+  {
+    timed(): start(clock_type::now()) {}
+    void done() { atomic::exchange_add(constructors_time, microseconds(clock_type::now() - start)); }
+    clock_type::time_point start;
+  };
+
+  // a heavy table as in our services: a sorted set of pseudo-random keys
+  template<uint32_t Seed>
+  struct table
+  {
+    table()
+    {
+      timed t;
+      keys.resize(1 << 20);
+      uint32_t x = Seed;
+      for(size_t i = 0; i < keys.size(); i++){
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        keys[i] = x;
+      }
+      sort(keys.begin(), keys.end());
+      t.done();
+    }
+
+    bool contains(uint32_t key) const { return binary_search(keys.begin(), keys.end(), key); }
+
+    vector<uint32_t> keys;
+  };
+
+  // an index built over the other tables
+  template<class A, class B, class C, class D>
+  struct table_index
+  {
+    table_index(const A& a, const B& b, const C& c, const D& d)
+      :count()
+    {
+      timed t;
+      for(size_t i = 0; i < a.keys.size(); i += 16)
+        count += b.contains(a.keys[i]) + c.contains(a.keys[i]) + d.contains(a.keys[i]);
+      t.done();
+    }
+    size_t count;
+  };
+
+  parallel_static<table<1>, abandon_on_fast_exit> t1;
+  parallel_static<table<2>, abandon_on_fast_exit> t2;
+  parallel_static<table<3>, abandon_on_fast_exit> t3;
+  parallel_static<table<4>, abandon_on_fast_exit> t4;
+  parallel_static<table<5>, abandon_on_fast_exit> t5;
+  parallel_static<table<6>, abandon_on_fast_exit> t6;
+  parallel_static<table<7>, abandon_on_fast_exit> t7;
+  parallel_static<table<8>, abandon_on_fast_exit> t8;
+  parallel_static<table<9>, abandon_on_fast_exit> t9;
+  parallel_static<table<10>, abandon_on_fast_exit> t10;
+  parallel_static<table<11>, abandon_on_fast_exit> t11;
+  parallel_static<table<12>, abandon_on_fast_exit> t12;
+
+  // the parallel_static object is default constructed, so the dependencies are passed by a wrapper
+  struct first_index: table_index<table<1>, table<2>, table<3>, table<4> >
+  {
+    first_index(): table_index<table<1>, table<2>, table<3>, table<4> >(*t1, *t2, *t3, *t4) {}
+  };
+
+  struct second_index: table_index<table<5>, table<6>, table<7>, table<8> >
+  {
+    second_index(): table_index<table<5>, table<6>, table<7>, table<8> >(*t5, *t6, *t7, *t8) {}
+  };
+
+  parallel_static<first_index> i1(t1, t2, t3, t4);
+  parallel_static<second_index> i2(t5, t6, t7, t8);
+}
+
+class app: consoleapp
+{
+  unsigned threads;
+  bool fast;
+public:
+  int proceed();
+protected:
+  bool parse_args()
+  {
+    threads = 0;
+    fast = false;
+    command_line cmdl;
+    for(command_line::const_iterator cmd = cmdl.cbegin()+1; cmd != cmdl.cend(); ++cmd){
+      if(!wcscmp(*cmd, L"-fast"))
+        fast = true;
+      else
+        threads = static_cast<unsigned>(wcstol(*cmd, 0, 10));
+    }
+    return true;
+  }
+
+  void print(const char* format, uint64_t a, uint64_t b = 0, uint64_t c = 0)
+  {
+    char buf[256];
+    const int l = _snprintf(buf, sizeof(buf)-1, format, a, b, c);
+    if(l > 0)
+      console::write<char>(buf, l);
+  }
+};
+
+int app::proceed()
+{
+  parse_args();
+
+  const clock_type::time_point start = clock_type::now();
+  const size_t count = static_objects::initialize(threads);
+  const uint64_t startup = microseconds(clock_type::now() - start);
+
+  const unsigned workers = threads ? threads : thread::hardware_concurrency();
+  print(" %I64u objects initialized by %I64u threads\n", count, workers);
+  print(" startup %I64u us, constructors %I64u us, speedup %I64u%%\n", startup, constructors_time, startup ? constructors_time * 100 / startup : 0);
+  print(" index hits %I64u\n", i1->count + i2->count);
+
+  // the tables are abandoned at exit, the indices are still destroyed in order
+  static_objects::fast_exit_mode(fast);
+  return 0;
+}
+
+int consoleapp::main()
+{
+  app app_;
+  return app_.proceed();
+}
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <array>
 #include <list>
+#include <vector>
 
 #include <km/new.hxx>
 #include <km/driver_object.hxx>
@@ -22,6 +23,8 @@
 #include <nt/registry.hxx>
 #include <nt/service.hxx>
 
+#include <path_matcher.hxx>
+
 
 #include <km/debug.hxx>
 
@@ -38,7 +41,14 @@ using namespace ntl::km;
 static const char shared_data[shared_data_size] = ZENADRIVER_SIGNATURE_SHARED_DATA;
 
 // ...and we are rearranging it to speed up PE images fitering
-static list<wstring> * white;
+struct whitelist
+{
+  // the file names of the visible drivers
+  path_matcher  names;
+  // a visible driver is allowed once
+  vector<bool>  loaded;
+};
+static whitelist * white;
 
 // boot group is filtered during startup, however carantined later
 static list<string> * boot_black;
@@ -49,9 +59,11 @@ static inline
 bool build_whitelist()
 {
   if ( white ) return true;
-  white = new list<wstring>;
+  white = new whitelist;
   if ( !white ) return false;
 
+  list<wstring> names;
+
   const wchar_t * str_begin = 0;
   const wchar_t * str_end = 0;
   for ( const wchar_t * p = reinterpret_cast<const wchar_t*>(shared_data);
@@ -75,18 +87,22 @@ bool build_whitelist()
       str_end = p;
       // null-string at the end
       if ( str_begin == str_end ) break;
-      white->push_back(wstring(str_begin, str_end - str_begin));
-      if ( equal_filenames(white->back(), const_ansi_string("dump_atapi.sys"))
-        || equal_filenames(white->back(), const_ansi_string("dump_WMILIB.SYS")))
+      names.push_back(wstring(str_begin, str_end - str_begin));
+      if ( equal_filenames(names.back(), const_ansi_string("dump_atapi.sys"))
+        || equal_filenames(names.back(), const_ansi_string("dump_WMILIB.SYS")))
       {
-        const wstring::size_type und = white->back().rfind('_');
-        white->back().erase(und-4, 5);
+        const wstring::size_type und = names.back().rfind('_');
+        names.back().erase(und-4, 5);
       }
-      dbg::trace.printf("\t ZenADriver whitelist : %ws\n", white->back().c_str());
+      dbg::trace.printf("\t ZenADriver whitelist : %ws\n", names.back().c_str());
+      // the drivers are matched by the file names
+      names.back().erase(0, names.back().rfind(L'\\') + 1);
       str_begin = str_end + 1;
     }
   }
-  return !white->empty();
+  if ( !white->names.build(names.begin(), names.end()) ) return false;
+  white->loaded.resize(names.size());
+  return !white->names.empty();
 } 
 
 
@@ -124,17 +140,18 @@ bool carantine_file(const const_unicode_string & filename)
   raw_data filedata(f.get_data());
   f.erase();
 
-  wstring new_name( filename.get_string() );
-  
-  // special case for NTFS data streams
-  wstring::size_type colon = new_name.rfind(L':');
-  if ( colon != wstring::npos ) new_name[colon] = '_';
+  // the path fits the stack buffer
+  inline_unicode_string<260> new_name(L"\\??\\"ZENADRIVER_FOLDER_NAME);
+  const size_t name = new_name.size() + 1;
+  unicode_string_view path(filename);
+  new_name.append_path(path.split_back('\\'));
+  if ( !new_name.good() ) return false;
 
-  ///\todo basic_string::replace
-  new_name.erase(0, 1+new_name.rfind(L'\\'));
-  new_name.insert(0, L"\\??\\"ZENADRIVER_FOLDER_NAME L"\\");
+  // special case for NTFS data streams
+  const size_t colon = new_name.view().rfind(':');
+  if ( colon != unicode_string_view::npos && colon >= name ) new_name[colon] = '_';
 
-  file backup(new_name,
+  file backup(new_name.str(),
               file::supersede,
               file::write_data | file::write_attributes | synchronize,
               file::share_read);
@@ -199,15 +216,11 @@ void __stdcall
     // search through the list of visible drivers
     if ( white )
     {
-      for ( list<wstring>::iterator it = white->begin();
-            it != white->end();
-            ++it )
+      const size_t visible = white->names.find(*full_imagename);
+      if ( visible != path_matcher::npos && !white->loaded[visible] )
       {
-        if ( !equal_filenames(*it, *full_imagename) )
-          continue;
         allowed = true;
-        if ( !in_csrss ) white->erase(it);
-        break;
+        if ( !in_csrss ) white->loaded[visible] = true;
       }
     }
     
@@ -286,18 +299,14 @@ bool filter_boot_drivers()
   for ( list<string>::iterator a_it = boot_black->begin();
         a_it != boot_black->end(); )
   {
-    for ( list<wstring>::iterator w_it = white->begin();
-          w_it != white->end();
-          ++w_it )
+    const size_t visible = white->names.find(*a_it);
+    if ( visible == path_matcher::npos || white->loaded[visible] )
     {
-      if ( !equal_filenames(*a_it, *w_it) )
-        continue;
-      white->erase(w_it);
-      a_it = boot_black->erase(a_it);
-      goto next_a_it;
+      ++a_it;
+      continue;
     }
-    ++a_it;
-    next_a_it:;
+    white->loaded[visible] = true;
+    a_it = boot_black->erase(a_it);
   }
 
   // patch drivers to disallow run
@@ -0,0 +1,333 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <btree.hxx>
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  // the reference vectors have no const key
+  template<class T>
+  bool equivalent(const T& x, const T& y) { return x == y; }
+  template<class Key, class T>
+  bool equivalent(const std::pair<const Key, T>& x, const std::pair<Key, T>& y) { return x.first == y.first && x.second == y.second; }
+
+  struct equivalent_values
+  {
+    template<class T, class U>
+    bool operator()(const T& x, const U& y) const { return equivalent(x, y); }
+  };
+
+  // the tree iterates as the reference in both directions
+  template<class Tree, class Reference>
+  bool same(const Tree& t, const Reference& r)
+  {
+    if ( t.size() != r.size() || !std::equal(t.begin(), t.end(), r.begin(), equivalent_values()) )
+      return false;
+    return std::equal(t.rbegin(), t.rend(), r.rbegin(), equivalent_values());
+  }
+
+  // random insertions and erasures against std::map, small nodes make the tree deep
+  template<class Map>
+  void random_ops(uint32_t keys, unsigned rounds)
+  {
+    Map t;
+    std::map<int, int> r;
+    for ( unsigned round = 0; round < rounds; round++ )
+    {
+      const int key = static_cast<int>(random(keys)) - static_cast<int>(keys / 2);
+      switch ( random(6) )
+      {
+      case 0: case 1: case 2:
+        {
+          const bool fresh = r.find(key) == r.end();
+          std::pair<typename Map::iterator, bool> p = t.insert(std::make_pair(key, int(round)));
+          VERIFY(p.second == fresh && p.first->first == key);
+          if ( fresh )
+            r.insert(std::make_pair(key, int(round)));
+          VERIFY(p.first->second == r[key]);
+        }
+        break;
+      case 3:
+        VERIFY(t.erase(key) == (r.erase(key) ? 1u : 0u));
+        break;
+      case 4:
+        {
+          // erase() returns the next value
+          typename Map::iterator i = t.lower_bound(key);
+          std::map<int, int>::iterator j = r.lower_bound(key);
+          VERIFY((i == t.end()) == (j == r.end()));
+          if ( i != t.end() )
+          {
+            VERIFY(equivalent(*i, *j));
+            i = t.erase(i);
+            r.erase(j++);
+            VERIFY((i == t.end()) == (j == r.end()) && (i == t.end() || equivalent(*i, *j)));
+          }
+        }
+        break;
+      case 5:
+        {
+          typename Map::const_iterator i = t.upper_bound(key);
+          std::map<int, int>::const_iterator j = r.upper_bound(key);
+          VERIFY((i == t.end()) == (j == r.end()) && (i == t.end() || equivalent(*i, *j)));
+          VERIFY(t.count(key) == r.count(key));
+        }
+        break;
+      }
+      if ( round % 512 == 0 )
+        VERIFY(same(t, r));
+    }
+    VERIFY(same(t, r));
+    for ( std::map<int, int>::const_iterator j = r.begin(); j != r.end(); ++j )
+      VERIFY(t.find(j->first) != t.end() && t.find(j->first)->second == j->second);
+
+    // drained from the front
+    while ( !t.empty() )
+    {
+      VERIFY(t.begin()->first == r.begin()->first);
+      t.erase(t.begin());
+      r.erase(r.begin());
+    }
+    VERIFY(t.nodes() == 0 && t.height() == 0);
+  }
+
+  void test01()
+  {
+    random_ops<btree_map<int, int> >(20000, 200000);
+    random_ops<btree_map<int, int, std::less<int>, std::allocator<std::pair<const int, int> >, 64> >(3000, 100000);
+    random_ops<btree_map<int, int, std::less<int>, std::allocator<std::pair<const int, int> >, 96> >(500, 50000);
+
+    btree_map<int, int, std::greater<int> > g;
+    for ( int i = 0; i < 1000; i++ )
+      g[i] = i;
+    VERIFY(g.begin()->first == 999 && g.lower_bound(500)->first == 500 && g.upper_bound(500)->first == 499);
+
+    // the keys are const as in std::map, the mapped values are mutable in place
+    typedef btree_map<int, int> map_type;
+    VERIFY((std::is_same<map_type::value_type, std::pair<const int, int> >::value));
+    VERIFY((std::is_same<map_type::iterator::reference, std::pair<const int, int>&>::value));
+    VERIFY((std::is_same<btree_multimap<int, int>::const_iterator::pointer, const std::pair<const int, int>*>::value));
+    map_type m(g.begin(), g.end());
+    map_type::iterator i = m.find(500);
+    i->second = -1;
+    (*i).second--;
+    VERIFY(m[500] == -2 && m.find(501)->second == 501 && m.size() == 1000);
+  }
+
+  bool by_key(const std::pair<int, int>& x, const std::pair<int, int>& y) { return x.first < y.first; }
+
+  // the equal keys of the multimap stay in the order of insertion
+  void test02()
+  {
+    typedef btree_multimap<int, int, std::less<int>, std::allocator<std::pair<const int, int> >, 64> multimap_type;
+    multimap_type m;
+    std::vector<std::pair<int, int> > r;
+    for ( int i = 0; i < 20000; i++ )
+    {
+      const int key = static_cast<int>(random(300));
+      m.insert(std::make_pair(key, i));
+      r.push_back(std::make_pair(key, i));
+    }
+    std::stable_sort(r.begin(), r.end(), by_key);
+    VERIFY(m.size() == r.size() && std::equal(m.begin(), m.end(), r.begin(), equivalent_values()));
+
+    for ( int key = -1; key <= 300; key++ )
+    {
+      const std::pair<multimap_type::iterator, multimap_type::iterator> e = m.equal_range(key);
+      const size_t n = static_cast<size_t>(std::distance(e.first, e.second));
+      VERIFY(n == m.count(key));
+      VERIFY(n == 0 || (m.find(key) == e.first && e.first->first == key));
+      for ( multimap_type::iterator i = e.first; i != e.second; ++i )
+        VERIFY(i->first == key);
+    }
+    const size_t n = m.count(7);
+    VERIFY(n && m.erase(7) == n && m.count(7) == 0 && m.size() == r.size() - n);
+
+    // the hint keeps the order too
+    multimap_type h;
+    for ( int i = 0; i < 1000; i++ )
+      h.insert(h.end(), std::make_pair(i / 10, i));
+    for ( int i = 0; i < 100; i++ )
+      h.insert(h.begin(), std::make_pair(-1, i));
+    multimap_type::const_iterator i = h.begin();
+    VERIFY(i->first == -1 && i->second == 99);
+    std::advance(i, 100);
+    VERIFY(i->first == 0 && i->second == 0);
+  }
+
+  // the SIMD search of the signed and unsigned keys against the sorted array
+  template<class Key>
+  void search_keys(const Key* keys, size_t n)
+  {
+    btree_set<Key> s(keys, keys + n);
+    std::vector<Key> sorted(keys, keys + n);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    VERIFY(same(s, sorted));
+    for ( size_t i = 0; i < n; i++ )
+      for ( int d = -1; d <= 1; d++ )
+      {
+        const Key x = static_cast<Key>(static_cast<uint32_t>(keys[i]) + d);
+        const typename std::vector<Key>::iterator l = std::lower_bound(sorted.begin(), sorted.end(), x);
+        const typename std::vector<Key>::iterator u = std::upper_bound(sorted.begin(), sorted.end(), x);
+        VERIFY(std::distance(s.begin(), s.lower_bound(x)) == l - sorted.begin());
+        VERIFY(std::distance(s.begin(), s.upper_bound(x)) == u - sorted.begin());
+        VERIFY((s.find(x) != s.end()) == (l != u));
+      }
+  }
+
+  void test03()
+  {
+    std::vector<int32_t> signed_keys;
+    std::vector<uint32_t> unsigned_keys;
+    static const uint32_t edges[] = { 0, 1, 2, 0x7FFFFFFE, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xFFFFFFFE, 0xFFFFFFFF };
+    for ( size_t i = 0; i < _countof(edges); i++ )
+    {
+      signed_keys.push_back(static_cast<int32_t>(edges[i]));
+      unsigned_keys.push_back(edges[i]);
+    }
+    for ( int i = 0; i < 3000; i++ )
+    {
+      const uint32_t k = random(1u << 24) << 8 | random(256);
+      signed_keys.push_back(static_cast<int32_t>(k));
+      unsigned_keys.push_back(random(2) ? k : random(100));
+    }
+    search_keys(&signed_keys[0], signed_keys.size());
+    search_keys(&unsigned_keys[0], unsigned_keys.size());
+
+    // the keys of the map values are interleaved
+    btree_map<uint32_t, uint32_t> m;
+    for ( size_t i = 0; i < unsigned_keys.size(); i++ )
+      m[unsigned_keys[i]] = static_cast<uint32_t>(i);
+    for ( size_t i = 0; i < unsigned_keys.size(); i++ )
+      VERIFY(m.find(unsigned_keys[i]) != m.end() && m.at(unsigned_keys[i]) == m[unsigned_keys[i]]);
+    VERIFY(m.lower_bound(0xFFFFFFFF)->first == 0xFFFFFFFF && m.upper_bound(0xFFFFFFFF) == m.end());
+  }
+
+  // copy, assignment and ranges
+  void test04()
+  {
+    btree_set<int, std::less<int>, std::allocator<int>, 64> a, b;
+    for ( int i = 0; i < 5000; i++ )
+      a.insert(static_cast<int>(random(100000)));
+    b = a;
+    VERIFY(a == b && !(a < b) && b.nodes() <= a.nodes());
+    b.insert(-1);
+    VERIFY(a != b && b < a);
+    a.swap(b);
+    VERIFY(a.find(-1) != a.end() && b.find(-1) == b.end());
+
+    // the sorted input fills the nodes
+    std::vector<int> sorted(b.begin(), b.end());
+    btree_set<int, std::less<int>, std::allocator<int>, 64> c(sorted.begin(), sorted.end());
+    VERIFY(c == b && c.nodes() <= b.nodes());
+
+    // range erasure
+    std::set<int> r(sorted.begin(), sorted.end());
+    btree_set<int, std::less<int>, std::allocator<int>, 64>::iterator first = c.lower_bound(20000), last = c.lower_bound(70000);
+    first = c.erase(first, last);
+    r.erase(r.lower_bound(20000), r.lower_bound(70000));
+    VERIFY(same(c, r) && *first == *r.lower_bound(70000));
+    c.erase(c.begin(), c.end());
+    VERIFY(c.empty() && c.begin() == c.end() && c.bytes_used() == 0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 1M symbols: lookup, ordered walk and memory per element against rb_tree
+
+  size_t allocated;
+
+  template<class T>
+  struct counting_allocator: std::allocator<T>
+  {
+    template<class U> struct rebind { typedef counting_allocator<U> other; };
+
+    counting_allocator() {}
+    template<class U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n, const void* = 0)
+    {
+      allocated += n * sizeof(T);
+      return std::allocator<T>::allocate(n);
+    }
+    void deallocate(T* p, size_t n)
+    {
+      allocated -= n * sizeof(T);
+      std::allocator<T>::deallocate(p, n);
+    }
+  };
+
+  template<class Map>
+  void bench_map(const char* name, const std::vector<uint32_t>& keys, const std::vector<uint32_t>& probes)
+  {
+    const size_t bytes_before = allocated;
+    Map m;
+    for ( size_t i = 0; i < keys.size(); i++ )
+      m.insert(std::make_pair(keys[i], static_cast<uint32_t>(i)));
+    const size_t bytes = allocated - bytes_before;
+
+    uint64_t sum = 0;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for ( size_t i = 0; i < probes.size(); i++ )
+    {
+      const typename Map::const_iterator it = m.find(probes[i]);
+      if ( it != m.end() )
+        sum += it->second;
+    }
+    const uint64_t t_find = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( typename Map::const_iterator it = m.begin(); it != m.end(); ++it )
+      sum += it->first;
+    const uint64_t t_walk = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("%-10s lookup %4I64u, walk %3I64u cycles per element, %2u bytes per element (%I64u)\n",
+      name, t_find / probes.size(), t_walk / m.size(), static_cast<unsigned>(bytes / m.size()), sum);
+  }
+
+  void bench()
+  {
+    static const size_t count = 1000 * 1000;
+    std::vector<uint32_t> keys(count), probes(count);
+    for ( size_t i = 0; i < count; i++ )
+      keys[i] = random(1u << 24) << 8 | random(256);
+    for ( size_t i = 0; i < count; i++ )
+      probes[i] = random(2) ? keys[random(count)] : random(1u << 24) << 8;
+
+    typedef std::pair<const uint32_t, uint32_t> value_type;
+    bench_map<std::map<uint32_t, uint32_t, std::less<uint32_t>, counting_allocator<std::pair<const uint32_t, uint32_t> > > >("rb_tree", keys, probes);
+    bench_map<btree_map<uint32_t, uint32_t, std::less<uint32_t>, counting_allocator<value_type> > >("btree", keys, probes);
+    bench_map<btree_map<uint32_t, uint32_t, std::greater<uint32_t>, counting_allocator<value_type> > >("btree/bin", keys, probes);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    test04();
+    bench();
+  }
+}
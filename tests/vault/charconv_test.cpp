@@ -0,0 +1,292 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <charconv>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  template<size_t N>
+  bool to_chars_is(const char (&expected)[N], double v, std::chars_format::type fmt = std::chars_format::general)
+  {
+    char buf[64];
+    const std::to_chars_result re = std::to_chars(buf, buf + _countof(buf), v, fmt);
+    return re.ec == std::posix_error::success && static_cast<size_t>(re.ptr - buf) == N-1 && std::memcmp(buf, expected, N-1) == 0;
+  }
+
+  // integers
+  void test01()
+  {
+    char buf[80];
+    std::to_chars_result re = std::to_chars(buf, buf + _countof(buf), 0);
+    VERIFY(re.ec == 0 && re.ptr - buf == 1 && buf[0] == '0');
+
+    re = std::to_chars(buf, buf + _countof(buf), -1234567890);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "-1234567890");
+
+    re = std::to_chars(buf, buf + _countof(buf), 18446744073709551615ULL);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "18446744073709551615");
+
+    re = std::to_chars(buf, buf + _countof(buf), -9223372036854775807LL - 1);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "-9223372036854775808");
+
+    re = std::to_chars(buf, buf + _countof(buf), 255, 16);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "ff");
+
+    re = std::to_chars(buf, buf + _countof(buf), -255, 2);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "-11111111");
+
+    re = std::to_chars(buf, buf + _countof(buf), 35, 36);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "z");
+
+    // buffer too small
+    re = std::to_chars(buf, buf + 3, 1234);
+    VERIFY(re.ec == std::posix_error::value_too_large && re.ptr == buf + 3);
+
+    // every power of ten boundary
+    unsigned long long p = 1;
+    for(int i = 1; i < 20; i++){
+      re = std::to_chars(buf, buf + _countof(buf), p - 1);
+      VERIFY(re.ptr - buf == (i == 1 ? 1 : i - 1));
+      re = std::to_chars(buf, buf + _countof(buf), p);
+      VERIFY(re.ptr - buf == i);
+      p *= 10;
+    }
+  }
+
+  void test02()
+  {
+    int i = 42;
+    const char s1[] = "12345xyz";
+    std::from_chars_result re = std::from_chars(s1, s1 + 8, i);
+    VERIFY(re.ec == 0 && i == 12345 && re.ptr == s1 + 5);
+
+    // no leading whitespace, no plus sign, no base prefix
+    const char s2[] = " 1";
+    i = 42;
+    re = std::from_chars(s2, s2 + 2, i);
+    VERIFY(re.ec == std::posix_error::invalid_argument && re.ptr == s2 && i == 42);
+    const char s3[] = "+1";
+    re = std::from_chars(s3, s3 + 2, i);
+    VERIFY(re.ec == std::posix_error::invalid_argument);
+    const char s4[] = "0x1f";
+    re = std::from_chars(s4, s4 + 4, i, 16);
+    VERIFY(re.ec == 0 && i == 0 && re.ptr == s4 + 1);
+
+    // limits
+    short sh;
+    const char s5[] = "-32768";
+    re = std::from_chars(s5, s5 + 6, sh);
+    VERIFY(re.ec == 0 && sh == -32768);
+    const char s6[] = "32768";
+    re = std::from_chars(s6, s6 + 5, sh);
+    VERIFY(re.ec == std::posix_error::result_out_of_range && re.ptr == s6 + 5);
+    unsigned u;
+    const char s7[] = "-1";
+    re = std::from_chars(s7, s7 + 2, u);
+    VERIFY(re.ec == std::posix_error::invalid_argument);
+    unsigned long long ull;
+    const char s8[] = "18446744073709551615";
+    re = std::from_chars(s8, s8 + 20, ull);
+    VERIFY(re.ec == 0 && ull == 18446744073709551615ULL);
+    const char s9[] = "18446744073709551616";
+    re = std::from_chars(s9, s9 + 20, ull);
+    VERIFY(re.ec == std::posix_error::result_out_of_range);
+    const char s10[] = "FfFf";
+    re = std::from_chars(s10, s10 + 4, u, 16);
+    VERIFY(re.ec == 0 && u == 0xffff);
+
+    // round trip
+    long long v = 1;
+    for(int n = 0; n < 10000; n++){
+      char buf[32];
+      v = v * 6364136223846793005LL + 1442695040888963407LL;
+      const long long x = v >> (n % 64);
+      const int base = 2 + n % 35;
+      std::to_chars_result tr = std::to_chars(buf, buf + _countof(buf), x, base);
+      long long y;
+      re = std::from_chars(buf, tr.ptr, y, base);
+      VERIFY(re.ec == 0 && re.ptr == tr.ptr && x == y);
+    }
+  }
+
+  // floating point
+  void test03()
+  {
+    VERIFY(to_chars_is("0", 0.0));
+    VERIFY(to_chars_is("-0", -0.0));
+    VERIFY(to_chars_is("0.1", 0.1));
+    VERIFY(to_chars_is("0.3", 0.3));
+    VERIFY(to_chars_is("123456.789", 123456.789));
+    VERIFY(to_chars_is("1.23456789e+05", 123456.789, std::chars_format::scientific));
+    VERIFY(to_chars_is("100000000000000000000", 1e20));
+    VERIFY(to_chars_is("1e+21", 1e21));
+    VERIFY(to_chars_is("2.5e-05", 2.5e-5));
+    VERIFY(to_chars_is("0.000025", 2.5e-5, std::chars_format::fixed));
+    VERIFY(to_chars_is("5e-324", 5e-324));
+    VERIFY(to_chars_is("1.7976931348623157e+308", 1.7976931348623157e308));
+
+    char buf[32];
+    std::to_chars_result re = std::to_chars(buf, buf + _countof(buf), 0.1f);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "0.1");
+    // shortest of fixed and scientific
+    re = std::to_chars(buf, buf + _countof(buf), 1e20);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "1e+20");
+    re = std::to_chars(buf, buf + _countof(buf), 1200.0);
+    VERIFY(re.ec == 0 && std::string(buf, re.ptr) == "1200");
+  }
+
+  // std::string conversions
+  void test04()
+  {
+    VERIFY(std::to_string(-1) == "-1");
+    VERIFY(std::to_string(4294967295U) == "4294967295");
+    VERIFY(std::to_wstring(-9223372036854775807LL - 1) == L"-9223372036854775808");
+
+    size_t idx;
+    VERIFY(std::stoi(std::string("  +42abc"), &idx) == 42 && idx == 5);
+    VERIFY(std::stoi(std::string("-2147483648")) == -2147483647 - 1);
+    VERIFY(std::stol(std::wstring(L"\t-17"), &idx) == -17 && idx == 4);
+    VERIFY(std::stoul(std::string("ff"), 0, 16) == 255);
+    VERIFY(std::stoull(std::string("18446744073709551615")) == 18446744073709551615ULL);
+  }
+
+  template<size_t N>
+  bool to_chars_is(const char (&expected)[N], double v, std::chars_format::type fmt, int precision)
+  {
+    char buf[400];
+    const std::to_chars_result re = std::to_chars(buf, buf + _countof(buf), v, fmt, precision);
+    return re.ec == std::posix_error::success && static_cast<size_t>(re.ptr - buf) == N-1 && std::memcmp(buf, expected, N-1) == 0;
+  }
+
+  // the precision is rounded exactly, the ties to even
+  void test05()
+  {
+    VERIFY(to_chars_is("0.100", 0.1, std::chars_format::fixed, 3));
+    VERIFY(to_chars_is("0.1000000000000000055511", 0.1, std::chars_format::fixed, 22));
+    VERIFY(to_chars_is("2", 2.5, std::chars_format::fixed, 0) && to_chars_is("4", 3.5, std::chars_format::fixed, 0));
+    VERIFY(to_chars_is("2.67", 2.675, std::chars_format::fixed, 2));
+    VERIFY(to_chars_is("100.0", 99.96, std::chars_format::fixed, 1));
+    VERIFY(to_chars_is("0.00", 0.004, std::chars_format::fixed, 2) && to_chars_is("-0.01", -0.006, std::chars_format::fixed, 2));
+    VERIFY(to_chars_is("1.235e+05", 123456.789, std::chars_format::scientific, 3));
+    VERIFY(to_chars_is("1e+01", 9.5, std::chars_format::scientific, 0));
+    VERIFY(to_chars_is("4.94066e-324", 5e-324, std::chars_format::scientific, 5));
+    VERIFY(to_chars_is("0.000000e+00", 0.0, std::chars_format::scientific, 6));
+    VERIFY(to_chars_is("123457", 123456.789, std::chars_format::general, 6) && to_chars_is("1.2e+06", 1.2e6, std::chars_format::general, 6));
+    VERIFY(to_chars_is("0.0001", 1e-4, std::chars_format::general, 6) && to_chars_is("1e-05", 1e-5, std::chars_format::general, 6));
+    VERIFY(to_chars_is("179769313486231570814527423731704356798070567525844996598917476803157260780028538760589558632766878171540458953514382464234321326889464182768467546703537516986049910576551282076245490090389328944075868508455133942304583236903222948165808559332123348274797826204144723168738177180919299881250404026184124858368",
+      1.7976931348623157e308, std::chars_format::fixed, 0));
+
+    char buf[8];
+    VERIFY(std::to_chars(buf, buf + _countof(buf), 1.5, std::chars_format::fixed, 7).ec == std::posix_error::value_too_large);
+
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << 3.14159 << ' ' << std::setw(8) << -2.5;
+    os << ' ' << std::scientific << std::setprecision(1) << 1234.5 << ' ' << std::uppercase << 1e-10;
+    VERIFY(os.str() == "3.14    -2.50 1.2e+03 1.0E-10");
+    os.unsetf(std::ios_base::floatfield);
+    os << ' ' << 0.1;
+    VERIFY(os.str() == "3.14    -2.50 1.2e+03 1.0E-10 0.1");
+
+    // the default floatfield is %g with precision() significant digits, showpoint is %#g
+    std::ostringstream g;
+    g << 1.0/3 << ' ' << std::setprecision(3) << 1.0/3 << ' ' << std::setprecision(0) << 1234.5 << ' ' << 100.0;
+    g << ' ' << std::showpoint << std::setprecision(6) << 1.0 << ' ' << std::fixed << std::setprecision(0) << 2.0;
+    VERIFY(g.str() == "0.333333 0.333 1e+03 1e+02 1.00000 2.");
+
+    // the large precision does not fit the buffer of the facet on the stack
+    std::ostringstream big;
+    big << std::fixed << std::setprecision(600) << 1e300;
+    VERIFY(!big.fail() && big.str().size() == 301 + 1 + 600 && big.str().compare(0, 5, "10000") == 0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // throughput: to_chars/from_chars against the previous paths
+
+  void bench()
+  {
+    static const unsigned iterations = 1000000;
+    char buf[64];
+    volatile size_t sink = 0;
+    unsigned long long v = 88172645463325252ULL;
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      v ^= v << 13, v ^= v >> 7, v ^= v << 17;
+      sink += std::to_chars(buf, buf + _countof(buf), v >> (i & 63)).ptr - buf;
+    }
+    const uint64_t t_to_chars = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      v ^= v << 13, v ^= v >> 7, v ^= v << 17;
+      size_t written;
+      ntl::numeric::num2str(v >> (i & 63), false, buf, _countof(buf), 10, &written);
+      sink += written;
+    }
+    const uint64_t t_num2str = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      v ^= v << 13, v ^= v >> 7, v ^= v << 17;
+      sink += _snprintf(buf, _countof(buf), "%I64u", v >> (i & 63));
+    }
+    const uint64_t t_snprintf = ntl::intrinsic::rdtsc() - t;
+
+    const char number[] = "1234567890123";
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      unsigned long long x;
+      std::from_chars(number, number + 13, x);
+      sink += static_cast<size_t>(x);
+    }
+    const uint64_t t_from_chars = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      unsigned long long x;
+      ntl::numeric::str2num<unsigned long long, long long>(x, number, 13, 10, std::numeric_limits<unsigned long long>::__max, 0LL);
+      sink += static_cast<size_t>(x);
+    }
+    const uint64_t t_str2num = ntl::intrinsic::rdtsc() - t;
+
+    double d = 1.0;
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      d = d * 1.0000001 + 0.001;
+      sink += std::to_chars(buf, buf + _countof(buf), d).ptr - buf;
+    }
+    const uint64_t t_dtoa = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("to_chars(ull):   %I64u cycles/call\n", t_to_chars / iterations);
+    dbg::trace.printf("num2str(ull):    %I64u cycles/call\n", t_num2str / iterations);
+    dbg::trace.printf("_snprintf(%%I64u): %I64u cycles/call\n", t_snprintf / iterations);
+    dbg::trace.printf("from_chars(ull): %I64u cycles/call\n", t_from_chars / iterations);
+    dbg::trace.printf("str2num(ull):    %I64u cycles/call\n", t_str2num / iterations);
+    dbg::trace.printf("to_chars(double):%I64u cycles/call\n", t_dtoa / iterations);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    test04();
+    test05();
+    bench();
+  }
+}
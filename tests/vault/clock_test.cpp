@@ -0,0 +1,191 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <chrono>
+#include <thread>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+#ifdef __linux__
+# include <time.h>
+#endif
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace std::chrono;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Stand-in for the shared data page: a writer thread updates the time
+  // in steps, the same way the clock interrupt does.
+
+  struct fake_shared_page
+  {
+    volatile ntl::nt::system_time InterruptTime;
+    volatile bool stop;
+  } page;
+
+  // reference time in 100ns units
+  int64_t reference_time()
+  {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 10000000 + ts.tv_nsec / 100;
+#else
+    return ntl::user_shared_data::instance().InterruptTime.get();
+#endif
+  }
+
+  // the kernel stores the high part twice around the low one
+  void store(volatile ntl::nt::system_time& t, int64_t v)
+  {
+    t.high2 = static_cast<int32_t>(v >> 32);
+    t.low = static_cast<uint32_t>(v);
+    t.high = static_cast<int32_t>(v >> 32);
+  }
+
+  void page_writer(int64_t tick)
+  {
+    int64_t last = reference_time();
+    store(page.InterruptTime, last);
+    while(!page.stop){
+      const int64_t now = reference_time();
+      if(now - last >= tick)
+        store(page.InterruptTime, last = now);
+    }
+  }
+
+  struct fake_time_source
+  {
+    static int64_t interrupt_time() { return page.InterruptTime.get(); }
+  };
+
+  // torn reads: both halves of every stored value are equal
+  void tear_writer()
+  {
+    for(uint32_t i = 0; !page.stop; i++)
+      store(page.InterruptTime, static_cast<int64_t>(i) << 32 | i);
+  }
+
+  void test01()
+  {
+    page.stop = false;
+    std::thread writer(&tear_writer);
+    for(unsigned i = 0; i < 10000000; i++){
+      const int64_t v = page.InterruptTime.get();
+      VERIFY(static_cast<uint32_t>(v >> 32) == static_cast<uint32_t>(v));
+    }
+    page.stop = true;
+    writer.join();
+  }
+
+  // tsc clock calibrated against the stand-in page with 1ms ticks
+  void test02()
+  {
+    typedef std::chrono::__::tsc_clock<fake_time_source> clock;
+    // the interrupt time until calibrated
+    store(page.InterruptTime, 12345);
+    VERIFY(clock::now() == 1234500);
+
+    page.stop = false;
+    std::thread writer(&page_writer, int64_t(10000));
+
+    const bool tsc = clock::calibrate();
+    VERIFY(clock::calibrate() == tsc);
+
+    const int64_t r0 = reference_time(), c0 = clock::now();
+    int64_t prev = c0, c1;
+    while(reference_time() - r0 < 50 * 10000){
+      c1 = clock::now();
+      VERIFY(c1 >= prev);
+      prev = c1;
+    }
+    const int64_t r1 = reference_time();
+    c1 = clock::now();
+    page.stop = true;
+    writer.join();
+
+    if(tsc){
+      // within 0.5% of the reference
+      const int64_t elapsed = c1 - c0, expected = (r1 - r0) * 100;
+      VERIFY(elapsed > expected - expected / 200 && elapsed < expected + expected / 200);
+    }
+  }
+
+  // the real clocks never go back
+  template<class Clock>
+  void monotonic()
+  {
+    typename Clock::time_point prev = Clock::now();
+    for(unsigned i = 0; i < 1000000; i++){
+      const typename Clock::time_point t = Clock::now();
+      VERIFY(t >= prev);
+      prev = t;
+    }
+  }
+
+  void test03()
+  {
+    monotonic<steady_clock>();
+    monotonic<high_resolution_clock>();
+    high_resolution_clock::calibrate();
+    monotonic<high_resolution_clock>();
+    monotonic<monotonic_clock>();
+
+    const steady_clock::time_point s0 = steady_clock::now();
+    const high_resolution_clock::time_point h0 = high_resolution_clock::now();
+    while(steady_clock::now() - s0 < milliseconds(100))
+      ;
+    const nanoseconds hd = high_resolution_clock::now() - h0;
+    VERIFY(hd >= milliseconds(80) && hd <= milliseconds(150));
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // cost of now()
+
+  template<class Clock>
+  uint64_t now_cost()
+  {
+    static const unsigned iterations = 10000000;
+    volatile typename Clock::rep sink = 0;
+    const high_resolution_clock::time_point t = high_resolution_clock::now();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += Clock::now().time_since_epoch().count();
+    return static_cast<uint64_t>((high_resolution_clock::now() - t).count() * 1000 / iterations);
+  }
+
+  void bench()
+  {
+    high_resolution_clock::calibrate();
+    const uint64_t hires = now_cost<high_resolution_clock>();
+    const uint64_t steady = now_cost<steady_clock>();
+    const uint64_t system = now_cost<system_clock>();
+
+    ntl::nt::systime_t st;
+    const high_resolution_clock::time_point t = high_resolution_clock::now();
+    for(unsigned i = 0; i < 1000000; i++)
+      ntl::nt::NtQuerySystemTime(&st);
+    const uint64_t syscall = static_cast<uint64_t>((high_resolution_clock::now() - t).count());
+
+    dbg::trace.printf("high_resolution_clock::now: %I64u ps/call\n", hires);
+    dbg::trace.printf("steady_clock::now:          %I64u ps/call\n", steady);
+    dbg::trace.printf("system_clock::now:          %I64u ps/call\n", system);
+    dbg::trace.printf("NtQuerySystemTime:          %I64u ps/call\n", syscall);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
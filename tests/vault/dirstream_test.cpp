@@ -0,0 +1,240 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <tr2/filesystem.hxx>
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+namespace fs = std::tr2::sys::filesystem;
+
+namespace
+{
+  using namespace ntl::nt;
+  typedef file_id_both_dir_information entry_type;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Mock of the ZwOpenFile/ZwQueryDirectoryFile pair over an in-memory directory,
+  // it packs the entries the same way the file systems do. The redirector rejects the entries with the file ids.
+
+  struct mock_directory
+  {
+    std::vector<std::wstring> names;
+    unsigned queries;
+    uint64_t bytes;
+    bool redirector;
+  } directory;
+
+  void set_id(entry_type* e, size_t id) { e->FileId = id; }
+  void set_id(file_directory_information*, size_t) {}
+
+  struct mock_directory_api
+  {
+    struct handle_type
+    {
+      size_t pos;
+      bool opened;
+      handle_type() : pos(), opened() {}
+    };
+
+    static ntstatus open(handle_type& h, const const_unicode_string&)
+    {
+      h.opened = true, h.pos = 0;
+      return status::success;
+    }
+
+    static ntstatus query(handle_type& h, void* buf, uint32_t size, bool restart, file_information_class info_class)
+    {
+      assert(h.opened);
+      directory.queries++;
+      if(info_class == entry_type::info_class_type)
+        return directory.redirector ? status::invalid_info_class : pack<entry_type>(h, buf, size, restart);
+      assert(info_class == file_directory_information::info_class_type);
+      return pack<file_directory_information>(h, buf, size, restart);
+    }
+
+    template<class Entry>
+    static ntstatus pack(handle_type& h, void* buf, uint32_t size, bool restart)
+    {
+      if(restart)
+        h.pos = 0;
+      if(h.pos == directory.names.size())
+        return status::no_more_files;
+
+      char* const base = static_cast<char*>(buf);
+      uint32_t offset = 0;
+      Entry* prev = nullptr;
+      for(; h.pos < directory.names.size(); h.pos++){
+        const std::wstring& name = directory.names[h.pos];
+        const uint32_t length = static_cast<uint32_t>(offsetof(Entry, FileName) + name.size() * sizeof(wchar_t));
+        if(offset + length > size)
+          break;
+        Entry* e = reinterpret_cast<Entry*>(base + offset);
+        std::memset(e, 0, offsetof(Entry, FileName));
+        e->FileAttributes = h.pos % 10 == 0 ? file_attribute::directory : file_attribute::normal;
+        e->EndOfFile = h.pos;
+        set_id(e, h.pos + 1);
+        e->FileNameLength = static_cast<uint32_t>(name.size() * sizeof(wchar_t));
+        std::memcpy(e->FileName, name.data(), e->FileNameLength);
+        if(prev)
+          prev->NextEntryOffset = static_cast<uint32_t>(reinterpret_cast<char*>(e) - reinterpret_cast<char*>(prev));
+        prev = e;
+        offset = (offset + length + 7) & ~7u;
+      }
+      if(!prev)
+        return status::buffer_overflow;
+      directory.bytes += offset;
+      return status::success;
+    }
+
+    static void close(handle_type& h)
+    {
+      h.opened = false;
+    }
+  };
+
+  typedef fs::__::directory_stream<mock_directory_api> mock_stream;
+
+  void make_directory(size_t count)
+  {
+    directory.names.clear();
+    directory.names.push_back(L".");
+    directory.names.push_back(L"..");
+    wchar_t name[32];
+    for(size_t i = 0; i < count; i++){
+      _snwprintf(name, _countof(name), L"file_%08u.dat", static_cast<unsigned>(i));
+      directory.names.push_back(name);
+    }
+    directory.queries = 0, directory.bytes = 0;
+  }
+
+  // every entry is read once and in order
+  void test01()
+  {
+    static const size_t counts[] = { 0, 1, 100, 5000, 100000 };
+    for(size_t n = 0; n < _countof(counts); n++){
+      make_directory(counts[n]);
+      mock_stream s;
+      VERIFY(success(s.open(const_unicode_string(L"\\mock"))));
+      size_t i = 0;
+      for(; s.entry(); s.next(), i++){
+        const entry_type* e = s.id_entry();
+        VERIFY(e && e->FileId == i + 3 && directory.names[i + 2] == std::wstring(e->FileName, e->FileNameLength / sizeof(wchar_t)));
+      }
+      VERIFY(i == counts[n]);
+      // each entry is transferred once, in the full buffers
+      VERIFY(directory.queries <= 2 + directory.bytes / (mock_stream::buffer_size / 2));
+    }
+  }
+
+  // the real directory: the iterator sees the same entries as the stream
+  void test02()
+  {
+    const fs::path dir = fs::initial_path();
+    fs::__::directory_stream<> s;
+    size_t streamed = 0;
+    if(success(s.open(const_unicode_string(dir.external_file_string()))))
+      for(; s.entry(); s.next())
+        streamed++;
+
+    size_t iterated = 0;
+    for(fs::directory_iterator it(dir), end; it != end; ++it){
+      iterated++;
+      VERIFY(it->info().file_id != 0 || it->info().attributes != 0);
+      // the cached status needs no open
+      if(!(it->info().attributes & file_attribute::reparse_point))
+        VERIFY(fs::status_known(it->status()));
+    }
+    VERIFY(streamed == iterated);
+  }
+
+  // the redirector rejects the file ids: the stream falls back once and reads the plain entries
+  void test03()
+  {
+    make_directory(3000);
+    directory.redirector = true;
+    mock_stream s;
+    VERIFY(success(s.open(const_unicode_string(L"\\mock"))));
+    VERIFY(s.entry() && !s.id_entry());
+    const unsigned first_queries = directory.queries;
+    size_t i = 0;
+    for(; s.entry(); s.next(), i++){
+      const const_unicode_string name = s.name();
+      VERIFY(directory.names[i + 2] == std::wstring(name.begin(), name.size()) && s.entry()->EndOfFile == int64_t(i + 2));
+      if(i == 10){
+        fs::directory_entry de;
+        fs::__::assign_directory_entry(de, fs::path("\\mock"), s);
+        VERIFY(de.path().leaf() == "file_00000010.dat" && de.info().attributes == file_attribute::directory);
+        VERIFY(!de.info().has_file_id && de.symlink_status().type() == fs::directory_file);
+      }
+    }
+    VERIFY(i == 3000 && first_queries == 2 && !s.id_entry());
+    // the fallback is remembered: the rejected class is queried once
+    VERIFY(directory.queries <= 3 + directory.bytes / (mock_stream::buffer_size / 2));
+    directory.redirector = false;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the previous whole-directory load: restart with a growing buffer until everything fits
+
+  size_t legacy_load(mock_directory_api::handle_type& h)
+  {
+    uint32_t size = (sizeof(file_directory_information) + 32) * 64;
+    std::vector<char> buf;
+    ntstatus st;
+    do{
+      buf.resize(size *= 4);
+      st = mock_directory_api::query(h, &buf[0], size, true, entry_type::info_class_type);
+      if(success(st)){
+        char tmp[sizeof(entry_type) + 64];
+        st = mock_directory_api::query(h, tmp, sizeof(tmp), false, entry_type::info_class_type);
+        st = st == status::no_more_files ? status::success : status::buffer_overflow;
+      }
+    } while(st == status::buffer_overflow);
+    return buf.size();
+  }
+
+  void bench()
+  {
+    make_directory(100000);
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    mock_directory_api::handle_type h;
+    mock_directory_api::open(h, const_unicode_string(L"\\mock"));
+    const size_t legacy_memory = legacy_load(h);
+    const uint64_t t_legacy = ntl::intrinsic::rdtsc() - t;
+    const uint64_t legacy_bytes = directory.bytes;
+    const unsigned legacy_queries = directory.queries;
+
+    directory.queries = 0, directory.bytes = 0;
+    t = ntl::intrinsic::rdtsc();
+    mock_stream s;
+    s.open(const_unicode_string(L"\\mock"));
+    size_t n = 0;
+    for(; s.entry(); s.next())
+      n++;
+    const uint64_t t_stream = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("100k entries, whole load: %u queries, %I64u bytes copied, %u KB buffer, %I64u cycles\n",
+      legacy_queries, legacy_bytes, static_cast<unsigned>(legacy_memory / 1024), t_legacy);
+    dbg::trace.printf("100k entries, streaming:  %u queries, %I64u bytes copied, %u KB buffer, %I64u cycles\n",
+      directory.queries, directory.bytes, mock_stream::buffer_size / 1024, t_stream);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,380 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <tr2/filesystem.hxx>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <cstring>
+#include <stdexcept>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+namespace fs = std::tr2::sys::filesystem;
+
+namespace
+{
+  using namespace ntl::nt;
+  typedef file_id_both_dir_information entry_type;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Stand-in filesystem: the directory tree in memory behind the ZwOpenFile/ZwQueryDirectoryFile pair,
+  // it counts the directories opened at once and may delay each query to model the I/O latency.
+
+  struct mock_node
+  {
+    std::wstring name;
+    uint32_t attributes;
+  };
+
+  struct mock_tree
+  {
+    std::map<std::wstring, std::vector<mock_node> > dirs;
+    std::set<std::wstring> denied;
+    std::mutex guard;
+    unsigned opened, max_opened;
+    unsigned latency_ms;
+  } tree;
+
+  struct mock_directory_api
+  {
+    struct handle_type
+    {
+      const std::vector<mock_node>* dir;
+      size_t pos;
+      handle_type() : dir(), pos() {}
+    };
+
+    static ntstatus open(handle_type& h, const const_unicode_string& name)
+    {
+      close(h);
+      const std::wstring key(name.begin(), name.size());
+      if(tree.denied.count(key))
+        return status::access_denied;
+      std::map<std::wstring, std::vector<mock_node> >::const_iterator it = tree.dirs.find(key);
+      if(it == tree.dirs.end())
+        return status::object_name_not_found;
+      std::lock_guard<std::mutex> lock(tree.guard);
+      if(++tree.opened > tree.max_opened)
+        tree.max_opened = tree.opened;
+      h.dir = &it->second, h.pos = 0;
+      return status::success;
+    }
+
+    static void close(handle_type& h)
+    {
+      if(h.dir){
+        std::lock_guard<std::mutex> lock(tree.guard);
+        tree.opened--;
+        h.dir = nullptr;
+      }
+    }
+
+    static ntstatus query(handle_type& h, void* buf, uint32_t size, bool restart, file_information_class info_class)
+    {
+      assert(h.dir && info_class == entry_type::info_class_type);
+      if(tree.latency_ms)
+        std::this_thread::sleep_for(std::chrono::milliseconds(tree.latency_ms));
+      if(restart)
+        h.pos = 0;
+      if(h.pos == h.dir->size())
+        return status::no_more_files;
+
+      char* const base = static_cast<char*>(buf);
+      uint32_t offset = 0;
+      entry_type* prev = nullptr;
+      for(; h.pos < h.dir->size(); h.pos++){
+        const mock_node& node = (*h.dir)[h.pos];
+        const uint32_t length = static_cast<uint32_t>(offsetof(entry_type, FileName) + node.name.size() * sizeof(wchar_t));
+        if(offset + length > size)
+          break;
+        entry_type* e = reinterpret_cast<entry_type*>(base + offset);
+        std::memset(e, 0, offsetof(entry_type, FileName));
+        e->FileAttributes = node.attributes;
+        e->FileId = h.pos + 1;
+        e->FileNameLength = static_cast<uint32_t>(node.name.size() * sizeof(wchar_t));
+        std::memcpy(e->FileName, node.name.data(), e->FileNameLength);
+        if(prev)
+          prev->NextEntryOffset = static_cast<uint32_t>(reinterpret_cast<char*>(e) - reinterpret_cast<char*>(prev));
+        prev = e;
+        offset = (offset + length + 7) & ~7u;
+      }
+      return prev ? status::success : status::buffer_overflow;
+    }
+  };
+
+  const fs::wpath root(L"\\mock");
+
+  std::wstring key_of(const fs::wpath& p)
+  {
+    return p.external_file_string();
+  }
+
+  // builds the tree of `depth` levels with `subdirs` directories and `files` files in each directory,
+  // returns the number of the entries below the root
+  size_t make_tree(const fs::wpath& dir, unsigned depth, unsigned subdirs, unsigned files)
+  {
+    std::vector<mock_node>& nodes = tree.dirs[key_of(dir)];
+    nodes.clear();
+    mock_node dots[2] = { { L".", file_attribute::directory }, { L"..", file_attribute::directory } };
+    nodes.insert(nodes.end(), dots, dots + 2);
+    size_t count = 0;
+    wchar_t name[32];
+    for(unsigned i = 0; i < files; i++){
+      _snwprintf(name, _countof(name), L"file_%04u.dat", i);
+      const mock_node node = { name, file_attribute::normal };
+      nodes.push_back(node);
+      count++;
+    }
+    if(depth)
+      for(unsigned i = 0; i < subdirs; i++){
+        _snwprintf(name, _countof(name), L"dir_%u", i);
+        const mock_node node = { name, file_attribute::directory };
+        tree.dirs[key_of(dir)].push_back(node);
+        count += 1 + make_tree(dir / name, depth - 1, subdirs, files);
+      }
+    return count;
+  }
+
+  void reset_tree()
+  {
+    tree.dirs.clear();
+    tree.denied.clear();
+    tree.opened = tree.max_opened = 0;
+    tree.latency_ms = 0;
+  }
+
+  typedef fs::directory_walk_batch<fs::wpath> batch_type;
+
+  struct collector
+  {
+    std::set<std::wstring> paths;
+    std::map<std::wstring, unsigned> last_batches;
+    size_t batches, max_batch, links;
+    unsigned max_level;
+    size_t cancel_after;
+    std::wstring prune;
+
+    collector() : batches(), max_batch(), links(), max_level(), cancel_after(~size_t(0)) {}
+
+    void operator()(batch_type& batch)
+    {
+      batches++;
+      if(batch.size() > max_batch)
+        max_batch = batch.size();
+      if(batch.last())
+        last_batches[batch.directory().string()]++;
+      if(batch.level() > max_level)
+        max_level = batch.level();
+      for(size_t i = 0; i < batch.size(); i++){
+        const bool inserted = paths.insert(batch[i].path().string()).second;
+        VERIFY(inserted);
+        if(!prune.empty() && batch[i].path().leaf() == prune)
+          batch.prune(i);
+        if(fs::is_symlink(batch[i].symlink_status()))
+          links++;
+      }
+      if(paths.size() >= cancel_after)
+        batch.cancel();
+    }
+  };
+
+  template<class Visitor>
+  fs::directory_walk_result walk(Visitor& visitor, const fs::directory_walk_options& opt)
+  {
+    return fs::__::directory_walker<fs::wpath, Visitor, mock_directory_api>(visitor, opt)(root);
+  }
+
+  // every entry is visited once whatever the number of threads and the batch size is
+  void test01()
+  {
+    reset_tree();
+    const size_t total = make_tree(root, 4, 4, 10);
+    const size_t directories = tree.dirs.size();
+
+    static const unsigned threads[] = { 1, 2, 8 };
+    static const unsigned batches[] = { 1, 7, 256 };
+    for(size_t t = 0; t < _countof(threads); t++)
+      for(size_t b = 0; b < _countof(batches); b++){
+        fs::directory_walk_options opt;
+        opt.threads = threads[t];
+        opt.batch_size = batches[b];
+        collector c;
+        const fs::directory_walk_result re = walk(c, opt);
+        VERIFY(!re.ec && re.errors == 0 && !re.cancelled);
+        VERIFY(re.entries == total && c.paths.size() == total);
+        VERIFY(re.directories == directories);
+        VERIFY(c.max_batch <= batches[b] && c.max_level == 4);
+        // one last batch per directory
+        VERIFY(c.last_batches.size() == directories);
+        for(std::map<std::wstring, unsigned>::const_iterator it = c.last_batches.begin(); it != c.last_batches.end(); ++it)
+          VERIFY(it->second == 1);
+        VERIFY(tree.opened == 0 && tree.max_opened <= threads[t]);
+      }
+
+    // the open directories are bounded
+    fs::directory_walk_options opt;
+    opt.threads = 16;
+    opt.max_open_handles = 3;
+    tree.max_opened = 0;
+    tree.latency_ms = 1;
+    collector c;
+    VERIFY(walk(c, opt).entries == total);
+    VERIFY(tree.max_opened <= 3);
+  }
+
+  // pruning and depth limit
+  void test02()
+  {
+    reset_tree();
+    const size_t total = make_tree(root, 3, 3, 2);
+
+    // the pruned directory is visited, its content is not
+    fs::directory_walk_options opt;
+    opt.threads = 4;
+    collector c;
+    c.prune = L"dir_1";
+    const fs::directory_walk_result re = walk(c, opt);
+    for(std::set<std::wstring>::const_iterator it = c.paths.begin(); it != c.paths.end(); ++it)
+      VERIFY(it->find(L"dir_1/") == std::wstring::npos && it->find(L"dir_1\\") == std::wstring::npos);
+    VERIFY(c.paths.count((root / L"dir_1").string()) == 1);
+    VERIFY(re.entries < total && !re.cancelled);
+
+    // max_depth = 1 reads the root and its subdirectories only
+    opt.max_depth = 1;
+    collector c2;
+    const fs::directory_walk_result re2 = walk(c2, opt);
+    VERIFY(re2.directories == 4 && c2.max_level == 1 && re2.entries == 5 + 3 * 5);
+  }
+
+  // reparse points, errors, cancellation
+  void test03()
+  {
+    reset_tree();
+    const size_t total = make_tree(root, 2, 2, 3);
+    // a junction to the directory with one file
+    const mock_node junction = { L"link", file_attribute::directory | file_attribute::reparse_point };
+    tree.dirs[key_of(root)].push_back(junction);
+    const mock_node file = { L"target.txt", file_attribute::normal };
+    tree.dirs[key_of(root / L"link")].push_back(file);
+
+    fs::directory_walk_options opt;
+    opt.threads = 2;
+    collector c;
+    fs::directory_walk_result re = walk(c, opt);
+    VERIFY(re.entries == total + 1 && c.paths.count((root / L"link").string()) == 1);
+
+    opt.follow_reparse_points = true;
+    collector c2;
+    re = walk(c2, opt);
+    VERIFY(re.entries == total + 2 && c2.paths.count((root / L"link" / L"target.txt").string()) == 1);
+
+    // the reparse point status is known without an open
+    VERIFY(c.links == 1 && c2.links == 1);
+
+    // a denied directory doesn't stop the walk
+    opt.follow_reparse_points = false;
+    tree.denied.insert(key_of(root / L"dir_0"));
+    collector c3;
+    re = walk(c3, opt);
+    VERIFY(re.errors == 1 && re.ec && re.entries == total + 1 - (2 * 3 + 3 + 2));
+    tree.denied.clear();
+
+    // the missing root
+    collector c4;
+    re = fs::__::directory_walker<fs::wpath, collector, mock_directory_api>(c4, opt)(fs::wpath(L"\\nonexistent"));
+    VERIFY(re.errors == 1 && re.ec && re.entries == 0 && re.directories == 0);
+
+    // cancelled by the visitor
+    opt.threads = 4;
+    opt.batch_size = 1;
+    collector c5;
+    c5.cancel_after = 5;
+    re = walk(c5, opt);
+    VERIFY(re.cancelled && re.entries < total && tree.opened == 0);
+
+    // cancelled by the flag before the start
+    volatile bool stop = true;
+    opt.cancel = &stop;
+    collector c6;
+    re = walk(c6, opt);
+    VERIFY(re.cancelled && re.entries == 0);
+  }
+
+  // the exception of the visitor is rethrown by the calling thread after the workers are stopped
+  struct thrower
+  {
+    size_t throw_after;
+    mutable size_t calls;
+    void operator()(batch_type&) const
+    {
+      if(++calls == throw_after)
+        throw std::runtime_error("visitor");
+    }
+  };
+
+  void test04()
+  {
+#if STLX__USE_EXCEPTIONS
+    reset_tree();
+    make_tree(root, 3, 3, 2);
+    for(unsigned threads = 1; threads <= 4; threads *= 4){
+      fs::directory_walk_options opt;
+      opt.threads = threads;
+      opt.batch_size = 1;
+      const thrower t = { 3, 0 };
+      bool thrown = false;
+      try{
+        fs::__::directory_walker<fs::wpath, const thrower, mock_directory_api>(t, opt)(root);
+      }
+      catch(const std::runtime_error&){
+        thrown = true;
+      }
+      VERIFY(thrown && t.calls >= 3 && tree.opened == 0);
+    }
+#endif
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the walk of a latency bound tree: single worker (as recursive_directory_iterator) against the pool
+
+  void bench()
+  {
+    reset_tree();
+    const size_t total = make_tree(root, 3, 6, 20);
+    tree.latency_ms = 1;
+
+    static const unsigned threads[] = { 1, 4, 16, 64 };
+    for(size_t t = 0; t < _countof(threads); t++){
+      fs::directory_walk_options opt;
+      opt.threads = threads[t];
+      collector c;
+      const uint64_t start = ntl::intrinsic::rdtsc();
+      const fs::directory_walk_result re = walk(c, opt);
+      const uint64_t cycles = ntl::intrinsic::rdtsc() - start;
+      VERIFY(re.entries == total);
+      dbg::trace.printf("%u directories, %u entries, %2u threads: %I64u Mcycles, %u open at once\n",
+        static_cast<unsigned>(re.directories), static_cast<unsigned>(total), threads[t], cycles / 1000000, tree.max_opened);
+      tree.max_opened = 0;
+    }
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    test04();
+    bench();
+  }
+}
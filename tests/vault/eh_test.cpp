@@ -0,0 +1,206 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <nt/exception.hxx>
+#include <stdexcept>
+#include <cstring>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  int alive;
+
+  // counts the objects destroyed by the unwinding
+  struct guard
+  {
+    guard() { ++alive; }
+    ~guard() { --alive; }
+  };
+
+  struct error
+  {
+    explicit error(int code): code(code) {}
+    virtual ~error() {}
+    int code;
+  };
+
+  struct parse_error: error
+  {
+    explicit parse_error(int code): error(code) {}
+  };
+
+  // the catch of the second base adjusts the object pointer
+  struct tag
+  {
+    tag(): mark(0x7A6) {}
+    virtual ~tag() {}
+    int mark;
+  };
+
+  struct tagged_error: parse_error, tag
+  {
+    explicit tagged_error(int code): parse_error(code) {}
+  };
+
+  template<class E>
+  void throw_deep(int depth, const E& e)
+  {
+    guard g;
+    if ( depth == 0 )
+      throw e;
+    throw_deep(depth - 1, e);
+  }
+
+  // the matches are repeated to check them from the cache too
+  void test01()
+  {
+    for ( int pass = 0; pass < 3; pass++ )
+    {
+      int caught = 0;
+      try { throw_deep(8, parse_error(1)); }
+      catch(const tagged_error&) { VERIFY(false); }
+      catch(const error& e) { caught = e.code; }
+      VERIFY(caught == 1 && alive == 0);
+
+      try { throw_deep(3, tagged_error(2)); }
+      catch(tag& t) { caught = t.mark; }
+      VERIFY(caught == 0x7A6 && alive == 0);
+
+      try { throw_deep(3, tagged_error(3)); }
+      catch(parse_error& e) { caught = e.code; }
+      VERIFY(caught == 3);
+
+      static tagged_error object(4);
+      try { throw_deep(2, &object); }
+      catch(const tag* t) { caught = t == static_cast<tag*>(&object) ? t->mark : -1; }
+      VERIFY(caught == 0x7A6);
+
+      try { throw_deep(2, 5); }
+      catch(long) { VERIFY(false); }
+      catch(const int& i) { caught = i; }
+      VERIFY(caught == 5);
+
+      try { throw_deep(1, std::out_of_range("range")); }
+      catch(const std::logic_error&) { caught = 6; }
+      VERIFY(caught == 6);
+
+      try { throw_deep(1, 7.0); }
+      catch(int) { VERIFY(false); }
+      catch(...) { caught = 7; }
+      VERIFY(caught == 7 && alive == 0);
+    }
+  }
+
+  // the nested handlers and the rethrow
+  void test02()
+  {
+    int caught = 0;
+    try
+    {
+      try
+      {
+        guard g;
+        throw_deep(4, parse_error(10));
+      }
+      catch(const parse_error& e)
+      {
+        VERIFY(alive == 0);
+        caught = e.code;
+        throw;
+      }
+    }
+    catch(error& e)
+    {
+      caught += e.code;
+    }
+    VERIFY(caught == 20 && alive == 0);
+
+    try
+    {
+      try { throw_deep(2, error(1)); }
+      catch(const error&) { throw parse_error(30); }
+    }
+    catch(const parse_error& e)
+    {
+      caught = e.code;
+    }
+    VERIFY(caught == 30 && alive == 0);
+  }
+
+  // the distinct type_info records of the same and of the other types, as if they
+  // were in the different modules, and a record whose address is reused
+  struct type_record
+  {
+    const void* vptr;
+    void*       spare;
+    char        name[16];
+  };
+
+  const type_info& type_of(const type_record& r)
+  {
+    return *reinterpret_cast<const type_info*>(&r);
+  }
+
+  void test03()
+  {
+    using ntl::cxxruntime::type_match_cache;
+    type_match_cache& cache = type_match_cache::instance();
+    type_record a = { 0, 0, ".?AUerror@@" }, b = { 0, 0, ".?AUerror@@" }, c = { 0, 0, ".?AUother@@" };
+    for ( int pass = 0; pass < 3; pass++ )
+    {
+      VERIFY(cache.equal(&type_of(a), &type_of(b)) && cache.equal(&type_of(b), &type_of(a)));
+      VERIFY(!cache.equal(&type_of(a), &type_of(c)) && !cache.equal(&type_of(c), &type_of(b)));
+    }
+
+    // the module of `c` is unloaded and the next one has `error` at its address
+    VERIFY(!cache.equal(&type_of(a), &type_of(c)));
+    c.spare = 0;
+    std::strcpy(c.name, ".?AUerror@@");
+    VERIFY(!cache.equal(&type_of(a), &type_of(c)));
+    ntl::cxxruntime::flush_type_caches();
+    VERIFY(cache.equal(&type_of(a), &type_of(c)) && cache.equal(&type_of(a), &type_of(c)));
+    VERIFY(cache.equal(&type_of(a), &type_of(b)));
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+
+  template<class E>
+  uint64_t throw_cycles(int depth, const E& e)
+  {
+    static const int count = 2000;
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    for ( int i = 0; i < count; i++ )
+      try { throw_deep(depth, e); }
+      catch(const error&) {}
+    return (ntl::intrinsic::rdtsc() - t) / count;
+  }
+
+  void bench()
+  {
+    const uint64_t t1 = throw_cycles(0, parse_error(0));
+    const uint64_t t16 = throw_cycles(16, parse_error(0));
+    const uint64_t t16b = throw_cycles(16, tagged_error(0));
+    dbg::trace.printf("throw/catch: 1 frame %6I64u, 16 frames %6I64u, 16 frames of the multiple bases %6I64u cycles\n",
+      t1, t16, t16b);
+  }
+
+  void main()
+  {
+    // the first throw of the thread does not allocate then
+    static ntl::cxxruntime::tiddata state;
+    ntl::cxxruntime::reserve_exception_state(&state);
+
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
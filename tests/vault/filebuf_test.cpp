@@ -0,0 +1,194 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <fstream>
+#include <vector>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  const char test_file[] = "filebuf_test.bin";
+
+  void fill(std::vector<char>& v, unsigned seed)
+  {
+    for(size_t i = 0; i < v.size(); i++)
+      seed = seed * 1103515245 + 12345, v[i] = static_cast<char>(seed >> 16);
+  }
+
+  bool verify_file(const std::vector<char>& expected)
+  {
+    std::ifstream f(test_file, std::ios::binary);
+    std::vector<char> v(expected.size() + 16);
+    f.read(&v[0], static_cast<std::streamsize>(v.size()));
+    return static_cast<size_t>(f.gcount()) == expected.size() && std::equal(expected.begin(), expected.end(), v.begin());
+  }
+
+  // mixed small and bulk writes and reads
+  void test01()
+  {
+    std::vector<char> data(3 * 1024 * 1024 + 77);
+    fill(data, 1);
+    {
+      std::ofstream f(test_file, std::ios::binary|std::ios::trunc);
+      size_t pos = 0;
+      const size_t chunks[] = { 1, 100, 70000, 5, 1024*1024, 3, 200000 };
+      for(size_t i = 0; pos < data.size(); i = (i + 1) % _countof(chunks)){
+        const size_t n = std::min(chunks[i], data.size() - pos);
+        VERIFY(f.write(&data[pos], static_cast<std::streamsize>(n)));
+        pos += n;
+      }
+    }
+    VERIFY(verify_file(data));
+
+    std::ifstream f(test_file, std::ios::binary);
+    std::vector<char> v(data.size());
+    f.read(&v[0], 10);
+    f.read(&v[10], 2 * 1024 * 1024);  // bypasses the buffer
+    f.read(&v[10 + 2 * 1024 * 1024], static_cast<std::streamsize>(data.size() - 10 - 2 * 1024 * 1024));
+    VERIFY(f && v == data);
+  }
+
+  // tunable buffers
+  void test02()
+  {
+    std::vector<char> data(1000000);
+    fill(data, 2);
+    {
+      std::ofstream f;
+      VERIFY(f.rdbuf()->pubsetbuf(nullptr, 1024*1024) != nullptr);
+      f.open(test_file, std::ios::binary|std::ios::trunc);
+      for(size_t i = 0; i < data.size(); i++)
+        f.put(data[i]);
+    }
+    VERIFY(verify_file(data));
+    {
+      // unbuffered
+      std::ofstream f;
+      f.rdbuf()->pubsetbuf(nullptr, 0);
+      f.open(test_file, std::ios::binary|std::ios::trunc);
+      f.write(&data[0], 1000);
+    }
+    VERIFY(verify_file(std::vector<char>(data.begin(), data.begin() + 1000)));
+  }
+
+  // direct I/O with a size which isn't a multiple of the sector
+  void test03()
+  {
+    std::vector<char> data(5 * 1024 * 1024 + 123);
+    fill(data, 3);
+    {
+      std::ofstream f(test_file, std::ios::binary|std::ios::trunc|std::ios::direct|std::ios::sequential);
+      VERIFY(f.is_open());
+      for(size_t pos = 0; pos < data.size(); pos += 1000)
+        f.write(&data[pos], static_cast<std::streamsize>(std::min<size_t>(1000, data.size() - pos)));
+      f.flush();
+    }
+    VERIFY(verify_file(data));
+    {
+      std::ifstream f(test_file, std::ios::binary|std::ios::direct);
+      VERIFY(f.is_open());
+      std::vector<char> v(data.size());
+      f.read(&v[0], static_cast<std::streamsize>(v.size()));
+      VERIFY(v == data);
+
+      // only the sector boundaries are reachable
+      VERIFY(f.rdbuf()->pubseekoff(100, std::ios::beg) == std::streampos(-1));
+      VERIFY(f.rdbuf()->pubseekpos(8192) == std::streampos(8192));
+      char c;
+      VERIFY(f.get(c) && c == data[8192]);
+      VERIFY(f.rdbuf()->pubseekoff(4095, std::ios::cur) == std::streampos(12288));
+      VERIFY(f.rdbuf()->pubseekoff(-1, std::ios::cur) == std::streampos(-1));
+    }
+
+    // the tail of the last sector stays in the buffer, which is not replaced then
+    {
+      std::ofstream f(test_file, std::ios::binary|std::ios::trunc|std::ios::direct);
+      f.write(&data[0], 8192);
+      VERIFY(f.rdbuf()->pubsetbuf(nullptr, 64 * 1024) != nullptr);
+      f.write(&data[8192], 100);
+      VERIFY(f.rdbuf()->pubsetbuf(nullptr, 128 * 1024) == nullptr);
+      f.write(&data[8292], 50);
+    }
+    VERIFY(verify_file(std::vector<char>(data.begin(), data.begin() + 8342)));
+
+    // text, append and unaligned buffers are rejected
+    std::ofstream f1(test_file, std::ios::direct);
+    VERIFY(!f1.is_open());
+    std::ofstream f2(test_file, std::ios::binary|std::ios::app|std::ios::direct);
+    VERIFY(!f2.is_open());
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // write and read throughput across buffer sizes
+
+  void bench()
+  {
+    static const size_t total = 512 * 1024 * 1024;
+    static const size_t record = 100;
+    std::vector<char> data(1024 * 1024);
+    fill(data, 4);
+
+    const std::streamsize sizes[] = { 4*1024, 16*1024, 64*1024, 256*1024, 1024*1024, 4*1024*1024 };
+    for(size_t i = 0; i < _countof(sizes); i++){
+      for(int direct = 0; direct < 2; direct++){
+        const std::ios::openmode mode = static_cast<std::ios::openmode>(std::ios::binary|std::ios::sequential|(direct ? std::ios::direct : 0));
+
+        uint64_t t = ntl::intrinsic::rdtsc();
+        {
+          std::ofstream f;
+          f.rdbuf()->pubsetbuf(nullptr, sizes[i]);
+          f.open(test_file, mode|std::ios::trunc);
+          for(size_t pos = 0; pos < total; pos += record)
+            f.write(&data[pos % (data.size() - record)], record);
+        }
+        const uint64_t t_write = ntl::intrinsic::rdtsc() - t;
+
+        t = ntl::intrinsic::rdtsc();
+        {
+          std::ifstream f;
+          f.rdbuf()->pubsetbuf(nullptr, sizes[i]);
+          f.open(test_file, mode);
+          char buf[record];
+          while(f.read(buf, record));
+        }
+        const uint64_t t_read = ntl::intrinsic::rdtsc() - t;
+
+        dbg::trace.printf("buffer %7u%s: write %I64u, read %I64u cycles/KB\n", static_cast<unsigned>(sizes[i]), direct ? " direct" : "       ",
+          t_write / (total / 1024), t_read / (total / 1024));
+      }
+    }
+
+    // bulk transfers which bypass the buffer
+    uint64_t t = ntl::intrinsic::rdtsc();
+    {
+      std::ofstream f(test_file, std::ios::binary|std::ios::trunc);
+      for(size_t pos = 0; pos < total; pos += data.size())
+        f.write(&data[0], static_cast<std::streamsize>(data.size()));
+    }
+    const uint64_t t_write = ntl::intrinsic::rdtsc() - t;
+    t = ntl::intrinsic::rdtsc();
+    {
+      std::ifstream f(test_file, std::ios::binary);
+      while(f.read(&data[0], static_cast<std::streamsize>(data.size())));
+    }
+    const uint64_t t_read = ntl::intrinsic::rdtsc() - t;
+    dbg::trace.printf("bulk 1 MB records: write %I64u, read %I64u cycles/KB\n", t_write / (total / 1024), t_read / (total / 1024));
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,283 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <flat_map.hxx>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  typedef std::pair<int, int> value_type;
+
+  bool by_key(const value_type& x, const value_type& y) { return x.first < y.first; }
+
+  // the reference vectors have no const key
+  bool equivalent(const std::pair<const int, int>& x, const value_type& y) { return x.first == y.first && x.second == y.second; }
+
+  template<class Map>
+  bool same(const Map& t, const std::map<int, int>& r)
+  {
+    if ( t.size() != r.size() )
+      return false;
+    typename Map::const_iterator i = t.begin();
+    for ( std::map<int, int>::const_iterator j = r.begin(); j != r.end(); ++i, ++j )
+      if ( i->first != j->first || i->second != j->second )
+        return false;
+    return true;
+  }
+
+  // the bounds of every layout are the bounds of the reference
+  template<class Map>
+  void lookup(const Map& t, const std::map<int, int>& r, int keys)
+  {
+    VERIFY(same(t, r));
+    for ( int key = -1; key <= keys; key++ )
+    {
+      const typename Map::const_iterator l = t.lower_bound(key), u = t.upper_bound(key), f = t.find(key);
+      const std::map<int, int>::const_iterator rl = r.lower_bound(key), ru = r.upper_bound(key);
+      VERIFY(l - t.begin() == std::distance(r.begin(), rl));
+      VERIFY(u - t.begin() == std::distance(r.begin(), ru));
+      VERIFY((f != t.end()) == (r.find(key) != r.end()) && (f == t.end() || f == l));
+      VERIFY(t.count(key) == r.count(key));
+    }
+  }
+
+  template<class Layout>
+  void layout_ops(int keys, size_t count)
+  {
+    typedef flat_map<int, int, std::less<int>, std::allocator<value_type>, Layout> map_type;
+
+    // the bulk construction keeps the first of the equal keys
+    std::vector<value_type> input;
+    std::map<int, int> r;
+    for ( size_t i = 0; i < count; i++ )
+    {
+      input.push_back(value_type(static_cast<int>(random(keys)), static_cast<int>(i)));
+      r.insert(input.back());
+    }
+    map_type t(input.begin(), input.end());
+    lookup(t, r, keys);
+
+    // the batches are merged
+    for ( int batch = 0; batch < 10; batch++ )
+    {
+      std::vector<value_type> more;
+      for ( size_t i = count ? random(static_cast<uint32_t>(count)) : 0; i; i-- )
+      {
+        more.push_back(value_type(static_cast<int>(random(keys * 2)) - keys / 2, batch));
+        r.insert(more.back());
+      }
+      t.insert(more.begin(), more.end());
+      VERIFY(same(t, r));
+    }
+    lookup(t, r, keys);
+
+    // single values
+    for ( int i = 0; i < 500; i++ )
+    {
+      const int key = static_cast<int>(random(keys));
+      if ( random(2) )
+      {
+        const bool fresh = r.insert(value_type(key, i)).second;
+        const std::pair<typename map_type::iterator, bool> p = t.insert(value_type(key, i));
+        VERIFY(p.second == fresh && p.first->first == key && p.first->second == r[key]);
+      }
+      else
+      {
+        VERIFY(t.erase(key) == r.erase(key));
+      }
+    }
+    lookup(t, r, keys);
+
+    // the sorted range
+    map_type s(sorted_range, r.begin(), r.end());
+    lookup(s, r, keys);
+    s.clear();
+    VERIFY(s.empty() && s.find(0) == s.end() && s.lower_bound(0) == s.end());
+  }
+
+  void test01()
+  {
+    layout_ops<flat_binary_layout>(3000, 2000);
+    layout_ops<flat_branchless_layout>(3000, 2000);
+    layout_ops<flat_eytzinger_layout>(3000, 2000);
+    // all the sizes of the implicit tree
+    for ( size_t n = 0; n < 70; n++ )
+    {
+      layout_ops<flat_eytzinger_layout>(static_cast<int>(n + 1), n);
+      layout_ops<flat_branchless_layout>(static_cast<int>(n + 1), n);
+    }
+  }
+
+  // the equal keys of the multimap stay in the order of insertion, the batches too
+  void test02()
+  {
+    flat_multimap<int, int> m;
+    std::vector<value_type> r;
+    for ( int batch = 0; batch < 8; batch++ )
+    {
+      std::vector<value_type> more;
+      for ( int i = 0; i < 1000; i++ )
+        more.push_back(value_type(static_cast<int>(random(100)), batch * 1000 + i));
+      if ( batch & 1 )
+      {
+        m.insert(more.begin(), more.end());
+      }
+      else
+      {
+        for ( size_t i = 0; i < more.size(); i++ )
+          m.insert(more[i]);
+      }
+      r.insert(r.end(), more.begin(), more.end());
+    }
+    std::stable_sort(r.begin(), r.end(), by_key);
+    VERIFY(m.size() == r.size() && std::equal(m.begin(), m.end(), r.begin(), equivalent));
+
+    const std::pair<flat_multimap<int, int>::iterator, flat_multimap<int, int>::iterator> e = m.equal_range(42);
+    VERIFY(e.second - e.first == static_cast<ptrdiff_t>(m.count(42)) && e.first->first == 42 && e.second->first == 43);
+    const size_t n = m.count(7);
+    VERIFY(n && m.erase(7) == n && m.count(7) == 0);
+
+    // hinted
+    flat_multiset<int> s;
+    for ( int i = 0; i < 100; i++ )
+      s.insert(s.end(), i / 10);
+    VERIFY(s.size() == 100 && std::is_sorted(s.begin(), s.end()) && s.count(5) == 10);
+  }
+
+  // set, element access, copy and comparison
+  void test03()
+  {
+    std::vector<int> keys;
+    for ( int i = 0; i < 5000; i++ )
+      keys.push_back(static_cast<int>(random(3000)));
+    flat_set<int> a(keys.begin(), keys.end());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    VERIFY(a.size() == keys.size() && std::equal(a.begin(), a.end(), keys.begin()));
+    VERIFY(a.bytes_used() == a.capacity() * sizeof(int));
+
+    flat_set<int> b(a);
+    VERIFY(a == b && !(a < b));
+    const flat_set<int>::iterator i = b.insert(b.lower_bound(-1), -1);
+    VERIFY(i == b.begin() && b < a && a != b);
+    b.swap(a);
+    VERIFY(*a.begin() == -1 && *b.begin() == 0);
+    VERIFY(*a.erase(a.begin()) == 0 && a == b);
+
+    flat_map<int, int, std::greater<int> > m;
+    for ( int i = 0; i < 100; i++ )
+      m[i % 10] += i;
+    VERIFY(m.size() == 10 && m.begin()->first == 9 && m.at(9) == 9 + 19 + 29 + 39 + 49 + 59 + 69 + 79 + 89 + 99);
+    VERIFY(m.lower_bound(5)->first == 5 && m.upper_bound(5)->first == 4);
+
+    // the keys are const as in std::map, the mapped values are mutable in place
+    typedef flat_map<int, int> map_type;
+    VERIFY((std::is_same<map_type::value_type, std::pair<const int, int> >::value));
+    VERIFY((std::is_same<map_type::iterator, std::pair<const int, int>*>::value));
+    VERIFY((std::is_same<flat_multimap<int, int>::const_iterator, const std::pair<const int, int>*>::value));
+    map_type c(m.rbegin(), m.rend());
+    map_type::iterator j = c.find(5);
+    j->second = -1;
+    (*j).second--;
+    VERIFY(c[5] == -2 && c.find(6)->second == m[6] && c.size() == 10 && c.begin()->first == 0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 1M symbols: construction, lookup, ordered walk and memory per element against std::map
+
+  size_t allocated;
+
+  template<class T>
+  struct counting_allocator: std::allocator<T>
+  {
+    template<class U> struct rebind { typedef counting_allocator<U> other; };
+
+    counting_allocator() {}
+    template<class U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n, const void* = 0)
+    {
+      allocated += n * sizeof(T);
+      return std::allocator<T>::allocate(n);
+    }
+    void deallocate(T* p, size_t n)
+    {
+      allocated -= n * sizeof(T);
+      std::allocator<T>::deallocate(p, n);
+    }
+  };
+
+  template<class Map>
+  void bench_map(const char* name, const std::vector<std::pair<uint32_t, uint32_t> >& values, const std::vector<uint32_t>& probes)
+  {
+    const size_t bytes_before = allocated;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    const Map m(values.begin(), values.end());
+    const uint64_t t_build = ntl::intrinsic::rdtsc() - t;
+    const size_t bytes = allocated - bytes_before;
+
+    uint64_t sum = 0;
+    t = ntl::intrinsic::rdtsc();
+    for ( size_t i = 0; i < probes.size(); i++ )
+    {
+      const typename Map::const_iterator it = m.find(probes[i]);
+      if ( it != m.end() )
+        sum += it->second;
+    }
+    const uint64_t t_find = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( typename Map::const_iterator it = m.begin(); it != m.end(); ++it )
+      sum += it->first;
+    const uint64_t t_walk = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("%-10s build %4I64u, lookup %4I64u, walk %3I64u cycles per element, %2u bytes per element (%I64u)\n",
+      name, t_build / values.size(), t_find / probes.size(), t_walk / m.size(), static_cast<unsigned>(bytes / m.size()), sum);
+  }
+
+  void bench()
+  {
+    static const size_t count = 1000 * 1000;
+    std::vector<std::pair<uint32_t, uint32_t> > values(count);
+    std::vector<uint32_t> probes(count);
+    for ( size_t i = 0; i < count; i++ )
+      values[i] = std::make_pair(random(1u << 24) << 8 | random(256), static_cast<uint32_t>(i));
+    for ( size_t i = 0; i < count; i++ )
+      probes[i] = random(2) ? values[random(count)].first : random(1u << 24) << 8;
+
+    typedef std::pair<uint32_t, uint32_t> value_type;
+    typedef std::less<uint32_t> less;
+    bench_map<std::map<uint32_t, uint32_t, less, counting_allocator<std::pair<const uint32_t, uint32_t> > > >("rb_tree", values, probes);
+    bench_map<flat_map<uint32_t, uint32_t, less, counting_allocator<value_type> > >("binary", values, probes);
+    bench_map<flat_map<uint32_t, uint32_t, less, counting_allocator<value_type>, flat_branchless_layout> >("branchless", values, probes);
+    bench_map<flat_map<uint32_t, uint32_t, less, counting_allocator<value_type>, flat_eytzinger_layout> >("eytzinger", values, probes);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,159 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <format.hxx>
+#include <cstring>
+#include <cstdio>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+namespace fmt = ntl::fmt;
+
+namespace
+{
+  template<size_t N>
+  bool is(const char (&expected)[N], const char* s, size_t len)
+  {
+    return len == N-1 && std::strcmp(s, expected) == 0;
+  }
+
+  // integers
+  void test01()
+  {
+    char buf[128];
+    size_t n = fmt::format(buf, "hello");
+    VERIFY(is("hello", buf, n));
+
+    n = fmt::format(buf, "a {} b", 42);
+    VERIFY(is("a 42 b", buf, n));
+
+    n = fmt::format(buf, "{} {}", -2147483647 - 1, 18446744073709551615ULL);
+    VERIFY(is("-2147483648 18446744073709551615", buf, n));
+
+    n = fmt::format(buf, "{{}} {}", 1);
+    VERIFY(is("{} 1", buf, n));
+
+    n = fmt::format(buf, "{:x} {:X} {:#x} {:o} {:b}", 255, 255, 255, 255, 5);
+    VERIFY(is("ff FF 0xff 377 101", buf, n));
+
+    n = fmt::format(buf, "{:5}|{:<5}|{:05}|{:05}", 42, 42, 42, -42);
+    VERIFY(is("   42|42   |00042|-0042", buf, n));
+
+    n = fmt::format(buf, "{} {} {} {:d}", "x", true, 'c', 'c');
+    VERIFY(is("x true c 99", buf, n));
+  }
+
+  // pointers, NTSTATUS and native strings
+  void test02()
+  {
+    char buf[128];
+    size_t n = fmt::format(buf, "{}", ntl::nt::status::access_denied);
+    VERIFY(is("0xC0000022", buf, n));
+    n = fmt::format(buf, "{:d}", ntl::nt::status::access_denied);
+    VERIFY(is("-1073741790", buf, n));
+
+    n = fmt::format(buf, "{}", reinterpret_cast<void*>(0xDEADBEEF));
+    VERIFY(sizeof(void*) == 8 ? is("0x00000000DEADBEEF", buf, n) : is("0xDEADBEEF", buf, n));
+
+    const wchar_t name[] = L"Dr\x00e4ver.sys";
+    const ntl::nt::const_unicode_string us(name, 4);
+    n = fmt::format(buf, "[{}] [{:6}] [{:>4}]", us, "ab", L"ab");
+    VERIFY(is("[Dr?v] [ab    ] [  ab]", buf, n));
+
+    n = fmt::format(buf, "{}", static_cast<const char*>(0));
+    VERIFY(is("(null)", buf, n));
+
+    wchar_t wbuf[32];
+    fmt::format(wbuf, L"{} {:x} {}", 7, 255u, "nar");
+    VERIFY(std::wcscmp(wbuf, L"7 ff nar") == 0);
+  }
+
+  // truncation and malformed fields
+  void test03()
+  {
+    char small[4];
+    size_t n = fmt::format(small, "{}", 123456);
+    VERIFY(n == 6 && std::strcmp(small, "123") == 0);
+    VERIFY(fmt::format(small, 0, "{}", 1) == 1);
+
+    char buf[32];
+    n = fmt::format(buf, "{} {x");
+    VERIFY(is("{} {x", buf, n));
+    n = fmt::format(buf, "{} {} {:q}", 1, 2);
+    VERIFY(is("1 2 {:q}", buf, n));
+
+#ifdef NTL_FORMAT
+    static_assert(fmt::placeholders("a {} {:x} {{}}") == 2, "");
+    static_assert(fmt::placeholders("a { ") == -1, "");
+    n = NTL_FORMAT(buf, "{} {}", 1, "x");
+    VERIFY(is("1 x", buf, n));
+
+    // the compiled format is split at compile time and formats as the run-time parser
+    static_assert(fmt::detail::segment_count("a{:>08x}b{{") == 4, "");
+    static_assert(fmt::compile<4>("a{:>08x}b{{").segments[1].spec.width == 8, "");
+    static_assert(fmt::compile<4>("a{:>08x}b{{").segments[1].spec.type == 'x', "");
+    static_assert(fmt::compile<4>("a{:>08x}b{{").segments[3].length == 1, "");
+    static_assert(!fmt::detail::fields_valid("{:q}") && fmt::detail::fields_valid("{:<#08d}"), "");
+    char expected[32];
+    n = NTL_FORMAT(buf, "[{:>8}] [{:#010x}] {{{:s}}}", -5, 255u, "s");
+    VERIFY(n == fmt::format(expected, "[{:>8}] [{:#010x}] {{{:s}}}", -5, 255u, "s") && std::strcmp(buf, expected) == 0);
+    n = NTL_FORMAT(buf, "");
+    VERIFY(n == 0 && buf[0] == 0);
+    wchar_t wbuf[8];
+    n = NTL_FORMAT(wbuf, L"{{{:X}}}", 255);
+    VERIFY(n == 4 && wbuf[0] == L'{' && wbuf[1] == L'F' && wbuf[3] == L'}');
+#endif
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // throughput: format against _snprintf
+
+  void bench()
+  {
+    static const unsigned iterations = 1000000;
+    char buf[128];
+    volatile size_t sink = 0;
+    const ntl::nt::const_unicode_string name(L"\\Device\\HarddiskVolume1\\Windows\\System32\\ntdll.dll");
+    void* const p = buf;
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += fmt::format(buf, "pid {} status {} at {} image {}", i, ntl::nt::status::access_denied, p, name);
+    const uint64_t t_format = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += _snprintf(buf, _countof(buf), "pid %u status 0x%08X at 0x%p image %wZ", i, ntl::nt::status::access_denied, p, &name);
+    const uint64_t t_snprintf = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += fmt::format(buf, "{} {:x}", i, i);
+    const uint64_t t_format_int = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += _snprintf(buf, _countof(buf), "%u %x", i, i);
+    const uint64_t t_snprintf_int = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("format(mixed):     %I64u cycles/call\n", t_format / iterations);
+    dbg::trace.printf("_snprintf(mixed):  %I64u cycles/call\n", t_snprintf / iterations);
+    dbg::trace.printf("format(ints):      %I64u cycles/call\n", t_format_int / iterations);
+    dbg::trace.printf("_snprintf(ints):   %I64u cycles/call\n", t_snprintf_int / iterations);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,205 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <functional>
+#include <memory>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  // allocations made by the wrappers for the counted callables
+  int allocations = 0, alive = 0;
+
+  template<size_t Size>
+  struct counted
+  {
+    int value;
+    char captures[Size];
+
+    explicit counted(int value) : value(value) { ++alive; }
+    counted(const counted& r) : value(r.value) { ++alive; }
+    ~counted() { --alive; }
+
+    int operator()(int x) const { return x + value; }
+
+    static void* operator new(size_t size) { ++allocations; return ::operator new(size); }
+    static void operator delete(void* p) { ::operator delete(p); }
+  };
+
+  typedef counted<sizeof(void*)>      small_callable; // a pointer with a few captures
+  typedef counted<8 * sizeof(void*)>  large_callable;
+
+  struct owner
+  {
+    std::unique_ptr<int> p;
+    explicit owner(int* p) : p(p) {}
+    int operator()() const { return *p; }
+  };
+
+  struct object
+  {
+    int k;
+    int mul(int x) const { return k * x; }
+  };
+
+  int twice(int x) { return x * 2; }
+
+  // inline storage
+  void test01()
+  {
+    allocations = 0;
+    {
+      std::function<int(int)> f(small_callable(1));
+      VERIFY(allocations == 0 && f(2) == 3);
+
+      std::function<int(int)> g(f);
+      VERIFY(allocations == 0 && g(3) == 4 && alive == 2);
+
+      std::function<int(int)> h(large_callable(5));
+      VERIFY(allocations == 1 && h(1) == 6);
+
+      std::function<int(int)> h2(h);
+      VERIFY(allocations == 2 && h2(2) == 7);
+
+      h2.swap(f);
+      VERIFY(f(2) == 7 && h2(2) == 3 && allocations == 2);
+
+      VERIFY(f.target<large_callable>() != nullptr && f.target<large_callable>()->value == 5);
+      VERIFY(f.target<small_callable>() == nullptr);
+    }
+    VERIFY(alive == 0);
+
+    std::function<int(int)> fp(&twice);
+    VERIFY(fp(4) == 8 && *fp.target<int(*)(int)>() == &twice);
+
+    std::function<int(int)> empty;
+    VERIFY(!empty);
+    bool thrown = false;
+    try { empty(1); }
+    catch(std::bad_function_call&) { thrown = true; }
+    VERIFY(thrown);
+
+    // members and references
+    object o = { 3 };
+    std::function<int(object*, int)> m(&object::mul);
+    VERIFY(m(&o, 5) == 15);
+
+    large_callable big(7);
+    allocations = 0;
+    std::function<int(int)> r(std::ref(big));
+    VERIFY(allocations == 0 && r(1) == 8 && r.target<large_callable>() == &big);
+  }
+
+  // move_only_function
+  void test02()
+  {
+    std::move_only_function<int()> m(owner(new int(42)));
+    VERIFY(m() == 42);
+
+    std::move_only_function<int()> m2(std::move(m));
+    VERIFY(!m && m2() == 42);
+
+    m = std::move(m2);
+    VERIFY(m() == 42 && !m2);
+    m = nullptr;
+    VERIFY(!m);
+
+    allocations = 0;
+    {
+      std::move_only_function<int(int)> s(small_callable(1)), l(large_callable(2));
+      VERIFY(allocations == 1 && s(1) == 2 && l(1) == 3);
+    }
+    VERIFY(alive == 0);
+  }
+
+  // function_ref
+  void test03()
+  {
+    large_callable big(1);
+    allocations = 0;
+    std::function_ref<int(int)> r(big);
+    VERIFY(r(1) == 2 && allocations == 0 && alive == 1);
+
+    std::function_ref<int(int)> f(twice);
+    VERIFY(f(5) == 10);
+    std::function_ref<int(int)> fp(&twice);
+    VERIFY(fp(6) == 12);
+
+    std::function_ref<int(int)> c(r);
+    VERIFY(c(2) == 3);
+    STATIC_ASSERT(sizeof(std::function_ref<int(int)>) == 2 * sizeof(void*));
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // call overhead
+
+  int __declspec(noinline) call_ref(std::function_ref<int(int)> f, int x) { return f(x); }
+
+  void bench()
+  {
+    static const unsigned iterations = 10000000;
+    volatile int sink = 0;
+    small_callable sc(1);
+    large_callable lc(1);
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += sc(i);
+    const uint64_t t_direct = ntl::intrinsic::rdtsc() - t;
+
+    std::function<int(int)> fs(sc), fl(lc);
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += fs(i);
+    const uint64_t t_small = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += fl(i);
+    const uint64_t t_large = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++)
+      sink += call_ref(sc, i);
+    const uint64_t t_ref = ntl::intrinsic::rdtsc() - t;
+
+    // construction, call and destruction as done for every completion callback
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      std::function<int(int)> f(sc);
+      sink += f(i);
+    }
+    const uint64_t t_small_once = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < iterations; i++){
+      std::function<int(int)> f(lc);
+      sink += f(i);
+    }
+    const uint64_t t_large_once = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("direct call:               %I64u cycles/call\n", t_direct / iterations);
+    dbg::trace.printf("function (inline):         %I64u cycles/call\n", t_small / iterations);
+    dbg::trace.printf("function (heap):           %I64u cycles/call\n", t_large / iterations);
+    dbg::trace.printf("function_ref:              %I64u cycles/call\n", t_ref / iterations);
+    dbg::trace.printf("function (inline) created: %I64u cycles/call\n", t_small_once / iterations);
+    dbg::trace.printf("function (heap) created:   %I64u cycles/call\n", t_large_once / iterations);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,148 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <fstream>
+#include <string>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  const char test_file[] = "mapstream_test.txt";
+
+  void make_file(const char* name, unsigned lines)
+  {
+    std::ofstream f(name, std::ios::binary|std::ios::trunc);
+    for(unsigned i = 0; i < lines; i++)
+      f << "line " << i << (i % 7 ? " abc" : "") << '\n';
+  }
+
+  // line by line against the buffered filebuf, with the windows smaller than file
+  void test01()
+  {
+    make_file(test_file, 200000);
+    const size_t windows[] = { 1, 64*1024, 200*1024, std::mapped_filebuf::default_window_size };
+    for(size_t w = 0; w < _countof(windows); w++){
+      std::imapstream ms;
+      ms.rdbuf()->window(windows[w]);
+      ms.open(test_file);
+      VERIFY(ms.is_open());
+      VERIFY(ms.rdbuf()->window() >= windows[w]);
+
+      std::ifstream fs(test_file, std::ios::binary);
+      std::string a, b;
+      unsigned n = 0;
+      while(std::getline(fs, a)){
+        VERIFY(std::getline(ms, b));
+        VERIFY(a == b);
+        n++;
+      }
+      VERIFY(n == 200000);
+      VERIFY(!std::getline(ms, b));
+    }
+  }
+
+  // seeking and putback across the window boundaries
+  void test02()
+  {
+    std::imapstream ms;
+    ms.rdbuf()->window(64*1024);
+    ms.open(test_file);
+    std::ifstream fs(test_file, std::ios::binary);
+
+    ms.seekg(0, std::ios::end);
+    fs.seekg(0, std::ios::end);
+    const std::streamoff end = ms.tellg();
+    VERIFY(end == std::streamoff(fs.tellg()) && end == ms.rdbuf()->size());
+
+    const std::streamoff positions[] = { 0, 65535, 65536, 65537, 131071, end - 3 };
+    std::string a, b;
+    for(size_t i = 0; i < _countof(positions); i++){
+      ms.clear(); fs.clear();
+      ms.seekg(positions[i]);
+      fs.seekg(positions[i]);
+      std::getline(ms, b);
+      std::getline(fs, a);
+      VERIFY(a == b && ms.tellg() == fs.tellg());
+    }
+
+    ms.seekg(65535);
+    const int c = ms.get();
+    ms.seekg(65536);
+    VERIFY(ms.unget());
+    VERIFY(ms.get() == c);
+
+    // bulk read through several windows
+    std::string ra(300000, 0), rb(300000, 0);
+    ms.seekg(60000);
+    fs.seekg(60000);
+    ms.read(&ra[0], ra.size());
+    fs.read(&rb[0], rb.size());
+    VERIFY(ms.gcount() == fs.gcount() && ra == rb);
+
+    // no output
+    std::mapped_filebuf sb;
+    VERIFY(!sb.open(test_file, std::ios::out));
+  }
+
+  void test03()
+  {
+    { std::ofstream f("mapstream_empty.txt", std::ios::binary|std::ios::trunc); }
+    std::imapstream e("mapstream_empty.txt");
+    VERIFY(e.is_open());
+    VERIFY(e.get() == std::char_traits<char>::eof());
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // line reading throughput: buffered filebuf against the mapped one
+
+  void bench()
+  {
+    static const unsigned lines = 16 * 1024 * 1024; // about 1 GB
+    const char big_file[] = "mapstream_bench.txt";
+    {
+      std::ofstream f(big_file, std::ios::binary|std::ios::trunc);
+      const std::string tail(48, 'x');
+      for(unsigned i = 0; i < lines; i++)
+        f << i << " some text for the line " << tail << '\n';
+    }
+    std::string line;
+    size_t total = 0;
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    {
+      std::ifstream f(big_file, std::ios::binary);
+      while(std::getline(f, line))
+        total += line.size();
+    }
+    const uint64_t t_filebuf = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    {
+      std::imapstream f(big_file);
+      while(std::getline(f, line))
+        total -= line.size();
+    }
+    const uint64_t t_mapped = ntl::intrinsic::rdtsc() - t;
+    VERIFY(total == 0);
+
+    dbg::trace.printf("ifstream getline:   %I64u cycles/line\n", t_filebuf / lines);
+    dbg::trace.printf("imapstream getline: %I64u cycles/line\n", t_mapped / lines);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,250 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <km/mdl_view.hxx>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl;
+  using namespace ntl::km;
+
+  //////////////////////////////////////////////////////////////////////////
+  // MDL chain builder: each chunk of the data is copied into its own block described by
+  // the MDL mapped to the system space, as the locked nonpaged buffers are.
+
+  class mock_mdl_chain
+  {
+  public:
+    mock_mdl_chain(const uint8_t * data, const size_t * chunks, size_t count)
+    {
+      mdls.resize(count);
+      blocks.resize(count);
+      for ( size_t i = 0; i < count; i++ )
+      {
+        blocks[i].assign(data, data + chunks[i]);
+        data += chunks[i];
+        mdl & m = mdls[i];
+        std::memset(&m, 0, sizeof(m));
+        m.Next = i + 1 < count ? &mdls[i + 1] : 0;
+        m.mapped_to_system_va = 1;
+        m.MappedSystemVa = blocks[i].empty() ? 0 : &blocks[i][0];
+        m.StartVa = reinterpret_cast<void*>(uintptr_t(m.MappedSystemVa) & ~uintptr_t(4095));
+        m.ByteOffset = static_cast<uint32_t>(uintptr_t(m.MappedSystemVa) & 4095);
+        m.ByteCount = static_cast<uint32_t>(chunks[i]);
+      }
+    }
+
+    const mdl * get() const { return mdls.empty() ? 0 : &mdls[0]; }
+
+    std::vector<uint8_t> flatten() const
+    {
+      std::vector<uint8_t> data;
+      for ( size_t i = 0; i < blocks.size(); i++ )
+        data.insert(data.end(), blocks[i].begin(), blocks[i].end());
+      return data;
+    }
+
+  private:
+    std::vector<mdl> mdls;
+    std::vector<std::vector<uint8_t> > blocks;
+  };
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  // splits the size into random chunks, some of them empty
+  std::vector<size_t> random_chunks(size_t size, uint32_t max_chunk)
+  {
+    std::vector<size_t> chunks;
+    while ( size )
+    {
+      const size_t n = std::min<size_t>(size, random(max_chunk + 1));
+      chunks.push_back(n);
+      size -= n;
+    }
+    return chunks;
+  }
+
+  std::vector<uint8_t> random_data(size_t size, uint32_t alphabet = 256)
+  {
+    std::vector<uint8_t> data(size);
+    for ( size_t i = 0; i < size; i++ )
+      data[i] = static_cast<uint8_t>(random(alphabet));
+    return data;
+  }
+
+  uint16_t reference_checksum(const uint8_t * p, size_t n)
+  {
+    uint32_t sum = 0;
+    for ( ; n > 1; n -= 2, p += 2 )
+    {
+      uint16_t w;
+      std::memcpy(&w, p, 2);
+      sum += w;
+    }
+    if ( n )
+    {
+      uint16_t w = 0;
+      std::memcpy(&w, p, 1);
+      sum += w;
+    }
+    while ( sum >> 16 )
+      sum = (sum & 0xFFFF) + (sum >> 16);
+    return static_cast<uint16_t>(~sum);
+  }
+
+  // chunks, windows and copies
+  void test01()
+  {
+    const uint8_t text[] = "0123456789abcdefghij";
+    const size_t chunks[] = { 3, 0, 7, 1, 9 };
+    mock_mdl_chain chain(text, chunks, _countof(chunks));
+    mdl_view v(chain.get());
+    VERIFY(v.size() == 20);
+
+    size_t n = 0, total = 0;
+    for ( mdl_view::const_iterator it = v.begin(); it != v.end(); ++it, n++ )
+    {
+      const span<uint8_t> c = *it;
+      VERIFY(!c.empty() && std::equal(c.begin(), c.end(), text + total));
+      total += c.size();
+    }
+    VERIFY(n == 4 && total == 20);
+
+    // the window starts and ends inside the chunks
+    const mdl_view w = v.subview(5, 9);
+    VERIFY(w.size() == 9);
+    mdl_view::const_iterator it = w.begin();
+    VERIFY((*it).size() == 5 && (*it)[0] == '5');
+    VERIFY((*++it).size() == 1 && (*++it).size() == 3 && ++it == w.end());
+    VERIFY(std::equal(w.bytes_begin(), w.bytes_end(), text + 5));
+    VERIFY(std::distance(w.bytes_begin(), w.bytes_end()) == 9);
+    VERIFY(v.subview(20).empty() && v.subview(25).begin() == v.end() && v.subview(3, 0).empty());
+
+    // copy out and back
+    uint8_t buf[32] = {};
+    VERIFY(w.copy_to(buf, sizeof(buf)) == 9 && std::memcmp(buf, "56789abcd", 9) == 0);
+    VERIFY(v.copy_to(buf, 4, 18) == 2 && std::memcmp(buf, "ij", 2) == 0);
+    VERIFY(v.copy_from("ABCDEFG", 7, 2) == 7);
+    std::vector<uint8_t> flat = chain.flatten();
+    VERIFY(std::memcmp(&flat[0], "01ABCDEFG9abcdefghij", 20) == 0);
+
+    // contiguous access
+    uint8_t tmp[8];
+    const uint8_t * p = v.contiguous(tmp, 3, 3);
+    VERIFY(p != tmp && std::memcmp(p, "BCD", 3) == 0);
+    p = v.contiguous(tmp, 4, 8);
+    VERIFY(p == tmp && std::memcmp(p, "G9ab", 4) == 0);
+    VERIFY(v.contiguous(tmp, 4, 18) == 0);
+
+    // random splits
+    for ( int round = 0; round < 200; round++ )
+    {
+      const std::vector<uint8_t> data = random_data(1 + random(3000));
+      const std::vector<size_t> cuts = random_chunks(data.size(), 1 + random(700));
+      mock_mdl_chain c(&data[0], &cuts[0], cuts.size());
+      const mdl_view all(c.get());
+      const size_t pos = random(static_cast<uint32_t>(data.size())), len = random(static_cast<uint32_t>(data.size()));
+      std::vector<uint8_t> out(data.size());
+      const size_t copied = all.copy_to(&out[0], len, pos);
+      VERIFY(copied == std::min(len, data.size() - pos));
+      VERIFY(std::equal(out.begin(), out.begin() + copied, data.begin() + pos));
+      VERIFY(std::equal(all.bytes_begin(), all.bytes_end(), data.begin()));
+    }
+  }
+
+  // search and checksum across the chunks
+  void test02()
+  {
+    for ( int round = 0; round < 500; round++ )
+    {
+      const std::vector<uint8_t> data = random_data(1 + random(2000), 4);
+      const std::vector<size_t> cuts = random_chunks(data.size(), 1 + random(64));
+      mock_mdl_chain c(&data[0], &cuts[0], cuts.size());
+      const mdl_view v(c.get());
+
+      const size_t plen = 1 + random(6), from = random(static_cast<uint32_t>(data.size()));
+      const std::vector<uint8_t> pattern = random_data(plen, 4);
+      const std::vector<uint8_t>::const_iterator expected = std::search(data.begin() + from, data.end(), pattern.begin(), pattern.end());
+      const size_t found = v.find(&pattern[0], plen, from);
+      VERIFY(expected == data.end() ? found == mdl_view::npos : found == size_t(expected - data.begin()));
+
+      // the byte iterators work with the algorithms too
+      const mdl_view::byte_iterator it = std::search(v.bytes_begin(), v.bytes_end(), pattern.begin(), pattern.end());
+      VERIFY((it == v.bytes_end()) == (std::search(data.begin(), data.end(), pattern.begin(), pattern.end()) == data.end()));
+
+      VERIFY(v.internet_checksum() == reference_checksum(&data[0], data.size()));
+      const size_t pos = random(static_cast<uint32_t>(data.size()));
+      VERIFY(v.subview(pos).internet_checksum() == reference_checksum(&data[pos], data.size() - pos));
+    }
+    const uint8_t text[] = "abcabd";
+    const size_t chunks[] = { 4, 2 };
+    mock_mdl_chain c(text, chunks, 2);
+    const mdl_view v(c.get());
+    VERIFY(v.find("abd", 3) == 3 && v.find("abc", 3, 1) == mdl_view::npos && v.find("", 0, 6) == 6);
+    VERIFY(v.find("d", 1, 7) == mdl_view::npos);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 64 KB in the 1460-byte segments: flatten and parse against the view
+
+  void bench()
+  {
+    const std::vector<uint8_t> data = random_data(64 * 1024);
+    std::vector<size_t> cuts(data.size() / 1460, 1460);
+    cuts.push_back(data.size() % 1460);
+    mock_mdl_chain c(&data[0], &cuts[0], cuts.size());
+    const mdl_view v(c.get());
+    static const uint8_t pattern[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x01 };
+    static const unsigned rounds = 200;
+
+    std::vector<uint8_t> flat;
+    size_t r1 = 0, r2 = 0;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for ( unsigned i = 0; i < rounds; i++ )
+    {
+      flat.resize(v.size());
+      v.copy_to(&flat[0], flat.size());
+      r1 += reference_checksum(&flat[0], flat.size());
+      r1 += std::search(flat.begin(), flat.end(), pattern, pattern + sizeof(pattern)) - flat.begin();
+      std::vector<uint8_t>().swap(flat);
+    }
+    const uint64_t t_flat = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( unsigned i = 0; i < rounds; i++ )
+    {
+      r2 += v.internet_checksum();
+      const size_t pos = v.find(pattern, sizeof(pattern));
+      r2 += pos == mdl_view::npos ? v.size() : pos;
+    }
+    const uint64_t t_view = ntl::intrinsic::rdtsc() - t;
+    VERIFY(r1 == r2);
+
+    dbg::trace.printf("64 KB in %u MDLs, checksum + search: flatten %I64u, view %I64u cycles\n",
+      static_cast<unsigned>(cuts.size()), t_flat / rounds, t_view / rounds);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}
@@ -0,0 +1,233 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <lazy.hxx>
+#include <mutex>
+#include <thread>
+#include <memory>
+
+#include <nt/process_information.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  volatile uint32_t calls;
+
+  void init()
+  {
+    ntl::atomic::increment(calls);
+  }
+
+  void init_sum(int a, int b)
+  {
+    ntl::atomic::exchange_add(calls, static_cast<uint32_t>(a + b));
+  }
+
+  // some work to keep the other threads waiting
+  void work(uint64_t cycles)
+  {
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    while ( ntl::intrinsic::rdtsc() - t < cycles )
+      ;
+  }
+
+  void test01()
+  {
+    std::once_flag flag;
+    calls = 0;
+    VERIFY(!flag.ready());
+    for ( int i = 0; i < 100; i++ )
+      std::call_once(flag, init);
+    VERIFY(calls == 1 && flag.ready());
+
+    std::once_flag flag2;
+    std::call_once(flag2, init_sum, 2, 3);
+    std::call_once(flag2, init_sum, 4, 5);
+    VERIFY(calls == 6);
+
+#if STLX__USE_EXCEPTIONS
+    // the failed initialization is taken by the next call
+    struct failing
+    {
+      static void call(int attempt)
+      {
+        ntl::atomic::increment(calls);
+        if ( attempt == 0 )
+          throw attempt;
+      }
+    };
+    std::once_flag flag3;
+    calls = 0;
+    try { std::call_once(flag3, &failing::call, 0); }
+    catch(int) {}
+    VERIFY(calls == 1 && !flag3.ready());
+    std::call_once(flag3, &failing::call, 1);
+    std::call_once(flag3, &failing::call, 2);
+    VERIFY(calls == 2 && flag3.ready());
+#endif
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the race of the threads
+
+  struct table
+  {
+    static volatile uint32_t constructed, destroyed;
+    table()
+    {
+      ntl::atomic::increment(constructed);
+      work(1000000);
+      for ( size_t i = 0; i < _countof(data); i++ )
+        data[i] = static_cast<int>(i * 3);
+    }
+    ~table()
+    {
+      ntl::atomic::increment(destroyed);
+    }
+    int data[256];
+  };
+
+  volatile uint32_t table::constructed, table::destroyed;
+
+  struct racer
+  {
+    std::once_flag* flag;
+    ntl::lazy<table>* object;
+    volatile uint32_t* seen;
+
+    static void once(racer* self)
+    {
+      std::call_once(*self->flag, init);
+      if ( calls == 1 )
+        ntl::atomic::increment(*self->seen);
+    }
+
+    static void get(racer* self)
+    {
+      if ( self->object->get().data[255] == 255 * 3 )
+        ntl::atomic::increment(*self->seen);
+    }
+  };
+
+  template<class F>
+  void race(unsigned threads, F func, racer* r)
+  {
+    const std::unique_ptr<std::thread[]> pool(new std::thread[threads]);
+    for ( unsigned i = 0; i < threads; i++ )
+    {
+      std::thread t(func, r);
+      pool[i].swap(t);
+    }
+    for ( unsigned i = 0; i < threads; i++ )
+      pool[i].join();
+  }
+
+  void test02()
+  {
+    for ( int round = 0; round < 20; round++ )
+    {
+      std::once_flag flag;
+      volatile uint32_t seen = 0;
+      calls = 0;
+      racer r = { &flag, 0, &seen };
+      race(16, &racer::once, &r);
+      VERIFY(calls == 1 && seen == 16);
+    }
+
+    table::constructed = table::destroyed = 0;
+    {
+      ntl::lazy<table> object;
+      VERIFY(!object.ready() && table::constructed == 0);
+      volatile uint32_t seen = 0;
+      racer r = { 0, &object, &seen };
+      race(16, &racer::get, &r);
+      VERIFY(table::constructed == 1 && seen == 16 && object.ready());
+      VERIFY(&*object == &object.get() && object->data[1] == 3);
+    }
+    VERIFY(table::destroyed == 1);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the CPU time burned by the waiters: the parked call_once against the backoff spin it replaced
+
+  volatile uint32_t spin_locked, spin_inited;
+
+  void spin_once(void (*func)())
+  {
+    if ( spin_inited )
+      return;
+    for ( ntl::atomic::backoff b; ntl::atomic::compare_exchange(spin_locked, 1u, 0u) == 1; )
+      b.pause();
+    if ( !spin_inited )
+    {
+      func();
+      spin_inited = true;
+    }
+    ntl::atomic::exchange(spin_locked, 0u);
+  }
+
+  volatile uint64_t threads_time, init_time;
+  std::once_flag* bench_flag;
+
+  int64_t thread_time()
+  {
+    const ntl::nt::thread_information<ntl::nt::kernel_user_times> times;
+    return times ? times->KernelTime + times->UserTime : 0;
+  }
+
+  void heavy_init()
+  {
+    const int64_t t = thread_time();
+    work(200000000);
+    init_time = thread_time() - t;
+  }
+
+  struct waiter
+  {
+    static void parked(racer*)
+    {
+      const int64_t t = thread_time();
+      std::call_once(*bench_flag, heavy_init);
+      ntl::atomic::exchange_add(threads_time, static_cast<uint64_t>(thread_time() - t));
+    }
+
+    static void spinning(racer*)
+    {
+      const int64_t t = thread_time();
+      spin_once(heavy_init);
+      ntl::atomic::exchange_add(threads_time, static_cast<uint64_t>(thread_time() - t));
+    }
+  };
+
+  void bench()
+  {
+    const unsigned threads = 16;
+    std::once_flag flag;
+    bench_flag = &flag;
+    threads_time = 0;
+    race(threads, &waiter::parked, static_cast<racer*>(0));
+    const uint64_t t_parked = threads_time - init_time;
+
+    threads_time = 0;
+    race(threads, &waiter::spinning, static_cast<racer*>(0));
+    const uint64_t t_spinning = threads_time - init_time;
+
+    // the thread times are in 100ns units
+    dbg::trace.printf("call_once: %u waiters of 200 Mcycles initialization burned %I64u ms parked, %I64u ms spinning\n",
+      threads - 1, t_parked / 10000, t_spinning / 10000);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}
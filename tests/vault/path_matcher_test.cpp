@@ -0,0 +1,242 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <path_matcher.hxx>
+#include <string>
+#include <vector>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using ntl::path_matcher;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  size_t find(const path_matcher& m, const wchar_t* path)
+  {
+    return m.find(path, path + std::char_traits<wchar_t>::length(path));
+  }
+
+  // the paths, the relative patterns, the globs and the case
+  void test01()
+  {
+    std::vector<std::wstring> patterns;
+    patterns.push_back(L"atapi.sys");                                     // 0
+    patterns.push_back(L"\\SystemRoot\\System32\\drivers\\ndis.sys");     // 1
+    patterns.push_back(L"drivers\\*.sys");                                // 2
+    patterns.push_back(L"\\Device\\HarddiskVolume?\\Windows\\*.dll");     // 3
+    patterns.push_back(L"\x0414\x0440\x0430\x0439\x0432\x0435\x0440.sys"); // 4
+    patterns.push_back(L"caf\xE9*.dll");                                  // 5
+    patterns.push_back(L"");                                              // 6
+    patterns.push_back(L"ATAPI.SYS");                                     // 7
+    path_matcher m;
+    VERIFY(m.empty() && find(m, L"atapi.sys") == path_matcher::npos);
+    VERIFY(m.build(patterns.begin(), patterns.end()));
+    VERIFY(m.size() == patterns.size());
+
+    VERIFY(find(m, L"\\SystemRoot\\system32\\DRIVERS\\ATAPI.SYS") == 0);
+    VERIFY(find(m, L"atapi.sys") == 0 && find(m, L"\\atapi.sys") == 0);
+    VERIFY(find(m, L"\\SystemRoot\\xatapi.sys") == path_matcher::npos);
+    VERIFY(find(m, L"\\SystemRoot\\atapi.sys\\x") == path_matcher::npos);
+    VERIFY(find(m, L"\\SYSTEMROOT\\system32\\drivers\\NDIS.sys") == 1);
+    VERIFY(find(m, L"\\??\\C:\\Windows\\System32\\drivers\\ndis.sys") == 2);
+    VERIFY(find(m, L"\\SystemRoot\\System32\\drivers\\ndis.sys\\") == path_matcher::npos);
+    VERIFY(find(m, L"\\SystemRoot\\System32\\drivers\\.sys") == 2);
+    VERIFY(find(m, L"\\SystemRoot\\drivers\\sub\\a.sys") == path_matcher::npos);
+    VERIFY(find(m, L"\\Device\\HarddiskVolume2\\Windows\\ntdll.DLL") == 3);
+    VERIFY(find(m, L"\\Device\\HarddiskVolume12\\Windows\\ntdll.dll") == path_matcher::npos);
+    VERIFY(find(m, L"\\Device\\HarddiskVolume2\\Windows\\System32\\ntdll.dll") == path_matcher::npos);
+    VERIFY(find(m, L"\\Device\\HarddiskVolume2\\Windows\\") == path_matcher::npos);
+    VERIFY(find(m, L"\\SystemRoot\\\x0434\x0420\x0410\x0419\x0412\x0415\x0440.SYS") == 4);
+    VERIFY(find(m, L"\\SystemRoot\\CAF\xC9.dll") == 5 && find(m, L"caf\xE9-2.dll") == 5);
+    VERIFY(find(m, L"cafe.dll") == path_matcher::npos);
+    VERIFY(find(m, L"") == path_matcher::npos && find(m, L"\\") == path_matcher::npos);
+
+    // the ANSI names and the native strings
+    const std::string ansi("\\SystemRoot\\System32\\Drivers\\Atapi.sys");
+    VERIFY(m.find(ntl::nt::const_unicode_string(L"\\SystemRoot\\System32\\Drivers\\Ndis.sys")) == 1);
+    VERIFY(m.find(ansi) == 0 && m.match(std::wstring(L"drivers\\NDIS.SYS")) && !m.match(std::string("ndis.sys")));
+
+    // rebuild
+    std::vector<std::string> narrow(1, "*");
+    VERIFY(m.build(narrow.begin(), narrow.end()) && m.size() == 1);
+    VERIFY(find(m, L"\\a\\b") == 0 && find(m, L"") == 0 && find(m, L"\\a\\") == 0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the automaton against the backtracking over every pattern
+
+  wchar_t upcase(wchar_t c)
+  {
+    return c < 0x80 ? (c >= 'a' && c <= 'z' ? wchar_t(c - 'a' + 'A') : c) : ntl::nt::RtlUpcaseUnicodeChar(c);
+  }
+
+  bool glob(const wchar_t* p, const wchar_t* pe, const wchar_t* s, const wchar_t* se)
+  {
+    if ( p == pe )
+      return s == se;
+    if ( *p == '*' )
+      for ( ;; ++s )
+      {
+        if ( glob(p + 1, pe, s, se) )
+          return true;
+        if ( s == se || *s == '\\' )
+          return false;
+      }
+    if ( s == se || (*p == '?' ? *s == '\\' : upcase(*p) != upcase(*s)) )
+      return false;
+    return glob(p + 1, pe, s + 1, se);
+  }
+
+  bool matches(const std::wstring& pattern, const std::wstring& path)
+  {
+    if ( pattern.empty() )
+      return false;
+    const wchar_t* const p = pattern.c_str(), * const s = path.c_str();
+    if ( pattern[0] == '\\' )
+      return glob(p, p + pattern.size(), s, s + path.size());
+    for ( size_t i = 0; i <= path.size(); i++ )
+      if ( (i == 0 || s[i - 1] == '\\') && glob(p, p + pattern.size(), s + i, s + path.size()) )
+        return true;
+    return false;
+  }
+
+  std::wstring random_text(size_t max, bool globs)
+  {
+    static const wchar_t chars[] = { 'a', 'B', 'b', '\\', '\\', '.', 0x0434, 0x0414, 0xE9, 0xC9, 0x131, 'I', '*', '?' };
+    std::wstring s(random(static_cast<uint32_t>(max + 1)), L' ');
+    for ( size_t i = 0; i < s.size(); i++ )
+      s[i] = chars[random(_countof(chars) - (globs ? 0 : 2))];
+    return s;
+  }
+
+  void test02()
+  {
+    std::vector<std::wstring> patterns;
+    path_matcher m;
+    for ( int round = 0; round < 3000; round++ )
+    {
+      patterns.resize(1 + random(6));
+      for ( size_t i = 0; i < patterns.size(); i++ )
+        patterns[i] = random_text(8, true);
+      VERIFY(m.build(patterns.begin(), patterns.end()));
+      for ( int probe = 0; probe < 50; probe++ )
+      {
+        std::wstring path = random_text(12, false);
+        if ( random(2) )
+        {
+          // make the path out of a pattern
+          path = patterns[random(static_cast<uint32_t>(patterns.size()))];
+          for ( size_t i = 0; i < path.size(); i++ )
+            if ( path[i] == '*' || path[i] == '?' )
+              path[i] = random(3) ? 'b' : 'a';
+          if ( random(2) )
+            path.insert(0, L"\\x\\");
+        }
+        size_t expected = path_matcher::npos;
+        for ( size_t i = 0; i < patterns.size() && expected == path_matcher::npos; i++ )
+          if ( matches(patterns[i], path) )
+            expected = i;
+        VERIFY(m.find(path) == expected);
+      }
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 10000 driver names and paths: the list scanned by the file names as in zenadriver against the automaton
+
+  bool equal_filenames(const std::wstring& pattern, const std::wstring& path)
+  {
+    const size_t slash = path.rfind(L'\\') + 1, name = pattern.rfind(L'\\') + 1;
+    if ( path.size() - slash != pattern.size() - name )
+      return false;
+    for ( size_t i = 0; name + i < pattern.size(); i++ )
+      if ( upcase(pattern[name + i]) != upcase(path[slash + i]) )
+        return false;
+    return true;
+  }
+
+  std::wstring driver_name()
+  {
+    std::wstring s(4 + random(8), L' ');
+    for ( size_t i = 0; i < s.size(); i++ )
+      s[i] = static_cast<wchar_t>('a' + random(26));
+    return s + (random(4) ? L".sys" : L".dll");
+  }
+
+  void bench_set(const char* name, const std::vector<std::wstring>& patterns, const std::vector<std::wstring>& paths, bool linear)
+  {
+    path_matcher m;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    VERIFY(m.build(patterns.begin(), patterns.end()));
+    const uint64_t t_build = ntl::intrinsic::rdtsc() - t;
+
+    size_t found = 0;
+    t = ntl::intrinsic::rdtsc();
+    for ( size_t i = 0; i < paths.size(); i++ )
+      found += m.find(paths[i]) != path_matcher::npos;
+    const uint64_t t_find = ntl::intrinsic::rdtsc() - t;
+
+    uint64_t t_list = 0;
+    if ( linear )
+    {
+      // the list is scanned for a part of the paths only
+      const size_t probes = paths.size() / 100;
+      t = ntl::intrinsic::rdtsc();
+      for ( size_t i = 0; i < probes; i++ )
+        for ( size_t k = 0; k < patterns.size(); k++ )
+          if ( equal_filenames(patterns[k], paths[i]) )
+          {
+            found++;
+            break;
+          }
+      t_list = (ntl::intrinsic::rdtsc() - t) / probes;
+    }
+    dbg::trace.printf("%-8s %5u patterns: build %6I64u Kcycles, find %4I64u cycles, list scan %8I64u cycles per path (%u)\n",
+      name, static_cast<unsigned>(patterns.size()), t_build / 1000, t_find / paths.size(), t_list, static_cast<unsigned>(found));
+  }
+
+  void bench()
+  {
+    static const size_t count = 10000;
+    std::vector<std::wstring> names(count), full(count), globs(count), paths(100000);
+    for ( size_t i = 0; i < count; i++ )
+    {
+      names[i] = driver_name();
+      full[i] = L"\\SystemRoot\\System32\\drivers\\" + names[i];
+      globs[i] = random(100) ? names[i] : L"oem" + names[i].substr(0, 2) + L"*.sys";
+    }
+    for ( size_t i = 0; i < paths.size(); i++ )
+    {
+      // a half of the paths are in the set, in the other case
+      std::wstring name = random(2) ? names[random(count)] : driver_name();
+      for ( size_t k = 0; k < name.size(); k++ )
+        if ( random(2) )
+          name[k] = upcase(name[k]);
+      paths[i] = L"\\SystemRoot\\system32\\DRIVERS\\" + name;
+    }
+    bench_set("names", names, paths, true);
+    bench_set("paths", full, paths, false);
+    bench_set("globs", globs, paths, false);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}
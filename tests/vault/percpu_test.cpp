@@ -0,0 +1,219 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <km/percpu.hxx>
+#include <thread>
+#include <vector>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl::km;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Stand-in of the kernel: the processors are the threads which set their number,
+  // so each thread has its own shard and never leaves it.
+
+  __declspec(thread) unsigned mock_cpu;
+  unsigned mock_processors;
+
+  struct mock_api
+  {
+    static unsigned processor_count() { return mock_processors; }
+    static unsigned current_processor() { return mock_cpu; }
+
+    struct preemption_guard {};
+  };
+
+  typedef basic_sharded_counter<mock_api> counter_type;
+  typedef basic_percpu_histogram<mock_api> histogram_type;
+
+  // the instances are separate and in their own cache lines
+  void test01()
+  {
+    mock_processors = 3;
+    percpu<int, mock_api> data;
+    VERIFY(success(data.initialize()) && data.processor_count() == 3);
+    VERIFY(data[0] == 0 && data[1] == 0 && data[2] == 0);
+    for ( unsigned cpu = 0; cpu < 3; cpu++ )
+    {
+      mock_cpu = cpu;
+      data.local() += cpu + 10;
+    }
+    VERIFY(data[0] == 10 && data[1] == 11 && data[2] == 12);
+    VERIFY(reinterpret_cast<uintptr_t>(&data[1]) % SYSTEM_CACHE_ALIGNMENT_SIZE == 0);
+    VERIFY(reinterpret_cast<uintptr_t>(&data[2]) - reinterpret_cast<uintptr_t>(&data[1]) == SYSTEM_CACHE_ALIGNMENT_SIZE);
+    mock_cpu = 0;
+  }
+
+  // the deltas are folded into the total by the batch
+  void test02()
+  {
+    mock_processors = 2;
+    counter_type counter(8);
+    VERIFY(success(counter.initialize()));
+    VERIFY(counter.approximate() == 0 && counter.exact() == 0 && counter.error_bound() == 16);
+
+    for ( int i = 0; i < 7; i++ )
+      counter.increment();
+    mock_cpu = 1;
+    counter.add(5);
+    VERIFY(counter.approximate() == 0 && counter.exact() == 12);
+
+    // the 8th update of processor 0 is folded
+    mock_cpu = 0;
+    counter.increment();
+    VERIFY(counter.approximate() == 8 && counter.exact() == 13);
+
+    // the negative and the large updates
+    mock_cpu = 1;
+    counter.add(-20);
+    VERIFY(counter.approximate() == -7 && counter.exact() == -7);
+    counter.add(int64_t(1) << 40);
+    VERIFY(counter.exact() == (int64_t(1) << 40) - 7);
+    counter.decrement();
+    VERIFY(counter.exact() - counter.approximate() == -1);
+    mock_cpu = 0;
+  }
+
+  // the buckets cover the whole range, the percentiles are within 25%
+  void test03()
+  {
+    VERIFY(histogram_type::buckets == 252);
+    for ( uint64_t v = 0; v < 5000; v++ )
+    {
+      const unsigned b = histogram_type::bucket_of(v);
+      VERIFY(histogram_type::lower_bound(b) <= v && v <= histogram_type::upper_bound(b));
+    }
+    for ( unsigned b = 0; b + 1 < histogram_type::buckets; b++ )
+    {
+      VERIFY(histogram_type::bucket_of(histogram_type::lower_bound(b)) == b);
+      VERIFY(histogram_type::bucket_of(histogram_type::upper_bound(b)) == b);
+      VERIFY(histogram_type::upper_bound(b) - histogram_type::lower_bound(b) <= histogram_type::lower_bound(b) / 4);
+    }
+    VERIFY(histogram_type::bucket_of(~uint64_t(0)) == histogram_type::buckets - 1);
+
+    mock_processors = 4;
+    histogram_type latencies;
+    VERIFY(success(latencies.initialize()));
+    // 1..1000 spread over the processors
+    for ( uint64_t v = 1; v <= 1000; v++ )
+    {
+      mock_cpu = static_cast<unsigned>(v % 4);
+      latencies.record(v);
+    }
+    mock_cpu = 0;
+    histogram_type::snapshot s;
+    latencies.read(s);
+    VERIFY(s.count == 1000);
+    const uint64_t p50 = s.percentile(500), p99 = s.percentile(990), p100 = s.percentile(1000);
+    VERIFY(p50 >= 500 && p50 <= 500 * 5 / 4);
+    VERIFY(p99 >= 990 && p99 <= 990 * 5 / 4);
+    VERIFY(p100 >= 1000 && p100 <= 1000 * 5 / 4);
+    VERIFY(s.percentile(0) == 1);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the processors update concurrently
+
+  counter_type* shared_counter;
+  histogram_type* shared_histogram;
+  volatile uint64_t global_count;
+  volatile uint64_t cycles;
+
+  void count_sharded(unsigned cpu, uint32_t n)
+  {
+    mock_cpu = cpu;
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    for ( uint32_t i = 0; i < n; i++ )
+      shared_counter->increment();
+    ntl::atomic::exchange_add(cycles, ntl::intrinsic::rdtsc() - t);
+  }
+
+  void count_interlocked(unsigned, uint32_t n)
+  {
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    for ( uint32_t i = 0; i < n; i++ )
+      ntl::atomic::increment(global_count);
+    ntl::atomic::exchange_add(cycles, ntl::intrinsic::rdtsc() - t);
+  }
+
+  void record_latencies(unsigned cpu, uint32_t n)
+  {
+    mock_cpu = cpu;
+    for ( uint32_t i = 0; i < n; i++ )
+    {
+      shared_histogram->record(i % 100);
+      shared_counter->increment();
+    }
+  }
+
+  void run_processors(unsigned processors, void (*func)(unsigned, uint32_t), uint32_t n)
+  {
+    std::vector<std::thread> cpus;
+    for ( unsigned i = 0; i < processors; i++ )
+      cpus.push_back(std::thread(func, i, n));
+    for ( unsigned i = 0; i < processors; i++ )
+      cpus[i].join();
+  }
+
+  void test04()
+  {
+    mock_processors = 8;
+    counter_type counter(64);
+    histogram_type histogram;
+    VERIFY(success(counter.initialize()) && success(histogram.initialize()));
+    shared_counter = &counter;
+    shared_histogram = &histogram;
+
+    run_processors(8, record_latencies, 10007);
+    VERIFY(counter.exact() == 8 * 10007);
+    VERIFY(counter.exact() - counter.approximate() < counter.error_bound());
+    histogram_type::snapshot s;
+    histogram.read(s);
+    VERIFY(s.count == 8 * 10007 && s.percentile(1000) == histogram_type::upper_bound(histogram_type::bucket_of(99)));
+  }
+
+  // the interlocked increments of a global counter against the sharded counter, a shard per thread
+  void bench()
+  {
+    static const uint32_t count = 1000000;
+    for ( unsigned threads = 1; threads <= 64; threads *= 2 )
+    {
+      cycles = 0;
+      global_count = 0;
+      run_processors(threads, count_interlocked, count);
+      const uint64_t t_interlocked = cycles / (threads * count);
+
+      mock_processors = threads;
+      counter_type counter;
+      counter.initialize();
+      shared_counter = &counter;
+      cycles = 0;
+      run_processors(threads, count_sharded, count);
+      const uint64_t t_sharded = cycles / (threads * count);
+      VERIFY(counter.exact() == int64_t(threads) * count && global_count == uint64_t(threads) * count);
+
+      dbg::trace.printf("%2u threads: interlocked counter %3I64u cycles, sharded counter %3I64u cycles per increment\n",
+        threads, t_interlocked, t_sharded);
+    }
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    test04();
+    bench();
+  }
+}
@@ -0,0 +1,439 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <nt/registry.hxx>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstring>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl::nt;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Mock of the Zw* registry calls over an in-memory registry,
+  // the key handle is the address of the key node.
+
+  struct mock_value
+  {
+    std::wstring name;
+    key::value_type type;
+    std::vector<uint8_t> data;
+  };
+
+  struct mock_key
+  {
+    std::vector<std::wstring> subkeys;
+    std::vector<mock_value> values;
+    int64_t last_write_time;
+    std::vector<io_status_block*> watchers;
+    unsigned cancels;
+  };
+
+  struct mock_registry
+  {
+    std::map<std::wstring, mock_key> keys;
+    unsigned calls;
+    void (*on_enumerate_value)();
+  } registry;
+
+  size_t align(size_t n) { return (n + 7) & ~size_t(7); }
+
+  struct mock_registry_api
+  {
+    struct handle_type
+    {
+      legacy_handle h;
+      handle_type() : h() {}
+      legacy_handle get() const { return h; }
+    };
+
+    static mock_key& node(legacy_handle h)
+    {
+      return *const_cast<mock_key*>(reinterpret_cast<const mock_key*>(h));
+    }
+
+    static ntstatus open_key(handle_type& h, const object_attributes& oa, uint32_t)
+    {
+      std::map<std::wstring, mock_key>::iterator it = registry.keys.find(std::wstring(oa.ObjectName->begin(), oa.ObjectName->size()));
+      if(it == registry.keys.end())
+        return status::object_name_not_found;
+      h.h = reinterpret_cast<legacy_handle>(&it->second);
+      return status::success;
+    }
+
+    static ntstatus query_key(legacy_handle h, key_information_class info_class, void* info, uint32_t length, uint32_t& result_length)
+    {
+      registry.calls++;
+      assert(info_class == KeyFullInformation);
+      const mock_key& k = node(h);
+      key::full_information fi = {};
+      fi.LastWriteTime = k.last_write_time;
+      fi.SubKeys = static_cast<uint32_t>(k.subkeys.size());
+      fi.Values = static_cast<uint32_t>(k.values.size());
+      for(size_t i = 0; i < k.subkeys.size(); i++)
+        fi.MaxNameLen = std::max(fi.MaxNameLen, static_cast<uint32_t>(k.subkeys[i].size() * sizeof(wchar_t)));
+      for(size_t i = 0; i < k.values.size(); i++){
+        fi.MaxValueNameLen = std::max(fi.MaxValueNameLen, static_cast<uint32_t>(k.values[i].name.size() * sizeof(wchar_t)));
+        fi.MaxValueDataLen = std::max(fi.MaxValueDataLen, static_cast<uint32_t>(k.values[i].data.size()));
+      }
+      result_length = offsetof(key::full_information, Class);
+      if(length < result_length)
+        return status::buffer_too_small;
+      std::memcpy(info, &fi, result_length);
+      return status::success;
+    }
+
+    static ntstatus enumerate_key(legacy_handle h, uint32_t index, key_information_class info_class, void* info, uint32_t length, uint32_t& result_length)
+    {
+      registry.calls++;
+      assert(info_class == KeyBasicInformation);
+      const mock_key& k = node(h);
+      if(index >= k.subkeys.size())
+        return status::no_more_entries;
+      const std::wstring& name = k.subkeys[index];
+      result_length = static_cast<uint32_t>(offsetof(key_basic_information, Name) + name.size() * sizeof(wchar_t));
+      if(length < result_length)
+        return status::buffer_overflow;
+      key_basic_information* bi = static_cast<key_basic_information*>(info);
+      bi->LastWriteTime = k.last_write_time;
+      bi->TitleIndex = 0;
+      bi->NameLength = static_cast<uint32_t>(name.size() * sizeof(wchar_t));
+      std::memcpy(bi->Name, name.data(), bi->NameLength);
+      return status::success;
+    }
+
+    static ntstatus enumerate_value_key(legacy_handle h, uint32_t index, key_value_information_class info_class, void* info, uint32_t length, uint32_t& result_length)
+    {
+      registry.calls++;
+      assert(info_class == KeyValueFullInformation);
+      if(registry.on_enumerate_value){
+        void (*hook)() = registry.on_enumerate_value;
+        registry.on_enumerate_value = nullptr;
+        hook();
+      }
+      const mock_key& k = node(h);
+      if(index >= k.values.size())
+        return status::no_more_entries;
+      const mock_value& v = k.values[index];
+      const uint32_t name_length = static_cast<uint32_t>(v.name.size() * sizeof(wchar_t));
+      const uint32_t data_offset = static_cast<uint32_t>(align(offsetof(key::value_full_information, Name) + name_length));
+      result_length = data_offset + static_cast<uint32_t>(v.data.size());
+      if(length < result_length)
+        return status::buffer_overflow;
+      key::value_full_information* vi = static_cast<key::value_full_information*>(info);
+      vi->TitleIndex = 0;
+      vi->Type = v.type;
+      vi->DataOffset = data_offset;
+      vi->DataLength = static_cast<uint32_t>(v.data.size());
+      vi->NameLength = name_length;
+      std::memcpy(vi->Name, v.name.data(), name_length);
+      if(!v.data.empty())
+        std::memcpy(static_cast<char*>(info) + data_offset, &v.data[0], v.data.size());
+      return status::success;
+    }
+
+    static ntstatus notify_change_key(legacy_handle h, legacy_handle event, io_status_block* iosb, uint32_t, bool)
+    {
+      registry.calls++;
+      assert(event);
+      node(h).watchers.push_back(iosb);
+      return status::pending;
+    }
+
+    static ntstatus create_event(handle_type& event)
+    {
+      static int events;
+      event.h = reinterpret_cast<legacy_handle>(&events);
+      return status::success;
+    }
+
+    // closing the key completes the pending requests
+    static void cancel_notify_change_key(handle_type& h, legacy_handle)
+    {
+      mock_key& k = node(h.get());
+      for(size_t i = 0; i < k.watchers.size(); i++)
+        k.watchers[i]->Status = status::notify_cleanup;
+      k.watchers.clear();
+      k.cancels++;
+      h.h = legacy_handle();
+    }
+  };
+
+  mock_key& make_key(const std::wstring& path)
+  {
+    mock_key& k = registry.keys[path];
+    k.subkeys.clear(), k.values.clear(), k.watchers.clear();
+    k.cancels = 0;
+    k.last_write_time = 1;
+    return k;
+  }
+
+  void changed(mock_key& k)
+  {
+    k.last_write_time++;
+    for(size_t i = 0; i < k.watchers.size(); i++)
+      k.watchers[i]->Status = status::notify_enum_dir;
+    k.watchers.clear();
+  }
+
+  void set_value(mock_key& k, const std::wstring& name, key::value_type type, const void* data, size_t size)
+  {
+    mock_value* v = nullptr;
+    for(size_t i = 0; i < k.values.size(); i++)
+      if(k.values[i].name == name)
+        v = &k.values[i];
+    if(!v){
+      k.values.push_back(mock_value());
+      v = &k.values.back();
+      v->name = name;
+    }
+    v->type = type;
+    v->data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    changed(k);
+  }
+
+  void set_dword(mock_key& k, const std::wstring& name, uint32_t value)
+  {
+    set_value(k, name, key::reg_dword, &value, sizeof(value));
+  }
+
+  void make_subkeys(mock_key& k, size_t count)
+  {
+    wchar_t name[32];
+    for(size_t i = 0; i < count; i++){
+      _snwprintf(name, _countof(name), L"subkey_%06u", static_cast<unsigned>(i));
+      k.subkeys.push_back(name);
+    }
+  }
+
+  legacy_handle handle_of(const mock_key& k) { return reinterpret_cast<legacy_handle>(&k); }
+
+  typedef basic_subkey_iterator<mock_registry_api> mock_subkey_iterator;
+  typedef basic_key_snapshot<mock_registry_api> mock_snapshot;
+
+  // the subkeys are enumerated by one call each, the longest name fits the iterator
+  void test01()
+  {
+    mock_key& k = make_key(L"\\Registry\\Machine\\Hive");
+    make_subkeys(k, 1000);
+    k.subkeys.push_back(std::wstring(mock_subkey_iterator::max_name_length, L'x'));
+
+    registry.calls = 0;
+    size_t n = 0;
+    for(mock_subkey_iterator it(handle_of(k), 0), end; it != end; ++it, ++n){
+      const const_unicode_string name = it.view();
+      VERIFY(std::wstring(name.begin(), name.size()) == k.subkeys[n]);
+      if(n % 100 == 0)
+        VERIFY(*it == k.subkeys[n] && it->size() == k.subkeys[n].size());
+    }
+    VERIFY(n == k.subkeys.size());
+    VERIFY(registry.calls == n + 1);
+
+    mock_key& empty = make_key(L"\\Registry\\Machine\\Empty");
+    VERIFY(mock_subkey_iterator(handle_of(empty), 0) == mock_subkey_iterator());
+  }
+
+  void added_during_capture()
+  {
+    set_dword(registry.keys[L"\\Registry\\Machine\\Config"], L"Late", 7);
+  }
+
+  // snapshot: one arena, reused by the next capture; the capture is repeated if the key changes
+  void test02()
+  {
+    mock_key& k = make_key(L"\\Registry\\Machine\\Config");
+    make_subkeys(k, 300);
+    wchar_t name[32];
+    for(uint32_t i = 0; i < 50; i++){
+      _snwprintf(name, _countof(name), L"Value_%u", i);
+      set_dword(k, name, i * 3);
+    }
+    const wchar_t path[] = L"C:\\Program Files\\Agent\0";
+    set_value(k, L"InstallPath", key::reg_sz, path, sizeof(path));
+    const uint8_t blob[] = { 1, 2, 3, 4, 5 };
+    set_value(k, L"Blob", key::reg_binary, blob, sizeof(blob));
+
+    mock_snapshot snap;
+    VERIFY(snap.capture(handle_of(k)) == status::success);
+    VERIFY(snap.subkey_count() == 300 && snap.value_count() == 52 && snap.allocations() == 1);
+    for(uint32_t i = 0; i < snap.subkey_count(); i++)
+      VERIFY(std::wstring(snap.subkey(i).begin(), snap.subkey(i).size()) == k.subkeys[i]);
+    VERIFY(snap.last_write_time() == k.last_write_time);
+
+    uint32_t dw = 0;
+    VERIFY(snap.query(L"value_17", dw) && dw == 51);
+    VERIFY(!snap.query(L"InstallPath", dw));
+    const_unicode_string s;
+    VERIFY(snap.query(L"INSTALLPATH", s) && std::wstring(s.begin(), s.size()) == L"C:\\Program Files\\Agent");
+    const mock_snapshot::value_entry* v = snap.find(L"Blob");
+    VERIFY(v && v->type == key::reg_binary && v->size == sizeof(blob) && std::memcmp(v->data, blob, sizeof(blob)) == 0);
+    VERIFY(!snap.find(L"Missing"));
+
+    // the smaller key reuses the arena
+    mock_key& small = make_key(L"\\Registry\\Machine\\Small");
+    set_dword(small, L"A", 1);
+    set_dword(small, L"\x00C9t\x00E9", 2);
+    VERIFY(snap.capture(handle_of(small)) == status::success);
+    VERIFY(snap.value_count() == 2 && snap.subkey_count() == 0 && snap.allocations() == 1);
+    // the letters beyond ASCII are folded too
+    VERIFY(snap.query(L"\x00E9T\x00C9", dw) && dw == 2 && !snap.query(L"ETE", dw));
+
+    // the value added between the enumerations is captured by the retry
+    registry.on_enumerate_value = added_during_capture;
+    VERIFY(snap.capture(handle_of(k)) == status::success);
+    VERIFY(snap.value_count() == 53 && snap.query(L"Late", dw) && dw == 7);
+
+    // one large value among the small ones grows the arena once instead of inflating every value
+    mock_key& big = make_key(L"\\Registry\\Machine\\Big");
+    make_subkeys(big, 10);
+    for(uint32_t i = 0; i < 1000; i++){
+      _snwprintf(name, _countof(name), L"Value_%u", i);
+      set_dword(big, name, i);
+      if(i == 500){
+        const std::vector<uint8_t> large(1024 * 1024, 0x5A);
+        set_value(big, L"Large", key::reg_binary, &large[0], large.size());
+      }
+    }
+    mock_snapshot big_snap;
+    VERIFY(big_snap.capture(handle_of(big)) == status::success);
+    VERIFY(big_snap.value_count() == 1001 && big_snap.subkey_count() == 10 && big_snap.allocations() == 2);
+    for(uint32_t i = 0; i < 1000; i++){
+      _snwprintf(name, _countof(name), L"value_%u", i);
+      VERIFY(big_snap.query(const_unicode_string(name, std::wcslen(name)), dw) && dw == i);
+    }
+    VERIFY(std::wstring(big_snap.subkey(3).begin(), big_snap.subkey(3).size()) == big.subkeys[3]);
+    v = big_snap.find(L"Large");
+    VERIFY(v && v->size == 1024 * 1024 && static_cast<const uint8_t*>(v->data)[0] == 0x5A && static_cast<const uint8_t*>(v->data)[v->size - 1] == 0x5A);
+  }
+
+  // cache: the repeated reads don't touch the registry until the key changes
+  void test03()
+  {
+    mock_key& k = make_key(L"\\Registry\\Machine\\Agent");
+    set_dword(k, L"Timeout", 30);
+    set_dword(k, L"Retries", 3);
+
+    const const_unicode_string key_name(L"\\Registry\\Machine\\Agent");
+    {
+      basic_key_cache<mock_registry_api> cache((object_attributes(key_name)));
+      VERIFY(success(cache.last_status()));
+
+      uint32_t dw = 0;
+      VERIFY(cache.query(L"Timeout", dw) && dw == 30);
+      registry.calls = 0;
+      for(int i = 0; i < 1000; i++)
+        VERIFY(cache.query(L"Retries", dw) && dw == 3);
+      VERIFY(registry.calls == 0 && cache.refreshes() == 1);
+
+      set_dword(k, L"Timeout", 60);
+      VERIFY(cache.query(L"Timeout", dw) && dw == 60);
+      VERIFY(cache.refreshes() == 2);
+      VERIFY(cache.query(L"Timeout", dw) && cache.refreshes() == 2);
+      VERIFY(k.watchers.size() == 1 && k.cancels == 0);
+    }
+    // the pending notification is completed before its io_status_block is gone
+    VERIFY(k.watchers.empty() && k.cancels == 1);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the previous enumeration: a new buffer for every subkey, retried from scratch on overflow
+
+  size_t legacy_enumerate(legacy_handle h, std::wstring& last)
+  {
+    size_t n = 0;
+    for(uint32_t index = 0; ; index++, n++){
+      uint32_t size = 64 - 2*sizeof(void*);
+      for(;;){
+        uint8_t* const buf = new uint8_t[size];
+        const ntstatus s = mock_registry_api::enumerate_key(h, index, KeyBasicInformation, buf, size, size);
+        if(s == status::buffer_overflow){
+          delete[] buf;
+          continue;
+        }
+        if(s == status::success){
+          const key_basic_information& p = *reinterpret_cast<key_basic_information*>(buf);
+          last.assign(&p.Name[0], p.NameLength / sizeof(wchar_t));
+          delete[] buf;
+          break;
+        }
+        delete[] buf;
+        return n;
+      }
+    }
+  }
+
+  void bench()
+  {
+    mock_key& hive = make_key(L"\\Registry\\Machine\\Large");
+    make_subkeys(hive, 100000);
+
+    registry.calls = 0;
+    std::wstring last;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    const size_t n_legacy = legacy_enumerate(handle_of(hive), last);
+    const uint64_t t_legacy = ntl::intrinsic::rdtsc() - t;
+    const unsigned calls_legacy = registry.calls;
+
+    registry.calls = 0;
+    size_t n = 0, chars = 0;
+    t = ntl::intrinsic::rdtsc();
+    for(mock_subkey_iterator it(handle_of(hive), 0), end; it != end; ++it, ++n)
+      chars += it.view().size();
+    const uint64_t t_views = ntl::intrinsic::rdtsc() - t;
+    VERIFY(n == n_legacy);
+
+    dbg::trace.printf("100k subkeys, new[] per entry: %u calls, %I64u cycles/subkey\n", calls_legacy, t_legacy / n_legacy);
+    dbg::trace.printf("100k subkeys, iterator views:  %u calls, %I64u cycles/subkey\n", registry.calls, t_views / n);
+
+    // the config reads: capture per read against the cache
+    mock_key& config = make_key(L"\\Registry\\Machine\\Agent");
+    for(uint32_t i = 0; i < 20; i++){
+      wchar_t name[32];
+      _snwprintf(name, _countof(name), L"Setting_%u", i);
+      set_dword(config, name, i);
+    }
+    static const unsigned reads = 100000;
+    uint32_t dw, sum = 0;
+    mock_snapshot snap;
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < reads; i++){
+      snap.capture(handle_of(config));
+      snap.query(L"Setting_13", dw);
+      sum += dw;
+    }
+    const uint64_t t_capture = ntl::intrinsic::rdtsc() - t;
+
+    const const_unicode_string key_name(L"\\Registry\\Machine\\Agent");
+    basic_key_cache<mock_registry_api> cache((object_attributes(key_name)));
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < reads; i++){
+      cache.query(L"Setting_13", dw);
+      sum += dw;
+    }
+    const uint64_t t_cache = ntl::intrinsic::rdtsc() - t;
+    VERIFY(sum == 2 * reads * 13);
+
+    dbg::trace.printf("config read, capture each time: %I64u cycles/read\n", t_capture / reads);
+    dbg::trace.printf("config read, key_cache:         %I64u cycles/read\n", t_cache / reads);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
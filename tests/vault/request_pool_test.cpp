@@ -0,0 +1,339 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <km/request_pool.hxx>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <deque>
+#include <cstring>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl::km;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Stand-in of the kernel: the processors are the threads which set their number,
+  // the lookaside list is the locked heap which counts the blocks and spends `heap_cycles` as the pool allocator would.
+
+  __declspec(thread) unsigned mock_cpu;
+
+  struct mock_kernel
+  {
+    unsigned processors;
+    std::mutex heap_guard;
+    unsigned heap_blocks, heap_allocations;
+    bool heap_full;
+    unsigned heap_cycles;
+    std::mutex list_guards[16];
+  } kernel;
+
+  void spend(unsigned cycles)
+  {
+    for ( const uint64_t end = ntl::intrinsic::rdtsc() + cycles; ntl::intrinsic::rdtsc() < end; )
+      ;
+  }
+
+  template<class Cell>
+  struct mock_lookaside_list
+  {
+    Cell * allocate()
+    {
+      std::lock_guard<std::mutex> lock(kernel.heap_guard);
+      spend(kernel.heap_cycles);
+      if ( kernel.heap_full )
+        return 0;
+      kernel.heap_blocks++, kernel.heap_allocations++;
+      return reinterpret_cast<Cell*>(new uint64_t[(sizeof(Cell) + 7) / 8]);
+    }
+
+    void free(void * p)
+    {
+      std::lock_guard<std::mutex> lock(kernel.heap_guard);
+      spend(kernel.heap_cycles);
+      kernel.heap_blocks--;
+      delete[] static_cast<uint64_t*>(p);
+    }
+  };
+
+  struct mock_api
+  {
+    template<class CellType>
+    struct lookaside
+    {
+      typedef mock_lookaside_list<CellType> type;
+    };
+
+    static unsigned processor_count() { return kernel.processors; }
+    static unsigned current_processor() { return mock_cpu; }
+
+    static std::mutex & guard(const slist_header & list)
+    {
+      return kernel.list_guards[(reinterpret_cast<uintptr_t>(&list) / SYSTEM_CACHE_ALIGNMENT_SIZE) % _countof(kernel.list_guards)];
+    }
+
+    static slist_entry * pop(slist_header & list, kspin_lock &)
+    {
+      std::lock_guard<std::mutex> lock(guard(list));
+      slist_entry * e = list.Next;
+      if ( e )
+        list.Next = e->Next, list.Depth--;
+      return e;
+    }
+
+    static void push(slist_header & list, slist_entry * e, kspin_lock &)
+    {
+      std::lock_guard<std::mutex> lock(guard(list));
+      e->Next = list.Next;
+      list.Next = e;
+      list.Depth++;
+    }
+  };
+
+  void reset_kernel(unsigned processors)
+  {
+    kernel.processors = processors;
+    kernel.heap_blocks = kernel.heap_allocations = 0;
+    kernel.heap_full = false;
+    kernel.heap_cycles = 0;
+    mock_cpu = 0;
+  }
+
+  struct request_context
+  {
+    static volatile int32_t alive;
+    uint32_t sequence;
+    uint8_t  buffer[200];
+
+    request_context() : sequence(0xCAFE) { ntl::atomic::increment(alive); }
+    ~request_context() { ntl::atomic::decrement(alive); }
+  };
+  volatile int32_t request_context::alive;
+
+  typedef request_pool<request_context, mock_api> pool_type;
+
+  // the reserve serves the requests, the misses and the overflows go to the lookaside list
+  void test01()
+  {
+    reset_kernel(2);
+    {
+      pool_type pool;
+      VERIFY(success(pool.initialize(4, 6)));
+      VERIFY(kernel.heap_blocks == 8 && pool.stats().cells == 8 && pool.stats().peak == 8);
+
+      request_context * held[10];
+      for ( int i = 0; i < 10; i++ )
+      {
+        held[i] = pool.allocate();
+        VERIFY(held[i] && held[i]->sequence == 0xCAFE);
+      }
+      VERIFY(request_context::alive == 10);
+      request_pool_stats s = pool.stats();
+      // the own cache, then the cache of the other processor, then the lookaside list
+      VERIFY(s.hits == 4 && s.steals == 4 && s.misses == 2 && s.in_use() == 10 && s.cells == 10 && s.peak == 10);
+
+      // a context may be freed on another processor, the cache of which keeps up to 6 of them
+      mock_cpu = 1;
+      for ( int i = 0; i < 10; i++ )
+        pool.free(held[i]);
+      VERIFY(request_context::alive == 0);
+      s = pool.stats();
+      VERIFY(s.frees == 10 && s.in_use() == 0 && s.cells == 6 && s.peak == 10);
+      VERIFY(kernel.heap_blocks == 6);
+
+      // the cache of processor 1 serves now
+      const unsigned allocations = kernel.heap_allocations;
+      request_context * p = pool.allocate();
+      VERIFY(p && pool.stats().hits == 5 && kernel.heap_allocations == allocations);
+      pool.free(p);
+    }
+    {
+      // out of memory
+      pool_type pool;
+      VERIFY(success(pool.initialize(0)));
+      kernel.heap_full = true;
+      VERIFY(pool.allocate() == 0 && pool.stats().failures == 1);
+      kernel.heap_full = false;
+    }
+    // the cached contexts go back
+    VERIFY(kernel.heap_blocks == 0);
+  }
+
+  // the context attached to an IRP lives until taken back
+  void test02()
+  {
+    reset_kernel(1);
+    pool_type pool;
+    VERIFY(success(pool.initialize(2)));
+
+    irp Irp;
+    std::memset(&Irp, 0, sizeof(Irp));
+    {
+      pool_type::context_ptr context(pool);
+      VERIFY(context && context->sequence == 0xCAFE);
+      context->sequence = 42;
+      context.attach(Irp);
+      VERIFY(!context);
+    }
+    VERIFY(request_context::alive == 1 && pool.stats().in_use() == 1);
+    VERIFY(pool_type::context_ptr::attached(Irp)->sequence == 42);
+    {
+      // completion
+      pool_type::context_ptr context(pool, Irp);
+      VERIFY(context && context->sequence == 42);
+      VERIFY(pool_type::context_ptr::attached(Irp) == 0);
+    }
+    VERIFY(request_context::alive == 0 && pool.stats().in_use() == 0);
+
+    // released contexts are freed by the caller
+    request_context * p;
+    {
+      pool_type::context_ptr context(pool);
+      p = context.release();
+    }
+    VERIFY(request_context::alive == 1);
+    pool.free(p);
+    VERIFY(pool.stats().hits == 2 && pool.stats().misses == 0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // IRP arrival simulation: each processor receives a number of requests per tick, keeps each one in flight
+  // for a number of ticks and completes some of them on the next processor, as a DPC of another processor would.
+
+  struct simulation
+  {
+    unsigned ticks;
+    unsigned arrivals;      // mean arrivals per tick and processor
+    unsigned service;       // ticks in flight
+    unsigned remote;        // 1 of the `remote` completions runs on another processor
+  };
+
+  struct direct_allocator
+  {
+    request_context * allocate()
+    {
+      mock_lookaside_list<request_context> heap;
+      request_context * p = heap.allocate();
+      return p ? new (p) request_context() : 0;
+    }
+    void free(request_context * p)
+    {
+      p->~request_context();
+      mock_lookaside_list<request_context>().free(p);
+    }
+  };
+
+  template<class Allocator>
+  void processor(Allocator & allocator, const simulation & sim, unsigned cpu, uint64_t * cycles, unsigned * requests)
+  {
+    mock_cpu = cpu;
+    std::deque<std::pair<unsigned, request_context*> > in_flight;
+    uint32_t seed = 12345 + cpu;
+    unsigned n = 0;
+    const uint64_t start = ntl::intrinsic::rdtsc();
+    for ( unsigned tick = 0; tick < sim.ticks; tick++ )
+    {
+      seed = seed * 1664525 + 1013904223;
+      const unsigned count = (seed >> 16) % (sim.arrivals * 2 + 1);
+      for ( unsigned i = 0; i < count; i++, n++ )
+      {
+        request_context * p = allocator.allocate();
+        VERIFY(p);
+        in_flight.push_back(std::make_pair(tick + sim.service, p));
+      }
+      for ( ; !in_flight.empty() && in_flight.front().first <= tick; in_flight.pop_front() )
+      {
+        const bool remote = sim.remote && (seed >> 8) % sim.remote == 0;
+        mock_cpu = remote ? (cpu + 1) % kernel.processors : cpu;
+        allocator.free(in_flight.front().second);
+        mock_cpu = cpu;
+      }
+    }
+    for ( ; !in_flight.empty(); in_flight.pop_front() )
+      allocator.free(in_flight.front().second);
+    *cycles = ntl::intrinsic::rdtsc() - start;
+    *requests = n;
+  }
+
+  template<class Allocator>
+  uint64_t simulate(Allocator & allocator, const simulation & sim, unsigned * total)
+  {
+    std::vector<std::thread> cpus;
+    std::vector<uint64_t> cycles(kernel.processors);
+    std::vector<unsigned> requests(kernel.processors);
+    for ( unsigned i = 0; i < kernel.processors; i++ )
+      cpus.push_back(std::thread(processor<Allocator>, std::ref(allocator), std::cref(sim), i, &cycles[i], &requests[i]));
+    uint64_t sum = 0;
+    *total = 0;
+    for ( unsigned i = 0; i < kernel.processors; i++ )
+    {
+      cpus[i].join();
+      sum += cycles[i];
+      *total += requests[i];
+    }
+    return sum;
+  }
+
+  // the counters stay consistent under the concurrent use
+  void test03()
+  {
+    reset_kernel(4);
+    pool_type pool;
+    VERIFY(success(pool.initialize(8, 16)));
+    const simulation sim = { 2000, 4, 3, 4 };
+    unsigned requests;
+    simulate(pool, sim, &requests);
+    const request_pool_stats s = pool.stats();
+    VERIFY(s.hits + s.steals + s.misses == requests && s.frees == requests && s.in_use() == 0);
+    VERIFY(s.cells == kernel.heap_blocks && s.peak >= s.cells && request_context::alive == 0);
+  }
+
+  void bench()
+  {
+    static const simulation loads[] =
+    {
+      { 20000,  2, 4, 0 },
+      { 20000,  8, 4, 4 },
+      { 20000, 32, 8, 2 },
+    };
+    reset_kernel(4);
+    // about the cost of ExAllocatePoolWithTag
+    kernel.heap_cycles = 300;
+    for ( size_t i = 0; i < _countof(loads); i++ )
+    {
+      const simulation & sim = loads[i];
+      unsigned requests;
+
+      direct_allocator direct;
+      const uint64_t t_direct = simulate(direct, sim, &requests);
+
+      pool_type pool;
+      // sized by the expected requests in flight
+      pool.initialize(static_cast<uint16_t>(sim.arrivals * sim.service));
+      const uint64_t t_pool = simulate(pool, sim, &requests);
+      const request_pool_stats s = pool.stats();
+
+      dbg::trace.printf("%2u arrivals/tick, %u ticks in flight, 1/%u remote: direct %I64u, pool %I64u cycles/request, %u%% hits, %u%% steals, peak %u\n",
+        sim.arrivals, sim.service, sim.remote, t_direct / requests, t_pool / requests,
+        static_cast<unsigned>(uint64_t(s.hits) * 100 / requests), static_cast<unsigned>(uint64_t(s.steals) * 100 / requests), s.peak);
+    }
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,350 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <typeinfo>
+#include <cstddef>
+#include <cstring>
+#include <nt/exception.hxx>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+extern "C" void* __cdecl __RTDynamicCast(void* object, int32_t vfdelta, void* srctype, void* desttype, int isreference) throw(...);
+
+namespace
+{
+  // the deep single inheritance
+  struct base
+  {
+    virtual ~base() {}
+    int b;
+  };
+
+  template<int N>
+  struct level: level<N - 1>
+  {
+    int v;
+  };
+
+  template<>
+  struct level<0>: base
+  {};
+
+  typedef level<12> deep;
+
+  // the multiple inheritance
+  struct left
+  {
+    virtual ~left() {}
+    int l;
+  };
+
+  struct right
+  {
+    virtual ~right() {}
+    int r;
+  };
+
+  struct both: left, right
+  {
+    int x;
+  };
+
+  struct more: both
+  {
+    int m;
+  };
+
+  struct other: left
+  {};
+
+  // the casts are repeated to check them from the cache too
+  void test01()
+  {
+    deep d;
+    level<3> l3;
+    base* const pd = &d, * const p3 = &l3;
+    for ( int pass = 0; pass < 3; pass++ )
+    {
+      VERIFY(dynamic_cast<deep*>(pd) == &d);
+      VERIFY(dynamic_cast<level<5>*>(pd) == static_cast<level<5>*>(&d));
+      VERIFY(dynamic_cast<level<3>*>(p3) == &l3);
+      VERIFY(dynamic_cast<deep*>(p3) == 0 && dynamic_cast<level<4>*>(p3) == 0);
+      VERIFY(dynamic_cast<void*>(pd) == &d);
+    }
+
+    more m;
+    other o;
+    right* const pr = &m;
+    left* const pl = &m, * const po = &o;
+    for ( int pass = 0; pass < 3; pass++ )
+    {
+      // the cross casts adjust the pointer by the offset of the base
+      VERIFY(dynamic_cast<left*>(pr) == static_cast<left*>(&m));
+      VERIFY(dynamic_cast<right*>(pl) == pr);
+      VERIFY(dynamic_cast<both*>(pr) == static_cast<both*>(&m) && dynamic_cast<more*>(pr) == &m);
+      VERIFY(dynamic_cast<other*>(pl) == 0 && dynamic_cast<other*>(po) == &o);
+      VERIFY(dynamic_cast<right*>(po) == 0 && dynamic_cast<more*>(po) == 0);
+      VERIFY(dynamic_cast<void*>(pr) == &m);
+    }
+
+    // the same types through the other objects
+    both b;
+    right* const pb = &b;
+    VERIFY(dynamic_cast<more*>(pb) == 0 && dynamic_cast<both*>(pb) == &b && dynamic_cast<more*>(pr) == &m);
+
+    VERIFY(typeid(*pr) == typeid(more) && typeid(*pb) != typeid(more) && typeid(*pd) == typeid(deep));
+    VERIFY(typeid(deep) == typeid(level<12>) && typeid(level<3>) != typeid(level<4>));
+
+#if STLX__USE_EXCEPTIONS
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+      bool thrown = false;
+      try
+      {
+        dynamic_cast<other&>(*pl);
+      }
+      catch(const std::bad_cast&)
+      {
+        thrown = true;
+      }
+      VERIFY(thrown && &dynamic_cast<more&>(*pr) == &m);
+    }
+#endif
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // The synthetic MSVC RTTI: the object locators, the class hierarchy and its base
+  // class array of `complete: left, right` are built here and __RTDynamicCast walks
+  // them. A cached result is told from a resolved one by changing the hierarchy.
+
+#ifdef _M_X64
+  typedef uint32_t rtti_ref; // the offset from the image base
+#else
+  typedef const void* rtti_ref;
+#endif
+
+  struct synthetic_type
+  {
+    const void* vptr;
+    void*       spare;
+    char        name[16];
+  };
+
+#pragma pack(push, 4)
+  struct synthetic_base
+  {
+    rtti_ref  type;
+    uint32_t  bases;
+    int32_t   member_offset;
+    int32_t   vbtable_offset;
+    int32_t   vdisp_offset;
+    uint32_t  attributes;
+    rtti_ref  hierarchy;
+  };
+
+  struct synthetic_hierarchy
+  {
+    uint32_t  signature;
+    uint32_t  attributes;
+    uint32_t  bases;
+    rtti_ref  classes;
+  };
+
+  struct synthetic_locator
+  {
+    uint32_t  signature;
+    int32_t   offset;
+    int32_t   cdoffset;
+    rtti_ref  type;
+    rtti_ref  hierarchy;
+#ifdef _M_X64
+    int32_t   self;
+#else
+    const synthetic_locator* self;
+#endif
+  };
+#pragma pack(pop)
+
+  enum { complete_type, left_type, right_type, unrelated_type };
+  enum { left_locator, right_locator, vtordisp_locator };
+
+  struct synthetic_image
+  {
+    synthetic_type      types[4];
+    synthetic_base      bases[3];
+    rtti_ref            classes[3];
+    synthetic_hierarchy hierarchy;
+    synthetic_locator   locators[3];
+  } image;
+
+  // the vftable of the locator, its [-1] entry is the locator
+  const void* vftables[3][2];
+
+  struct synthetic_object
+  {
+    int32_t     padding;
+    int32_t     vtordisp;
+    const void* left;
+    const void* right;
+  };
+
+  rtti_ref ref(const void* p)
+  {
+#ifdef _M_X64
+    return static_cast<rtti_ref>(reinterpret_cast<const char*>(p) - reinterpret_cast<const char*>(&image));
+#else
+    return p;
+#endif
+  }
+
+  void build_image()
+  {
+    static const char* const names[4] = { ".?AUcomplete@@", ".?AUleft@@", ".?AUright@@", ".?AUunrelated@@" };
+    for ( int i = 0; i < 4; i++ )
+      std::strcpy(image.types[i].name, names[i]);
+
+    static const int32_t offsets[3] = { 0, offsetof(synthetic_object, left), offsetof(synthetic_object, right) };
+    for ( int i = 0; i < 3; i++ )
+    {
+      synthetic_base& base = image.bases[i];
+      base.type = ref(&image.types[i]);
+      base.bases = i == complete_type ? 2 : 0;
+      base.member_offset = offsets[i];
+      base.vbtable_offset = -1;
+      base.vdisp_offset = 0;
+      base.attributes = 0;
+      base.hierarchy = ref(&image.hierarchy);
+      image.classes[i] = ref(&base);
+    }
+    image.hierarchy.signature = 0;
+    image.hierarchy.attributes = 1; // multiple
+    image.hierarchy.bases = 3;
+    image.hierarchy.classes = ref(image.classes);
+
+    for ( int i = 0; i < 3; i++ )
+    {
+      synthetic_locator& locator = image.locators[i];
+      locator.offset = offsets[i == right_locator ? right_type : left_type];
+      // the displacement of the complete object is read from the vtordisp field
+      locator.cdoffset = i == vtordisp_locator ? static_cast<int32_t>(offsetof(synthetic_object, left) - offsetof(synthetic_object, vtordisp)) : 0;
+      locator.type = ref(&image.types[complete_type]);
+      locator.hierarchy = ref(&image.hierarchy);
+#ifdef _M_X64
+      locator.signature = 1;
+      locator.self = ref(&locator);
+#else
+      locator.signature = 0;
+      locator.self = &locator;
+#endif
+      vftables[i][0] = &locator;
+      vftables[i][1] = 0;
+    }
+  }
+
+  void* cast(const void* object, int srctype, int desttype, bool isreference = false)
+  {
+    return __RTDynamicCast(const_cast<void*>(object), 0, &image.types[srctype], &image.types[desttype], isreference);
+  }
+
+  const void* shifted(const void* p, int offset)
+  {
+    return reinterpret_cast<const char*>(p) + offset;
+  }
+
+  void test02()
+  {
+    using ntl::cxxruntime::flush_type_caches;
+    build_image();
+    synthetic_object o = { 0, 0, &vftables[left_locator][1], &vftables[right_locator][1] };
+    const void* const pl = &o.left, * const pr = &o.right;
+
+    // the first casts are resolved by the hierarchy
+    VERIFY(cast(pl, left_type, complete_type) == &o);
+    VERIFY(cast(pr, right_type, left_type) == pl);
+    VERIFY(cast(pl, left_type, unrelated_type) == 0);
+
+    // the hit does not read the changed hierarchy, the miss of a new key does
+    VERIFY(cast(pl, left_type, right_type) == pr);
+    image.bases[right_type].member_offset += 8;
+    VERIFY(cast(pl, left_type, right_type) == pr);
+    VERIFY(cast(pr, right_type, complete_type) == 0);
+    flush_type_caches();
+    VERIFY(cast(pl, left_type, right_type) == shifted(pr, 8));
+    image.bases[right_type].member_offset -= 8;
+    flush_type_caches();
+    VERIFY(cast(pr, right_type, complete_type) == &o);
+
+    // the failed cast is cached as the failure marker
+    VERIFY(cast(pl, left_type, unrelated_type) == 0);
+    image.bases[right_type].type = ref(&image.types[unrelated_type]);
+    VERIFY(cast(pl, left_type, unrelated_type) == 0);
+#if STLX__USE_EXCEPTIONS
+    bool thrown = false;
+    try
+    {
+      cast(pl, left_type, unrelated_type, true);
+    }
+    catch(const std::bad_cast&)
+    {
+      thrown = true;
+    }
+    VERIFY(thrown);
+#endif
+    flush_type_caches();
+    VERIFY(cast(pl, left_type, unrelated_type) == pr);
+    image.bases[right_type].type = ref(&image.types[right_type]);
+    flush_type_caches();
+    VERIFY(cast(pl, left_type, unrelated_type) == 0);
+
+    // the result through the locator with vtordisp is never cached
+    synthetic_object v = { 0, 0, &vftables[vtordisp_locator][1], &vftables[right_locator][1] };
+    VERIFY(cast(pl, left_type, right_type) == pr);
+    VERIFY(cast(&v.left, left_type, right_type) == &v.right);
+    image.bases[right_type].member_offset += 8;
+    VERIFY(cast(&v.left, left_type, right_type) == shifted(&v.right, 8));
+    VERIFY(cast(pl, left_type, right_type) == pr);
+    image.bases[right_type].member_offset -= 8;
+    VERIFY(cast(&v.left, left_type, right_type) == &v.right);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+
+  template<class To, class From>
+  uint64_t cast_cycles(From* p, size_t& found)
+  {
+    static const int count = 100000;
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    for ( int i = 0; i < count; i++ )
+      found += dynamic_cast<To*>(p) != 0;
+    return (ntl::intrinsic::rdtsc() - t) / count;
+  }
+
+  void bench()
+  {
+    deep d;
+    level<3> l3;
+    more m;
+    both b;
+    size_t found = 0;
+    const uint64_t t_deep = cast_cycles<deep>(static_cast<base*>(&d), found);
+    const uint64_t t_failed = cast_cycles<deep>(static_cast<base*>(&l3), found);
+    const uint64_t t_cross = cast_cycles<left>(static_cast<right*>(&m), found);
+    const uint64_t t_down = cast_cycles<more>(static_cast<right*>(&b), found);
+    dbg::trace.printf("dynamic_cast: deep %3I64u, deep failed %3I64u, cross %3I64u, multiple failed %3I64u cycles (%u)\n",
+      t_deep, t_failed, t_cross, t_down, static_cast<unsigned>(found));
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}
@@ -0,0 +1,118 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <static_init.hxx>
+#include <cstdlib>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using ntl::parallel_static;
+  using ntl::static_objects;
+  using ntl::abandon_on_fast_exit;
+
+  // the order of the constructors and the destructors
+  volatile uint32_t constructed, destroyed;
+  volatile uint64_t work_cycles;
+
+  template<int N>
+  struct object
+  {
+    static uint32_t order, gone;
+
+    object()
+    {
+      const uint64_t t = ntl::intrinsic::rdtsc();
+      // some work to let the workers overlap
+      volatile uint32_t x = N;
+      for ( int i = 0; i < 200000; i++ )
+        x = x * 1664525 + 1013904223;
+      order = ntl::atomic::increment(constructed);
+      ntl::atomic::exchange_add(work_cycles, ntl::intrinsic::rdtsc() - t);
+    }
+
+    ~object()
+    {
+      gone = ntl::atomic::increment(destroyed);
+    }
+  };
+
+  template<int N> uint32_t object<N>::order;
+  template<int N> uint32_t object<N>::gone;
+
+  // the diamond: 1 <- 2, 3 <- 4, where 4 is defined before its dependencies
+  extern parallel_static<object<2> > o2;
+  extern parallel_static<object<3> > o3;
+  parallel_static<object<4> > o4(o2, o3);
+  parallel_static<object<1> > o1;
+  parallel_static<object<2> > o2(o1);
+  parallel_static<object<3> > o3(o1);
+
+  // the chain
+  parallel_static<object<10> > c0;
+  parallel_static<object<11> > c1(c0);
+  parallel_static<object<12> > c2(c1);
+  parallel_static<object<13> > c3(c2, o4);
+
+  // the independent ones, abandoned at the fast exit
+  parallel_static<object<20>, abandon_on_fast_exit> a0;
+  parallel_static<object<21>, abandon_on_fast_exit> a1(o1);
+  parallel_static<object<22> > a2;
+  parallel_static<object<23> > a3;
+  parallel_static<object<24> > a4;
+  parallel_static<object<25> > a5;
+
+  template<int A, int B>
+  bool before()
+  {
+    return object<A>::order && object<A>::order < object<B>::order;
+  }
+
+  template<int A, int B>
+  bool destroyed_before()
+  {
+    return object<A>::gone && object<A>::gone < object<B>::gone;
+  }
+
+  void test01()
+  {
+    VERIFY(!static_objects::initialized() && !o1.ready() && !a5.ready());
+
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    VERIFY(static_objects::initialize(4) == 14);
+    const uint64_t startup = ntl::intrinsic::rdtsc() - t;
+    VERIFY(static_objects::initialized() && constructed == 14);
+    VERIFY(o1.ready() && o4.ready() && c3.ready() && a5.ready());
+
+    VERIFY((before<1, 2>() && before<1, 3>() && before<2, 4>() && before<3, 4>()));
+    VERIFY((before<10, 11>() && before<11, 12>() && before<12, 13>() && before<4, 13>() && before<1, 21>()));
+    VERIFY(&*o4 == &o4.get() && destroyed == 0);
+
+    dbg::trace.printf("static_objects: 14 objects by 4 threads %6I64u Kcycles, the constructors %6I64u Kcycles\n",
+      startup / 1000, work_cycles / 1000);
+  }
+
+  // runs after the teardown, which is registered later
+  void __cdecl check_teardown()
+  {
+    VERIFY(destroyed == 12 && object<20>::gone == 0 && object<21>::gone == 0);
+    VERIFY((destroyed_before<4, 2>() && destroyed_before<4, 3>() && destroyed_before<2, 1>() && destroyed_before<3, 1>()));
+    VERIFY((destroyed_before<13, 12>() && destroyed_before<12, 11>() && destroyed_before<11, 10>() && destroyed_before<13, 4>()));
+    VERIFY(!o1.ready() && !c3.ready() && a0.ready());
+  }
+
+  void main()
+  {
+    std::atexit(check_teardown);
+    test01();
+    static_objects::fast_exit_mode();
+  }
+}
@@ -0,0 +1,261 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <nt/string_view.hxx>
+#include <string>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using ntl::nt::unicode_string_view;
+  using ntl::nt::ci_unicode_string_view;
+  using ntl::nt::inline_unicode_string;
+  using ntl::nt::const_unicode_string;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  // the allocator which counts the spills of the builders
+  size_t allocations, deallocations;
+
+  struct counting_allocator:
+    public std::allocator<wchar_t>
+  {
+    wchar_t* allocate(size_t n)
+    {
+      ++allocations;
+      return std::allocator<wchar_t>::allocate(n);
+    }
+
+    void deallocate(wchar_t* p, size_t n)
+    {
+      ++deallocations;
+      std::allocator<wchar_t>::deallocate(p, n);
+    }
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  // the view
+
+  void test01()
+  {
+    const std::wstring ws(L"\\SystemRoot\\System32\\drivers\\ndis.sys");
+    unicode_string_view v(ws);
+    VERIFY(v.size() == ws.size() && v.data() == ws.data());
+    VERIFY(v == L"\\SystemRoot\\System32\\drivers\\ndis.sys" && v != L"\\SystemRoot");
+    VERIFY(v.starts_with(L"\\SystemRoot\\") && v.starts_with('\\') && !v.starts_with(L"\\systemroot"));
+    VERIFY(v.ends_with(L".sys") && v.ends_with('s') && !v.ends_with(L"\\ndis.sys\\"));
+    VERIFY(v.find(L"System") == 1 && v.find(L"System", 2) == 12 && v.rfind(L"System") == 12);
+    VERIFY(v.find('\\') == 0 && v.rfind('\\') == 28 && v.find(L"nope") == unicode_string_view::npos);
+    VERIFY(v.find_first_of(L".3") == 18 && v.find_last_of(L"\\.") == 33 && v.find_first_not_of('\\') == 1);
+    VERIFY(v.find_last_not_of(L"sy.") == 31 && v.find(L"") == 0 && v.rfind(L"") == v.size());
+    VERIFY(v.substr(29) == L"ndis.sys" && v.substr(1, 10) == L"SystemRoot" && v.substr(v.size()).empty());
+    VERIFY(v.compare(L"\\T") < 0 && v.compare(L"\\S") > 0 && v.compare(1, 10, L"SystemRoot") == 0);
+    VERIFY(unicode_string_view(L"ab") < L"abc" && unicode_string_view(L"b") > L"abc");
+
+    // the path components
+    unicode_string_view path(v), name(v);
+    VERIFY(name.split_back('\\') == L"ndis.sys" && name == L"\\SystemRoot\\System32\\drivers");
+    const wchar_t* const parts[] = { L"", L"SystemRoot", L"System32", L"drivers", L"ndis.sys" };
+    for ( size_t i = 0; i < _countof(parts); i++ )
+      VERIFY(path.split_front('\\') == parts[i]);
+    VERIFY(path.empty() && path.split_front('\\').empty());
+    unicode_string_view single(L"ndis.sys");
+    VERIFY(single.split_back('\\') == L"ndis.sys" && single.empty());
+
+    // the native strings
+    const const_unicode_string native = v.native();
+    VERIFY(native.begin() == v.data() && native.size() == v.size());
+    VERIFY(unicode_string_view(native) == v && unicode_string_view(const_unicode_string(L"ndis.sys")) == L"ndis.sys");
+    VERIFY(v.get_string() == ws && unicode_string_view().native().empty());
+
+    // the case
+    const ci_unicode_string_view ci(v);
+    VERIFY(ci == L"\\SYSTEMROOT\\system32\\DRIVERS\\NDIS.SYS" && ci.starts_with(L"\\systemroot"));
+    VERIFY(ci.find(L"SYSTEM", 2) == 12 && ci.rfind('N') == 29 && ci.ends_with(L".SYS"));
+    VERIFY(ci_unicode_string_view(L"\x0434\x0440\xE9") == L"\x0414\x0420\xC9" && ci_unicode_string_view(L"a") < L"B");
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the searches against std::wstring
+
+  std::wstring random_text(size_t max)
+  {
+    static const wchar_t chars[] = { 'a', 'b', 'A', '\\' };
+    std::wstring s(random(static_cast<uint32_t>(max + 1)), L' ');
+    for ( size_t i = 0; i < s.size(); i++ )
+      s[i] = chars[random(_countof(chars))];
+    return s;
+  }
+
+  size_t result(size_t pos)
+  {
+    return pos == std::wstring::npos ? unicode_string_view::npos : pos;
+  }
+
+  void test02()
+  {
+    for ( int round = 0; round < 20000; round++ )
+    {
+      const std::wstring s = random_text(10), p = random_text(3);
+      const unicode_string_view v(s), pv(p);
+      const size_t pos = random(static_cast<uint32_t>(s.size() + 2));
+      VERIFY(v.find(pv, pos) == result(s.find(p, pos)));
+      VERIFY(v.rfind(pv, pos) == result(s.rfind(p, pos)) && v.rfind(pv) == result(s.rfind(p)));
+      VERIFY(p.empty() || v.find(p[0], pos) == result(s.find(p[0], pos)));
+      VERIFY(v.rfind(s.empty() ? L'a' : s[0], pos) == result(s.rfind(s.empty() ? L'a' : s[0], pos)));
+      VERIFY(v.find_first_of(pv, pos) == result(s.find_first_of(p, pos)));
+      VERIFY(v.find_last_of(pv, pos) == result(s.find_last_of(p, pos)));
+      VERIFY(v.find_first_not_of(pv, pos) == result(s.find_first_not_of(p, pos)));
+      VERIFY(v.find_last_not_of(pv, pos) == result(s.find_last_not_of(p, pos)));
+      VERIFY(v.find_first_not_of('a', pos) == result(s.find_first_not_of(L'a', pos)));
+      VERIFY(v.find_last_not_of('a', pos) == result(s.find_last_not_of(L'a', pos)));
+      VERIFY((v.compare(pv) < 0) == (s.compare(p) < 0) && (v.compare(pv) == 0) == (s == p));
+      VERIFY(v.starts_with(pv) == (s.compare(0, p.size(), p) == 0 && s.size() >= p.size()));
+      VERIFY(v.ends_with(pv) == (s.size() >= p.size() && s.compare(s.size() - p.size(), p.size(), p) == 0));
+
+      // the case-insensitive search is the search in the upper case
+      std::wstring us(s), up(p);
+      for ( size_t i = 0; i < us.size(); i++ ) us[i] = us[i] == 'a' ? 'A' : us[i];
+      for ( size_t i = 0; i < up.size(); i++ ) up[i] = up[i] == 'a' ? 'A' : up[i];
+      const ci_unicode_string_view ci(s), cp(p);
+      VERIFY(ci.find(cp, pos) == result(us.find(up, pos)) && ci.rfind(cp, pos) == result(us.rfind(up, pos)));
+      VERIFY((ci == cp) == (us == up) && ci.find_first_of(cp, pos) == result(us.find_first_of(up, pos)));
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the builder and its allocations
+
+  void test03()
+  {
+    allocations = deallocations = 0;
+    {
+      // a path fits the inline buffer
+      inline_unicode_string<260, counting_allocator> path;
+      VERIFY(path.empty() && path.c_str()[0] == 0 && path.capacity() == 260);
+      path.append(L"\\??\\").append(L"zenadriver").append_path(L"ndis.sys");
+      VERIFY(path.view() == L"\\??\\zenadriver\\ndis.sys" && path.c_str()[path.size()] == 0);
+      path.append_path(L"\\x").append_path(L"y\\").append_path(L"\\z");
+      VERIFY(path.view() == L"\\??\\zenadriver\\ndis.sys\\x\\y\\z");
+
+      // the native string is the builder itself
+      const const_unicode_string& native = path;
+      VERIFY(native.begin() == path.data() && native.size() == path.size() && native.capacity() == 260);
+      VERIFY(unicode_string_view(path.str()) == path.view());
+
+      path.resize(4);
+      path += L"C:";
+      path += '\\';
+      path.push_back('a');
+      VERIFY(path.view() == L"\\??\\C:\\a" && path.good());
+      path.pop_back();
+      path.resize(path.size() + 2, 'b');
+      VERIFY(path.view() == L"\\??\\C:\\bb" && path.c_str()[path.size()] == 0);
+
+      inline_unicode_string<260, counting_allocator> copy(path);
+      copy = L"other";
+      copy = path;
+      VERIFY(copy.view() == path.view() && copy.data() != path.data());
+      copy.clear();
+      VERIFY(copy.empty() && copy.c_str()[0] == 0);
+    }
+    VERIFY(allocations == 0 && deallocations == 0);
+
+    {
+      // a spill and the growth
+      inline_unicode_string<8, counting_allocator> s;
+      std::wstring expected;
+      s.append(L"12345678");
+      VERIFY(allocations == 0 && s.capacity() == 8);
+      for ( int i = 0; i < 1000; i++ )
+      {
+        s.append(static_cast<wchar_t>('a' + i % 26));
+        expected += static_cast<wchar_t>('a' + i % 26);
+      }
+      VERIFY(s.view() == L"12345678" + expected && s.c_str()[s.size()] == 0);
+      VERIFY(allocations == 7 && deallocations == 6 && s.capacity() == 1024);
+
+      // the string appended to itself
+      s.resize(10);
+      s.append(s.view()).append(s.view().substr(2, 3));
+      VERIFY(s.view() == L"12345678ab12345678ab345");
+      s.assign(s.view().substr(8, 4));
+      VERIFY(s.view() == L"ab12" && s.good());
+    }
+    VERIFY(allocations == deallocations);
+
+    {
+      // the self-append which spills
+      inline_unicode_string<6, counting_allocator> s(L"abcd");
+      s.append(s.view());
+      VERIFY(s.view() == L"abcdabcd" && allocations == 8);
+      s.reserve(100);
+      VERIFY(s.capacity() == 100 && s.view() == L"abcdabcd");
+
+      // the limit of the native strings
+      VERIFY(s.reserve(s.max_size()) && !s.reserve(s.max_size() + 1) && !s.good());
+      inline_unicode_string<8, counting_allocator> max;
+      max.append(max.max_size(), 'x');
+      VERIFY(max.good() && max.size() == 0x7FFF && max.str().size() == 0x7FFF);
+      max.append('y');
+      VERIFY(!max.good() && max.size() == 0x7FFF && max.view().ends_with('x'));
+    }
+    VERIFY(allocations == deallocations);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the quarantine path of zenadriver: std::wstring against the builder
+
+  void bench()
+  {
+    static const int count = 100000;
+    const std::wstring filename(L"\\SystemRoot\\System32\\drivers\\oem_storage_filter.sys");
+    size_t total = 0;
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for ( int i = 0; i < count; i++ )
+    {
+      std::wstring new_name(filename);
+      new_name.erase(0, 1 + new_name.rfind(L'\\'));
+      new_name.insert(0, L"\\??\\zenadriver\\");
+      total += new_name.size();
+    }
+    const uint64_t t_string = ntl::intrinsic::rdtsc() - t;
+
+    allocations = 0;
+    t = ntl::intrinsic::rdtsc();
+    for ( int i = 0; i < count; i++ )
+    {
+      unicode_string_view name(filename);
+      inline_unicode_string<260, counting_allocator> new_name(L"\\??\\zenadriver");
+      new_name.append_path(name.split_back('\\'));
+      total += new_name.size();
+    }
+    const uint64_t t_inline = ntl::intrinsic::rdtsc() - t;
+    VERIFY(allocations == 0);
+
+    dbg::trace.printf("quarantine path: std::wstring %4I64u cycles, inline_unicode_string %4I64u cycles (%u)\n",
+      t_string / count, t_inline / count, static_cast<unsigned>(total));
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
@@ -0,0 +1,297 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <nt/system_information.hxx>
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include <atomic.hxx>
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl::nt;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Stand-in of NtQuerySystemInformation(SystemProcessInformation) over a list of processes,
+  // the entries are packed the same way as the kernel does.
+
+  struct mock_thread
+  {
+    uintptr_t tid;
+    int64_t   create_time;
+    uint32_t  switches;
+  };
+
+  struct mock_process
+  {
+    uintptr_t pid;
+    int64_t   create_time;
+    std::wstring name;
+    int32_t   handles;
+    std::vector<mock_thread> threads;
+  };
+
+  struct mock_system
+  {
+    std::vector<mock_process> processes;
+    unsigned queries;
+  } sys;
+
+  size_t align(size_t n) { return (n + 7) & ~size_t(7); }
+
+  uint32_t required_size()
+  {
+    size_t size = 0;
+    for(size_t i = 0; i < sys.processes.size(); i++)
+      size += align(sizeof(system_process_information) + sys.processes[i].threads.size() * sizeof(system_thread_information)
+        + (sys.processes[i].name.size() + 1) * sizeof(wchar_t));
+    return static_cast<uint32_t>(size);
+  }
+
+  ntstatus __stdcall mock_query_system_information(system_information_class info_class, void* buf, uint32_t length, uint32_t* return_length)
+  {
+    sys.queries++;
+    assert(info_class == SystemProcessInformation);
+    const uint32_t required = required_size();
+    if(return_length)
+      *return_length = required;
+    if(length < required)
+      return status::info_length_mismatch;
+
+    char* p = static_cast<char*>(buf);
+    system_process_information* prev = nullptr;
+    for(size_t i = 0; i < sys.processes.size(); i++){
+      const mock_process& mp = sys.processes[i];
+      system_process_information* pi = reinterpret_cast<system_process_information*>(p);
+      std::memset(pi, 0, sizeof(system_process_information));
+      pi->NumberOfThreads = static_cast<uint32_t>(mp.threads.size());
+      pi->CreateTime = mp.create_time;
+      pi->UniqueProcessId = reinterpret_cast<legacy_handle>(mp.pid);
+      pi->HandleCount = mp.handles;
+      system_thread_information* ti = reinterpret_cast<system_thread_information*>(pi + 1);
+      for(size_t t = 0; t < mp.threads.size(); t++, ti++){
+        std::memset(ti, 0, sizeof(system_thread_information));
+        ti->ClientId.UniqueProcess = pi->UniqueProcessId;
+        ti->ClientId.UniqueThread = reinterpret_cast<legacy_handle>(mp.threads[t].tid);
+        ti->CreateTime = mp.threads[t].create_time;
+        ti->ContextSwitches = mp.threads[t].switches;
+      }
+      wchar_t* name = reinterpret_cast<wchar_t*>(ti);
+      std::memcpy(name, mp.name.c_str(), (mp.name.size() + 1) * sizeof(wchar_t));
+      ::new(&pi->ImageName) const_unicode_string(name, mp.name.size());
+      const size_t entry = align(reinterpret_cast<char*>(name + mp.name.size() + 1) - p);
+      if(prev)
+        prev->NextEntryOffset = static_cast<uint32_t>(p - reinterpret_cast<char*>(prev));
+      prev = pi;
+      p += entry;
+    }
+    return status::success;
+  }
+
+  typedef system_information_query<system_processes, mock_query_system_information> mock_query;
+  typedef basic_process_monitor<mock_query_system_information> mock_monitor;
+
+  void make_system(size_t processes, size_t threads)
+  {
+    sys.processes.clear();
+    uintptr_t tid = 4;
+    for(size_t i = 0; i < processes; i++){
+      mock_process p;
+      p.pid = 4 + i * 4;
+      p.create_time = 1000 + i;
+      wchar_t name[32];
+      _snwprintf(name, _countof(name), L"process_%u.exe", static_cast<unsigned>(i));
+      p.name = name;
+      p.handles = 10;
+      for(size_t t = 0; t < threads; t++){
+        const mock_thread mt = { tid += 4, 2000 + t, 0 };
+        p.threads.push_back(mt);
+      }
+      sys.processes.push_back(p);
+    }
+    sys.queries = 0;
+  }
+
+  size_t count(const system_processes* ps)
+  {
+    size_t n = 0;
+    for(system_processes::const_iterator it = ps->cbegin(); it != ps->cend(); ++it)
+      n++;
+    return n;
+  }
+
+  // the query remembers the size and reuses the buffer
+  void test01()
+  {
+    make_system(200, 10);
+    mock_query q;
+    VERIFY(success(q.update()));
+    VERIFY(q.queries() == 2 && q.allocations() == 2);
+    VERIFY(q.size() == required_size() && q.capacity() > q.size());
+    VERIFY(count(q.data()) == 200 && q->NumberOfThreads == 10);
+    VERIFY(std::wstring(q->ImageName.begin(), q->ImageName.size()) == L"process_0.exe");
+
+    // the next polls: one syscall each, no allocations while the headroom lasts
+    for(int i = 0; i < 10; i++){
+      mock_process p = sys.processes.back();
+      p.pid += 4;
+      sys.processes.push_back(p);
+      VERIFY(success(q.update()));
+    }
+    VERIFY(q.queries() == 12 && q.allocations() == 2 && count(q.data()) == 210);
+
+    // a new query object starts from the remembered size
+    mock_query q2;
+    VERIFY(success(q2.update()));
+    VERIFY(q2.queries() == 1 && q2.allocations() == 1);
+
+    // so does the one-shot system_information
+    sys.queries = 0;
+    system_information_base<system_processes, mock_query_system_information> once;
+    VERIFY(once.data() && sys.queries == 1 && count(once.data()) == 210);
+  }
+
+  struct recorder: process_diff_visitor
+  {
+    std::vector<uintptr_t> added, removed, changed;
+    std::vector<uintptr_t> threads_added, threads_removed, threads_changed;
+
+    static uintptr_t id(legacy_handle h) { return reinterpret_cast<uintptr_t>(h); }
+
+    void process_added(const system_process_information& p)    { added.push_back(id(p.UniqueProcessId)); }
+    void process_removed(const system_process_information& p)  { removed.push_back(id(p.UniqueProcessId)); }
+    void process_changed(const system_process_information& p, const system_process_information& q)
+    {
+      VERIFY(p.UniqueProcessId == q.UniqueProcessId);
+      changed.push_back(id(p.UniqueProcessId));
+    }
+    void thread_added(const system_process_information&, const system_thread_information& t)   { threads_added.push_back(id(t.ClientId.UniqueThread)); }
+    void thread_removed(const system_process_information&, const system_thread_information& t) { threads_removed.push_back(id(t.ClientId.UniqueThread)); }
+    void thread_changed(const system_process_information&, const system_thread_information& t, const system_thread_information& u)
+    {
+      VERIFY(t.ContextSwitches != u.ContextSwitches);
+      threads_changed.push_back(id(t.ClientId.UniqueThread));
+    }
+  };
+
+  // double-buffered polling reports only the deltas
+  void test02()
+  {
+    make_system(50, 4);
+    mock_monitor m;
+    VERIFY(success(m.poll()));
+    recorder r;
+    m.diff(r);
+    VERIFY(r.added.size() == 50 && r.removed.empty() && r.changed.empty() && r.threads_added.empty());
+
+    // nothing changed
+    VERIFY(success(m.poll()));
+    recorder r2;
+    m.diff(r2);
+    VERIFY(r2.added.empty() && r2.removed.empty() && r2.changed.empty() && r2.threads_changed.empty());
+
+    // a process exits, another one starts with a reused id, one thread starts, one runs, one exits
+    const uintptr_t exited = sys.processes[3].pid;
+    sys.processes.erase(sys.processes.begin() + 3);
+    sys.processes[7].create_time += 100000;            // id reuse
+    const uintptr_t reused = sys.processes[7].pid;
+    mock_process& busy = sys.processes[10];
+    busy.handles++;
+    busy.threads[1].switches += 5;
+    const uintptr_t ran = busy.threads[1].tid;
+    const uintptr_t gone = busy.threads[2].tid;
+    busy.threads.erase(busy.threads.begin() + 2);
+    const mock_thread started = { 100000, 9999, 0 };
+    busy.threads.push_back(started);
+    std::swap(sys.processes[0], sys.processes[20]);     // the order doesn't matter
+
+    VERIFY(success(m.poll()));
+    recorder r3;
+    m.diff(r3);
+    VERIFY(r3.removed.size() == 2 && r3.added.size() == 1 && r3.added[0] == reused);
+    VERIFY((r3.removed[0] == exited && r3.removed[1] == reused) || (r3.removed[1] == exited && r3.removed[0] == reused));
+    VERIFY(r3.changed.size() == 1 && r3.changed[0] == busy.pid);
+    VERIFY(r3.threads_added.size() == 1 && r3.threads_added[0] == 100000);
+    VERIFY(r3.threads_removed.size() == 1 && r3.threads_removed[0] == gone);
+    VERIFY(r3.threads_changed.size() == 1 && r3.threads_changed[0] == ran);
+
+    VERIFY(count(m.processes()) == 49);
+    VERIFY(m.query().allocations() <= 2);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the previous query: start from sizeof and double until it fits, every time
+
+  void* legacy_query(unsigned& queries)
+  {
+    unsigned long length = 0;
+    char* ptr;
+    for(unsigned long i = sizeof(system_processes); (ptr = new char[length = length ? length : i]) != 0; i *= 2){
+      queries++;
+      const ntstatus s = mock_query_system_information(SystemProcessInformation, ptr, length, 0);
+      if(s == status::success)
+        break;
+      delete[] ptr;
+      if(s != status::info_length_mismatch)
+        return 0;
+      length = 0;
+    }
+    return ptr;
+  }
+
+  void bench()
+  {
+    make_system(300, 20);
+    static const unsigned polls = 1000;
+
+    unsigned legacy_queries = 0;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < polls; i++)
+      delete[] static_cast<char*>(legacy_query(legacy_queries));
+    const uint64_t t_legacy = ntl::intrinsic::rdtsc() - t;
+
+    mock_query q;
+    t = ntl::intrinsic::rdtsc();
+    for(unsigned i = 0; i < polls; i++)
+      q.update();
+    const uint64_t t_query = ntl::intrinsic::rdtsc() - t;
+
+    // 1% of the threads run between the polls
+    mock_monitor m;
+    m.poll();
+    uint64_t t_poll = 0, t_diff = 0;
+    size_t changes = 0;
+    for(unsigned i = 0; i < polls; i++){
+      for(size_t n = 0; n < 60; n++)
+        sys.processes[(i * 7 + n * 13) % 300].threads[n % 20].switches++;
+      t = ntl::intrinsic::rdtsc();
+      m.poll();
+      t_poll += ntl::intrinsic::rdtsc() - t;
+      recorder r;
+      t = ntl::intrinsic::rdtsc();
+      m.diff(r);
+      t_diff += ntl::intrinsic::rdtsc() - t;
+      changes += r.threads_changed.size();
+    }
+
+    dbg::trace.printf("300 processes, doubling query: %u queries/poll, %I64u cycles/poll\n", legacy_queries / polls, t_legacy / polls);
+    dbg::trace.printf("300 processes, reused buffer:  %u queries/poll, %I64u cycles/poll, %u allocations\n", q.queries() / polls, t_query / polls, q.allocations());
+    dbg::trace.printf("300 processes, monitor poll %I64u + diff %I64u cycles, %u thread changes/poll\n", t_poll / polls, t_diff / polls, static_cast<unsigned>(changes / polls));
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}
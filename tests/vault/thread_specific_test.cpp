@@ -0,0 +1,153 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <thread_specific.hxx>
+#include <mutex>
+#include <thread>
+#include <memory>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using ntl::thread_specific;
+
+  volatile uint32_t alive;
+  volatile uint64_t total;
+
+  // a per-thread counter which reports its count when destroyed
+  struct counter
+  {
+    counter(): count() { ntl::atomic::increment(alive); }
+    ~counter()
+    {
+      ntl::atomic::exchange_add(total, count);
+      ntl::atomic::decrement(alive);
+    }
+    uint64_t count;
+  };
+
+  thread_specific<counter> counters;
+
+  void test01()
+  {
+    VERIFY(counters.get_if_exists() == 0 && alive == 0);
+    counter* const p = counters.get();
+    VERIFY(p && counters.get() == p && &*counters == p && alive == 1);
+    counters->count += 5;
+
+    // the independent keys
+    {
+      thread_specific<counter> other;
+      VERIFY(other.get_if_exists() == 0);
+      other->count = 7;
+      VERIFY(other.get() != p && alive == 2 && counters->count == 5);
+    }
+    // the destroyed key has released the instance of this thread
+    VERIFY(alive == 1 && total == 7);
+
+    // the key reused by the next object does not see the old values
+    thread_specific<counter>* const leaked = new thread_specific<counter>();
+    delete leaked;
+    thread_specific<int> fresh;
+    VERIFY(fresh.get_if_exists() == 0 && *fresh == 0);
+
+    counters.reset();
+    VERIFY(counters.get_if_exists() == 0 && alive == 0 && total == 12);
+    VERIFY(counters.get() != 0 && alive == 1);
+    total = 0;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the instances of the threads are destroyed at their exit
+
+  void count_up(uint32_t n)
+  {
+    for ( uint32_t i = 0; i < n; i++ )
+      counters->count++;
+  }
+
+  template<class F>
+  void run_threads(unsigned threads, F func, uint32_t n)
+  {
+    const std::unique_ptr<std::thread[]> pool(new std::thread[threads]);
+    for ( unsigned i = 0; i < threads; i++ )
+    {
+      std::thread t(func, n);
+      pool[i].swap(t);
+    }
+    for ( unsigned i = 0; i < threads; i++ )
+      pool[i].join();
+  }
+
+  void test02()
+  {
+    counters->count = 1;
+    run_threads(8, count_up, 10000);
+    VERIFY(total == 80000 && alive == 1 && counters->count == 1);
+
+    // this thread is not started by std::thread
+    ntl::release_thread_specific();
+    VERIFY(total == 80001 && alive == 0 && counters.get_if_exists() == 0);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // the per-thread counters against the counter guarded by a mutex
+
+  std::mutex guard;
+  uint64_t shared_count;
+  volatile uint64_t cycles;
+
+  void count_locked(uint32_t n)
+  {
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    for ( uint32_t i = 0; i < n; i++ )
+    {
+      std::lock_guard<std::mutex> lock(guard);
+      shared_count++;
+    }
+    ntl::atomic::exchange_add(cycles, ntl::intrinsic::rdtsc() - t);
+  }
+
+  void count_specific(uint32_t n)
+  {
+    const uint64_t t = ntl::intrinsic::rdtsc();
+    for ( uint32_t i = 0; i < n; i++ )
+      counters->count++;
+    ntl::atomic::exchange_add(cycles, ntl::intrinsic::rdtsc() - t);
+  }
+
+  void bench()
+  {
+    static const uint32_t count = 200000;
+    for ( unsigned threads = 1; threads <= 16; threads *= 4 )
+    {
+      cycles = 0;
+      run_threads(threads, count_locked, count);
+      const uint64_t t_locked = cycles / (threads * count);
+
+      cycles = 0;
+      total = 0;
+      run_threads(threads, count_specific, count);
+      const uint64_t t_specific = cycles / (threads * count);
+      VERIFY(total == uint64_t(threads) * count);
+
+      dbg::trace.printf("%2u threads: mutex-guarded counter %4I64u cycles, thread_specific counter %3I64u cycles per increment\n",
+        threads, t_locked, t_specific);
+    }
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}
@@ -0,0 +1,330 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <timer_wheel.hxx>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cstring>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  using namespace ntl;
+
+  typedef basic_timer_wheel<std::mutex> wheel_type;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  // deadlines from the next tick to the top level
+  uint64_t random_delay()
+  {
+    static const unsigned bits[] = { 6, 12, 18, 24, 30 };
+    return 1 + ((uint64_t(random(1u << 24)) << 8 | random(256)) & ((uint64_t(1) << bits[random(_countof(bits))]) - 1));
+  }
+
+  struct timeout: timer_wheel_entry
+  {
+    uint64_t  fired;
+    unsigned  count;
+  };
+
+  struct expiry_log
+  {
+    wheel_type *          wheel;
+    std::vector<uint64_t> deadlines;
+  };
+
+  void on_timeout(timer_wheel_entry & entry, void * context)
+  {
+    expiry_log & log = *static_cast<expiry_log*>(context);
+    timeout & t = static_cast<timeout&>(entry);
+    t.fired = log.wheel->current();
+    t.count++;
+    log.deadlines.push_back(entry.deadline());
+  }
+
+  // the entries expire at the advance() which passes their deadline, in the order of the deadlines
+  void test01()
+  {
+    wheel_type wheel(0xFFFFF000);
+    expiry_log log = { &wheel };
+    static const size_t count = 5000;
+    timeout * const timers = new timeout[count];
+    for ( size_t i = 0; i < count; i++ )
+    {
+      timers[i].count = 0;
+      VERIFY(wheel.schedule(timers[i], wheel.current() + random_delay(), on_timeout, &log));
+      VERIFY(timers[i].active());
+    }
+    VERIFY(!wheel.schedule(timers[0], 0, on_timeout, &log));
+    VERIFY(wheel.advance(wheel.current()) == 0 && wheel.size() == count);
+
+    size_t fired = 0;
+    while ( fired < count )
+    {
+      const uint64_t from = wheel.current();
+      // the single ticks and the jumps
+      const uint64_t step = random(4) ? 1 + random(100) : random_delay();
+      log.deadlines.clear();
+      const size_t n = wheel.advance(from + step);
+      VERIFY(n == log.deadlines.size());
+      VERIFY(std::is_sorted(log.deadlines.begin(), log.deadlines.end()));
+      VERIFY(n == 0 || (log.deadlines.front() > from && log.deadlines.back() <= from + step));
+      fired += n;
+      VERIFY(wheel.size() == count - fired);
+    }
+    for ( size_t i = 0; i < count; i++ )
+      VERIFY(timers[i].count == 1 && !timers[i].active());
+    delete[] timers;
+
+    // exactly at the deadline
+    for ( int i = 0; i < 300; i++ )
+    {
+      timeout t; t.count = 0;
+      const uint64_t deadline = wheel.current() + random_delay();
+      wheel.schedule(t, deadline, on_timeout, &log);
+      VERIFY(wheel.advance(deadline - 1) == 0 && t.count == 0);
+      VERIFY(wheel.advance(deadline) == 1 && t.count == 1 && t.fired == deadline);
+    }
+  }
+
+  struct periodic: timer_wheel_entry
+  {
+    wheel_type *  wheel;
+    uint64_t      period;
+    unsigned      count;
+  };
+
+  void on_period(timer_wheel_entry & entry, void *)
+  {
+    periodic & p = static_cast<periodic&>(entry);
+    p.count++;
+    VERIFY(p.wheel->schedule(p, p.deadline() + p.period, on_period));
+  }
+
+  // cancelling and scheduling again
+  void test02()
+  {
+    wheel_type wheel;
+    expiry_log log = { &wheel };
+    timeout a, b, c;
+    a.count = b.count = c.count = 0;
+
+    // pending: moved into the wheel and unlinked, may be scheduled again or freed at once
+    VERIFY(wheel.schedule(a, 10, on_timeout, &log) && wheel.schedule(b, 10, on_timeout, &log));
+    VERIFY(wheel.cancel(a) && !a.active() && !wheel.cancel(a));
+    timeout * const temp = new timeout;
+    VERIFY(wheel.schedule(*temp, 12, on_timeout, &log));
+    VERIFY(wheel.cancel(b) && wheel.schedule(b, 20, on_timeout, &log) && b.active());
+    VERIFY(wheel.cancel(*temp));
+    std::memset(temp, 0xCC, sizeof(timeout));
+    delete temp;
+    VERIFY(wheel.advance(5) == 0 && wheel.size() == 1);
+    VERIFY(wheel.schedule(a, 15, on_timeout, &log));
+
+    // armed: unlinked
+    VERIFY(wheel.schedule(c, 5000, on_timeout, &log));
+    VERIFY(wheel.advance(6) == 0 && wheel.size() == 3);
+    VERIFY(wheel.cancel(c) && !c.active() && wheel.size() == 2 && !wheel.cancel(c));
+    VERIFY(wheel.advance(100) == 2 && a.count == 1 && b.count == 1 && a.fired == 100);
+    VERIFY(wheel.advance(10000) == 0 && c.count == 0 && wheel.size() == 0);
+
+    // the past deadlines expire at once
+    VERIFY(wheel.schedule(c, 3, on_timeout, &log));
+    VERIFY(wheel.advance(wheel.current()) == 1 && c.count == 1);
+    // also when the cancel of another pending entry moves it into the wheel
+    timeout d;
+    d.count = 0;
+    VERIFY(wheel.schedule(c, 3, on_timeout, &log) && wheel.schedule(d, 4, on_timeout, &log));
+    VERIFY(wheel.cancel(d) && wheel.size() == 1 && c.active());
+    VERIFY(wheel.advance(wheel.current()) == 1 && c.count == 2 && d.count == 0 && wheel.size() == 0);
+
+    // the routine schedules its entry again
+    periodic p;
+    p.wheel = &wheel, p.period = 7, p.count = 0;
+    VERIFY(wheel.schedule(p, wheel.current() + p.period, on_period));
+    for ( uint64_t t = wheel.current() + 1, end = t + 700; t <= end; t++ )
+      wheel.advance(t);
+    VERIFY(p.count == 100 && p.active());
+    VERIFY(wheel.cancel(p));
+  }
+
+  // the deadlines beyond the top level
+  void test03()
+  {
+    wheel_type wheel(12345);
+    expiry_log log = { &wheel };
+    const uint64_t top = uint64_t(1) << 36;
+    const uint64_t deadlines[] = { top + 5, 3 * top + 777, top - 1, 12345 + top, (uint64_t(1) << 42) + 1 };
+    timeout timers[_countof(deadlines)];
+    for ( size_t i = 0; i < _countof(deadlines); i++ )
+    {
+      timers[i].count = 0;
+      wheel.schedule(timers[i], deadlines[i], on_timeout, &log);
+    }
+    std::vector<uint64_t> sorted(deadlines, deadlines + _countof(deadlines));
+    std::sort(sorted.begin(), sorted.end());
+    for ( size_t i = 0; i < sorted.size(); i++ )
+    {
+      VERIFY(wheel.advance(sorted[i] - 1) == 0);
+      VERIFY(wheel.advance(sorted[i]) == 1);
+    }
+    for ( size_t i = 0; i < _countof(deadlines); i++ )
+      VERIFY(timers[i].count == 1 && timers[i].fired == deadlines[i]);
+
+    // the deadlines of the next epochs, seen from its end, its middle and its start
+    const uint64_t starts[] = { top - 10, uint64_t(1) << 30, top + 12345 };
+    for ( size_t i = 0; i < _countof(starts); i++ )
+    {
+      wheel_type w(starts[i]);
+      expiry_log l = { &w };
+      const uint64_t epoch_end = (starts[i] | (top - 1)) + 1;
+      timeout next, later, cancelled;
+      next.count = later.count = cancelled.count = 0;
+      VERIFY(w.schedule(next, epoch_end + 5, on_timeout, &l) && w.schedule(later, epoch_end + 3 * top + 1, on_timeout, &l));
+      VERIFY(w.schedule(cancelled, epoch_end + 7, on_timeout, &l));
+      VERIFY(w.advance(epoch_end - 3) == 0 && w.size() == 3 && w.cancel(cancelled) && w.size() == 2);
+      for ( uint64_t t = epoch_end - 2; t < epoch_end + 5; t++ )
+        VERIFY(w.advance(t) == 0);
+      VERIFY(w.advance(epoch_end + 5) == 1 && next.count == 1 && next.fired == epoch_end + 5);
+      VERIFY(w.advance(epoch_end + 3 * top) == 0 && w.size() == 1);
+      VERIFY(w.advance(8 * top) == 1 && later.count == 1 && w.size() == 0 && cancelled.count == 0);
+    }
+  }
+
+  // lock-free scheduling and cancelling against the ticking thread
+  struct concurrent_log
+  {
+    volatile uint32_t fired;
+    volatile uint32_t cancelled;
+    volatile uint32_t done;
+  };
+
+  void on_concurrent(timer_wheel_entry &, void * context)
+  {
+    atomic::increment(static_cast<concurrent_log*>(context)->fired);
+  }
+
+  static const unsigned per_thread = 20000;
+
+  void scheduler(wheel_type & wheel, concurrent_log & log, timer_wheel_entry * entries, unsigned id)
+  {
+    uint32_t s = id + 1;
+    for ( unsigned k = 0; k < per_thread; k++ )
+    {
+      s = s * 1664525 + 1013904223;
+      // some of them are in the past already
+      VERIFY(wheel.schedule(entries[k], k / 4 + (s >> 20), on_concurrent, &log));
+      if ( k >= 8 && (s >> 8) % 3 == 0 && wheel.cancel(entries[k - 8]) )
+        atomic::increment(log.cancelled);
+    }
+    atomic::increment(log.done);
+  }
+
+  void test04()
+  {
+    wheel_type wheel;
+    concurrent_log log = { 0, 0, 0 };
+    static const unsigned threads = 4;
+    timer_wheel_entry * const entries = new timer_wheel_entry[threads * per_thread];
+
+    std::vector<std::thread> workers;
+    for ( unsigned i = 0; i < threads; i++ )
+      workers.push_back(std::thread(scheduler, std::ref(wheel), std::ref(log), &entries[i * per_thread], i));
+
+    for ( uint64_t t = 1; log.done != threads; t++ )
+      wheel.advance(t);
+    for ( unsigned i = 0; i < threads; i++ )
+      workers[i].join();
+    wheel.advance(wheel.current() + (1 << 14));
+    VERIFY(log.fired + log.cancelled == threads * per_thread && wheel.size() == 0);
+    delete[] entries;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 1M active timeouts over 2^20 ticks: the wheel against the ordered set
+
+  void bench()
+  {
+    static const unsigned count = 1000 * 1000, span_bits = 20;
+    std::vector<uint64_t> deadlines(count);
+    for ( unsigned i = 0; i < count; i++ )
+      deadlines[i] = 1 + (uint64_t(random(1u << 24)) & ((1u << span_bits) - 1));
+    concurrent_log log = { 0, 0, 0 };
+
+    // the wheel
+    timer_wheel_entry * const entries = new timer_wheel_entry[count];
+    wheel_type wheel;
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for ( unsigned i = 0; i < count; i++ )
+      wheel.schedule(entries[i], deadlines[i], on_concurrent, &log);
+    wheel.advance(0);
+    const uint64_t w_schedule = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( unsigned i = 0; i < count; i += 2 )
+      wheel.cancel(entries[i]);
+    const uint64_t w_cancel = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( uint64_t tick = 1; tick <= (1u << span_bits); tick++ )
+      wheel.advance(tick);
+    const uint64_t w_expire = ntl::intrinsic::rdtsc() - t;
+    VERIFY(log.fired == count / 2);
+    delete[] entries;
+
+    // the set ordered by the deadline and the index
+    typedef std::set<std::pair<uint64_t, unsigned> > timer_set;
+    timer_set map;
+    std::vector<timer_set::iterator> handles(count);
+    uint32_t fired = 0;
+    t = ntl::intrinsic::rdtsc();
+    for ( unsigned i = 0; i < count; i++ )
+      handles[i] = map.insert(std::make_pair(deadlines[i], i)).first;
+    const uint64_t m_schedule = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( unsigned i = 0; i < count; i += 2 )
+      map.erase(handles[i]);
+    const uint64_t m_cancel = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    for ( uint64_t tick = 1; tick <= (1u << span_bits); tick++ )
+      while ( !map.empty() && map.begin()->first <= tick )
+      {
+        fired += map.begin()->second & 1;
+        map.erase(map.begin());
+      }
+    const uint64_t m_expire = ntl::intrinsic::rdtsc() - t;
+    VERIFY(fired == count / 2);
+
+    dbg::trace.printf("1M timeouts, cycles per schedule/cancel/expiry: wheel %I64u/%I64u/%I64u, map %I64u/%I64u/%I64u\n",
+      w_schedule / count, w_cancel / (count / 2), w_expire / (count / 2),
+      m_schedule / count, m_cancel / (count / 2), m_expire / (count / 2));
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    test04();
+    bench();
+  }
+}
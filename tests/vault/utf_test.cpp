@@ -0,0 +1,332 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <codecvt>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <utf8.hxx>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  namespace utf = std::ext::utf;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  // the reference encoders
+  void put_utf8(std::string& s, uint32_t c)
+  {
+    if ( c < 0x80 )
+      s += static_cast<char>(c);
+    else if ( c < 0x800 )
+      s += static_cast<char>(0xC0 | c >> 6), s += static_cast<char>(0x80 | (c & 0x3F));
+    else if ( c < 0x10000 )
+      s += static_cast<char>(0xE0 | c >> 12), s += static_cast<char>(0x80 | (c >> 6 & 0x3F)), s += static_cast<char>(0x80 | (c & 0x3F));
+    else
+      s += static_cast<char>(0xF0 | c >> 18), s += static_cast<char>(0x80 | (c >> 12 & 0x3F)),
+      s += static_cast<char>(0x80 | (c >> 6 & 0x3F)), s += static_cast<char>(0x80 | (c & 0x3F));
+  }
+
+  void put_utf16(std::wstring& s, uint32_t c)
+  {
+    if ( c < 0x10000 )
+      s += static_cast<wchar_t>(c);
+    else
+      s += static_cast<wchar_t>(0xD800 + ((c - 0x10000) >> 10)), s += static_cast<wchar_t>(0xDC00 + (c & 0x3FF));
+  }
+
+  enum corpus { ascii, latin, cyrillic, cjk, emoji, mixed, corpora };
+  const char* const corpus_names[corpora] = { "ascii", "latin", "cyrillic", "cjk", "emoji", "mixed" };
+
+  uint32_t code_point(corpus kind)
+  {
+    switch ( kind )
+    {
+    case ascii:     return random(8) ? 'a' + random(26) : ' ';
+    case latin:     return random(12) ? 'a' + random(26) : 0xE0 + random(0x20);
+    case cyrillic:  return random(8) ? 0x430 + random(0x20) : ' ';
+    case cjk:       return random(10) ? 0x4E00 + random(0x5000) : 0x3001;
+    case emoji:     return random(4) ? 0x1F600 + random(0x50) : ' ';
+    default:
+      {
+        const uint32_t c = random(0x110000 >> random(16));
+        return c - 0xD800 < 0x800 ? c - 0x800 : c;
+      }
+    }
+  }
+
+  void make_text(corpus kind, size_t code_points, std::wstring& w, std::string& s)
+  {
+    w.clear(), s.clear();
+    for ( size_t i = 0; i < code_points; i++ )
+    {
+      const uint32_t c = code_point(kind);
+      put_utf16(w, c);
+      put_utf8(s, c);
+    }
+  }
+
+  // the conversions of every corpus equal the reference, in one go and by the small buffers
+  void test01()
+  {
+    std::wstring w, back;
+    std::string s, out;
+    for ( int round = 0; round < 600; round++ )
+    {
+      make_text(static_cast<corpus>(round % corpora), random(200), w, s);
+      const wchar_t* const wf = w.data(), * const wl = wf + w.size();
+      const char* const sf = s.data(), * const sl = sf + s.size();
+      VERIFY(utf::utf8_length(wf, wl) == s.size());
+
+      out.assign(s.size() + 16, '\0');
+      const wchar_t* wnext;
+      char* snext;
+      VERIFY(utf::to_utf8(wf, wl, wnext, &out[0], &out[0] + out.size(), snext) == utf::ok);
+      VERIFY(wnext == wl && out.compare(0, snext - &out[0], s) == 0 && snext - &out[0] == static_cast<ptrdiff_t>(s.size()));
+
+      back.assign(w.size() + 16, L'\0');
+      const char* cnext;
+      wchar_t* bnext;
+      VERIFY(utf::from_utf8(sf, sl, cnext, &back[0], &back[0] + back.size(), bnext) == utf::ok);
+      VERIFY(cnext == sl && back.compare(0, bnext - &back[0], w) == 0 && bnext - &back[0] == static_cast<ptrdiff_t>(w.size()));
+
+      // by the destination chunks of 1..20 elements
+      out.clear();
+      for ( const wchar_t* from = wf; from != wl; )
+      {
+        char buf[20];
+        const utf::result r = utf::to_utf8(from, wl, from, buf, buf + 1 + random(20), snext);
+        VERIFY(r == utf::ok || r == utf::partial);
+        out.append(buf, snext);
+      }
+      VERIFY(out == s);
+
+      back.clear();
+      for ( const char* from = sf; from != sl; )
+      {
+        wchar_t buf[20];
+        const utf::result r = utf::from_utf8(from, sl, from, buf, buf + 2 + random(19), bnext);
+        VERIFY(r == utf::ok || r == utf::partial);
+        back.append(buf, bnext);
+      }
+      VERIFY(back == w);
+
+      // the source split anywhere stops at the split sequence
+      if ( !s.empty() )
+      {
+        const char* split = sf + random(static_cast<uint32_t>(s.size()));
+        back.assign(w.size() + 16, L'\0');
+        const utf::result r = utf::from_utf8(sf, split, cnext, &back[0], &back[0] + back.size(), bnext);
+        VERIFY(r == ((split == sf || (*split & 0xC0) != 0x80) ? utf::ok : utf::partial));
+        VERIFY(cnext <= split && split - cnext < 4 && (cnext == split || (*cnext & 0xC0) == 0xC0));
+      }
+    }
+  }
+
+  utf::result from_bytes(const char* s, size_t n, size_t& consumed)
+  {
+    wchar_t buf[64];
+    const char* next;
+    wchar_t* to;
+    const utf::result r = utf::from_utf8(s, s + n, next, buf, buf + 64, to);
+    consumed = next - s;
+    return r;
+  }
+
+  // the invalid sequences
+  void test02()
+  {
+    static const struct { const char* s; size_t n; utf::result r; size_t consumed; } cases[] = {
+      { "ab\xC0\x80", 4, utf::error, 2 },         // overlong
+      { "\xC1\xBF", 2, utf::error, 0 },
+      { "a\xE0\x80\x80", 4, utf::error, 1 },
+      { "\xF0\x80\x80\x80", 4, utf::error, 0 },
+      { "\xED\xA0\x80", 3, utf::error, 0 },       // surrogate
+      { "\xF4\x90\x80\x80", 4, utf::error, 0 },   // above 0x10FFFF
+      { "\xF5\x80\x80\x80", 4, utf::error, 0 },
+      { "a\x80", 2, utf::error, 1 },              // continuation
+      { "\xE4\xB8" "a", 3, utf::error, 0 },
+      { "abc\xE4\xB8", 5, utf::partial, 3 },      // incomplete
+      { "\xF0\x9F\x98", 3, utf::partial, 0 },
+      { "ab\xE0", 3, utf::partial, 2 },
+      { "ab\xE0\x80", 4, utf::error, 2 },        // incomplete and invalid
+      { "\xED\xA0", 2, utf::error, 0 },
+      { "\xF0\x8F", 2, utf::error, 0 },
+      { "\xF4\x90", 2, utf::error, 0 },
+      { "\xF0\x9F\x98\x80", 4, utf::ok, 4 },
+      { "\xEF\xBF\xBF", 3, utf::ok, 3 },
+    };
+    for ( size_t i = 0; i < _countof(cases); i++ )
+    {
+      size_t consumed;
+      VERIFY(from_bytes(cases[i].s, cases[i].n, consumed) == cases[i].r && consumed == cases[i].consumed);
+    }
+    // in the middle of the SIMD blocks
+    std::string s(100, 'x');
+    s[37] = '\xFF';
+    size_t consumed;
+    VERIFY(from_bytes(s.data(), 64, consumed) == utf::error && consumed == 37);
+    std::wstring w(2000, L'x');
+    w.insert(0, 1500, L'\x44F');
+    w[1700] = 0xDC00;
+    std::string out(8000, '\0');
+    const wchar_t* wnext;
+    char* snext;
+    VERIFY(utf::to_utf8(w.data(), w.data() + w.size(), wnext, &out[0], &out[0] + out.size(), snext) == utf::error);
+    VERIFY(wnext == w.data() + 1700 && snext == &out[0] + 3000 + 200);
+    w[1700] = 0xD800;
+    VERIFY(utf::to_utf8(w.data(), w.data() + 1701, wnext, &out[0], &out[0] + out.size(), snext) == utf::partial && wnext == w.data() + 1700);
+    VERIFY(utf::to_utf8(w.data(), w.data() + 1702, wnext, &out[0], &out[0] + out.size(), snext) == utf::error && wnext == w.data() + 1700);
+
+    // UCS-2 has no pairs, the maximal code
+    const wchar_t pair[] = { 0xD83D, 0xDE00, 0 };
+    VERIFY(utf::to_utf8(pair, pair + 2, wnext, &out[0], &out[0] + out.size(), snext, 0xFFFF, false) == utf::error);
+    const wchar_t latin[] = { L'a', 0x100 };
+    VERIFY(utf::to_utf8(latin, latin + 2, wnext, &out[0], &out[0] + out.size(), snext, 0xFF) == utf::error && wnext == latin + 1);
+    VERIFY(from_bytes("\xF0\x9F\x98\x80", 4, consumed) == utf::ok);
+    wchar_t buf[4];
+    const char* cnext;
+    wchar_t* bnext;
+    const char smile[] = "\xF0\x9F\x98\x80";
+    VERIFY(utf::from_utf8(smile, smile + 4, cnext, buf, buf + 4, bnext, 0xFFFF, false) == utf::error);
+    VERIFY(utf::from_utf8(smile, smile + 4, cnext, buf, buf + 1, bnext) == utf::partial && bnext == buf);
+  }
+
+  // the facets and wstring_convert
+  void test03()
+  {
+    std::wstring w;
+    std::string s;
+    make_text(mixed, 3000, w, s);
+
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t> > convert;
+    VERIFY(convert.to_bytes(w) == s && convert.converted() == w.size());
+    VERIFY(convert.from_bytes(s) == w);
+
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t> > with_error("?", L"?");
+    VERIFY(with_error.to_bytes(std::wstring(1, wchar_t(0xDC00))) == "?");
+    // the input ends in a lone high surrogate
+    VERIFY(with_error.to_bytes(L"a\xD800") == "?" && with_error.converted() == 1);
+    VERIFY(with_error.from_bytes("\xC0\x80") == L"?");
+
+    // the header
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t, 0x10ffff, std::codecvt_mode(std::generate_header|std::consume_header)> > header;
+    const std::string bytes = header.to_bytes(L"\x44F" L"a");
+    VERIFY(bytes == "\xEF\xBB\xBF\xD1\x8F" "a");
+    VERIFY(header.from_bytes(bytes) == L"\x44F" L"a");
+    // the text shorter than the header and not its prefix
+    VERIFY(header.from_bytes("ab") == L"ab" && header.from_bytes("a") == L"a");
+
+    // UCS-2
+    std::wstring_convert<std::codecvt_utf8<wchar_t> > ucs2("!");
+    VERIFY(ucs2.to_bytes(L"\x44F") == "\xD1\x8F" && ucs2.to_bytes(w) == "!");
+
+    // UTF-16 bytes
+    typedef std::codecvt_utf16<wchar_t, 0x10ffff, std::codecvt_mode(std::generate_header|std::little_endian)> utf16le;
+    const utf16le le;
+    std::mbstate_t state = std::mbstate_t();
+    const wchar_t* wnext;
+    char out[16], *snext;
+    const wchar_t ya[] = { 0x44F, L'a' };
+    VERIFY(le.out(state, ya, ya + 2, wnext, out, out + 16, snext) == std::codecvt_base::ok);
+    VERIFY(snext - out == 6 && std::string(out, snext) == std::string("\xFF\xFE\x4F\x04" "a\0", 6));
+    typedef std::codecvt_utf16<wchar_t, 0x10ffff, std::consume_header> utf16;
+    const utf16 be;
+    state = std::mbstate_t();
+    wchar_t in[4], *inext;
+    const char* cnext;
+    VERIFY(be.in(state, out, snext, cnext, in, in + 4, inext) == std::codecvt_base::ok && inext - in == 2 && in[0] == 0x44F && in[1] == L'a');
+    state = std::mbstate_t();
+    const char pair[] = "\xD8\x3D\xDE\x00\x00" "a";
+    VERIFY(be.length(state, pair, pair + 6, 1) == 0);
+
+    // the native strings
+    ntl::nt::const_unicode_string name(w.data(), 1000);
+    std::string log("name: ");
+    VERIFY(ntl::append_utf8(log, name) && log.size() == 6 + ntl::utf8_length(name));
+    VERIFY(log.compare(6, std::string::npos, convert.to_bytes(w.substr(0, 1000))) == 0);
+    std::wstring bad(L"a\xD800" L"b");
+    VERIFY(!ntl::append_utf8(log, ntl::nt::const_unicode_string(bad.data(), bad.size())) && log.size() == 6 + ntl::utf8_length(name));
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 4 MB corpora: the length, UTF-16 to UTF-8, UTF-8 to UTF-16 and the code point conversion of the reference
+
+  uint64_t nanoseconds(const std::chrono::high_resolution_clock::time_point& t)
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - t).count()) | 1;
+  }
+
+  void bench()
+  {
+    typedef std::chrono::high_resolution_clock clock;
+    clock::calibrate();
+    std::wstring w, back;
+    std::string s, out;
+    for ( int kind = 0; kind < corpora; kind++ )
+    {
+      make_text(static_cast<corpus>(kind), 2 * 1024 * 1024 / (kind >= cjk ? 2 : 1), w, s);
+      const wchar_t* const wf = w.data(), * const wl = wf + w.size();
+      const char* const sf = s.data(), * const sl = sf + s.size();
+      out.assign(s.size(), '\0');
+      back.assign(w.size(), L'\0');
+      const size_t input = w.size() * sizeof(wchar_t);
+
+      clock::time_point t = clock::now();
+      const size_t length = utf::utf8_length(wf, wl);
+      const uint64_t t_length = nanoseconds(t);
+
+      const wchar_t* wnext;
+      char* snext;
+      t = clock::now();
+      utf::to_utf8(wf, wl, wnext, &out[0], &out[0] + out.size(), snext);
+      const uint64_t t_out = nanoseconds(t);
+
+      const char* cnext;
+      wchar_t* bnext;
+      t = clock::now();
+      utf::from_utf8(sf, sl, cnext, &back[0], &back[0] + back.size(), bnext);
+      const uint64_t t_in = nanoseconds(t);
+      VERIFY(length == s.size() && out == s && back == w);
+
+      // the code points one by one
+      t = clock::now();
+      std::string naive;
+      naive.reserve(s.size());
+      for ( const wchar_t* p = wf; p != wl; ++p )
+      {
+        uint32_t c = *p;
+        if ( c - 0xD800 < 0x400 )
+          c = 0x10000 + ((c - 0xD800) << 10) + (*++p - 0xDC00);
+        put_utf8(naive, c);
+      }
+      const uint64_t t_naive = nanoseconds(t);
+      VERIFY(naive == s);
+
+      dbg::trace.printf("%-8s %5u KB utf16: length %5I64u, to utf8 %5I64u, from utf8 %5I64u, code points %5I64u MB/s\n",
+        corpus_names[kind], static_cast<unsigned>(input / 1024), input * 1000 / t_length, input * 1000 / t_out, input * 1000 / t_in, input * 1000 / t_naive);
+    }
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    test03();
+    bench();
+  }
+}
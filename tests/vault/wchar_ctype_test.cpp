@@ -0,0 +1,175 @@
+// common tests part
+#include <cassert>
+#include <nt/new.hxx>
+
+#define __attribute__(x)
+#pragma warning(disable:4101 4189)
+#define VERIFY(e) assert(e)
+
+#include <locale>
+#include <vector>
+
+#include <nt/debug.hxx>
+
+namespace dbg = ntl::nt::dbg;
+
+namespace
+{
+  typedef std::ctype<wchar_t> ctype;
+  typedef ctype::mask mask;
+
+  uint32_t seed = 1;
+  uint32_t random(uint32_t n)
+  {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  }
+
+  const ctype& facet()
+  {
+    return std::use_facet<ctype>(std::locale());
+  }
+
+  // FNV-1a of the masks
+  uint32_t hash(const mask* masks, size_t n)
+  {
+    uint32_t h = 2166136261u;
+    for ( size_t i = 0; i < n; i++ )
+      h = (h ^ static_cast<uint16_t>(masks[i])) * 16777619u;
+    return h;
+  }
+
+  const mask all_masks[] = { ctype::upper, ctype::lower, ctype::digit, ctype::space, ctype::punct, ctype::cntrl, ctype::xdigit, ctype::alpha,
+    ctype::alnum, ctype::graph, ctype::print };
+
+  // the table is the one which was decompressed from the old wchar_masks blob
+  void test01()
+  {
+    const ctype& ct = facet();
+    std::vector<wchar_t> chars(0x10000);
+    std::vector<mask> scalar(chars.size()), batch(chars.size());
+    for ( size_t c = 0; c < chars.size(); c++ )
+    {
+      chars[c] = static_cast<wchar_t>(c);
+      ct.is(&chars[c], &chars[c] + 1, &scalar[c]);
+    }
+    VERIFY(ct.is(&chars[0], &chars[0] + chars.size(), &batch[0]) == &chars[0] + chars.size());
+    VERIFY(hash(&scalar[0], scalar.size()) == 0x94a2d183);
+    VERIFY(scalar == batch);
+
+    VERIFY(ct.is(ctype::upper, L'A') && ct.is(ctype::xdigit, L'A') && !ct.is(ctype::lower, L'A'));
+    VERIFY(ct.is(ctype::lower, L'z') && !ct.is(ctype::xdigit, L'z') && ct.is(ctype::alnum, L'z'));
+    VERIFY(ct.is(ctype::digit, L'7') && ct.is(ctype::xdigit, L'7') && !ct.is(ctype::alpha, L'7'));
+    VERIFY(ct.is(ctype::space, L'\t') && ct.is(ctype::cntrl, L'\t') && ct.is(ctype::space, L' ') && !ct.is(ctype::cntrl, L' '));
+    VERIFY(ct.is(ctype::punct, L'!') && !ct.is(ctype::graph, L'$'));
+    VERIFY(ct.is(ctype::upper, 0x0416) && ct.is(ctype::lower, 0x03B1) && ct.is(ctype::alpha, 0x4E00) && !ct.is(ctype::upper|ctype::lower, 0x4E00));
+    VERIFY(ct.is(ctype::space, 0x3000) && ct.is(ctype::digit, 0xFF10) && !ct.is(ctype::xdigit, 0xFF10));
+    VERIFY(scalar[0xD800] == 0 && ct.is(ctype::cntrl, 0xE000) && scalar[0xFFFF] == 0);
+
+    for ( size_t c = 0; c < chars.size(); c++ )
+      for ( size_t m = 0; m < _countof(all_masks); m++ )
+        VERIFY(ct.is(all_masks[m], chars[c]) == ((scalar[c] & all_masks[m]) != 0));
+  }
+
+  // the batches of the ASCII, of the uniform pages and of the mixed characters are classified as the single characters
+  void test02()
+  {
+    const ctype& ct = facet();
+    static const uint32_t ranges[][2] = { { 0, 0x80 }, { 0x4E00, 0x9FA0 }, { 0, 0x10000 }, { 0x3FF8, 0x4008 }, { 0x20, 0x3C0 } };
+
+    std::vector<wchar_t> s(300);
+    std::vector<mask> v(s.size());
+    for ( int round = 0; round < 20000; round++ )
+    {
+      const uint32_t* const r = ranges[random(_countof(ranges))];
+      const size_t first = random(20), size = random(static_cast<uint32_t>(s.size() - first));
+      for ( size_t i = 0; i < s.size(); i++ )
+        s[i] = static_cast<wchar_t>(r[0] + random(r[1] - r[0]));
+      // the single different character
+      if ( random(2) )
+        s[first + random(static_cast<uint32_t>(size + 1))] = static_cast<wchar_t>(random(0x10000));
+
+      const wchar_t* const low = &s[first], * const high = low + size;
+      ct.is(low, high, &v[0]);
+      for ( size_t i = 0; i < size; i++ )
+      {
+        mask single;
+        ct.is(low + i, low + i + 1, &single);
+        VERIFY(v[i] == single);
+      }
+
+      const mask m = all_masks[random(_countof(all_masks))];
+      const wchar_t* is = low, * is_not = low;
+      while ( is != high && !ct.is(m, *is) )
+        ++is;
+      while ( is_not != high && ct.is(m, *is_not) )
+        ++is_not;
+      VERIFY(ct.scan_is(m, low, high) == is);
+      VERIFY(ct.scan_not(m, low, high) == is_not);
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // 1M characters of the ASCII, CJK and random text: the single character, the sequence and the flat 64K table
+
+  void bench_text(const char* name, const std::vector<wchar_t>& s, const mask* flat)
+  {
+    const ctype& ct = facet();
+    std::vector<mask> v(s.size());
+    const wchar_t* const low = &s[0], * const high = low + s.size();
+    uint64_t sum = 0;
+
+    uint64_t t = ntl::intrinsic::rdtsc();
+    for ( size_t i = 0; i < s.size(); i++ )
+      sum += ct.is(ctype::alpha, s[i]);
+    const uint64_t t_char = ntl::intrinsic::rdtsc() - t;
+
+    t = ntl::intrinsic::rdtsc();
+    ct.is(low, high, &v[0]);
+    const uint64_t t_batch = ntl::intrinsic::rdtsc() - t;
+    sum += v[s.size() / 2];
+
+    t = ntl::intrinsic::rdtsc();
+    for ( size_t i = 0; i < s.size(); i++ )
+      v[i] = flat[static_cast<uint16_t>(s[i])];
+    const uint64_t t_flat = ntl::intrinsic::rdtsc() - t;
+    sum += v[s.size() / 3];
+
+    t = ntl::intrinsic::rdtsc();
+    for ( const wchar_t* p = ct.scan_is(ctype::digit, low, high); p != high; p = ct.scan_is(ctype::digit, p + 1, high) )
+      sum += p - low;
+    const uint64_t t_scan = ntl::intrinsic::rdtsc() - t;
+
+    dbg::trace.printf("%-6s is %2I64u, sequence %2I64u, flat table %2I64u, scan_is %2I64u cycles per 100 characters (%I64u)\n",
+      name, t_char * 100 / s.size(), t_batch * 100 / s.size(), t_flat * 100 / s.size(), t_scan * 100 / s.size(), sum);
+  }
+
+  void bench()
+  {
+    static const size_t count = 1000 * 1000;
+    std::vector<mask> flat(0x10000);
+    for ( size_t c = 0; c < flat.size(); c++ )
+    {
+      const wchar_t wc = static_cast<wchar_t>(c);
+      facet().is(&wc, &wc + 1, &flat[c]);
+    }
+
+    std::vector<wchar_t> ascii(count), cjk(count), mixed(count);
+    for ( size_t i = 0; i < count; i++ )
+    {
+      ascii[i] = static_cast<wchar_t>(random(10) ? 'a' + random(26) : random(8) ? ' ' : '0' + random(10));
+      cjk[i] = static_cast<wchar_t>(0x4E00 + random(0x5000));
+      mixed[i] = static_cast<wchar_t>(random(0x10000));
+    }
+    bench_text("ascii", ascii, &flat[0]);
+    bench_text("cjk", cjk, &flat[0]);
+    bench_text("mixed", mixed, &flat[0]);
+  }
+
+  void main()
+  {
+    test01();
+    test02();
+    bench();
+  }
+}